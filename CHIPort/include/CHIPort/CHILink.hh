@@ -2,19 +2,19 @@
 #define __CHI_LINK_HH__
 
 #include <cstdint>
-#include <deque>
 
 #include <systemc>
 
 #include "CHIPort/CHIUtilities.h"
+#include "Common/RingQueue.hh"
 #include "sysc/kernel/sc_simcontext.h"
 
 namespace dmu {
 namespace Port {
 
 struct CHILink {
-  std::deque<CHIFlit> tx_queue;
-  std::deque<CHIFlit> rx_queue;
+  RingQueue<CHIFlit> tx_queue;
+  RingQueue<CHIFlit> rx_queue;
 
   /* Link credits issued to us by our peer that we can use. */
   uint8_t tx_credits_available = 0;
@@ -55,6 +55,13 @@ struct CHILink {
     return rx_credit_sent_upstream + rx_queue.size() < rx_credits_available;
   }
 
+  // send_flits 既不会归还 link credit 也不会发出 flit
+  inline bool is_send_idle() const
+  {
+    return static_cast<int>(rx_credit_sent_upstream + rx_queue.size()) >= rx_credits_available
+        && (tx_queue.empty() || tx_credits_available == 0);
+  }
+
   template <typename F>
   void send_flits(const ARM::CHI::Channel channel, F nb_transporter) 
   {
@@ -0,0 +1,155 @@
+#ifndef __CHI_LOAD_GENERATOR_HH__
+#define __CHI_LOAD_GENERATOR_HH__
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <iosfwd>
+#include <random>
+#include <vector>
+
+#include <ARM/TLM/arm_chi.h>
+#include <systemc>
+
+#include "CHIPort/CHIUtilities.h"
+
+namespace dmu{
+    namespace Port{
+
+enum class InjectionProcess
+{
+    Constant,   // 固定间隔
+    Poisson,    // 指数分布间隔
+    OnOff,      // ON / OFF 交替 (时长为指数分布), ON 期间以 Poisson 方式按峰值速率注入
+};
+
+enum class LocalityModel
+{
+    Stride,     // base + n * stride, 在 footprint 内回绕
+    HotSet,     // hot_probability 的请求落在 footprint 开头 hot_set_bytes 内, 其余在整个 footprint 内均匀分布
+    Random,     // 在 footprint 内均匀分布
+};
+
+// 一个 requester 的配置, 带宽按请求的字节数计算, GB/s 即 byte/ns
+struct RequesterConfig
+{
+    double bandwidth_gbps{1.0};                 // 平均注入带宽
+    InjectionProcess injection{InjectionProcess::Poisson};
+    double on_time_ns{200.0};                   // OnOff: ON / OFF 时长的均值, 峰值速率为 bandwidth * (on + off) / on
+    double off_time_ns{800.0};
+    double read_ratio{1.0};
+    LocalityModel locality{LocalityModel::Random};
+    uint64_t base_address{0};
+    uint64_t footprint_bytes{uint64_t(1) << 30};
+    uint64_t stride_bytes{64};
+    uint64_t hot_set_bytes{uint64_t(1) << 20};
+    double hot_probability{0.9};
+    ARM::CHI::Size size{ARM::CHI::SIZE_64};
+    uint8_t qos{15};
+    uint16_t src_id{1};
+    uint64_t seed{1};
+    uint64_t max_requests{0};                   // 0 表示不限
+};
+
+// 延迟从请求产生 (而不是发送) 开始计算, 包含 requester 内排队的时间
+struct RequesterStats
+{
+    uint64_t generated{0};
+    uint64_t issued{0};
+    uint64_t retried{0};
+    uint64_t completed_reads{0};
+    uint64_t completed_writes{0};
+    uint64_t completed_bytes{0};
+    uint64_t read_latency_sum_ps{0};
+    uint64_t write_latency_sum_ps{0};
+    uint64_t max_read_latency_ps{0};
+    uint64_t max_write_latency_ps{0};
+    uint64_t max_backlog{0};                    // requester 内等待发送的最大请求数
+};
+
+/*
+开环的多 requester CHI 流量发生器
+    每个 requester 按自己的注入过程产生请求, 不等待之前的请求完成, 来不及发送的请求在 requester 内排队
+    requester 之间轮询, 每个周期最多向 REQ 通道发送一个新请求; 请求被 RetryAck 后等待对应 pcrd_type 的 PcrdGrant 重发
+    读请求在收到 CompData, 写请求在 DBIDResp 和 Comp 都收到时完成
+统计在 ResetStats 之后重新开始, 用于跳过 warm-up
+*/
+class CHILoadGenerator : public sc_core::sc_module
+{
+    public:
+        static constexpr unsigned kNumOfTxnIds = 1024;
+
+        SC_HAS_PROCESS(CHILoadGenerator);
+        explicit CHILoadGenerator(const sc_core::sc_module_name& name, unsigned data_width_bits = 128);
+        ~CHILoadGenerator() override;
+
+        // 仿真开始前调用, 返回 requester 编号; 各 requester 的 src_id 必须不同 (PcrdGrant 按 src_id 发放)
+        unsigned AddRequester(const RequesterConfig& config);
+        void ResetStats();
+
+        inline unsigned GetNumOfRequesters() const { return requesters.size(); }
+        inline const RequesterStats& GetStats(unsigned requester) const { return requesters.at(requester).stats; }
+        inline unsigned GetNumOfOutstanding() const { return kNumOfTxnIds - freeTxnIds.size(); }
+        // 每个 requester 一行: 注入 / 完成带宽, 平均与最大延迟, retry 数目
+        void PrintReport(std::ostream& os) const;
+
+        ARM::CHI::SimpleInitiatorSocket<CHILoadGenerator> initiator;
+        sc_core::sc_in<bool> clock;
+
+    private:
+        struct Request
+        {
+            uint64_t address;
+            uint64_t generate_time_ps;
+            unsigned requester;
+            bool is_read;
+        };
+        struct Requester
+        {
+            RequesterConfig config;
+            std::mt19937_64 rng;
+            double mean_interval_ps;
+            double next_arrival_ps;
+            double on_end_ps;                   // OnOff: 当前 ON 的结束时间
+            uint64_t sequence{0};
+            std::deque<Request> backlog;
+            // 以 pcrd_type 索引: 等待 PcrdGrant 的请求 (txn id), 先于 RetryAck 到达的 PcrdGrant
+            std::array<std::deque<uint16_t>, 16> retry_queues;
+            std::array<unsigned, 16> pending_grants{};
+            RequesterStats stats;
+        };
+        struct Outstanding
+        {
+            Request request;
+            ARM::CHI::Payload* payload{nullptr};
+            ARM::CHI::Phase phase;
+            unsigned responses_left{0};         // 读: CompData; 写: DBIDResp 和 Comp (顺序不定)
+        };
+
+        void clock_posedge();
+        void clock_negedge();
+        tlm::tlm_sync_enum nb_transport_bw(ARM::CHI::Payload& payload, ARM::CHI::Phase& phase);
+
+        void HandleResponse(const CHIFlit& rsp_flit);
+        void HandleReadData(const CHIFlit& dat_flit);
+        void Generate(uint64_t now_ps);
+        void Issue();
+        void Resend(uint16_t txn_id, uint8_t pcrd_type);
+        void Complete(uint16_t txn_id);
+        double NextArrival(Requester& requester);
+        uint64_t NextAddress(Requester& requester);
+
+        CHIChannelState channels[CHI_NUM_CHANNELS];
+        const unsigned dataWidthBytes;
+        std::vector<Requester> requesters;
+        unsigned nextRequester{0};
+
+        std::vector<Outstanding> outstanding;   // (txn id)
+        std::vector<uint16_t> freeTxnIds;
+        sc_core::sc_time statsStart{sc_core::SC_ZERO_TIME};
+};
+
+    } // namespace Port
+} // namespace dmu
+
+#endif
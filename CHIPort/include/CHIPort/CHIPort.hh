@@ -5,19 +5,21 @@
 #include <tlm>
 #include <tlm_utils/simple_target_socket.h>
 #include <tlm_utils/simple_initiator_socket.h>
-#include <tlm_utils/peq_with_cb_and_phase.h>
 
 #include <ARM/TLM/arm_chi.h>
 
 #include "CHIPort/CHILink.hh"
 #include "CHIPort/CHIUtilities.h"
+#include "CHIPort/DataScoreboard.hh"
 #include "CHIPort/P2cFifo.hh"
 #include "CHIPort/PortMemoryManager.hh"
 #include "CHIPort/RdDataInfo.hh"
 #include "CHIPort/ResponseQueues.hh"
 #include "CHIPort/RetryResourceManager.hh"
 #include "CHIPort/WdataBufferArray.hh"
+#include "Common/CalendarPeq.hh"
 #include "Common/Common.hh"
+#include "Common/RingQueue.hh"
 #include "Configure/Configure.hh"
 
 #include <cstdint>
@@ -25,6 +27,7 @@
 #include <set>
 #include <unordered_map>
 #include <memory>
+#include <vector>
 
 namespace dmu{
     namespace Port{
@@ -45,9 +48,19 @@ protected:
     void noc_clock_posedge();
     void noc_clock_negedge();
 
+    // 时钟处理函数本周期没有事情可做时不再每个周期运行, 等对应的 activity event 唤醒后对齐到下一个时钟沿
+    // flit / credit 到达, 下游返回 UIF 消息, 以及其它处理函数改变状态之后由 NotifyActivity 唤醒
+    sc_core::sc_event dfi_activity_event;
+    sc_core::sc_event noc_posedge_activity_event;
+    sc_core::sc_event noc_negedge_activity_event;
+    bool IsDfiIdle();
+    bool IsNocPosedgeIdle() const;
+    bool IsNocNegedgeIdle() const;
+    void NotifyActivity();
+
     /*Request Channel*/
-    std::deque<CHIFlit> req_s1;
-    std::deque<CHIFlit> req_s2;
+    RingQueue<CHIFlit> req_s1;
+    RingQueue<CHIFlit> req_s2;
     void req_decode_s1();
     void req_decision_s2();
     void req_pop_s3();
@@ -66,7 +79,7 @@ protected:
     /*Write Data Channel*/
     void wdat_decode_s1();
     void wdat_push_s2();
-    std::deque<CHIFlit> wdat_s1;
+    RingQueue<CHIFlit> wdat_s1;
 
     /*Read Data Channel*/
     void rdat_arbit_s1();
@@ -80,11 +93,25 @@ protected:
                                        sc_core::sc_time& bwDelay);
     //UIF Interface
     void SendUifRequest(const QueueEntry& entry, unsigned cmd_id, bool is_rd);
+    // 读在 UIF_RDAT_END, 写在 UIF_WDAT_END 时 CHIPort 用完 payload, release 分配时 acquire 的引用
+    // 按 cmd_id (rdata id / dbid) 找回发出的 payload, RMW 时 controller 回传的是 child payload
+    void ReleaseUifRequest(unsigned cmd_id, bool is_rd);
+    // 发出 rdUifRequest / wrUifRequest 中的 UIF_REQ, controller 拒绝 (地址冲突 / 队列满) 时记为 rejectedUifRequest
+    bool IssueUifRequest(unsigned cmd_id, bool is_rd);
+    std::vector<tlm::tlm_generic_payload*> rdUifRequest; // (rdata id)
+    std::vector<tlm::tlm_generic_payload*> wrUifRequest; // (dbid)
+    // 被 controller 拒绝的 UIF_REQ, 保持顺序在下一个 dfi cycle 重发, 重发成功之前不再仲裁新的请求
+    struct RejectedUifRequest
+    {
+        unsigned cmd_id;
+        bool is_rd;
+    };
+    std::optional<RejectedUifRequest> rejectedUifRequest;
 
 public:
     explicit CHIPort(const sc_core::sc_module_name& name, const Configure& configure, unsigned data_width_bits, const sc_core::sc_time& clock_period);
     ~CHIPort() = default;
-    tlm_utils::peq_with_cb_and_phase<CHIPort> payloadEventQueue;
+    CalendarPeq<CHIPort> payloadEventQueue; // calendar 以 dfi cycle (clock_period) 为单位
     tlm_utils::simple_initiator_socket<CHIPort> iSocket; //DB intf
     ARM::CHI::SimpleTargetSocket<CHIPort> target; // CHI intf
 
@@ -92,6 +119,10 @@ public:
     sc_core::sc_in<bool> dfi_clock;
 
 public:
+    inline const PortMemoryManager& GetMemoryManager() const { return memoryManager; }
+    // 在 payload 中携带读写数据 (需要在仿真开始前调用), scoreboard_enable 时检查每个 CompData
+    void EnableDataCheck(bool scoreboard_enable);
+    inline const DataScoreboard* GetDataScoreboard() const { return dataScoreboard.get(); }
 
 private:
     void peqCallback(tlm::tlm_generic_payload& trans, const tlm::tlm_phase& phase);
@@ -103,6 +134,9 @@ private:
     std::unique_ptr<P2cFifo> p2cFifo;
     std::unique_ptr<ResponseQueues> responseQueues;
 
+    bool dataCheckEnabled = false;
+    std::unique_ptr<DataScoreboard> dataScoreboard;
+
     const Configure& _configure;
 
     int src_id;
@@ -3,7 +3,11 @@
 
 #include <ARM/TLM/arm_chi.h>
 
+#include <memory>
+#include <string>
+
 #include "CHIPort/CHIUtilities.h"
+#include "CHIPort/ReqTraceReader.hh"
 
 
 namespace dmu{
@@ -19,10 +23,27 @@ protected:
     unsigned data_width_bytes;
     uint16_t txn_id = 0;
 
+    /* Trace replay state, the REQ queue holds at most TRACE_LOOKAHEAD requests read from the trace. */
+    static constexpr size_t TRACE_LOOKAHEAD = 16;
+    std::unique_ptr<ReqTraceReader> trace_reader;
+    const ReqTraceRecord* trace_record = nullptr;
+    bool trace_timed = true;
+    uint64_t trace_issue_time_ps = 0;
+
     void clock_posedge();
     void clock_negedge();
 
+    /* The clock processes stop running every cycle while they have nothing to do and are re-armed by these events,
+     * then realigned to the next clock edge. */
+    sc_core::sc_event posedge_activity_event;
+    sc_core::sc_event negedge_activity_event;
+    bool is_posedge_idle() const;
+    bool is_negedge_idle() const;
+    void notify_activity();
+
     void handle_dbid_resp(const CHIFlit& dbid_flit);
+    void queue_request(ARM::CHI::ReqOpcode req_opcode, uint64_t address, ARM::CHI::Size size, uint16_t src_id, uint8_t qos);
+    void issue_trace_requests();
 
     tlm::tlm_sync_enum nb_transport_bw(ARM::CHI::Payload& payload, ARM::CHI::Phase& phase);
 
@@ -32,6 +53,12 @@ public:
     /* Add a payload to the traffic queue. */
     void add_payload(ARM::CHI::ReqOpcode req_opcode, uint64_t address, ARM::CHI::Size size);
 
+    /* Replay a binary request trace (see ReqTraceFormat.hh), records are read through mmap as the REQ queue drains.
+     * timed: issue each request at its recorded time, or later when the REQ queue is backed up.
+     * Otherwise issue as fast as link credits allow. */
+    void replay_trace(const std::string& path, bool timed = true);
+    bool trace_finished() const { return trace_record == nullptr && channels[ARM::CHI::CHANNEL_REQ].tx_queue.empty(); }
+
     ARM::CHI::SimpleInitiatorSocket<CHITrafficGenerator> initiator;
 
     sc_core::sc_in<bool> clock;
@@ -4,9 +4,11 @@
 #include "sysc/kernel/sc_time.h"
 #include <ARM/TLM/arm_chi_payload.h>
 #include <ARM/TLM/arm_chi_phase.h>
+#include "Common/RingQueue.hh"
 
+#include <array>
+#include <cassert>
 #include <cstdint>
-#include <deque>
 #include <vector>
 
 namespace dmu{
@@ -33,8 +35,20 @@ static const unsigned CHI_CACHE_LINE_SIZE_LOG2_BYTES = 6;
 static const unsigned CHI_CACHE_LINE_SIZE_BYTES = 1 << CHI_CACHE_LINE_SIZE_LOG2_BYTES;
 static const uint64_t CHI_CACHE_LINE_ADDRESS_MASK = ~((UINT64_C(1) << CHI_CACHE_LINE_SIZE_LOG2_BYTES) - 1);
 
+/* DataIDs of one transaction: at most a 64B line over a 128-bit data bus, so 4 beats.
+ * Fixed capacity so generating them per write does not touch the heap. */
+struct TransactionDataIds
+{
+    std::array<uint8_t, 4> ids;
+    unsigned count = 0;
+
+    void push_back(uint8_t data_id) { assert(count < ids.size()); ids[count++] = data_id; }
+    const uint8_t* begin() const { return ids.data(); }
+    const uint8_t* end() const { return ids.data() + count; }
+};
+
 /* Generate the DataIDs that will be seen in the transaction. */
-inline std::vector<uint8_t> transaction_data_ids(const ARM::CHI::Payload& payload, const unsigned data_width_bytes)
+inline TransactionDataIds transaction_data_ids(const ARM::CHI::Payload& payload, const unsigned data_width_bytes)
 {
     const unsigned size_bytes = 1 << payload.size;
     const uint64_t align_mask = size_bytes - 1;
@@ -45,8 +59,7 @@ inline std::vector<uint8_t> transaction_data_ids(const ARM::CHI::Payload& payloa
     const unsigned beat_count = size_bytes <= data_width_bytes ? 1 : size_bytes / data_width_bytes;
     const unsigned first_data_id = (aligned_offset >> 4) & ~(beat_inc - 1);
 
-    std::vector<uint8_t> data_ids;
-    data_ids.reserve(4);
+    TransactionDataIds data_ids;
 
     for (unsigned data_id = first_data_id, i = 0; i < beat_count; data_id += beat_inc, i++)
         data_ids.push_back(data_id);
@@ -81,8 +94,8 @@ static const unsigned CHI_MAX_LINK_CREDITS = 15;
 
 struct CHIChannelState
 {
-    std::deque<CHIFlit> tx_queue;
-    std::deque<CHIFlit> rx_queue;
+    RingQueue<CHIFlit> tx_queue;
+    RingQueue<CHIFlit> rx_queue;
 
     /* Link credits issued to us by our peer that we can use. */
     uint8_t tx_credits_available = 0;
@@ -116,6 +129,12 @@ struct CHIChannelState
         return true;
     }
 
+    /* send_flits would neither return a link credit nor send a flit. */
+    bool is_send_idle() const
+    {
+        return rx_credits_available <= 0 && (tx_queue.empty() || tx_credits_available == 0);
+    }
+
     template <typename F>
     void send_flits(const ARM::CHI::Channel channel, F nb_transporter)
     {
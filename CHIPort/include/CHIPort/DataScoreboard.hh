@@ -0,0 +1,63 @@
+#ifndef __DATA_SCOREBOARD_HH__
+#define __DATA_SCOREBOARD_HH__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ARM/TLM/arm_chi_payload.h"
+#include "CHIPort/CHIUtilities.h"
+#include "Common/BackingStore.hh"
+
+namespace dmu{
+    namespace Port{
+
+/*
+CHIPort 的读数据 scoreboard
+    参考模型是一份 BackingStore, 写请求发往 controller (UIF_REQ) 时按写数据更新, 此时 wdata 已经收齐
+    读请求发往 controller 时从参考模型取出期望的数据, 按 rdata id 保存
+    CompData 发出时与期望比较, 所以 controller 需要保证同地址的读写按 UIF_REQ 的顺序完成 (RAW / WAR / WAW)
+    被 controller 拒绝的请求在 port 中按原顺序重发, 期间不发新的请求, 所以参考模型的顺序不变
+额外的开销: 参考模型中写过的 page, 以及每个 rdata id 一个 cache line (GetNumOfBytes)
+*/
+class DataScoreboard
+{
+    public:
+        explicit DataScoreboard(unsigned num_of_read_ids);
+
+        void CommitWrite(const ARM::CHI::Payload& payload);
+        void IssueRead(unsigned rdata_id, const ARM::CHI::Payload& payload);
+        // 返回数据是否与期望一致, 前 kMaxReports 次不一致打印详细信息
+        bool CheckCompData(unsigned rdata_id, const ARM::CHI::Payload& payload);
+
+        inline uint64_t GetNumOfWrites() const { return numOfWrites; }
+        inline uint64_t GetNumOfChecks() const { return numOfChecks; }
+        inline uint64_t GetNumOfMismatches() const { return numOfMismatches; }
+        inline std::size_t GetNumOfBytes() const
+        {
+            return reference.GetNumOfBytes() + expectedReads.capacity() * sizeof(ExpectedRead);
+        }
+
+    private:
+        static constexpr unsigned kMaxReports = 16;
+
+        struct ExpectedRead
+        {
+            bool valid = false;
+            uint64_t address = 0; // 按 size 对齐后的地址
+            unsigned length = 0;
+            std::array<uint8_t, CHI_CACHE_LINE_SIZE_BYTES> data{};
+        };
+
+        BackingStore reference;
+        std::vector<ExpectedRead> expectedReads; // (rdata id)
+        uint64_t numOfWrites = 0;
+        uint64_t numOfChecks = 0;
+        uint64_t numOfMismatches = 0;
+};
+
+    } // namespace Port
+} // namespace dmu
+
+#endif
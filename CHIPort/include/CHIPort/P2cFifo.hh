@@ -4,8 +4,7 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
-#include <deque>
-#include <map>
+#include <vector>
 #include <memory>
 #include <stdexcept>
 #include <optional>
@@ -21,6 +20,7 @@
 #include "CHIPort/WdataBufferArray.hh"
 #include "CHIPort/PortCommon.hh"
 #include "Common/CommonDefine.hh"
+#include "Common/RingQueue.hh"
 #include "Common/StatisticExtension.hh"
 #include "Configure/Configure.hh"
 #include "sysc/kernel/sc_simcontext.h"
@@ -143,7 +143,7 @@ public:
 template<typename T>
 class LprQueue : public RequestQueueIf {
 private:
-    std::deque<T> request_queue;
+    RingQueue<T> request_queue;
     const RdDataInfo& rd_info;
 public:
     explicit LprQueue(size_t max_queue_depth, const sc_core::sc_time& expired_threshold, unsigned min_buffer_size, const RdDataInfo& rd_info) 
@@ -177,7 +177,7 @@ private:
 template<typename T>
 class HprQueue : public RequestQueueIf {
 private:
-    std::deque<T> request_queue;
+    RingQueue<T> request_queue;
     const RdDataInfo& rd_info;
 public:
     explicit HprQueue(size_t max_queue_depth, const sc_core::sc_time& expired_threshold, unsigned min_buffer_size, const RdDataInfo& rd_info) 
@@ -203,7 +203,9 @@ class WdataBufferArray;
 template<typename T>
 class TpwQueue : public RequestQueueIf {
 private:
-    std::map<unsigned,T> request_queue;
+    // 按 dbid 下标, Move2Head 按 dbid 从小到大查找 data ready 的写; 稳态下不走堆
+    std::vector<std::optional<T>> request_queue;
+    unsigned request_num{0};
     std::optional<std::pair<unsigned,T>> head_entry;
     const WdataBufferArray& wdata_buffer;
 public:
@@ -214,18 +216,25 @@ public:
 
     ~TpwQueue() override{
         DPRINT_INFO(false,"Port Tpw Queue","remain size:%ld, remain credit:%d, head has value:%s, queue head is rmw:%s",
-            request_queue.size(),
+            request_num,
             this->GetCredit()
             ,!this->IsHeadEmpty() ? "true" : "false"
         ,!this->IsHeadEmpty()&&IsRMWRequest() ? "true" : "false"
     );
     }
     bool HasRequest() const override { return !IsQueueEmpty() && !IsHeadEmpty();}
-    bool IsQueueEmpty() const override { return request_queue.empty() && !head_entry.has_value(); }
+    bool IsQueueEmpty() const override { return request_num == 0 && !head_entry.has_value(); }
 
     bool IsQueueFull() const override { return GetQueueSize() >= max_queue_depth; }
     bool IsQueueLocked() const override { return false; }
-    void InsertRequest(T element, unsigned dbid) {request_queue.emplace(dbid,element);}
+    void InsertRequest(T element, unsigned dbid)
+    {
+        if(dbid >= request_queue.size())
+            request_queue.resize(dbid + 1);
+        assert(!request_queue[dbid].has_value());
+        request_queue[dbid].emplace(std::move(element));
+        request_num++;
+    }
 
     bool IsRMWRequest() const {return head_entry.value().second.is_rmw;}
     const std::pair<unsigned, T>& GetRequest() {return head_entry.value();}
@@ -239,25 +248,26 @@ public:
     void Move2Head() 
     {
         assert(!head_entry.has_value());
-        for(auto iter = request_queue.begin();iter != request_queue.end();iter++)
+        for(unsigned dbid = 0; dbid < request_queue.size(); dbid++)
         {
-            if(wdata_buffer.IsEntryReady(iter->first)) 
+            if(request_queue[dbid].has_value() && wdata_buffer.IsEntryReady(dbid))
             {
-                iter->second.DecideRmw();
-                head_entry.emplace(iter->first,iter->second);
-                request_queue.erase(iter);
+                request_queue[dbid]->DecideRmw();
+                head_entry.emplace(dbid,std::move(*request_queue[dbid]));
+                request_queue[dbid].reset();
+                request_num--;
                 return;
             }
         }
     }
 
-size_t GetQueueSize() const override { return request_queue.size() + ((head_entry.has_value()) ? 1 : 0); }
+size_t GetQueueSize() const override { return request_num + ((head_entry.has_value()) ? 1 : 0); }
 
     // used for gpr command
     bool HasExpiredCmd() const {
         for(auto& entry: request_queue)
         {
-            if(entry.second.qos_level == PriorityClass::GPW && entry.second.expired_time >= sc_core::sc_time_stamp() )
+            if(entry.has_value() && entry->qos_level == PriorityClass::GPW && entry->expired_time >= sc_core::sc_time_stamp() )
                 return true;
         }
         return false;
@@ -286,28 +296,31 @@ private:
 
     bool IsRdHold() const; // Is Rd in hold state
     bool IsWrHold() const; // Is Wr in hold state
-    bool IsHprHighPriority() {return hpr_queue.IsQueueExpired() && hpr_queue.HasCredit() && hpr_queue.HasRequest();}
-    bool IsLprHighPriority() {return (lpr_queue.IsQueueExpired() || lpr_queue.HasExpiredCmd()) && lpr_queue.HasCredit() && lpr_queue.HasRequest();}
-    bool IsTpwHighPriority() {
+    bool IsHprHighPriority() const {return hpr_queue.IsQueueExpired() && hpr_queue.HasCredit() && hpr_queue.HasRequest();}
+    bool IsLprHighPriority() const {return (lpr_queue.IsQueueExpired() || lpr_queue.HasExpiredCmd()) && lpr_queue.HasCredit() && lpr_queue.HasRequest();}
+    bool IsTpwHighPriority() const {
         return (tpw_queue.IsQueueExpired()|| tpw_queue.HasExpiredCmd()) && tpw_queue.HasCredit() && tpw_queue.HasRequest();
     }
-    bool IsRdHighPriority(){
+    bool IsRdHighPriority() const {
         return (IsHprHighPriority() || IsLprHighPriority());
     }
 
-    bool IsWrHighPriority(){
+    bool IsWrHighPriority() const {
         return (IsTpwHighPriority());
     }
-    bool HasRdRequest() {
+    bool HasRdRequest() const {
         return (lpr_queue.HasRequest() && lpr_queue.HasCredit()) || (hpr_queue.HasRequest() && hpr_queue.HasCredit());
     }
-    bool HasWrRequest() {
+    bool HasWrRequest() const {
         // tpw队列有请求，有信用，并且 tpw的请求不是刚好是"rmw请求但此时 lpr队列没有信用"
         return tpw_queue.HasRequest() && tpw_queue.HasCredit() && (!(tpw_queue.IsRMWRequest() && !lpr_queue.HasCredit()));
     }
 public:
     void UpdateState();
     QueueType GetWinningQueue();
+    // GetWinningQueue 给出 NONE, 并且在队列请求或 credit 变化之前 UpdateState 不会改变状态
+    // (aging 相关的判断都要求队列同时有请求和 credit, 此时与仿真时间无关)
+    bool IsStalled() const;
     bool IsGprCritical() const;
     bool IsGpwCritical() const;
 };
@@ -348,6 +361,8 @@ public:
     inline bool IsHprQueueFull() const { return hpr_queue->IsQueueFull(); }
     inline bool IsTpwQueueFull() const { return tpw_queue->IsQueueFull(); }
     bool IsQueueEmpty() const {return !lpr_queue->HasRequest() && !hpr_queue->HasRequest() && !tpw_queue->HasRequest(); }
+    // 没有请求可以发往 controller
+    bool IsStalled() const { return IsQueueEmpty() || pa_arbiter->IsStalled(); }
 
     unsigned GetRdQueueSize() const { return lpr_queue->GetQueueSize() + hpr_queue->GetQueueSize(); }
     bool IsRdQueueRemainOneSpace() const { return GetRdQueueSize() == Rd_queue_depth - 1; }
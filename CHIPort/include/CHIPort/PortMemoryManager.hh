@@ -6,13 +6,22 @@
 #include <stack>
 #include <tlm>
 #include <unordered_map>
+#include <vector>
 
 #include "CHIPort/CHIUtilities.h"
+#include "Common/ExtensionPool.hh"
+#include "Common/StatisticExtension.hh"
+#include "Common/UifExtension.hh"
 #include "tlm_core/tlm_2/tlm_generic_payload/tlm_gp.h"
 
 namespace dmu{
     namespace Port{
 
+/*
+CHIPort 的 payload pool, payload 按 data length 分桶复用
+StatisticExtension / UifExtension 来自 ExtensionPool: allocate 时挂上, free (payload 最后一次 release) 时摘下放回 pool
+其它模块挂上的 extension (如 DfiExtension) 随 payload 留在 pool 中, 下次复用
+*/
 class PortMemoryManager : public tlm::tlm_mm_interface
 {
 public:
@@ -27,12 +36,30 @@ public:
 
     tlm::tlm_generic_payload& allocate(const CHIFlit& flit, bool is_rd);
     void free(tlm::tlm_generic_payload* payload) override;
+    // 给 payload 挂上 pool 中的 UifExtension, 替换掉的 extension 放回 pool
+    UifExtension* SetUifExtension(tlm::tlm_generic_payload& payload, const UifInfo& uif_info);
+    // 只能在第一次 allocate 之前改变, 已经分配的 payload 不会补上 data buffer
+    void SetStorageEnabled(bool enable);
+
+    inline uint64_t GetNumOfAllocations() const { return numberOfAllocations; }
+    inline uint64_t GetNumOfTransactions() const { return transactionId; }
+    // 还没有 free 回来的 payload 数
+    uint64_t GetNumOfPayloadsInUse() const;
+    inline uint64_t GetNumOfExtensionAllocations() const
+    {
+        return statisticExtensionPool.GetNumOfAllocations() + uifExtensionPool.GetNumOfAllocations();
+    }
 protected:
     tlm::tlm_generic_payload& allocate(unsigned dataLength);
 private:
     uint64_t numberOfAllocations = 0;
     uint64_t numberOfFrees = 0;
-    std::unordered_map<unsigned, std::stack<tlm::tlm_generic_payload*> > freePayloads;
+    // free list 用 vector, 避免 deque 在 push/pop 跨 node 时反复分配
+    std::unordered_map<unsigned, std::stack<tlm::tlm_generic_payload*, std::vector<tlm::tlm_generic_payload*>> > freePayloads;
+    // payload 所在的桶; data length 在使用过程中会被改写, free 时不能用 get_data_length()
+    std::unordered_map<const tlm::tlm_generic_payload*, unsigned> payloadDataLength;
+    ExtensionPool<StatisticExtension> statisticExtensionPool;
+    ExtensionPool<UifExtension> uifExtensionPool;
     bool storageEnabled = false;
     uint64_t transactionId = 0;
 };
@@ -5,8 +5,8 @@
 #include <cstdlib>
 #include <iostream>
 #include <systemc>
-#include <set>
-#include <unordered_map>
+#include <optional>
+#include <vector>
 #include <cassert>
 #include <utility>
 
@@ -49,69 +49,86 @@ public:
     explicit RdDataInfo(const Configure& configure)
         : rd_data_info_buffer_size(configure.controller_config->RD_DAT_INFO_DEPTH)
     {
-        for(uint16_t i = 0; i < rd_data_info_buffer_size; ++i){
-            unused_buffer_id.insert(i);
-        }
+        unused_buffer_id.assign(rd_data_info_buffer_size, true);
+        rdata_info_buffer.resize(rd_data_info_buffer_size);
     }
 
 private:
-    std::set<uint16_t> unused_buffer_id;
-    std::unordered_map<uint16_t, RdDataInfoEntry> rdata_info_buffer;
+    // 按 info tag 下标的定长数组, tag 分配/释放与 entry 进出都不走堆
+    std::vector<bool> unused_buffer_id;
+    std::vector<std::optional<RdDataInfoEntry>> rdata_info_buffer;
+    unsigned num_of_entries{0};
     const unsigned rd_data_info_buffer_size;
 public:
     void release_info_tag(uint16_t id){
-        unused_buffer_id.insert(id);
+        unused_buffer_id.at(id) = true;
     }
 
 
     bool IsEmpty() const {
-        return rdata_info_buffer.empty();
+        return num_of_entries == 0;
     }
 
     bool IsFull() const {
-        return rdata_info_buffer.size() >= rd_data_info_buffer_size;
+        return num_of_entries >= rd_data_info_buffer_size;
     }
     uint16_t allocate_info_tag() {
-        assert(!unused_buffer_id.empty());
-        uint16_t id = *unused_buffer_id.begin();
-        unused_buffer_id.erase(unused_buffer_id.begin());
-        return id;
+        // 最小的空闲 tag
+        for(uint16_t id = 0; id < rd_data_info_buffer_size; ++id) {
+            if(unused_buffer_id[id]) {
+                unused_buffer_id[id] = false;
+                return id;
+            }
+        }
+        std::cerr << "Error: No free info tag in RdDataInfo" << std::endl;
+        std::abort();
     }
-    const unsigned size() const { return rdata_info_buffer.size(); }
+    const unsigned size() const { return num_of_entries; }
 
     void allocate_info_buffer_entry(CHIFlit req_flit, uint16_t id)
     {
-        rdata_info_buffer.emplace(id, RdDataInfoEntry(req_flit));
+        assert(!rdata_info_buffer.at(id).has_value());
+        rdata_info_buffer[id].emplace(req_flit);
+        num_of_entries++;
     }
 
     void set_entry_data_ready(uint16_t id)
     {
-        rdata_info_buffer.at(id).set_data_ready();
+        rdata_info_buffer.at(id).value().set_data_ready();
     }
 
     void erase_entry(uint16_t id)
     {
-        rdata_info_buffer.erase(id);
+        if(rdata_info_buffer.at(id).has_value()) {
+            rdata_info_buffer[id].reset();
+            num_of_entries--;
+        }
         release_info_tag(id);
     }
 
     RdDataInfoEntry get_entry(uint16_t id)
     {
-        return rdata_info_buffer.at(id);
+        return rdata_info_buffer.at(id).value();
+    }
+
+    ARM::CHI::Payload& get_entry_payload(uint16_t id)
+    {
+        return rdata_info_buffer.at(id).value().payload;
     }
 
     bool has_entry_ready() const {
         for(auto& entry: rdata_info_buffer) {
-            if(entry.second.is_receive_data_ready()) 
+            if(entry.has_value() && entry->is_receive_data_ready())
                 return true;
         }
         return false;
     }
 
+    // tag 从小到大取第一个 data ready 的 entry
     std::pair<uint16_t, RdDataInfoEntry> get_ready_entry() const {
-        for(auto& entry: rdata_info_buffer) {
-            if(entry.second.is_receive_data_ready()) 
-                return std::make_pair(entry.first, entry.second);
+        for(uint16_t id = 0; id < rdata_info_buffer.size(); ++id) {
+            if(rdata_info_buffer[id].has_value() && rdata_info_buffer[id]->is_receive_data_ready())
+                return std::make_pair(id, *rdata_info_buffer[id]);
         }
         std::cerr << "Error: No entry ready in RdDataInfo" << std::endl;
         std::abort();
@@ -0,0 +1,54 @@
+#ifndef __REQ_TRACE_FORMAT_HH__
+#define __REQ_TRACE_FORMAT_HH__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dmu{
+    namespace Port{
+
+// CHI request trace 的二进制格式, 由 dmu_trace_convert 从文本 trace 生成, CHITrafficGenerator::replay_trace 通过 mmap 读取
+// 不依赖 SystemC, converter 只需要包含这个头文件
+//
+// File   := Header Record*
+// Header := magic[8] "DMUREQTR" | u32 version | u32 record size | u64 time unit in ps | u64 number of records
+// Record := u64 address | u32 delta | u16 src_id | u8 opcode | u8 size_qos
+//   delta    : 与上一条 record 的时间差 (time unit 为单位), 第一条相对 replay 开始的时间
+//   opcode   : ARM::CHI::ReqOpcode 的值, kReqTraceDelayOnly 表示只推进时间 (delta 超出 u32 时拆分)
+//   size_qos : bit[2:0] CHI size 编码 (log2 字节数), bit[7:4] qos
+//
+// record 定长且自然对齐, mmap 之后可以直接按数组访问; 所有整数都是 little-endian host order
+
+constexpr char kReqTraceMagic[8] = {'D','M','U','R','E','Q','T','R'};
+constexpr uint32_t kReqTraceVersion = 1;
+constexpr uint8_t kReqTraceDelayOnly = 0xff;
+
+struct ReqTraceHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t time_unit_ps;
+    uint64_t num_of_records;
+};
+
+struct ReqTraceRecord
+{
+    uint64_t address;
+    uint32_t delta;
+    uint16_t src_id;
+    uint8_t opcode;
+    uint8_t size_qos;
+
+    inline unsigned GetSize() const { return size_qos & 0x7; }
+    inline unsigned GetQos() const { return size_qos >> 4; }
+    static inline uint8_t PackSizeQos(unsigned size, unsigned qos) { return (size & 0x7) | ((qos & 0xf) << 4); }
+};
+
+static_assert(sizeof(ReqTraceHeader) == 32, "trace header layout changed");
+static_assert(sizeof(ReqTraceRecord) == 16, "trace record layout changed");
+
+    } // namespace Port
+} // namespace dmu
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef __REQ_TRACE_READER_HH__
+#define __REQ_TRACE_READER_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "CHIPort/ReqTraceFormat.hh"
+
+namespace dmu{
+    namespace Port{
+
+/*
+通过 mmap 顺序读取 ReqTraceFormat 的 trace 文件
+    record 不做拷贝, Next 直接返回 mmap 中的指针, 只在下一次 Next 之前有效
+    已经读过的部分按 kReleaseBytes 为单位 madvise(MADV_DONTNEED), 常驻内存与 trace 长度无关
+*/
+class ReqTraceReader
+{
+    public:
+        static constexpr std::size_t kReleaseBytes = std::size_t(4) << 20;
+
+        explicit ReqTraceReader(const std::string& path);
+        ReqTraceReader(const ReqTraceReader&) = delete;
+        ReqTraceReader& operator=(const ReqTraceReader&) = delete;
+        ~ReqTraceReader();
+
+        // 没有更多 record 时返回 nullptr
+        const ReqTraceRecord* Next();
+
+        inline uint64_t GetTimeUnitPs() const { return timeUnitPs; }
+        inline uint64_t GetNumOfRecords() const { return numOfRecords; }
+        inline uint64_t GetPosition() const { return position; }
+
+    private:
+        uint8_t* base = nullptr;
+        std::size_t mapLength = 0;
+        const ReqTraceRecord* records = nullptr;
+        uint64_t numOfRecords = 0;
+        uint64_t timeUnitPs = 1;
+        uint64_t position = 0;
+        std::size_t releasedBytes = 0; // [0, releasedBytes) 已经 madvise 释放
+};
+
+    } // namespace Port
+} // namespace dmu
+
+#endif
@@ -3,13 +3,13 @@
 
 #include <cstddef>
 #include <cstdint>
-#include <deque>
 #include <systemc>
 #include <unordered_map>
 #include "ARM/TLM/arm_chi_phase.h"
 #include "CHIPort/CHIUtilities.h"
 // #include "Controller/common/Configure.hh"
 #include "Common/CommonDefine.hh"
+#include "Common/RingQueue.hh"
 #include "Configure/Configure.hh"
 #include "PortCommon.hh"
 namespace dmu{
@@ -77,10 +77,12 @@ public:
         }
     }
 
-    void InsertRetryAckResp(const CHIFlit& req_flit)
+    // pcrd_type 为 PortCmdType, 与之后 PcrdGrant 的 pcrd_type 对应
+    void InsertRetryAckResp(const CHIFlit& req_flit, uint8_t pcrd_type)
     {
         auto& queue = response_queues.at(static_cast<size_t>(ResponseQueueType::RetryAck));
         queue.emplace_back(req_flit.payload, make_response_phase(req_flit.phase, ARM::CHI::RSP_OPCODE_RETRY_ACK));
+        queue.back().phase.pcrd_type = pcrd_type;
     }
 
     void InsertPcrdGrantResp(const CHIFlit& pcrd_flit)
@@ -106,7 +108,7 @@ private:
     const unsigned Max_ReadReceipt_Queue_size;
     const unsigned Max_Comp_Queue_size;
 
-    std::vector<std::deque<CHIFlit>> response_queues{Queue_Type_Num};
+    std::vector<RingQueue<CHIFlit>> response_queues{Queue_Type_Num};
 
 public:
     unsigned GetQueueSize(const ResponseQueueType& type) const
@@ -133,7 +133,8 @@ public:
     bool is_lgpr_full() const
     { return p2c_fifo.IsLprQueueFull() || p2c_fifo.lpr_queue->GetQueueSize() + lgpr_send_upstream_p_credit >= p2c_fifo.lpr_queue->GetMaxQueueDepth();  }
     bool is_cmo_full() const { return false;}    // TODO: Need to add the CMO Queue and resource allocation
-    bool is_tpw_full() const { return wdata_buffer_array.IsArrayFull() || p2c_fifo.IsTpwQueueFull() || p2c_fifo.tpw_queue->GetQueueSize() + tpw_send_upstream_p_credit >= p2c_fifo.tpw_queue->GetMaxQueueDepth(); }  //
+    // dbid 在 UIF_WDAT_END 才释放, 比 tpw queue 占用得久, 已发出的 p-credit 也要在 wdata buffer 中预留
+    bool is_tpw_full() const { return wdata_buffer_array.size() + tpw_send_upstream_p_credit >= wdata_buffer_array.capacity() || p2c_fifo.IsTpwQueueFull() || p2c_fifo.tpw_queue->GetQueueSize() + tpw_send_upstream_p_credit >= p2c_fifo.tpw_queue->GetMaxQueueDepth(); }  //
 
     bool is_gpr_expired_and_rd_queue_only_one_space() const {   return p2c_fifo.IsRdQueueRemainOneSpace() && is_gpr_expired();}
 
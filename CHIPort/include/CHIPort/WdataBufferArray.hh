@@ -4,8 +4,8 @@
 
 #include <cstdint>
 #include <systemc>
-#include <set>
-#include <unordered_map>
+#include <optional>
+#include <vector>
 #include <cassert>
 #include <cstring>
 #include "ARM/TLM/arm_chi_payload.h"
@@ -55,26 +55,28 @@ public:
     void release_dbid(uint16_t dbid);
     void receive_wdata_flit(const CHIFlit& dat_flit);
 
-    bool IsArrayFull() const {return buffer_array.size() >= WdataBufferArraySize;}
-    const unsigned size() const {return buffer_array.size();}
+    bool IsArrayFull() const {return num_of_entries >= WdataBufferArraySize;}
+    const unsigned size() const {return num_of_entries;}
+    unsigned capacity() const {return WdataBufferArraySize;}
 
     bool IsEntryReady(const uint16_t& dbid) const
     {
-        return buffer_array.at(dbid).IsEntryReady();
+        return buffer_array.at(dbid).value().IsEntryReady();
     }
     bool HasEntryReady() const {
         for(auto& buffer_entry : buffer_array)
         {
-            if(buffer_entry.second.IsEntryReady())
+            if(buffer_entry.has_value() && buffer_entry->IsEntryReady())
                 return true;
         }
         return false;
     }
 
 private:
-    std::set<uint16_t> unallocated_dbid;
-    std::unordered_map<uint16_t, WdataBufferEntry> buffer_array;
-    std::set<uint16_t> allocated_ptl_dbid;
+    // 按 dbid 下标的定长数组, dbid 分配/释放与 entry 进出都不走堆
+    std::vector<bool> dbid_unallocated;
+    std::vector<std::optional<WdataBufferEntry>> buffer_array;
+    unsigned num_of_entries{0};
 
     const uint8_t WdataBufferArraySize;
     const unsigned data_width_bytes;
@@ -0,0 +1,387 @@
+#include "CHIPort/CHILoadGenerator.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+
+#include "Common/CommonDefine.hh"
+
+namespace dmu{
+    namespace Port{
+
+static uint64_t
+now_in_ps()
+{
+    return sc_core::sc_time_stamp().value() / sc_core::sc_time(1, sc_core::SC_PS).value();
+}
+
+CHILoadGenerator::CHILoadGenerator(const sc_core::sc_module_name& name, const unsigned data_width_bits)
+    : sc_module(name)
+    , initiator("initiator", *this, &CHILoadGenerator::nb_transport_bw, ARM::TLM::PROTOCOL_CHI_E, data_width_bits)
+    , clock("clock")
+    , dataWidthBytes(data_width_bits / 8)
+    , outstanding(kNumOfTxnIds)
+{
+    SC_METHOD(clock_posedge);
+    sensitive << clock.pos();
+    dont_initialize();
+
+    SC_METHOD(clock_negedge);
+    sensitive << clock.neg();
+    dont_initialize();
+
+    for(unsigned txn_id = kNumOfTxnIds; txn_id > 0; txn_id--)
+        freeTxnIds.push_back(txn_id - 1);
+
+    // 需要向 port 发放 RSP (DBIDResp / Comp / RetryAck / PcrdGrant) 和 DAT (CompData) 的 link credit
+    for(const auto channel: {ARM::CHI::CHANNEL_RSP, ARM::CHI::CHANNEL_DAT})
+        channels[channel].rx_credits_available = CHI_MAX_LINK_CREDITS;
+}
+
+CHILoadGenerator::~CHILoadGenerator()
+{
+    for(auto& entry: outstanding)
+    {
+        if(entry.payload != nullptr)
+            entry.payload->unref();
+    }
+}
+
+unsigned
+CHILoadGenerator::AddRequester(const RequesterConfig& config)
+{
+    Requester requester;
+    requester.config = config;
+    requester.rng.seed(config.seed + requesters.size());
+    requester.mean_interval_ps = (1u << config.size) / config.bandwidth_gbps * 1000.0;
+    // 起始相位随机, 避免多个 Constant requester 同步注入
+    requester.next_arrival_ps = now_in_ps() + std::uniform_real_distribution<double>(0.0, requester.mean_interval_ps)(requester.rng);
+    requester.on_end_ps = requester.next_arrival_ps + std::exponential_distribution<double>(1.0 / (config.on_time_ns * 1000.0))(requester.rng);
+    requesters.push_back(std::move(requester));
+    return requesters.size() - 1;
+}
+
+void
+CHILoadGenerator::ResetStats()
+{
+    for(auto& requester: requesters)
+        requester.stats = RequesterStats();
+    statsStart = sc_core::sc_time_stamp();
+}
+
+double
+CHILoadGenerator::NextArrival(Requester& requester)
+{
+    const RequesterConfig& config = requester.config;
+    if(config.injection == InjectionProcess::Constant)
+        return requester.next_arrival_ps + requester.mean_interval_ps;
+    if(config.injection == InjectionProcess::Poisson)
+        return requester.next_arrival_ps + std::exponential_distribution<double>(1.0 / requester.mean_interval_ps)(requester.rng);
+
+    // OnOff: 超出当前 ON 的到达时间跳过 OFF, 指数分布无记忆, 在下一个 ON 的开始重新抽取
+    const double peak_interval_ps = requester.mean_interval_ps * config.on_time_ns / (config.on_time_ns + config.off_time_ns);
+    std::exponential_distribution<double> arrival(1.0 / peak_interval_ps);
+    double next = requester.next_arrival_ps + arrival(requester.rng);
+    while(next > requester.on_end_ps)
+    {
+        double on_start = requester.on_end_ps + std::exponential_distribution<double>(1.0 / (config.off_time_ns * 1000.0))(requester.rng);
+        requester.on_end_ps = on_start + std::exponential_distribution<double>(1.0 / (config.on_time_ns * 1000.0))(requester.rng);
+        next = on_start + arrival(requester.rng);
+    }
+    return next;
+}
+
+uint64_t
+CHILoadGenerator::NextAddress(Requester& requester)
+{
+    const RequesterConfig& config = requester.config;
+    const uint64_t size = uint64_t(1) << config.size;
+    uint64_t offset = 0;
+    if(config.locality == LocalityModel::Stride)
+    {
+        offset = (requester.sequence * config.stride_bytes) % config.footprint_bytes;
+    }
+    else
+    {
+        uint64_t range = config.footprint_bytes;
+        if(config.locality == LocalityModel::HotSet && std::uniform_real_distribution<double>(0.0, 1.0)(requester.rng) < config.hot_probability)
+            range = std::min(config.hot_set_bytes, config.footprint_bytes);
+        offset = std::uniform_int_distribution<uint64_t>(0, std::max<uint64_t>(range / size, 1) - 1)(requester.rng) * size;
+    }
+    requester.sequence++;
+    return (config.base_address + offset) & ~(size - 1);
+}
+
+void
+CHILoadGenerator::Generate(const uint64_t now_ps)
+{
+    for(unsigned index = 0; index < requesters.size(); index++)
+    {
+        Requester& requester = requesters[index];
+        const RequesterConfig& config = requester.config;
+        while(requester.next_arrival_ps <= now_ps
+            && (config.max_requests == 0 || requester.sequence < config.max_requests))
+        {
+            Request request;
+            request.generate_time_ps = static_cast<uint64_t>(requester.next_arrival_ps);
+            request.is_read = std::uniform_real_distribution<double>(0.0, 1.0)(requester.rng) < config.read_ratio;
+            request.address = NextAddress(requester);
+            request.requester = index;
+            requester.backlog.push_back(request);
+            requester.stats.generated++;
+            requester.stats.max_backlog = std::max<uint64_t>(requester.stats.max_backlog, requester.backlog.size());
+            requester.next_arrival_ps = NextArrival(requester);
+        }
+    }
+}
+
+void
+CHILoadGenerator::Issue()
+{
+    // REQ 通道中最多保留两个 flit, 其余请求留在 requester 内, 由轮询决定发送顺序
+    if(channels[ARM::CHI::CHANNEL_REQ].tx_queue.size() >= 2 || freeTxnIds.empty())
+        return;
+    for(unsigned i = 0; i < requesters.size(); i++)
+    {
+        unsigned index = (nextRequester + i) % requesters.size();
+        Requester& requester = requesters[index];
+        if(requester.backlog.empty())
+            continue;
+
+        const Request& request = requester.backlog.front();
+        const RequesterConfig& config = requester.config;
+        uint16_t txn_id = freeTxnIds.back();
+        freeTxnIds.pop_back();
+
+        Outstanding& entry = outstanding[txn_id];
+        entry.request = request;
+        entry.payload = ARM::CHI::Payload::new_payload();
+        entry.payload->address = request.address;
+        entry.payload->size = config.size;
+        entry.payload->mem_attr = ARM::CHI::MEM_ATTR_NORMAL_WB_A;
+        // port 对每个读请求只返回一个 CompData flit (携带整个 payload)
+        entry.responses_left = request.is_read ? 1 : 2;
+
+        entry.phase = ARM::CHI::Phase();
+        entry.phase.channel = ARM::CHI::CHANNEL_REQ;
+        entry.phase.tgt_id = 2;
+        entry.phase.src_id = config.src_id;
+        entry.phase.txn_id = txn_id;
+        // CompData 按 return_nid / return_txn_id 返回
+        entry.phase.return_nid = config.src_id;
+        entry.phase.return_txn_id = txn_id;
+        entry.phase.req_opcode = request.is_read ? ARM::CHI::REQ_OPCODE_READ_NO_SNP : ARM::CHI::REQ_OPCODE_WRITE_NO_SNP_FULL;
+        entry.phase.order = ARM::CHI::ORDER_REQUEST_ACCEPTED;
+        entry.phase.qos = config.qos;
+        if(!request.is_read && config.size != ARM::CHI::SIZE_64)
+            entry.phase.req_opcode = ARM::CHI::REQ_OPCODE_WRITE_NO_SNP_PTL;
+
+        channels[ARM::CHI::CHANNEL_REQ].tx_queue.emplace_back(*entry.payload, entry.phase);
+        requester.backlog.pop_front();
+        requester.stats.issued++;
+        nextRequester = (index + 1) % requesters.size();
+        return;
+    }
+}
+
+void
+CHILoadGenerator::Resend(const uint16_t txn_id, const uint8_t pcrd_type)
+{
+    Outstanding& entry = outstanding[txn_id];
+    ARM::CHI::Phase phase = entry.phase;
+    phase.allow_retry = false;
+    phase.pcrd_type = pcrd_type;
+    channels[ARM::CHI::CHANNEL_REQ].tx_queue.emplace_back(*entry.payload, phase);
+}
+
+void
+CHILoadGenerator::Complete(const uint16_t txn_id)
+{
+    Outstanding& entry = outstanding[txn_id];
+    Requester& requester = requesters[entry.request.requester];
+    const uint64_t latency = now_in_ps() - entry.request.generate_time_ps;
+    if(entry.request.is_read)
+    {
+        requester.stats.completed_reads++;
+        requester.stats.read_latency_sum_ps += latency;
+        requester.stats.max_read_latency_ps = std::max(requester.stats.max_read_latency_ps, latency);
+    }
+    else
+    {
+        requester.stats.completed_writes++;
+        requester.stats.write_latency_sum_ps += latency;
+        requester.stats.max_write_latency_ps = std::max(requester.stats.max_write_latency_ps, latency);
+    }
+    requester.stats.completed_bytes += uint64_t(1) << requester.config.size;
+
+    entry.payload->unref();
+    entry.payload = nullptr;
+    freeTxnIds.push_back(txn_id);
+}
+
+void
+CHILoadGenerator::HandleResponse(const CHIFlit& rsp_flit)
+{
+    const uint16_t txn_id = rsp_flit.phase.txn_id;
+    switch(rsp_flit.phase.rsp_opcode)
+    {
+    case ARM::CHI::RSP_OPCODE_DBID_RESP:
+    case ARM::CHI::RSP_OPCODE_DBID_RESP_ORD:
+    case ARM::CHI::RSP_OPCODE_COMP_DBID_RESP:
+    {
+        // 写数据按 txn id 填充, BE 为请求覆盖的字节
+        ARM::CHI::Payload& payload = rsp_flit.payload;
+        payload.byte_enable = transaction_valid_bytes_mask(payload);
+        std::memset(payload.data, txn_id, CHI_CACHE_LINE_SIZE_BYTES);
+
+        ARM::CHI::Phase dat_phase;
+        dat_phase.channel = ARM::CHI::CHANNEL_DAT;
+        dat_phase.qos = rsp_flit.phase.qos;
+        dat_phase.tgt_id = rsp_flit.phase.src_id;
+        dat_phase.src_id = rsp_flit.phase.tgt_id;
+        dat_phase.txn_id = rsp_flit.phase.dbid;
+        dat_phase.dat_opcode = ARM::CHI::DAT_OPCODE_NON_COPY_BACK_WR_DATA;
+        dat_phase.resp = ARM::CHI::RESP_I;
+        for(const auto data_id: transaction_data_ids(payload, dataWidthBytes))
+        {
+            dat_phase.data_id = data_id;
+            channels[ARM::CHI::CHANNEL_DAT].tx_queue.emplace_back(payload, dat_phase);
+        }
+        if(rsp_flit.phase.rsp_opcode == ARM::CHI::RSP_OPCODE_COMP_DBID_RESP)
+            outstanding[txn_id].responses_left--;
+        if(--outstanding[txn_id].responses_left == 0)
+            Complete(txn_id);
+        break;
+    }
+    case ARM::CHI::RSP_OPCODE_COMP:
+        if(--outstanding[txn_id].responses_left == 0)
+            Complete(txn_id);
+        break;
+    case ARM::CHI::RSP_OPCODE_RETRY_ACK:
+    {
+        const uint8_t pcrd_type = rsp_flit.phase.pcrd_type;
+        Requester& requester = requesters[outstanding[txn_id].request.requester];
+        requester.stats.retried++;
+        if(requester.pending_grants[pcrd_type] > 0)
+        {
+            requester.pending_grants[pcrd_type]--;
+            Resend(txn_id, pcrd_type);
+        }
+        else
+        {
+            requester.retry_queues[pcrd_type].push_back(txn_id);
+        }
+        break;
+    }
+    case ARM::CHI::RSP_OPCODE_PCRD_GRANT:
+    {
+        // p-credit 按 (src_id, pcrd_type) 发放, PcrdGrant 的 tgt_id 是 requester 的 src_id
+        const uint8_t pcrd_type = rsp_flit.phase.pcrd_type;
+        auto found = std::find_if(requesters.begin(), requesters.end(), [&rsp_flit](const Requester& requester) {
+            return requester.config.src_id == rsp_flit.phase.tgt_id;
+        });
+        if(found == requesters.end())
+        {
+            SC_REPORT_ERROR(name(), "PcrdGrant for unknown src id received");
+            break;
+        }
+        if(found->retry_queues[pcrd_type].empty())
+        {
+            found->pending_grants[pcrd_type]++;
+        }
+        else
+        {
+            Resend(found->retry_queues[pcrd_type].front(), pcrd_type);
+            found->retry_queues[pcrd_type].pop_front();
+        }
+        break;
+    }
+    case ARM::CHI::RSP_OPCODE_READ_RECEIPT:
+        break;
+    default:
+        SC_REPORT_ERROR(name(), "unexpected response opcode received");
+    }
+}
+
+void
+CHILoadGenerator::HandleReadData(const CHIFlit& dat_flit)
+{
+    switch(dat_flit.phase.dat_opcode)
+    {
+    case ARM::CHI::DAT_OPCODE_COMP_DATA:
+    case ARM::CHI::DAT_OPCODE_DATA_SEP_RESP:
+    {
+        Outstanding& entry = outstanding[dat_flit.phase.txn_id];
+        if(--entry.responses_left == 0)
+            Complete(dat_flit.phase.txn_id);
+        break;
+    }
+    default:
+        SC_REPORT_ERROR(name(), "unexpected read data opcode received");
+    }
+}
+
+void
+CHILoadGenerator::clock_posedge()
+{
+    RingQueue<CHIFlit>& rsp_queue = channels[ARM::CHI::CHANNEL_RSP].rx_queue;
+    while(!rsp_queue.empty())
+    {
+        HandleResponse(rsp_queue.front());
+        rsp_queue.pop_front();
+    }
+    RingQueue<CHIFlit>& dat_queue = channels[ARM::CHI::CHANNEL_DAT].rx_queue;
+    while(!dat_queue.empty())
+    {
+        HandleReadData(dat_queue.front());
+        dat_queue.pop_front();
+    }
+
+    Generate(now_in_ps());
+    Issue();
+}
+
+void
+CHILoadGenerator::clock_negedge()
+{
+    for(const auto channel: {ARM::CHI::CHANNEL_REQ, ARM::CHI::CHANNEL_RSP, ARM::CHI::CHANNEL_DAT})
+    {
+        channels[channel].send_flits(channel, [this](ARM::CHI::Payload& payload, ARM::CHI::Phase& phase) {
+            return initiator.nb_transport_fw(payload, phase);
+        });
+    }
+}
+
+tlm::tlm_sync_enum
+CHILoadGenerator::nb_transport_bw(ARM::CHI::Payload& payload, ARM::CHI::Phase& phase)
+{
+    if(!channels[phase.channel].receive_flit(payload, phase))
+        SC_REPORT_ERROR(name(), "flit on inactive channel received");
+    return tlm::TLM_ACCEPTED;
+}
+
+void
+CHILoadGenerator::PrintReport(std::ostream& os) const
+{
+    const double window_ns = (sc_core::sc_time_stamp() - statsStart).to_seconds() * 1e9;
+    os << std::left << std::setw(10) << "requester" << std::setw(14) << "offered GB/s" << std::setw(15) << "achieved GB/s"
+       << std::setw(14) << "rd avg ns" << std::setw(14) << "rd max ns" << std::setw(14) << "wr avg ns" << std::setw(14) << "wr max ns"
+       << std::setw(10) << "retried" << "max backlog" << std::endl;
+    for(unsigned index = 0; index < requesters.size(); index++)
+    {
+        const RequesterStats& stats = requesters[index].stats;
+        const double size = 1u << requesters[index].config.size;
+        os << std::left << std::fixed << std::setprecision(2) << std::setw(10) << index
+           << std::setw(14) << (window_ns > 0 ? stats.generated * size / window_ns : 0.0)
+           << std::setw(15) << (window_ns > 0 ? stats.completed_bytes / window_ns : 0.0)
+           << std::setw(14) << (stats.completed_reads ? stats.read_latency_sum_ps / 1000.0 / stats.completed_reads : 0.0)
+           << std::setw(14) << stats.max_read_latency_ps / 1000.0
+           << std::setw(14) << (stats.completed_writes ? stats.write_latency_sum_ps / 1000.0 / stats.completed_writes : 0.0)
+           << std::setw(14) << stats.max_write_latency_ps / 1000.0
+           << std::setw(10) << stats.retried << stats.max_backlog << std::endl;
+    }
+}
+
+    } // namespace Port
+} // namespace dmu
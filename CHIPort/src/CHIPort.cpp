@@ -58,9 +58,41 @@ make_tag_match_phase(const ARM::CHI::Phase& fw_phase)
     return rsp_phase;
 }
 
+// CHI payload 的 data / byte_enable 按 cache line 内的 offset 存放, tlm payload 的 data 从按 size 对齐的地址开始
+static unsigned
+chi_data_offset(const ARM::CHI::Payload& payload)
+{
+    return payload.address & ~uint64_t((1u << payload.size) - 1) & ~CHI_CACHE_LINE_ADDRESS_MASK;
+}
+
+static void
+copy_write_data(tlm::tlm_generic_payload& trans, const ARM::CHI::Payload& payload)
+{
+    const unsigned length = 1u << payload.size;
+    const unsigned offset = chi_data_offset(payload);
+    std::memcpy(trans.get_data_ptr(), payload.data + offset, length);
+    unsigned char* byte_enable = trans.get_byte_enable_ptr();
+    for(unsigned i = 0; i < length; i++)
+        byte_enable[i] = (payload.byte_enable >> (offset + i)) & 1 ? TLM_BYTE_ENABLED : TLM_BYTE_DISABLED;
+    trans.set_byte_enable_length(length);
+}
+
+static void
+copy_read_data(ARM::CHI::Payload& payload, const tlm::tlm_generic_payload& trans)
+{
+    std::memcpy(payload.data + chi_data_offset(payload), trans.get_data_ptr(), 1u << payload.size);
+}
+
 void
 CHIPort::dfi_clock_posedge()
 {
+    // 被 dfi_activity_event 唤醒时等到 dfi 上升沿再处理
+    if(!dfi_clock.posedge())
+    {
+        next_trigger(dfi_clock.posedge_event());
+        return;
+    }
+
     wdat_push_s2();
     wdat_decode_s1();
 
@@ -69,13 +101,64 @@ CHIPort::dfi_clock_posedge()
     //
     resp_gen_pcrd();
     req_decode_s1();
+
+    if(IsDfiIdle())
+        next_trigger(dfi_activity_event);
+    NotifyActivity();
 }
 
 void
 CHIPort::noc_clock_posedge()
 {
+    if(!noc_clock.posedge())
+    {
+        next_trigger(noc_clock.posedge_event());
+        return;
+    }
+
     rdat_arbit_s1();
     resp_arbit_s1();
+
+    if(IsNocPosedgeIdle())
+        next_trigger(noc_posedge_activity_event);
+    NotifyActivity();
+}
+
+bool
+CHIPort::IsDfiIdle()
+{
+    // p2c 的仲裁状态在有请求和 credit 之前不变; pcrd grant 只取决于队列资源和 retry 矩阵, 与时间无关
+    return wdat_s1.empty() && channels[ARM::CHI::CHANNEL_DAT].rx_queue.empty()
+        && req_s1.empty() && req_s2.empty()
+        && (channels[ARM::CHI::CHANNEL_REQ].rx_queue.empty() || responseQueues->IsResponseQueueFull(ResponseQueueType::RetryAck))
+        && p2cFifo->IsStalled() && !rejectedUifRequest
+        && !retryResourceManager->is_need_to_send_pcrd_grant();
+}
+
+bool
+CHIPort::IsNocPosedgeIdle() const
+{
+    return !rdDataInfo->has_entry_ready() && !responseQueues->HasRspPending();
+}
+
+bool
+CHIPort::IsNocNegedgeIdle() const
+{
+    return channels[ARM::CHI::CHANNEL_REQ].is_send_idle()
+        && channels[ARM::CHI::CHANNEL_RSP].is_send_idle()
+        && channels[ARM::CHI::CHANNEL_DAT].is_send_idle();
+}
+
+void
+CHIPort::NotifyActivity()
+{
+    // 立即通知: 在时钟沿所在的 delta cycle 中改变的状态, 等待中的处理函数在这个时钟沿就能处理
+    if(!IsDfiIdle())
+        dfi_activity_event.notify();
+    if(!IsNocPosedgeIdle())
+        noc_posedge_activity_event.notify();
+    if(!IsNocNegedgeIdle())
+        noc_negedge_activity_event.notify();
 }
 
 
@@ -91,6 +174,12 @@ CHIPort::noc_clock_posedge()
 void
 CHIPort::noc_clock_negedge()
 {
+    if(!noc_clock.negedge())
+    {
+        next_trigger(noc_clock.negedge_event());
+        return;
+    }
+
     for( const auto channel: {ARM::CHI::CHANNEL_REQ,ARM::CHI::CHANNEL_RSP,ARM::CHI::CHANNEL_DAT,})
     {
         channels[channel].send_flits(channel, [this](ARM::CHI::Payload& payload, ARM::CHI::Phase& phase)
@@ -98,6 +187,9 @@ CHIPort::noc_clock_negedge()
             return target.nb_transport_bw(payload,phase);
         });
     }
+
+    if(IsNocNegedgeIdle())
+        next_trigger(noc_negedge_activity_event);
 }
 
 
@@ -111,6 +203,7 @@ CHIPort::nb_transport_fw(ARM::CHI::Payload& payload, ARM::CHI::Phase& phase)
 {
     if(!channels[phase.channel].receive_flit(payload, phase))
         SC_REPORT_ERROR(name(),"flit on activate channel received");
+    NotifyActivity();
 
     return tlm::TLM_ACCEPTED;
 }
@@ -148,14 +241,17 @@ CHIPort::peqCallback(tlm::tlm_generic_payload& payload, const tlm::tlm_phase& ph
     {
         // // 从rdat—info中获取对应的CHI Flit，然后将其放入到对应的rdat buffer中
         // unsigned cmd_id = payload.get_extension<UifExtension>()->_uif_info.cmd_id;
-        DPRINT_INFO(true, "CHI Port", "Get the Rdat transaction First Data");
+        DPRINT_INFO(PORT, "CHI Port", "Get the Rdat transaction First Data");
     }
     else if(phase == UIF_RDAT_END)
     {
         // 将rdat buffer中的数据标定为读完成，同时将payload中的数据copy到对应的CHI Flit
         unsigned cmd_id = payload.get_extension<UifExtension>()->_uif_info.cmd_id;
         rdDataInfo->set_entry_data_ready(cmd_id);
-        DPRINT_INFO(true, "CHI Port", "Get the Rdat transaction Last Data");
+        if(dataCheckEnabled)
+            copy_read_data(rdDataInfo->get_entry_payload(cmd_id), payload);
+        ReleaseUifRequest(cmd_id, true);
+        DPRINT_INFO(PORT, "CHI Port", "Get the Rdat transaction Last Data");
         // 输出读事务的完成时间，并将指针插入到对应的队列map中，等待rdata_info 被移除时，记录对应的读数据在CHI接口处的输出时间
     }
     else if(phase == UIF_WDAT_REQ)
@@ -184,6 +280,7 @@ CHIPort::peqCallback(tlm::tlm_generic_payload& payload, const tlm::tlm_phase& ph
         tlm::tlm_phase wdat_end_phase = UIF_WDAT_END;
         sc_core::sc_time delay = sc_core::SC_ZERO_TIME;
         iSocket->nb_transport_fw(payload, wdat_end_phase, delay);
+        ReleaseUifRequest(wr_cmd_id, false);
     }
     else if(phase == WR_RESPONSE_COMPLETE)
     {
@@ -194,6 +291,7 @@ CHIPort::peqCallback(tlm::tlm_generic_payload& payload, const tlm::tlm_phase& ph
     {
         SC_REPORT_FATAL(name(), "Invalid phase");
     }
+    NotifyActivity();
 }
 
 
@@ -206,9 +304,11 @@ CHIPort::CHIPort(const sc_core::sc_module_name& name,const Configure& configure,
     dfi_clock("dfi_clcok"),
     noc_clock("noc_clock"),
     clock_period(clock_period),
-    payloadEventQueue(this, &CHIPort::peqCallback),
+    payloadEventQueue(this, &CHIPort::peqCallback, clock_period),
     memoryManager(false)
 {
+    rdUifRequest.resize(_configure.controller_config->RD_DAT_INFO_DEPTH, nullptr);
+    wrUifRequest.resize(_configure.controller_config->WR_DAT_BUFFER_DEPTH, nullptr);
 
     wdataBufferArray = std::make_unique<WdataBufferArray>(_configure,data_width_bytes);
     rdDataInfo = std::make_unique<RdDataInfo>(_configure);
@@ -236,6 +336,15 @@ CHIPort::CHIPort(const sc_core::sc_module_name& name,const Configure& configure,
     }
 }
 
+void
+CHIPort::EnableDataCheck(bool scoreboard_enable)
+{
+    memoryManager.SetStorageEnabled(true);
+    dataCheckEnabled = true;
+    if(scoreboard_enable)
+        dataScoreboard = std::make_unique<DataScoreboard>(_configure.controller_config->RD_DAT_INFO_DEPTH);
+}
+
 
 
 
@@ -259,9 +368,10 @@ void
 CHIPort::req_decision_s2(){
     if(!req_s1.empty())
     {
-        CHIFlit& req_flit = req_s1.front();
-        req_s2.push_back(std::move(req_flit));
+        req_s2.push_back(std::move(req_s1.front()));
         req_s1.pop_front();
+        // req_s1 pop 之后它的元素可能已经释放, 使用 req_s2 中的 flit
+        CHIFlit& req_flit = req_s2.back();
         // DPRINT_INFO(true, "CHIPort", "Request Channel stage 2, s2 queue size: %ld",req_s2.size());
 
         if(req_flit.phase.req_opcode == ARM::CHI::REQ_OPCODE_WRITE_NO_SNP_FULL ||
@@ -271,7 +381,7 @@ CHIPort::req_decision_s2(){
             bool req_accepted = handle_WriteNoSnp(req_flit,qos.GetQosLevel());
             if(!req_accepted)
             {
-                responseQueues->InsertRetryAckResp(req_flit);
+                responseQueues->InsertRetryAckResp(req_flit, static_cast<uint8_t>(qos.GetQosLevel()));
                 if(qos.GetQosLevel() == PriorityClass::TPW){
                     retryResourceManager->inc_write_tpw(req_flit.phase.src_id);
                 }
@@ -286,6 +396,7 @@ CHIPort::req_decision_s2(){
                 //分配tlm::tlm_generic_payload
                 // 插入到TPW队列
                 tlm::tlm_generic_payload& trans = memoryManager.allocate(req_flit,false);
+                trans.acquire();
                 p2cFifo->InsertTpwRequest(req_flit, static_cast<tlm::tlm_generic_payload*>(&trans), allocated_dbid,qos.GetQosLevel());
             }
         }
@@ -296,7 +407,7 @@ CHIPort::req_decision_s2(){
             bool req_accepted = handle_ReadNoSnp(req_flit,qos.GetQosLevel());
             if(!req_accepted)
             {
-                responseQueues->InsertRetryAckResp(req_flit);
+                responseQueues->InsertRetryAckResp(req_flit, static_cast<uint8_t>(qos.GetQosLevel()));
                 if(qos.GetQosLevel() == PriorityClass::GPR){
                     retryResourceManager->inc_read_gpr(req_flit.phase.src_id);
                 }
@@ -315,6 +426,7 @@ CHIPort::req_decision_s2(){
                 {
                     //分配tlm::tlm_generic_payload
                     tlm::tlm_generic_payload& trans = memoryManager.allocate(req_flit,true);
+                    trans.acquire();
                     // 插入到HPR队列
                     p2cFifo->InsertHprRequest(req_flit, static_cast<tlm::tlm_generic_payload*>(&trans),qos.GetQosLevel());
                 }
@@ -322,6 +434,7 @@ CHIPort::req_decision_s2(){
                 {
                     //分配tlm::tlm_generic_payload
                     tlm::tlm_generic_payload& trans = memoryManager.allocate(req_flit,true);
+                    trans.acquire();
                     // 插入到LPR队列
                     p2cFifo->InsertLGprRequest(req_flit, static_cast<tlm::tlm_generic_payload*>(&trans),qos.GetQosLevel());
                 }
@@ -346,6 +459,13 @@ CHIPort::req_pop_s3()
 {
     if(!req_s2.empty())
         req_s2.pop_front();
+    // 一个 dfi cycle 只发一个 UIF_REQ, 重发的 cycle 不再仲裁
+    if(rejectedUifRequest)
+    {
+        if(IssueUifRequest(rejectedUifRequest->cmd_id, rejectedUifRequest->is_rd))
+            rejectedUifRequest.reset();
+        return;
+    }
     if(!p2cFifo->IsQueueEmpty())
     {
         // DPRINT_INFO(true, "CHIPort", "Request Channel stage 3, s3 queue empty: %d",p2cFifo->IsQueueEmpty());
@@ -391,6 +511,8 @@ CHIPort::handle_WriteNoSnp(const CHIFlit& flit, PriorityClass qos_level){
     // return false;
     if(!flit.phase.allow_retry)
     {
+        // 使用 PcrdGrant 重发的请求, 归还为它预留的 p-credit
+        retryResourceManager->send_upstream_p_credit_dec(static_cast<PortCmdType>(qos_level));
         return true;
     }
     else{
@@ -418,6 +540,7 @@ bool
 CHIPort::handle_ReadNoSnp(const CHIFlit& flit, PriorityClass qos_level){
     if(!flit.phase.allow_retry)
     {
+        retryResourceManager->send_upstream_p_credit_dec(static_cast<PortCmdType>(qos_level));
         return true;
     }
     else{
@@ -518,8 +641,9 @@ CHIPort::resp_gen_pcrd()
         ARM::CHI::Phase pcrd_phase;
         pcrd_phase.channel = ARM::CHI::Channel::CHANNEL_RSP;
         pcrd_phase.lcrd = false;
-        //TODO:
         pcrd_phase.rsp_opcode = ARM::CHI::RSP_OPCODE_PCRD_GRANT;
+        pcrd_phase.tgt_id = pcrd_tgt_id;
+        pcrd_phase.pcrd_type = static_cast<uint8_t>(pcrd_cmd_type);
         responseQueues->InsertPcrdGrantResp(CHIFlit(*pcrd_payload,pcrd_phase));
         // retryResourceManager->cnt_dec(pcrd_cmd_type, pcrd_tgt_id);
         retryResourceManager->send_upstream_p_credit_inc(pcrd_cmd_type);
@@ -558,6 +682,8 @@ CHIPort::rdat_arbit_s1()
     if(rdDataInfo->has_entry_ready())
     {
         auto element = rdDataInfo->get_ready_entry();
+        if(dataScoreboard)
+            dataScoreboard->CheckCompData(element.first, element.second.payload);
         ARM::CHI::Phase data_phase = make_read_data_phase(element.second.phase,ARM::CHI::DAT_OPCODE_COMP_DATA);
         channels[ARM::CHI::CHANNEL_DAT].tx_queue.emplace_back(std::move(CHIFlit(element.second.payload,data_phase)));
         rdDataInfo->erase_entry(element.first);
@@ -575,15 +701,50 @@ CHIPort::SendUifRequest(const QueueEntry& entry, unsigned cmd_id, bool is_rd)
     uif_info.is_rmw = !is_rd && (entry.payload.byte_enable != ~uint64_t(0));
     uif_info.cmd_type = is_rd ? CmdType::RD : (uif_info.is_rmw ? CmdType::RMW : CmdType::WR);
     uif_info.cmd_id = cmd_id;
-    UifExtension* uif_ext = new UifExtension(uif_info);
-    trans->set_extension(uif_ext);
+    uif_info.data_bytes = 1u << entry.payload.size;
+    uif_info.src_id = entry.phase.src_id;
+    memoryManager.SetUifExtension(*trans, uif_info);
+    (is_rd ? rdUifRequest : wrUifRequest)[cmd_id] = trans;
     trans->set_address(entry.payload.address);
     trans->set_command(is_rd ? tlm::TLM_READ_COMMAND : tlm::TLM_WRITE_COMMAND);
     trans->set_data_length(entry.payload.size);
-    trans->get_extension<StatisticExtension>()->RecordOutPortTime(sc_core::sc_time_stamp());
+    // 写请求只有在 wdata 收齐后才会发出, 写数据此时放进 payload, scoreboard 的参考模型按 UIF_REQ 的顺序更新
+    if(dataCheckEnabled && is_rd)
+    {
+        trans->set_byte_enable_length(0);
+        if(dataScoreboard)
+            dataScoreboard->IssueRead(cmd_id, entry.payload);
+    }
+    else if(dataCheckEnabled)
+    {
+        assert(wdataBufferArray->IsEntryReady(cmd_id) && "write request sent before write data received");
+        copy_write_data(*trans, entry.payload);
+        if(dataScoreboard)
+            dataScoreboard->CommitWrite(entry.payload);
+    }
+    // 请求已经从 p2c fifo 弹出并消耗了 credit, 被拒绝时由 req_pop_s3 重发
+    if(!IssueUifRequest(cmd_id, is_rd))
+        rejectedUifRequest = RejectedUifRequest{cmd_id, is_rd};
+}
+
+bool
+CHIPort::IssueUifRequest(unsigned cmd_id, bool is_rd)
+{
+    tlm::tlm_generic_payload* trans = (is_rd ? rdUifRequest : wrUifRequest)[cmd_id];
     tlm::tlm_phase req_phase = UIF_REQ;
     sc_core::sc_time delay = sc_core::SC_ZERO_TIME;
-    iSocket->nb_transport_fw(*trans, req_phase, delay);
+    // 离开 port 的时间按 controller 接收的时刻记录
+    trans->get_extension<StatisticExtension>()->RecordOutPortTime(sc_core::sc_time_stamp());
+    return iSocket->nb_transport_fw(*trans, req_phase, delay) == tlm::TLM_ACCEPTED;
+}
+
+void
+CHIPort::ReleaseUifRequest(unsigned cmd_id, bool is_rd)
+{
+    tlm::tlm_generic_payload*& trans = (is_rd ? rdUifRequest : wrUifRequest)[cmd_id];
+    assert(trans != nullptr && "uif request is not outstanding");
+    trans->release();
+    trans = nullptr;
 }
 
     } // namespace Port
@@ -9,6 +9,12 @@ namespace dmu{
 
 void CHITrafficGenerator::clock_posedge()
 {
+    if (!clock.posedge())
+    {
+        next_trigger(clock.posedge_event());
+        return;
+    }
+
     if (!channels[ARM::CHI::CHANNEL_RSP].rx_queue.empty())
     {
         const CHIFlit rsp_flit = channels[ARM::CHI::CHANNEL_RSP].rx_queue.front();
@@ -32,7 +38,7 @@ void CHITrafficGenerator::clock_posedge()
             // XREPORT(" received PCRD Grant, ignoring");
             break;
         case ARM::CHI::RSP_OPCODE_READ_RECEIPT:
-            DPRINT_INFO(true, "Traffic Generator", "Received Read Receipt response");
+            DPRINT_INFO(PORT, "Traffic Generator", "Received Read Receipt response");
             break;
         default:
             SC_REPORT_ERROR(name(), "unexpected response opcode received");
@@ -56,6 +62,40 @@ void CHITrafficGenerator::clock_posedge()
     }
 
     /* The other channels are inactive and cannot receive flits, so no need to process them. */
+
+    if (is_posedge_idle())
+        next_trigger(posedge_activity_event);
+    notify_activity();
+}
+
+bool CHITrafficGenerator::is_posedge_idle() const
+{
+    return channels[ARM::CHI::CHANNEL_RSP].rx_queue.empty() && channels[ARM::CHI::CHANNEL_DAT].rx_queue.empty();
+}
+
+bool CHITrafficGenerator::is_negedge_idle() const
+{
+    if (!channels[ARM::CHI::CHANNEL_REQ].is_send_idle() || !channels[ARM::CHI::CHANNEL_RSP].is_send_idle()
+        || !channels[ARM::CHI::CHANNEL_DAT].is_send_idle())
+        return false;
+    /* A pending trace record waits for the REQ queue to drain, or for its issue time (see clock_negedge). */
+    return trace_record == nullptr || channels[ARM::CHI::CHANNEL_REQ].tx_queue.size() >= TRACE_LOOKAHEAD
+        || (trace_timed && trace_issue_time_ps > sc_core::sc_time_stamp().value() / sc_core::sc_time(1, sc_core::SC_PS).value());
+}
+
+void CHITrafficGenerator::notify_activity()
+{
+    /* Immediate notification lets a waiting process catch the clock edge of the current delta cycle.
+     * Requests added outside the simulation (before or between sc_start) can only use delta notification. */
+    if (sc_core::sc_get_status() != sc_core::SC_RUNNING)
+    {
+        negedge_activity_event.notify(sc_core::SC_ZERO_TIME);
+        return;
+    }
+    if (!is_posedge_idle())
+        posedge_activity_event.notify();
+    if (!is_negedge_idle())
+        negedge_activity_event.notify();
 }
 
 static ARM::CHI::Phase make_write_data_phase(const ARM::CHI::Phase& dbid_phase, const ARM::CHI::DatOpcode dat_opcode)
@@ -92,6 +132,15 @@ void CHITrafficGenerator::handle_dbid_resp(const CHIFlit& dbid_flit)
 
 void CHITrafficGenerator::clock_negedge()
 {
+    if (!clock.negedge())
+    {
+        next_trigger(clock.negedge_event());
+        return;
+    }
+
+    if (trace_record != nullptr)
+        issue_trace_requests();
+
     /* Try to issue credits and send transactions on active channels. */
     for (const auto channel : {ARM::CHI::CHANNEL_REQ, ARM::CHI::CHANNEL_RSP, ARM::CHI::CHANNEL_DAT})
     {
@@ -99,12 +148,26 @@ void CHITrafficGenerator::clock_negedge()
             return initiator.nb_transport_fw(payload, phase);
         });
     }
+
+    if (is_negedge_idle())
+    {
+        if (trace_record != nullptr && channels[ARM::CHI::CHANNEL_REQ].tx_queue.size() < TRACE_LOOKAHEAD)
+        {
+            const uint64_t now_ps = sc_core::sc_time_stamp().value() / sc_core::sc_time(1, sc_core::SC_PS).value();
+            next_trigger(sc_core::sc_time(static_cast<double>(trace_issue_time_ps - now_ps), sc_core::SC_PS), negedge_activity_event);
+        }
+        else
+        {
+            next_trigger(negedge_activity_event);
+        }
+    }
 }
 
 tlm::tlm_sync_enum CHITrafficGenerator::nb_transport_bw(ARM::CHI::Payload& payload, ARM::CHI::Phase& phase)
 {
     if (!channels[phase.channel].receive_flit(payload, phase))
         SC_REPORT_ERROR(name(), "flit on inactive channel received");
+    notify_activity();
 
     return tlm::TLM_ACCEPTED;
 }
@@ -135,16 +198,56 @@ CHITrafficGenerator::CHITrafficGenerator(const sc_core::sc_module_name& name, co
 
 void CHITrafficGenerator::add_payload(
     const ARM::CHI::ReqOpcode req_opcode, const uint64_t address, const ARM::CHI::Size size)
+{
+    queue_request(req_opcode, address, size, 1, 15);
+    notify_activity();
+}
+
+void CHITrafficGenerator::replay_trace(const std::string& path, const bool timed)
+{
+    trace_reader = std::make_unique<ReqTraceReader>(path);
+    trace_timed = timed;
+    trace_record = trace_reader->Next();
+    if (trace_record != nullptr)
+        trace_issue_time_ps = sc_core::sc_time_stamp().value() / sc_core::sc_time(1, sc_core::SC_PS).value()
+                            + trace_record->delta * trace_reader->GetTimeUnitPs();
+    notify_activity();
+}
+
+void CHITrafficGenerator::issue_trace_requests()
+{
+    const uint64_t now_ps = sc_core::sc_time_stamp().value() / sc_core::sc_time(1, sc_core::SC_PS).value();
+    RingQueue<CHIFlit>& req_queue = channels[ARM::CHI::CHANNEL_REQ].tx_queue;
+
+    while (trace_record != nullptr && req_queue.size() < TRACE_LOOKAHEAD)
+    {
+        if (trace_timed && trace_issue_time_ps > now_ps)
+            break;
+
+        if (trace_record->opcode != kReqTraceDelayOnly)
+        {
+            queue_request(static_cast<ARM::CHI::ReqOpcode>(trace_record->opcode), trace_record->address,
+                          static_cast<ARM::CHI::Size>(trace_record->GetSize()), trace_record->src_id, trace_record->GetQos());
+        }
+
+        trace_record = trace_reader->Next();
+        if (trace_record != nullptr)
+            trace_issue_time_ps += trace_record->delta * trace_reader->GetTimeUnitPs();
+    }
+}
+
+void CHITrafficGenerator::queue_request(const ARM::CHI::ReqOpcode req_opcode, const uint64_t address,
+    const ARM::CHI::Size size, const uint16_t src_id, const uint8_t qos)
 {
     ARM::CHI::Payload& req_payload = *ARM::CHI::Payload::new_payload();
     ARM::CHI::Phase req_phase;
 
     req_phase.tgt_id = 2;
-    req_phase.src_id = 1;
+    req_phase.src_id = src_id;
     req_phase.txn_id = txn_id++;
     req_phase.req_opcode = req_opcode;
     req_phase.order = ARM::CHI::ORDER_REQUEST_ACCEPTED;
-    req_phase.qos = 15;
+    req_phase.qos = qos;
 
     req_payload.address = address;
     req_payload.size = size;
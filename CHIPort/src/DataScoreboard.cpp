@@ -0,0 +1,64 @@
+#include "CHIPort/DataScoreboard.hh"
+#include "Common/CommonDefine.hh"
+
+#include <cassert>
+
+namespace dmu{
+    namespace Port{
+
+DataScoreboard::DataScoreboard(unsigned num_of_read_ids)
+: expectedReads(num_of_read_ids)
+{
+}
+
+void
+DataScoreboard::CommitWrite(const ARM::CHI::Payload& payload)
+{
+    const unsigned length = 1u << payload.size;
+    const uint64_t address = payload.address & ~uint64_t(length - 1);
+    const unsigned offset = address & ~CHI_CACHE_LINE_ADDRESS_MASK;
+    std::array<uint8_t, CHI_CACHE_LINE_SIZE_BYTES> byte_enable;
+    for(unsigned i = 0; i < length; i++)
+        byte_enable[i] = (payload.byte_enable >> (offset + i)) & 1 ? 0xff : 0x00;
+    reference.Write(address, payload.data + offset, length, byte_enable.data(), length);
+    numOfWrites++;
+}
+
+void
+DataScoreboard::IssueRead(unsigned rdata_id, const ARM::CHI::Payload& payload)
+{
+    ExpectedRead& expected = expectedReads.at(rdata_id);
+    assert(!expected.valid && "rdata id is still outstanding in scoreboard");
+    expected.valid = true;
+    expected.length = 1u << payload.size;
+    expected.address = payload.address & ~uint64_t(expected.length - 1);
+    reference.Read(expected.address, expected.data.data(), expected.length);
+}
+
+bool
+DataScoreboard::CheckCompData(unsigned rdata_id, const ARM::CHI::Payload& payload)
+{
+    ExpectedRead& expected = expectedReads.at(rdata_id);
+    assert(expected.valid && "CompData without outstanding read in scoreboard");
+    expected.valid = false;
+    numOfChecks++;
+
+    const unsigned offset = expected.address & ~CHI_CACHE_LINE_ADDRESS_MASK;
+    for(unsigned i = 0; i < expected.length; i++)
+    {
+        if(payload.data[offset + i] == expected.data[i])
+            continue;
+        numOfMismatches++;
+        if(numOfMismatches <= kMaxReports)
+        {
+            DPRINT_REPORT("Data Scoreboard", WARNING,
+                "CompData mismatch, address: 0x%llx, rdata id: %u, byte %u: expected 0x%02x, actual 0x%02x",
+                static_cast<unsigned long long>(expected.address), rdata_id, i, expected.data[i], payload.data[offset + i]);
+        }
+        return false;
+    }
+    return true;
+}
+
+    } // namespace Port
+} // namespace dmu
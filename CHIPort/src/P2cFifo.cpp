@@ -96,15 +96,31 @@ PaArbiter::GetWinningQueue() {
     {
         if(tpw_queue.HasRequest() && tpw_queue.HasCredit() && tpw_queue.IsQueueLocked())
             return TPW;
-        else if(tpw_queue.HasRequest() && tpw_queue.HasCredit())
+        // 队头是 RMW 时还需要一个 lpr credit, 没有时等待 credit 返回
+        else if(HasWrRequest())
             return TPW;
         else
-            return TPW;
+            return NONE;
     }
     else
         return NONE;
 }
 
+bool
+PaArbiter::IsStalled() const
+{
+    switch (state) {
+        case IDLE:
+            return !HasRdRequest() && !HasWrRequest();
+        case RD:
+            // tpw 有请求和 credit 时 tpw aging 到期会切换到 WR
+            return !HasRdRequest() && !(tpw_queue.HasRequest() && tpw_queue.HasCredit()) && IsRdHold();
+        default:
+            // WR 状态下保持 WR 与切换到 RD 取决于仲裁的先后, 每个 cycle 都重新仲裁
+            return false;
+    }
+}
+
 bool
 PaArbiter::IsGprCritical() const{
     if( (lpr_queue.HasExpiredCmd() && !lpr_queue.HasCredit()) ||
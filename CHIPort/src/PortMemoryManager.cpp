@@ -1,6 +1,7 @@
 #include "CHIPort/PortMemoryManager.hh"
 #include "Common/StatisticExtension.hh"
 #include "tlm_core/tlm_2/tlm_generic_payload/tlm_gp.h"
+#include <cassert>
 #include <iostream>
 #include <memory>
 #include <new>
@@ -50,8 +51,7 @@ tlm_generic_payload& PortMemoryManager::allocate(unsigned dataLength)
             std::fill(be,be + CHI_CACHE_LINE_SIZE_BYTES, 0x0);
             payload->set_byte_enable_ptr(be);
         }
-        StatisticExtension* statistic_ext = new StatisticExtension();
-        payload->set_extension(statistic_ext);
+        payloadDataLength.emplace(payload, dataLength);
         return *payload;
     }
 
@@ -66,15 +66,37 @@ tlm::tlm_generic_payload& PortMemoryManager::allocate(const CHIFlit& flit, bool
     tlm_generic_payload* payload = reinterpret_cast<tlm::tlm_generic_payload*>(& (this->allocate(dataLength)));
     payload->set_address(flit.payload.address);
     payload->set_command(is_rd ? tlm::TLM_READ_COMMAND: tlm::TLM_WRITE_COMMAND);
-    payload->get_extension<StatisticExtension>()->RecordTransactionId(transactionId);
+    statisticExtensionPool.Attach(*payload)->RecordTransactionId(transactionId);
     transactionId++;
     return *payload;
 }
 
 void PortMemoryManager::free(tlm::tlm_generic_payload* payload)
 {
-    unsigned dataLength = payload->get_data_length();
-    freePayloads[dataLength].push(payload);
+    statisticExtensionPool.Recycle(*payload);
+    uifExtensionPool.Recycle(*payload);
+    freePayloads[payloadDataLength.at(payload)].push(payload);
+}
+
+uint64_t PortMemoryManager::GetNumOfPayloadsInUse() const
+{
+    uint64_t numOfFree = 0;
+    for(const auto& innerBuffer: freePayloads)
+        numOfFree += innerBuffer.second.size();
+    return numberOfAllocations - numOfFree;
+}
+
+void PortMemoryManager::SetStorageEnabled(bool enable)
+{
+    assert(numberOfAllocations == 0 && "storage must be enabled before the first allocation");
+    storageEnabled = enable;
+}
+
+UifExtension* PortMemoryManager::SetUifExtension(tlm::tlm_generic_payload& payload, const UifInfo& uif_info)
+{
+    UifExtension* uif_ext = uifExtensionPool.Attach(payload);
+    uif_ext->_uif_info = uif_info;
+    return uif_ext;
 }
 
 
@@ -0,0 +1,90 @@
+#include "CHIPort/ReqTraceReader.hh"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Common/CommonDefine.hh"
+
+namespace dmu{
+    namespace Port{
+
+ReqTraceReader::ReqTraceReader(const std::string& path)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        DPRINT_ERROR("ReqTraceReader", "Unable to open trace file: %s", path.c_str());
+        return;
+    }
+    struct stat file_stat;
+    if(fstat(fd, &file_stat) != 0 || static_cast<std::size_t>(file_stat.st_size) < sizeof(ReqTraceHeader))
+    {
+        close(fd);
+        DPRINT_ERROR("ReqTraceReader", "Not a request trace file: %s", path.c_str());
+        return;
+    }
+    mapLength = file_stat.st_size;
+    void* map = mmap(nullptr, mapLength, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED)
+    {
+        mapLength = 0;
+        DPRINT_ERROR("ReqTraceReader", "Unable to mmap trace file: %s", path.c_str());
+        return;
+    }
+    base = static_cast<uint8_t*>(map);
+    madvise(base, mapLength, MADV_SEQUENTIAL);
+
+    ReqTraceHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if(std::memcmp(header.magic, kReqTraceMagic, sizeof(kReqTraceMagic)) != 0)
+    {
+        DPRINT_ERROR("ReqTraceReader", "Not a request trace file: %s", path.c_str());
+        return;
+    }
+    if(header.version != kReqTraceVersion || header.record_size != sizeof(ReqTraceRecord))
+    {
+        DPRINT_ERROR("ReqTraceReader", "Unsupported trace version %u (record size %u): %s", header.version, header.record_size, path.c_str());
+        return;
+    }
+    if(header.num_of_records > (mapLength - sizeof(header)) / sizeof(ReqTraceRecord))
+    {
+        DPRINT_ERROR("ReqTraceReader", "Truncated trace file, %llu records expected: %s", static_cast<unsigned long long>(header.num_of_records), path.c_str());
+        return;
+    }
+    records = reinterpret_cast<const ReqTraceRecord*>(base + sizeof(header));
+    numOfRecords = header.num_of_records;
+    timeUnitPs = header.time_unit_ps;
+}
+
+ReqTraceReader::~ReqTraceReader()
+{
+    if(base != nullptr)
+        munmap(base, mapLength);
+}
+
+const ReqTraceRecord*
+ReqTraceReader::Next()
+{
+    if(position >= numOfRecords)
+        return nullptr;
+    const ReqTraceRecord* record = records + position;
+    position++;
+
+    std::size_t consumed = reinterpret_cast<const uint8_t*>(record) - base;
+    if(consumed - releasedBytes >= kReleaseBytes)
+    {
+        // 只释放完整的 page, 当前 record 所在的 page 保留
+        std::size_t page_size = sysconf(_SC_PAGESIZE);
+        std::size_t release_end = consumed & ~(page_size - 1);
+        madvise(base + releasedBytes, release_end - releasedBytes, MADV_DONTNEED);
+        releasedBytes = release_end;
+    }
+    return record;
+}
+
+    } // namespace Port
+} // namespace dmu
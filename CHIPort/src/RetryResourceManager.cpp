@@ -199,19 +199,20 @@ RetryResourceManager::send_upstream_p_credit_dec(PortCmdType cmd_type)
 PortCmdType
 RetryResourceManager::select_type_cmd_type()
 {
-    if(is_gpr_expired() && has_retry_cmd(PriorityClass::GPR))
+    // 只在资源还有空余的类型中仲裁, 与 is_need_to_send_pcrd_grant 一致, 否则 PcrdGrant 可能发给已满的类型
+    if(is_gpr_expired() && !is_lgpr_full() && has_retry_cmd(PriorityClass::GPR))
     {
         return PortCmdType::GPR;
     }
-    if(is_gpw_expired() && has_retry_cmd(PriorityClass::GPW))
+    if(is_gpw_expired() && !is_tpw_full() && has_retry_cmd(PriorityClass::GPW))
     {
         return PortCmdType::GPW;
     }
 
     // 一级仲裁: LPR和GPR进行轮询仲裁
     PortCmdType lgpr_winner = PortCmdType::Invalid;
-    bool lpr_available = has_retry_cmd(PriorityClass::LPR);
-    bool gpr_available = has_retry_cmd(PriorityClass::GPR);
+    bool lpr_available = !is_lgpr_full() && has_retry_cmd(PriorityClass::LPR);
+    bool gpr_available = !is_lgpr_full() && has_retry_cmd(PriorityClass::GPR);
 
     if(lpr_available && gpr_available)
     {
@@ -237,8 +238,8 @@ RetryResourceManager::select_type_cmd_type()
 
     // 一级仲裁: TPW和GPW进行轮询仲裁
     PortCmdType tpw_gpw_winner = PortCmdType::Invalid;
-    bool tpw_available = has_retry_cmd(PriorityClass::TPW);
-    bool gpw_available = has_retry_cmd(PriorityClass::GPW);
+    bool tpw_available = !is_tpw_full() && has_retry_cmd(PriorityClass::TPW);
+    bool gpw_available = !is_tpw_full() && has_retry_cmd(PriorityClass::GPW);
     if(tpw_available && gpw_available)
     {
         if(tpw_gpw_arbit_result == 1){
@@ -272,13 +273,13 @@ RetryResourceManager::select_type_cmd_type()
     else{
         candidates.push_back(PortCmdType::Invalid);
     }
-    if(has_retry_cmd(PriorityClass::HPR)){
+    if(!is_hpr_full() && has_retry_cmd(PriorityClass::HPR)){
         candidates.push_back(PortCmdType::HPR);
     }
     else{
         candidates.push_back(PortCmdType::Invalid);
     }
-    if(!is_type_empty(RetryType::CMO)){
+    if(!is_cmo_full() && !is_type_empty(RetryType::CMO)){
         candidates.push_back(PortCmdType::CMO);
     }
     else{
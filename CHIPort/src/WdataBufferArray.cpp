@@ -1,6 +1,8 @@
 #include "CHIPort/WdataBufferArray.hh"
 #include "Common/CommonDefine.hh"
 #include <cassert>
+#include <cstdlib>
+#include <iostream>
 
 namespace dmu{
     namespace Port{
@@ -10,42 +12,54 @@ WdataBufferArray::WdataBufferArray(const Configure& configure, const unsigned da
 : WdataBufferArraySize(configure.controller_config->WR_DAT_BUFFER_DEPTH)
 , data_width_bytes(data_width_bytes)
 {
-    for(uint8_t i = 0; i < WdataBufferArraySize; i++)
-    {
-        unallocated_dbid.insert(i);
-    }
+    dbid_unallocated.assign(WdataBufferArraySize, true);
+    buffer_array.resize(WdataBufferArraySize);
 }
 
 const uint16_t
 WdataBufferArray::allocate_dbid()
 {
-    uint16_t dbid = *unallocated_dbid.begin();
-    unallocated_dbid.erase(unallocated_dbid.begin());
-    return dbid;
+    // 最小的空闲 dbid
+    for(uint16_t dbid = 0; dbid < WdataBufferArraySize; dbid++)
+    {
+        if(dbid_unallocated[dbid])
+        {
+            dbid_unallocated[dbid] = false;
+            return dbid;
+        }
+    }
+    std::cerr << "WdataBufferArray: no free dbid" << std::endl;
+    std::abort();
 }
 
 void
 WdataBufferArray::allocate_wdata_buffer_entry(const CHIFlit& req_flit,const unsigned& dbid)
 {
-    buffer_array.emplace(dbid,WdataBufferEntry(req_flit, this->data_width_bytes));
+    assert(!buffer_array.at(dbid).has_value());
+    buffer_array[dbid].emplace(req_flit, this->data_width_bytes);
+    num_of_entries++;
 }
 
 void
 WdataBufferArray::erase_wdata_buffer_entry(const uint16_t& dbid)
 {
-    buffer_array.erase(dbid);
+    if(buffer_array.at(dbid).has_value())
+    {
+        buffer_array[dbid].reset();
+        num_of_entries--;
+    }
 }
 
 void
 WdataBufferArray::release_dbid(uint16_t dbid)
 {
-    unallocated_dbid.insert(dbid);
+    dbid_unallocated.at(dbid) = true;
 }
 
 void
 WdataBufferArray::receive_wdata_flit(const CHIFlit& dat_flit)
 {
-    uint16_t& beat_count_remaning = buffer_array.at(dat_flit.phase.txn_id).beat_count;
+    uint16_t& beat_count_remaning = buffer_array.at(dat_flit.phase.txn_id).value().beat_count;
     // DPRINT_ASSERT(beat_count_remaning > 0, "WdataBufferArray", "dbid:%d ,beat_count_remaning should be greater than 0",dat_flit.phase.txn_id);
     beat_count_remaning--;
     // if(beat_count_remaning == 0)
@@ -0,0 +1,174 @@
+// 把文本 request trace 转换为 ReqTraceFormat 的二进制 trace, 供 CHITrafficGenerator::replay_trace 使用
+// usage: dmu_trace_convert <trace.txt> <trace.bin> [time_unit]
+//   time_unit: ps / ns / us 或者以 ps 为单位的数值 (例如时钟周期), 默认 ns
+// 文本格式, 每行一个请求, # 开头为注释:
+//   <time> <opcode> <address> [size_bytes] [src_id] [qos]
+//   time     : 绝对时间 (time_unit 为单位), 不能递减
+//   opcode   : R / RD / READ (ReadNoSnp), W / WR / WRITE (size 为 64 时 WriteNoSnpFull, 否则 WriteNoSnpPtl),
+//              ReadNoSnp / WriteNoSnpFull / WriteNoSnpPtl, 或者 CHI ReqOpcode 的数值
+//   size     : 字节数, 1 ~ 64 的 2 的幂, 默认 64
+//   src_id / qos 默认与 CHITrafficGenerator::add_payload 相同 (1 / 15)
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <ARM/TLM/arm_chi_phase.h>
+
+#include "CHIPort/ReqTraceFormat.hh"
+
+using namespace dmu::Port;
+
+namespace {
+
+bool
+ParseTimeUnit(const std::string& text, uint64_t& unit_ps)
+{
+    if(text == "ps")
+        unit_ps = 1;
+    else if(text == "ns")
+        unit_ps = 1000;
+    else if(text == "us")
+        unit_ps = 1000000;
+    else
+    {
+        char* end = nullptr;
+        unit_ps = std::strtoull(text.c_str(), &end, 0);
+        return end != text.c_str() && *end == '\0' && unit_ps != 0;
+    }
+    return true;
+}
+
+bool
+ParseOpcode(std::string text, unsigned size_bytes, uint8_t& opcode)
+{
+    for(auto& c: text)
+        c = std::toupper(static_cast<unsigned char>(c));
+    if(text == "R" || text == "RD" || text == "READ" || text == "READNOSNP")
+        opcode = ARM::CHI::REQ_OPCODE_READ_NO_SNP;
+    else if(text == "W" || text == "WR" || text == "WRITE")
+        opcode = size_bytes == 64 ? ARM::CHI::REQ_OPCODE_WRITE_NO_SNP_FULL : ARM::CHI::REQ_OPCODE_WRITE_NO_SNP_PTL;
+    else if(text == "WRITENOSNPFULL")
+        opcode = ARM::CHI::REQ_OPCODE_WRITE_NO_SNP_FULL;
+    else if(text == "WRITENOSNPPTL")
+        opcode = ARM::CHI::REQ_OPCODE_WRITE_NO_SNP_PTL;
+    else
+    {
+        char* end = nullptr;
+        unsigned long value = std::strtoul(text.c_str(), &end, 0);
+        if(end == text.c_str() || *end != '\0' || value >= kReqTraceDelayOnly)
+            return false;
+        opcode = static_cast<uint8_t>(value);
+    }
+    return true;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    if(argc < 3)
+    {
+        std::cerr << "usage: " << argv[0] << " <trace.txt> <trace.bin> [ps|ns|us|unit_in_ps]" << std::endl;
+        return 1;
+    }
+    std::ifstream input(argv[1]);
+    if(!input)
+    {
+        std::cerr << "Unable to open file: " << argv[1] << std::endl;
+        return 1;
+    }
+    std::ofstream output(argv[2], std::ios::binary | std::ios::trunc);
+    if(!output)
+    {
+        std::cerr << "Unable to create file: " << argv[2] << std::endl;
+        return 1;
+    }
+    ReqTraceHeader header{};
+    std::memcpy(header.magic, kReqTraceMagic, sizeof(kReqTraceMagic));
+    header.version = kReqTraceVersion;
+    header.record_size = sizeof(ReqTraceRecord);
+    header.time_unit_ps = 1000;
+    if(argc > 3 && !ParseTimeUnit(argv[3], header.time_unit_ps))
+    {
+        std::cerr << "Invalid time unit: " << argv[3] << std::endl;
+        return 1;
+    }
+    // record 数目在最后回填
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::string line;
+    uint64_t line_number = 0;
+    uint64_t last_time = 0;
+    while(std::getline(input, line))
+    {
+        line_number++;
+        std::istringstream fields(line);
+        std::string time_text, opcode_text, address_text;
+        if(!(fields >> time_text) || time_text[0] == '#')
+            continue;
+        unsigned size_bytes = 64, src_id = 1, qos = 15;
+        fields >> opcode_text >> address_text;
+        if(address_text.empty())
+        {
+            std::cerr << "line " << line_number << ": expected <time> <opcode> <address>" << std::endl;
+            return 1;
+        }
+        if(fields >> size_bytes)
+            fields >> src_id >> qos;
+
+        uint64_t time = std::strtoull(time_text.c_str(), nullptr, 0);
+        ReqTraceRecord record{};
+        record.address = std::strtoull(address_text.c_str(), nullptr, 0);
+        record.src_id = static_cast<uint16_t>(src_id);
+        if(time < last_time)
+        {
+            std::cerr << "line " << line_number << ": time goes backwards" << std::endl;
+            return 1;
+        }
+        if(size_bytes == 0 || size_bytes > 64 || (size_bytes & (size_bytes - 1)) != 0 || qos > 15)
+        {
+            std::cerr << "line " << line_number << ": invalid size or qos" << std::endl;
+            return 1;
+        }
+        if(!ParseOpcode(opcode_text, size_bytes, record.opcode))
+        {
+            std::cerr << "line " << line_number << ": unknown opcode " << opcode_text << std::endl;
+            return 1;
+        }
+        record.size_qos = ReqTraceRecord::PackSizeQos(__builtin_ctz(size_bytes), qos);
+
+        // delta 超出 u32 时先写 delay only 的 record
+        uint64_t delta = time - last_time;
+        while(delta > UINT32_MAX)
+        {
+            ReqTraceRecord delay{};
+            delay.delta = UINT32_MAX;
+            delay.opcode = kReqTraceDelayOnly;
+            output.write(reinterpret_cast<const char*>(&delay), sizeof(delay));
+            header.num_of_records++;
+            delta -= UINT32_MAX;
+        }
+        record.delta = static_cast<uint32_t>(delta);
+        output.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        header.num_of_records++;
+        last_time = time;
+    }
+
+    output.seekp(0);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if(!output)
+    {
+        std::cerr << "Failed to write file: " << argv[2] << std::endl;
+        return 1;
+    }
+    std::cerr << "converted " << header.num_of_records << " records" << std::endl;
+    return 0;
+}
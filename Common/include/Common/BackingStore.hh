@@ -0,0 +1,68 @@
+#ifndef __BACKING_STORE_HH__
+#define __BACKING_STORE_HH__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace dmu{
+
+/*
+稀疏的功能内存 (按系统地址), 只为写过的 4KB page 分配空间
+    page 挂在 4 层 radix tree 上, 每层 9 bit page number, 共覆盖 48 bit 地址
+    GetSpan 直接返回 page 内的连续内存, 不做拷贝; 跨 page 的访问由 Read / Write 拆开
+    最近访问的 page 缓存一份, 连续地址的访问不需要走 radix tree
+没有写过的地址读出 0
+*/
+class BackingStore
+{
+    public:
+        static constexpr unsigned kPageBits = 12;
+        static constexpr std::size_t kPageSize = std::size_t(1) << kPageBits;
+        static constexpr unsigned kLevelBits = 9;
+        static constexpr unsigned kNumOfLevels = 4;
+        static constexpr unsigned kAddressBits = kPageBits + kLevelBits * kNumOfLevels;
+
+        struct Span
+        {
+            uint8_t* data = nullptr; // page 不存在时为 nullptr
+            std::size_t length = 0;
+        };
+
+        BackingStore() = default;
+        BackingStore(const BackingStore&) = delete;
+        BackingStore& operator=(const BackingStore&) = delete;
+        ~BackingStore();
+
+        // address 开始最多 length 字节, 截止到 page 末尾; create 为 false 时不分配 page
+        Span GetSpan(uint64_t address, std::size_t length, bool create);
+        // byte_enable 按 TLM 的约定: byte_enable[i % byte_enable_length] == 0xff 的字节才写入, nullptr 表示全部写入
+        void Write(uint64_t address, const uint8_t* data, std::size_t length,
+                   const uint8_t* byte_enable = nullptr, std::size_t byte_enable_length = 0);
+        void Read(uint64_t address, uint8_t* data, std::size_t length);
+
+        inline std::size_t GetNumOfPages() const { return numOfPages; }
+        // page 和 radix tree 节点 (包括 root) 占用的内存
+        inline std::size_t GetNumOfBytes() const { return numOfPages * kPageSize + (numOfNodes + 1) * sizeof(Node); }
+
+    private:
+        static constexpr std::size_t kFanout = std::size_t(1) << kLevelBits;
+        // 最后一层的 slot 指向 page (kPageSize 字节), 其它层指向下一层 Node
+        struct Node
+        {
+            std::array<void*, kFanout> slots{};
+        };
+
+        uint8_t* FindPage(uint64_t page_number, bool create);
+        void FreeNode(Node* node, unsigned level);
+
+        Node root;
+        std::size_t numOfPages = 0;
+        std::size_t numOfNodes = 0;
+        uint64_t cachedPageNumber = ~uint64_t(0);
+        uint8_t* cachedPage = nullptr;
+};
+
+} // namespace dmu
+
+#endif
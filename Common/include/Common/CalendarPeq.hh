@@ -0,0 +1,368 @@
+#ifndef __CALENDAR_PEQ_HH__
+#define __CALENDAR_PEQ_HH__
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#ifndef SC_INCLUDE_DYNAMIC_PROCESSES // sc_spawn
+#define SC_INCLUDE_DYNAMIC_PROCESSES
+#endif
+#include <systemc>
+#include <tlm>
+
+namespace dmu{
+
+/*
+tlm_utils::peq_with_cb_and_phase 的替代, 接口和回调顺序相同 (同一时刻按 notify 的先后, delta / immediate 通知的处理也一样)
+    timed 通知放在以 resolution (dfi cycle) 为单位的 calendar 中: slot = tick % kNumOfSlots, slot 内按时间排序,
+    delay 是 resolution 整数倍时同一 slot 中的时间都相同, notify 直接接在 slot 尾部; 超出 kNumOfSlots 个 tick 的放在 overflow 中
+    节点来自内部的 pool, 稳态下 notify 没有 heap 分配
+    只有 notify 的时间早于已经安排的唤醒时间时才通知 sc_event, 每个有事件的时刻只唤醒一次;
+    回调中的 timed notify 只插入 calendar, fec 结束时统一安排一次唤醒, 不会反复取消 / 重新安排 kernel 的 timed 通知;
+    已经有 delta / immediate 唤醒时不安排 timed 唤醒 (sc_event 会忽略), 由那次 fec 安排
+    time -> tick 用预先算好的倒数做乘法, 不做 64 位除法; now 没有跨过下一个 tick 时 Advance 直接返回
+*/
+template<typename OWNER, typename TYPES = tlm::tlm_base_protocol_types>
+class CalendarPeq : public sc_core::sc_object
+{
+    public:
+        using tlm_payload_type = typename TYPES::tlm_payload_type;
+        using tlm_phase_type = typename TYPES::tlm_phase_type;
+        using cb = void (OWNER::*)(tlm_payload_type&, const tlm_phase_type&);
+
+        static constexpr unsigned kSlotBits = 8;
+        static constexpr unsigned kNumOfSlots = 1u << kSlotBits;
+
+        CalendarPeq(OWNER* owner, cb callback, const sc_core::sc_time& resolution)
+        : CalendarPeq(sc_core::sc_gen_unique_name("calendar_peq"), owner, callback, resolution)
+        {}
+        CalendarPeq(const char* name, OWNER* owner, cb callback, const sc_core::sc_time& resolution)
+        : sc_core::sc_object(name)
+        , m_owner(owner)
+        , m_cb(callback)
+        , resolution_value(resolution.value())
+        , tick_multiplier(resolution_value > 0 ? ~UINT64_C(0) / resolution_value : 0)
+        , next_tick_time(resolution_value)
+        {
+            sc_assert(resolution_value > 0);
+            sc_core::sc_spawn_options opts;
+            opts.spawn_method();
+            opts.set_sensitivity(&m_e);
+            opts.dont_initialize();
+            sc_core::sc_spawn(sc_bind(&CalendarPeq::fec, this), sc_core::sc_gen_unique_name("fec"), &opts);
+        }
+        CalendarPeq(const CalendarPeq&) = delete;
+        CalendarPeq& operator=(const CalendarPeq&) = delete;
+
+        void notify(tlm_payload_type& t, const tlm_phase_type& p, const sc_core::sc_time& when)
+        {
+            if(when == sc_core::SC_ZERO_TIME)
+            {
+                // 与 peq_with_cb_and_phase 相同: 奇数 delta cycle 中的通知在偶数 delta cycle 处理, 反之亦然
+                if(sc_core::sc_delta_count() & 0x1)
+                    m_even_delta.emplace_back(&t, p);
+                else
+                    m_uneven_delta.emplace_back(&t, p);
+                NotifyDelta();
+                return;
+            }
+            // fec 中 (回调里) 的 notify: fec 已经 Advance 到当前时刻, 结束时安排唤醒
+            const sc_core::sc_time& now = in_fec ? fec_time : sc_core::sc_time_stamp();
+            if(!in_fec)
+                Advance(now.value());
+            Node* node = AllocateNode();
+            node->payload = PAYLOAD(&t, p);
+            node->time = now + when;
+            Insert(node);
+            if(in_fec)
+            {
+                num_of_fec_inserts++;
+                if(fec_earliest == nullptr || node->time < fec_earliest->time)
+                    fec_earliest = node;
+            }
+            if(!in_fec && !delta_pending && node->time.value() < scheduled_time)
+            {
+                scheduled_time = node->time.value();
+                earliest_time = node->time;
+                m_e.notify(when);
+            }
+        }
+        void notify(tlm_payload_type& t, const tlm_phase_type& p)
+        {
+            m_immediate_yield.emplace_back(&t, p);
+            // immediate 通知取消 m_e 上其它的通知, 本次 fec 重新安排
+            delta_pending = true;
+            scheduled_time = kNoWakeup;
+            m_e.notify();
+        }
+
+        void cancel_all()
+        {
+            for(auto& slot: slots)
+                FreeList(slot);
+            occupied.fill(0);
+            FreeList(overflow);
+            m_uneven_delta.clear();
+            m_even_delta.clear();
+            m_immediate_yield.clear();
+            m_e.cancel();
+            scheduled_time = kNoWakeup;
+            delta_pending = false;
+        }
+
+        // 当前排队的 timed 通知数目
+        inline std::size_t GetNumOfPending() const { return num_of_pending; }
+        // pool 中分配过的节点数, 即同时排队的 timed 通知数目的峰值 (向上取整到 kNodesPerChunk)
+        inline std::size_t GetNumOfNodes() const { return node_chunks.size() * kNodesPerChunk; }
+
+    private:
+        using PAYLOAD = std::pair<tlm_payload_type*, tlm_phase_type>;
+        static constexpr uint64_t kNoWakeup = ~UINT64_C(0);
+        static constexpr unsigned kNodesPerChunk = 64;
+        static constexpr unsigned kNumOfWords = kNumOfSlots / 64;
+
+        struct Node
+        {
+            Node* next{nullptr};
+            PAYLOAD payload;
+            sc_core::sc_time time; // 绝对时间, 唤醒时直接相减得到 delay, 不经过 sc_time::from_value
+        };
+        struct List
+        {
+            Node* head{nullptr};
+            Node* tail{nullptr};
+        };
+
+        OWNER* m_owner;
+        cb m_cb;
+        const uint64_t resolution_value;
+        const uint64_t tick_multiplier; // floor((2^64 - 1) / resolution_value)
+
+        std::array<List, kNumOfSlots> slots;
+        std::array<uint64_t, kNumOfWords> occupied{};
+        List overflow;         // tick >= base_tick + kNumOfSlots, 按时间排序
+        uint64_t base_tick{0}; // slots 覆盖 [base_tick, base_tick + kNumOfSlots)
+        uint64_t next_tick_time; // (base_tick + 1) * resolution_value
+        std::size_t num_of_pending{0};
+        uint64_t scheduled_time{kNoWakeup}; // m_e 上安排的 timed 唤醒时刻
+        bool delta_pending{false}; // m_e 上有 delta / immediate 通知, 覆盖了 timed 唤醒
+        bool in_fec{false};
+        sc_core::sc_time fec_time; // in_fec 时的 sc_time_stamp
+        sc_core::sc_time earliest_time; // scheduled_time 对应的 sc_time
+        // 本次 fec 中插入的节点数和其中最早的一个; 排队的节点都是本次插入的 (例如只有一个 outstanding) 时不用扫描 calendar
+        std::size_t num_of_fec_inserts{0};
+        const Node* fec_earliest{nullptr};
+
+        std::vector<std::unique_ptr<Node[]>> node_chunks;
+        Node* free_nodes{nullptr};
+
+        std::vector<PAYLOAD> m_uneven_delta;
+        std::vector<PAYLOAD> m_even_delta;
+        std::vector<PAYLOAD> m_immediate_yield;
+        sc_core::sc_event m_e;
+
+        // time / resolution_value: 乘以倒数得到的商最多小 2, 再修正
+        inline uint64_t Tick(uint64_t time) const
+        {
+            uint64_t tick = static_cast<uint64_t>((static_cast<unsigned __int128>(time) * tick_multiplier) >> 64);
+            while(time - tick * resolution_value >= resolution_value)
+                tick++;
+            return tick;
+        }
+        // delta 通知会覆盖 m_e 上的 timed 通知
+        inline void NotifyDelta()
+        {
+            delta_pending = true;
+            scheduled_time = kNoWakeup;
+            m_e.notify(sc_core::SC_ZERO_TIME);
+        }
+
+        Node* AllocateNode()
+        {
+            if(free_nodes == nullptr)
+            {
+                node_chunks.emplace_back(new Node[kNodesPerChunk]);
+                Node* chunk = node_chunks.back().get();
+                for(unsigned i = 0; i < kNodesPerChunk; i++)
+                {
+                    chunk[i].next = free_nodes;
+                    free_nodes = &chunk[i];
+                }
+            }
+            Node* node = free_nodes;
+            free_nodes = node->next;
+            num_of_pending++;
+            return node;
+        }
+        void FreeNode(Node* node)
+        {
+            node->next = free_nodes;
+            free_nodes = node;
+            num_of_pending--;
+        }
+        void FreeList(List& list)
+        {
+            while(list.head != nullptr)
+            {
+                Node* node = list.head;
+                list.head = node->next;
+                FreeNode(node);
+            }
+            list.tail = nullptr;
+        }
+
+        // 放在时间不晚于它的最后一个节点之后, 保持同一时刻 notify 的先后顺序
+        static void InsertSorted(List& list, Node* node)
+        {
+            node->next = nullptr;
+            if(list.head == nullptr)
+            {
+                list.head = list.tail = node;
+            }
+            else if(list.tail->time <= node->time)
+            {
+                list.tail->next = node;
+                list.tail = node;
+            }
+            else if(node->time < list.head->time)
+            {
+                node->next = list.head;
+                list.head = node;
+            }
+            else
+            {
+                Node* ancestor = list.head;
+                while(ancestor->next->time <= node->time)
+                    ancestor = ancestor->next;
+                node->next = ancestor->next;
+                ancestor->next = node;
+            }
+        }
+        void Insert(Node* node)
+        {
+            const uint64_t tick = Tick(node->time.value());
+            if(tick >= base_tick + kNumOfSlots)
+            {
+                InsertSorted(overflow, node);
+                return;
+            }
+            const unsigned slot_index = tick % kNumOfSlots;
+            InsertSorted(slots[slot_index], node);
+            occupied[slot_index / 64] |= UINT64_C(1) << (slot_index % 64);
+        }
+
+        // 早于 now 的 timed 通知都已经处理, [base_tick, Tick(now)) 的 slot 都是空的, 直接移动窗口
+        // overflow 是排好序的, 进入窗口的节点依次接到各自 slot 的尾部
+        void Advance(uint64_t now)
+        {
+            if(now < next_tick_time)
+                return;
+            base_tick = Tick(now);
+            next_tick_time = (base_tick + 1) * resolution_value;
+            while(overflow.head != nullptr && Tick(overflow.head->time.value()) < base_tick + kNumOfSlots)
+            {
+                Node* node = overflow.head;
+                overflow.head = node->next;
+                Insert(node);
+            }
+            if(overflow.head == nullptr)
+                overflow.tail = nullptr;
+        }
+
+        // 从 base_tick 的 slot 开始找第一个非空的 slot, 窗口内都为空时看 overflow
+        const Node* Earliest() const
+        {
+            const unsigned first = base_tick % kNumOfSlots;
+            for(unsigned i = 0; i <= kNumOfWords; i++)
+            {
+                const unsigned word = (first / 64 + i) % kNumOfWords;
+                uint64_t bits = occupied[word];
+                // 起始 word 第一次只看 first 及以后的 bit, 绕回来时 (i == kNumOfWords) 只看之前的 bit
+                if(i == 0)
+                    bits &= ~UINT64_C(0) << (first % 64);
+                else if(i == kNumOfWords)
+                    bits &= (first % 64) == 0 ? 0 : ~UINT64_C(0) >> (64 - first % 64);
+                if(bits != 0)
+                    return slots[word * 64 + __builtin_ctzll(bits)].head;
+            }
+            return overflow.head;
+        }
+
+        void DispatchImmediateAndDelta()
+        {
+            // immediate yield notifications
+            for(std::size_t i = 0; i < m_immediate_yield.size(); i++)
+            {
+                PAYLOAD tmp = m_immediate_yield[i];
+                (m_owner->*m_cb)(*tmp.first, tmp.second);
+            }
+            m_immediate_yield.clear();
+            // delta notifications
+            const bool uneven = sc_core::sc_delta_count() & 0x1;
+            std::vector<PAYLOAD>& current = uneven ? m_uneven_delta : m_even_delta;
+            std::vector<PAYLOAD>& next = uneven ? m_even_delta : m_uneven_delta;
+            for(std::size_t i = 0; i < current.size(); i++)
+            {
+                PAYLOAD tmp = current[i];
+                (m_owner->*m_cb)(*tmp.first, tmp.second);
+            }
+            current.clear();
+            if(!next.empty())
+                NotifyDelta();
+        }
+
+        void fec()
+        {
+            // 没有 delta / immediate 通知时只可能是 scheduled_time 上的 timed 唤醒, 不用再取 sc_time_stamp
+            if(delta_pending || scheduled_time == kNoWakeup)
+                fec_time = sc_core::sc_time_stamp();
+            else
+                fec_time = earliest_time;
+            delta_pending = false;
+            const uint64_t now = fec_time.value();
+            if(scheduled_time <= now)
+                scheduled_time = kNoWakeup; // 本次唤醒
+            Advance(now);
+            in_fec = true;
+            num_of_fec_inserts = 0;
+            fec_earliest = nullptr;
+            // 只有 timed 通知时跳过 immediate / delta 的处理
+            if(!m_immediate_yield.empty() || !m_uneven_delta.empty() || !m_even_delta.empty())
+                DispatchImmediateAndDelta();
+
+            // timed notifications
+            const unsigned slot_index = base_tick % kNumOfSlots;
+            List& slot = slots[slot_index];
+            while(slot.head != nullptr && slot.head->time.value() == now)
+            {
+                Node* node = slot.head;
+                slot.head = node->next;
+                if(slot.head == nullptr)
+                    slot.tail = nullptr;
+                PAYLOAD tmp = node->payload;
+                FreeNode(node);
+                (m_owner->*m_cb)(*tmp.first, tmp.second);
+            }
+            if(slot.head == nullptr)
+                occupied[slot_index / 64] &= ~(UINT64_C(1) << (slot_index % 64));
+            in_fec = false;
+
+            // 有 delta 通知时由下一次 fec 安排
+            if(delta_pending || num_of_pending == 0)
+                return;
+            const Node* earliest = num_of_fec_inserts == num_of_pending ? fec_earliest : Earliest();
+            if(earliest != nullptr && earliest->time.value() < scheduled_time)
+            {
+                scheduled_time = earliest->time.value();
+                earliest_time = earliest->time;
+                m_e.notify(earliest->time - fec_time);
+            }
+        }
+};
+
+}
+
+#endif
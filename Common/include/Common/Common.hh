@@ -7,6 +7,9 @@
 #include <iomanip>
 #include <cassert>
 #include <cstdint>
+#include <array>
+#include <string>
+#include <string_view>
 
 #include <systemc>
 #include <tlm>
@@ -26,6 +29,11 @@ DECLARE_EXTENDED_PHASE(WR_RESPONSE_COMPLETE);
 DECLARE_EXTENDED_PHASE(UIF_RDAT_BEGIN);
 DECLARE_EXTENDED_PHASE(UIF_RDAT_END);
 
+// controller clock tick, Controller 内部统一使用的时间单位(tCK_mc 的整数倍)
+// 只在 TLM 接口处与 sc_time 相互转换, MaxTick 与 sc_max_time() 对应, 表示没有待发生的事件
+using Tick = uint64_t;
+constexpr Tick MaxTick = UINT64_MAX;
+
 enum class PriorityClass{
     HPR,
     LPR,
@@ -55,6 +63,18 @@ enum class CmdType{
     Invalid
 };
 
+inline std::string toString(const CmdType& cmdType) {
+    static constexpr std::array<std::string_view, 5> cmdTypeStrings = {
+        "RD", "WR", "MWR", "RMW", "Invalid"
+    };
+
+    size_t index = static_cast<size_t>(cmdType);
+    if (index < cmdTypeStrings.size()) {
+        return std::string(cmdTypeStrings[index]);
+    }
+    return "Unknown";
+}
+
 class Qos
 {
 public:
@@ -102,6 +122,8 @@ public:
         assert(qos_value >= 0 && qos_value <= 15);
     }
 
+    explicit Qos(uint8_t qos_value, PriorityClass qos_priority): _qos_value(qos_value), _qos_priority(qos_priority){}
+
     Qos():_qos_value(0),_qos_priority(PriorityClass::Invalid){}
     inline uint8_t GetQosValue() const{ return _qos_value;}
     inline PriorityClass GetQosLevel() const{ return _qos_priority;}
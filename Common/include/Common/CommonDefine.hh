@@ -3,41 +3,67 @@
 
 #include <iostream>
 #include <cstdio>
+#include <sstream>
 
 #include <systemc>
 
+#include "Common/TraceLog.hh"
+
 namespace dmu{
 
 // 定义是否启用调试打印的宏
 // #define ENABLE_DEBUG_PRINT
 
 // // debug flag
+// 每个 debug flag 对应 trace 的一个 category bit, 可以通过环境变量 DMU_TRACE 在运行时打开/关闭
+// DMU_TRACE_COMPILE_MASK 之外的 category 在编译期被删除
+
+#define PORT                ::dmu::trace::kPort
+#define TOP_DEBUG           ::dmu::trace::kTopDebug
+#define WR_CAM              ::dmu::trace::kWrCam
+#define RD_CAM              ::dmu::trace::kRdCam
+#define BANK_SLICE          ::dmu::trace::kBankSlice
+#define BANK_SLICE_MANAGER  ::dmu::trace::kBankSliceManager
+#define CMD_SELECT          ::dmu::trace::kCmdSelect
+#define MODE_SWITCH         ::dmu::trace::kModeSwitch
+#define TIME_CONSTRAINT     ::dmu::trace::kTimeConstraint
+#define DEVICE              ::dmu::trace::kDevice
+#define MEMORY_CONTROLLER   ::dmu::trace::kMemoryController
+#define NTT                 ::dmu::trace::kNtt
+#define PHY_DELAY_MODEL     ::dmu::trace::kPhyDelayModel
+#define UIF                 ::dmu::trace::kUif
 
-#define PORT 1
-#define TOP_DEBUG 1
-#define WR_CAM 1
-#define RD_CAM 1
-#define BANK_SLICE 1
-#define BANK_SLICE_MANAGER 1
-#define CMD_SELECT 1
-#define MODE_SWITCH 1
-#define TIME_CONSTRAINT 1
-#define DEVICE 1
-#define MEMORY_CONTROLLER 1
-#define NTT 1
-#define PHY_DELAY_MODEL 1
+#ifndef DMU_TRACE_COMPILE_MASK
+#define DMU_TRACE_COMPILE_MASK 0xFFFFFFFFu
+#endif
+
+#define PRINT_BUFFER_SIZE 4096
+// 直接格式化并通过 SC_REPORT 输出, ERROR/FATAL 不受 debug flag 控制
+#define DPRINT_REPORT(name, type, format, ...) \
+    do { \
+        char __fmt_buf[PRINT_BUFFER_SIZE] = {0}; \
+        std::ostringstream __ss; \
+        snprintf(__fmt_buf, sizeof(__fmt_buf), format, ##__VA_ARGS__); \
+        __ss << "@" << sc_core::sc_time_stamp() << ":" << __fmt_buf; \
+        SC_REPORT_##type(name, __ss.str().c_str()); \
+    } while (0)
 
 // 基于调试标志的统一打印实现
 #ifdef ENABLE_DEBUG_PRINT
-#define PRINT_BUFFER_SIZE 4096
-#define DPRINT(debug_flag, name,type, format, ...) \
+// debug_flag 为常量且不在 compile mask 中时整个分支被编译器删除
+#define DPRINT_ENABLED(debug_flag) \
+    (((debug_flag) & DMU_TRACE_COMPILE_MASK & ::dmu::trace::TraceLog::RuntimeMask()) != 0)
+
+// binary sink 打开时只记录原始参数, 由 dmu_trace_decode 离线格式化
+#define DPRINT(debug_flag, name, type, format, ...) \
     do { \
-        if (debug_flag) { \
-            char __fmt_buf[PRINT_BUFFER_SIZE] = {0}; \
-            std::ostringstream __ss; \
-            snprintf(__fmt_buf, sizeof(__fmt_buf), format, ##__VA_ARGS__); \
-            __ss << "@" << sc_core::sc_time_stamp() << ":" << __fmt_buf; \
-            SC_REPORT_##type(name, __ss.str().c_str()); \
+        if (DPRINT_ENABLED(debug_flag)) { \
+            if (::dmu::trace::TraceLog::IsBinary()) { \
+                static const uint32_t __fmt_id = ::dmu::trace::TraceLog::InternString(format); \
+                ::dmu::trace::TraceLog::Record(debug_flag, ::dmu::trace::Level::type, name, __fmt_id, ##__VA_ARGS__); \
+            } else { \
+                DPRINT_REPORT(name, type, format, ##__VA_ARGS__); \
+            } \
         } \
     } while (0)
 
@@ -45,15 +71,12 @@ namespace dmu{
 #define DPRINT_ASSERT(condition ,name, format, ...) \
     do { \
         if (!(condition)) { \
-            char __fmt_buf[PRINT_BUFFER_SIZE] = {0}; \
-            std::ostringstream __ss; \
-            snprintf(__fmt_buf, sizeof(__fmt_buf), format, ##__VA_ARGS__); \
-            __ss << "@" << sc_core::sc_time_stamp() << ":" << __fmt_buf; \
-            SC_REPORT_FATAL(name, __ss.str().c_str()); \
+            DPRINT_REPORT(name, FATAL, format, ##__VA_ARGS__); \
         } \
     } while(0)
 #else
-#define DPRINT(debug_flag, type, format, ...) do {} while (0)
+#define DPRINT_ENABLED(debug_flag) false
+#define DPRINT(debug_flag, name, type, format, ...) do {} while (0)
 #define DPRINT_ASSERT(condition ,name, format, ...) do {} while (0)
 #endif
 // example: DPRINTF(DEBUG_DRAMSIM3, "Instantiated DRAMsim3 with clock %d ns and queue size %d\n", 100, 10);
@@ -62,9 +85,9 @@ namespace dmu{
 // warning will show the __FILE__ and __LINE__
 #define DPRINT_WARNING(debug_flag, name, format, ...) DPRINT(debug_flag, name, WARNING, format, ##__VA_ARGS__)
 // error will call the progma error, and exist the progma
-#define DPRINT_ERROR(name, format, ...) DPRINT(true, name, ERROR, format, ##__VA_ARGS__)
+#define DPRINT_ERROR(name, format, ...) DPRINT_REPORT(name, ERROR, format, ##__VA_ARGS__)
 // fatal will call the progma abort
-#define DPRINT_FATAL(name, format, ...) DPRINT(true, name, FATAL, format, ##__VA_ARGS__)
+#define DPRINT_FATAL(name, format, ...) DPRINT_REPORT(name, FATAL, format, ##__VA_ARGS__)
 
 #define ABORT_MESSAGE(msg) \
     std::cerr << "Aborting at " << __FILE__ << ":" << __LINE__ << " : " << msg << std::endl; \
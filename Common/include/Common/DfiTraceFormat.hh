@@ -0,0 +1,144 @@
+#ifndef __DFI_TRACE_FORMAT_HH__
+#define __DFI_TRACE_FORMAT_HH__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace dmu{
+    namespace trace{
+
+// DFI 命令 / 请求统计的二进制 trace, 由 MemoryDevice 通过 DfiTraceWriter 写出, 取代 DfiCmd.txt / TransInfo.txt
+// dmu_dfi_decode 离线还原成原来的两个文本文件; 不依赖 SystemC, decoder 只需要包含这个头文件和 LzBlock.hh
+//
+// File   := Header Block*
+// Header := magic[8] "DMUDFITR" | u32 version | u32 flags | u64 time resolution in fs | u64 config hash
+//           | u32 block size | u32 reserved | u64 number of records (Close 时回填)
+// Block  := u32 raw size | u32 stored size | u8[stored size]
+//   stored size == raw size 时是未压缩的数据, 否则是 LzBlock 压缩的数据, 解压后是 raw size 字节
+//   解压后的数据是连续的 Record, record 不会跨 block
+// Record := DfiCmdRecord (32B) | TransRecord (128B) | TransCmdRecord (32B), 第一个字节是 RecordType
+//   TransRecord 只带前 kTransInlineCmds 个命令, 多出的命令跟在后面的 TransCmdRecord 中, 每个 3 个
+//
+// 时间都是 sc_time::value(), 单位是 header 中的 time resolution; 所有整数都是 little-endian host order
+
+constexpr char kDfiTraceMagic[8] = {'D','M','U','D','F','I','T','R'};
+constexpr uint32_t kDfiTraceVersion = 1;
+constexpr uint32_t kDfiTraceFlagCompressed = 1u << 0;
+constexpr uint32_t kDfiTraceBlockSize = 1u << 20;
+
+enum class RecordType : uint8_t
+{
+    DfiCmd = 1,
+    Trans = 2,
+    TransCmd = 3,
+};
+
+struct DfiTraceHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t time_resolution_fs;
+    uint64_t config_hash;
+    uint32_t block_size;
+    uint32_t reserved;
+    uint64_t num_of_records;
+};
+
+struct DfiTraceBlockHeader
+{
+    uint32_t raw_size;
+    uint32_t stored_size;
+};
+
+// 一个 DFI 命令, 对应 DfiCmd.txt 的一行
+//   bank 命令按 StatisticExtension 中的 DecodedAddress 输出, rank 命令 (is_rank) 按 DfiExtension 中的 BankAddress 输出
+struct DfiCmdRecord
+{
+    uint8_t type;
+    uint8_t command;   // Controller::Command::Type
+    uint8_t is_rank;
+    uint8_t channel;
+    uint32_t trans_id;
+    uint64_t time;
+    uint32_t row;
+    uint16_t column;
+    uint16_t byte;
+    uint16_t real_ba;
+    uint8_t cs;
+    uint8_t cid;
+    uint8_t bankgroup;
+    uint8_t bank;
+    uint8_t real_bg;
+    uint8_t real_cid;
+};
+
+// StatisticExtension 中的时间, 与 PrintStatistics 的输出顺序一致
+enum TransTime : uint8_t
+{
+    kInPortTime,
+    kOutPortTime,
+    kInCamTime,
+    kOutCamTime,
+    kUifDataBeginTime,
+    kUifDataEndTime,
+    kDfiDataBeginTime,
+    kDfiDataEndTime,
+    kDqDataBeginTime,
+    kDqDataEndTime,
+    kNumOfTransTimes
+};
+
+constexpr unsigned kTransInlineCmds = 3;
+constexpr unsigned kTransCmdRecordCmds = 3;
+
+// 一个完成的请求, 对应 TransInfo.txt 的一个 block
+struct TransRecord
+{
+    uint8_t type;
+    uint8_t num_of_cmds; // 全部命令的数目, 包括后面 TransCmdRecord 中的
+    uint8_t channel;
+    uint8_t cs;
+    uint32_t trans_id;
+    uint32_t row;
+    uint16_t column;
+    uint16_t byte;
+    uint8_t cid;
+    uint8_t bankgroup;
+    uint8_t bank;
+    uint8_t commands[kTransInlineCmds]; // DramCommand
+    uint16_t reserved;
+    uint64_t times[kNumOfTransTimes];
+    uint64_t command_times[kTransInlineCmds];
+};
+
+struct TransCmdRecord
+{
+    uint8_t type;
+    uint8_t commands[kTransCmdRecordCmds];
+    uint32_t trans_id;
+    uint64_t command_times[kTransCmdRecordCmds];
+};
+
+static_assert(sizeof(DfiTraceHeader) == 48, "dfi trace header layout changed");
+static_assert(sizeof(DfiTraceBlockHeader) == 8, "dfi trace block header layout changed");
+static_assert(sizeof(DfiCmdRecord) == 32, "dfi cmd record layout changed");
+static_assert(sizeof(TransRecord) == 128, "trans record layout changed");
+static_assert(sizeof(TransCmdRecord) == 32, "trans cmd record layout changed");
+
+// 与 Controller::Command::to_string 一致, 按 Command::Type 的值索引
+constexpr const char* kDfiCommandNames[] = {
+    "NOP", "WR", "RD", "WRA", "RDA", "ACT", "PRE",
+    "PRESB", "REFSB", "RFMSB", "PREAB", "REFAB", "RFMAB",
+    "SRE", "SREF", "PDE", "PDX"
+};
+
+// 与 dmu::to_string(DramCommand) 一致, 按 DramCommand 的值索引
+constexpr const char* kDramCommandNames[] = {
+    "ACT", "RD", "WR", "RDA", "WRA", "REFab", "REFsb", "RFMab", "RFMsb", "PREab", "PREsb", "PREpb", "Invalid"
+};
+
+    } // trace
+} // dmu
+
+#endif
@@ -0,0 +1,76 @@
+#ifndef __DFI_TRACE_WRITER_HH__
+#define __DFI_TRACE_WRITER_HH__
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/DfiTraceFormat.hh"
+
+namespace dmu{
+    namespace trace{
+
+/*
+DfiTraceFormat 的 writer
+    仿真线程只把定长 record 复制到当前 block, block 满了交给后台线程 (压缩 +) 写文件
+    待写的 block 超过 kMaxPendingBlocks 时仿真线程等待, 内存占用有上限
+    block 的 buffer 在两个线程之间循环使用, 稳定后不再分配内存
+*/
+class DfiTraceWriter
+{
+    public:
+        static constexpr std::size_t kMaxPendingBlocks = 4;
+
+        DfiTraceWriter() = default;
+        ~DfiTraceWriter();
+
+        DfiTraceWriter(const DfiTraceWriter&) = delete;
+        DfiTraceWriter& operator=(const DfiTraceWriter&) = delete;
+
+        // 文件打不开时返回 false
+        bool Open(const std::string& path, uint64_t time_resolution_fs, uint64_t config_hash, bool compress);
+        // 写出剩余的 block, 回填 record 数目
+        void Close();
+        inline bool IsOpen() const { return file != nullptr; }
+
+        template<typename Record>
+        void Append(const Record& record)
+        {
+            static_assert(sizeof(Record) <= kDfiTraceBlockSize, "record larger than block");
+            if(current.size() + sizeof(Record) > kDfiTraceBlockSize)
+                SubmitCurrent();
+            const uint8_t* data = reinterpret_cast<const uint8_t*>(&record);
+            current.insert(current.end(), data, data + sizeof(Record));
+            num_of_records++;
+        }
+
+        inline uint64_t GetNumOfRecords() const { return num_of_records; }
+
+    private:
+        void SubmitCurrent();
+        void WriterThread();
+        void WriteBlock(const std::vector<uint8_t>& block, std::vector<uint8_t>& compressed);
+
+        std::FILE* file{nullptr};
+        bool compress{false};
+        uint64_t num_of_records{0};
+        std::vector<uint8_t> current;
+
+        std::thread writer_thread;
+        std::mutex queue_mutex;
+        std::condition_variable queue_not_empty;
+        std::condition_variable queue_not_full;
+        std::deque<std::vector<uint8_t>> pending_blocks;
+        std::vector<std::vector<uint8_t>> free_blocks;
+        bool closing{false};
+};
+
+    } // trace
+} // dmu
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef __EXTENSION_POOL_HH__
+#define __EXTENSION_POOL_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <tlm>
+
+namespace dmu{
+
+/*
+按类型的 extension free list, 挂在 payload pool (PortMemoryManager / MemoryManager) 上使用
+    Attach: 从 free list 取一个 extension 挂到 payload 上, free list 为空时才 new
+    Recycle: payload 回到 memory manager (free) 时把 extension 摘下放回 free list
+稳态下 extension 与 payload 一起循环使用, 不再有 heap 分配
+T 需要有默认构造函数和 Reset(), Reset 把 extension 恢复到刚构造的状态 (保留 vector 等的容量)
+*/
+template<typename T>
+class ExtensionPool
+{
+    public:
+        ExtensionPool() = default;
+        ExtensionPool(const ExtensionPool&) = delete;
+        ExtensionPool& operator=(const ExtensionPool&) = delete;
+        ~ExtensionPool()
+        {
+            for(auto* ext: free_list)
+                delete ext;
+        }
+
+        T* Acquire()
+        {
+            if(free_list.empty())
+            {
+                numberOfAllocations++;
+                return new T();
+            }
+            T* ext = free_list.back();
+            free_list.pop_back();
+            return ext;
+        }
+        void Recycle(T* ext)
+        {
+            ext->Reset();
+            free_list.push_back(ext);
+        }
+
+        // payload 上已有的 T 先放回 free list 再挂新的, 返回的 extension 已经 Reset
+        T* Attach(tlm::tlm_generic_payload& trans)
+        {
+            T* ext = Acquire();
+            T* previous = trans.set_extension(ext);
+            if(previous != nullptr)
+                Recycle(previous);
+            return ext;
+        }
+        // payload 上没有 T 时什么都不做
+        void Recycle(tlm::tlm_generic_payload& trans)
+        {
+            T* ext = trans.get_extension<T>();
+            if(ext == nullptr)
+                return;
+            trans.clear_extension(ext);
+            Recycle(ext);
+        }
+
+        inline uint64_t GetNumOfAllocations() const { return numberOfAllocations; }
+        inline std::size_t GetNumOfFree() const { return free_list.size(); }
+
+    private:
+        std::vector<T*> free_list;
+        uint64_t numberOfAllocations = 0;
+};
+
+} // namespace dmu
+
+#endif
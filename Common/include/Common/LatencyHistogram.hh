@@ -0,0 +1,50 @@
+#ifndef __LATENCY_HISTOGRAM_HH__
+#define __LATENCY_HISTOGRAM_HH__
+
+#include <cstdint>
+#include <vector>
+
+namespace dmu{
+
+/*
+HDR (high dynamic range) 直方图, 记录非负整数 (延迟, 单位 ps)
+    小于 kSubBucketCount 的值每个值一个 bucket, 之后每个 2 的幂区间分成 kSubBucketCount / 2 个等宽 bucket
+    相对误差不超过 2 / kSubBucketCount (< 1%), 记录为 O(1), 内存只与最大值的数量级有关
+    bucket 数组按需增长, 每次多留一个 2 的幂区间, 每个值域只占几 KB
+*/
+class LatencyHistogram
+{
+    public:
+        static constexpr unsigned kSubBucketBits = 8;
+        static constexpr uint64_t kSubBucketCount = uint64_t(1) << kSubBucketBits;
+        static constexpr uint64_t kSubBucketHalf = kSubBucketCount / 2;
+
+        LatencyHistogram() = default;
+
+        void Record(uint64_t value);
+        void Merge(const LatencyHistogram& other);
+        void Reset();
+
+        inline uint64_t GetCount() const { return count; }
+        inline uint64_t GetMin() const { return count ? min : 0; }
+        inline uint64_t GetMax() const { return max; }
+        inline double GetMean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+        // percentile 取 [0, 100], 返回第一个累计数目达到 percentile 的 bucket 的上界 (不超过 max)
+        uint64_t GetValueAtPercentile(double percentile) const;
+
+    private:
+        static unsigned GetBucketIndex(uint64_t value);
+        static uint64_t GetBucketUpperBound(unsigned index);
+        static unsigned GetGrowSize(unsigned index);
+
+        std::vector<uint64_t> buckets;
+        uint64_t count{0};
+        uint64_t min{UINT64_MAX};
+        uint64_t max{0};
+        // 只用于 mean, 累计延迟超过 2^64 ps (~1.8e7 秒) 才会溢出
+        uint64_t sum{0};
+};
+
+}
+
+#endif
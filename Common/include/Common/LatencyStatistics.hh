@@ -0,0 +1,74 @@
+#ifndef __LATENCY_STATISTICS_HH__
+#define __LATENCY_STATISTICS_HH__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+
+#include "Common/Common.hh"
+#include "Common/LatencyHistogram.hh"
+#include "Common/StatisticExtension.hh"
+
+namespace dmu{
+
+// 由 StatisticExtension 中记录的时间计算的各阶段延迟
+enum class LatencyStage{
+    EndToEnd,   // 进入 port 到 DFI 数据结束
+    PortQueue,  // 进入 port 到发送给 controller
+    CamWait,    // 进入 cam 到发出 CAS
+    ActToCas,   // 最后一个 ACT 到 CAS, 只统计 page miss 的请求
+    Data,       // DFI 数据开始到结束 (DQ 上的 burst, 相对 DQ 只差固定的 PHY 延迟)
+    Invalid
+};
+
+inline std::string toString(const LatencyStage& stage) {
+    static constexpr std::array<std::string_view, 6> stageStrings = {
+        "end_to_end", "port_queue", "cam_wait", "act_to_cas", "data", "invalid"
+    };
+
+    size_t index = static_cast<size_t>(stage);
+    if (index < stageStrings.size()) {
+        return std::string(stageStrings[index]);
+    }
+    return "unknown";
+}
+
+/*
+在线统计每个请求各阶段的延迟, 取代离线解析 TransInfo.txt
+    所有请求, 以及按 qos class / opcode / srcid 分组, 每组每个阶段一个 LatencyHistogram
+    WriteJson 输出 count / mean / min / p50 / p90 / p99 / p99.9 / max, 单位 ns
+*/
+class LatencyStatistics
+{
+    public:
+        static constexpr std::size_t kNumOfStages = static_cast<std::size_t>(LatencyStage::Invalid);
+        using StageHistograms = std::array<LatencyHistogram, kNumOfStages>;
+
+        LatencyStatistics() = default;
+
+        // 请求的数据传输结束时调用一次
+        void Record(const StatisticExtension& statistic, PriorityClass qos_level, CmdType cmd_type, unsigned src_id);
+        // 合并另一个统计 (例如各个 sub-channel 的统计合成 DIMM 的统计)
+        void Merge(const LatencyStatistics& other);
+
+        inline uint64_t GetNumOfTransactions() const { return numOfTransactions; }
+        inline const StageHistograms& GetHistograms() const { return all; }
+
+        void WriteJson(std::ostream& os) const;
+        // 文件打不开时返回 false
+        bool WriteJson(const std::string& filename) const;
+
+    private:
+        StageHistograms all;
+        std::array<StageHistograms, static_cast<std::size_t>(PriorityClass::Invalid) + 1> byQos;
+        std::array<StageHistograms, static_cast<std::size_t>(CmdType::Invalid) + 1> byOpcode;
+        std::map<unsigned, StageHistograms> bySource;
+        uint64_t numOfTransactions{0};
+};
+
+}
+
+#endif
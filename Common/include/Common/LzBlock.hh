@@ -0,0 +1,187 @@
+#ifndef __LZ_BLOCK_HH__
+#define __LZ_BLOCK_HH__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+namespace dmu{
+    namespace trace{
+
+// LZ4 block 格式的压缩 / 解压, 用于 DfiTraceWriter 的 block 压缩, 不依赖 SystemC 和外部库
+// Sequence := token | [literal length 扩展] | literals | u16 offset | [match length 扩展]
+//   token 高 4 bit 为 literal 长度, 低 4 bit 为 match 长度 - 4, 取 15 时后面跟若干字节累加 (255 表示继续)
+//   最后一个 sequence 只有 literals; 与 LZ4 一样最后 5 个字节一定是 literal, 最后一个 match 在结尾 12 字节之前开始
+// trace record 字段重复度很高, 单个 hash 表的贪心匹配已经足够, 不追求压缩率
+namespace lz {
+
+constexpr unsigned kMinMatch = 4;
+constexpr size_t kLastLiterals = 5;
+constexpr size_t kMatchFindLimit = 12;
+constexpr unsigned kHashBits = 14;
+constexpr size_t kMaxOffset = 65535;
+
+inline uint32_t
+Load32(const uint8_t* p)
+{
+    uint32_t value;
+    std::memcpy(&value, p, 4);
+    return value;
+}
+
+inline uint32_t
+Hash(uint32_t sequence)
+{
+    return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+// 长度 >= 15 时写出扩展字节
+inline bool
+PutLength(size_t length, uint8_t* dst, size_t capacity, size_t& pos)
+{
+    for(; length >= 255; length -= 255)
+    {
+        if(pos >= capacity)
+            return false;
+        dst[pos++] = 255;
+    }
+    if(pos >= capacity)
+        return false;
+    dst[pos++] = static_cast<uint8_t>(length);
+    return true;
+}
+
+// 读出扩展字节并累加到 length, 越界时返回 false
+inline bool
+GetLength(const uint8_t* src, size_t src_size, size_t& pos, size_t& length)
+{
+    uint8_t byte;
+    do
+    {
+        if(pos >= src_size)
+            return false;
+        byte = src[pos++];
+        length += byte;
+    } while(byte == 255);
+    return true;
+}
+
+inline bool
+PutSequence(const uint8_t* literals, size_t literal_length, size_t offset, size_t match_length,
+            uint8_t* dst, size_t capacity, size_t& pos)
+{
+    if(pos >= capacity)
+        return false;
+    const size_t token_pos = pos++;
+    uint8_t token = static_cast<uint8_t>((literal_length < 15 ? literal_length : 15) << 4);
+    if(literal_length >= 15 && !PutLength(literal_length - 15, dst, capacity, pos))
+        return false;
+    if(pos + literal_length > capacity)
+        return false;
+    std::memcpy(dst + pos, literals, literal_length);
+    pos += literal_length;
+    if(match_length != 0)
+    {
+        if(pos + 2 > capacity)
+            return false;
+        const uint16_t offset16 = static_cast<uint16_t>(offset);
+        std::memcpy(dst + pos, &offset16, 2);
+        pos += 2;
+        const size_t code = match_length - kMinMatch;
+        token |= static_cast<uint8_t>(code < 15 ? code : 15);
+        if(code >= 15 && !PutLength(code - 15, dst, capacity, pos))
+            return false;
+    }
+    dst[token_pos] = token;
+    return true;
+}
+
+} // namespace lz
+
+// 返回压缩后的字节数; 压缩后不比原数据小 (或 capacity 不够) 时返回 0, 调用者保存原数据
+inline size_t
+LzCompress(const uint8_t* src, size_t src_size, uint8_t* dst, size_t capacity)
+{
+    using namespace lz;
+    constexpr uint32_t kEmpty = UINT32_MAX;
+    static thread_local uint32_t table[1u << kHashBits];
+    std::fill(std::begin(table), std::end(table), kEmpty);
+
+    size_t pos = 0;
+    size_t anchor = 0;
+    size_t ip = 0;
+    if(src_size > kMatchFindLimit)
+    {
+        const size_t match_limit = src_size - kMatchFindLimit;
+        const size_t match_end_limit = src_size - kLastLiterals;
+        while(ip < match_limit)
+        {
+            const uint32_t sequence = Load32(src + ip);
+            const uint32_t hash = Hash(sequence);
+            const uint32_t candidate = table[hash];
+            table[hash] = static_cast<uint32_t>(ip);
+            if(candidate == kEmpty || ip - candidate > kMaxOffset || Load32(src + candidate) != sequence)
+            {
+                ip++;
+                continue;
+            }
+            size_t match_length = kMinMatch;
+            while(ip + match_length < match_end_limit && src[candidate + match_length] == src[ip + match_length])
+                match_length++;
+            if(!PutSequence(src + anchor, ip - anchor, ip - candidate, match_length, dst, capacity, pos))
+                return 0;
+            ip += match_length;
+            anchor = ip;
+        }
+    }
+    if(!PutSequence(src + anchor, src_size - anchor, 0, 0, dst, capacity, pos))
+        return 0;
+    return pos < src_size ? pos : 0;
+}
+
+// 解压到 dst, 数据损坏或大小与 dst_size 不一致时返回 false
+inline bool
+LzDecompress(const uint8_t* src, size_t src_size, uint8_t* dst, size_t dst_size)
+{
+    using namespace lz;
+    size_t ip = 0;
+    size_t op = 0;
+    while(ip < src_size)
+    {
+        const uint8_t token = src[ip++];
+        size_t literal_length = token >> 4;
+        if(literal_length == 15 && !GetLength(src, src_size, ip, literal_length))
+            return false;
+        if(ip + literal_length > src_size || op + literal_length > dst_size)
+            return false;
+        std::memcpy(dst + op, src + ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+        if(ip == src_size)
+            break; // 最后一个 sequence 没有 match
+        if(ip + 2 > src_size)
+            return false;
+        uint16_t offset;
+        std::memcpy(&offset, src + ip, 2);
+        ip += 2;
+        size_t match_length = token & 0xf;
+        if(match_length == 15 && !GetLength(src, src_size, ip, match_length))
+            return false;
+        match_length += kMinMatch;
+        if(offset == 0 || offset > op || op + match_length > dst_size)
+            return false;
+        // match 可能与输出重叠 (offset < match_length), 逐字节复制
+        const uint8_t* match = dst + op - offset;
+        for(size_t i = 0; i < match_length; i++)
+            dst[op + i] = match[i];
+        op += match_length;
+    }
+    return op == dst_size;
+}
+
+    } // trace
+} // dmu
+
+#endif
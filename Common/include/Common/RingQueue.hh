@@ -0,0 +1,143 @@
+#ifndef __RING_QUEUE_HH__
+#define __RING_QUEUE_HH__
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace dmu{
+
+/*
+FIFO 用的环形 buffer, 接口是 std::deque 中 pipeline/queue 用到的子集 (push_back / emplace_back / pop_front / front / back / 遍历)
+    std::deque 按 512B 的 chunk 分配, pop_front 走空一个 chunk 就释放, push_back 越过 chunk 边界再分配, 稳态下每过一个 chunk 的元素就有一次 heap 分配
+    RingQueue 容量不够时翻倍, 之后不再缩小, 稳态下 push / pop 不走堆
+T 只需要可以 move (或 copy) 构造, 不需要赋值 (CHIFlit 的 payload 是引用)
+*/
+template<typename T>
+class RingQueue
+{
+    public:
+        RingQueue() = default;
+        RingQueue(const RingQueue& other) {Reserve(other.count); for(const auto& element: other) emplace_back(element);}
+        RingQueue(RingQueue&& other) noexcept
+        : storage(std::exchange(other.storage, nullptr))
+        , capacity(std::exchange(other.capacity, 0))
+        , head(std::exchange(other.head, 0))
+        , count(std::exchange(other.count, 0))
+        {}
+        // 逐个重新构造, 不要求 T 可以赋值; 已有容量保留
+        RingQueue& operator=(const RingQueue& other)
+        {
+            if(this != &other)
+            {
+                clear();
+                Reserve(other.count);
+                for(const auto& element: other)
+                    emplace_back(element);
+            }
+            return *this;
+        }
+        RingQueue& operator=(RingQueue&&) = delete;
+        ~RingQueue()
+        {
+            clear();
+            std::allocator<T>().deallocate(storage, capacity);
+        }
+
+        inline bool empty() const {return count == 0;}
+        inline std::size_t size() const {return count;}
+
+        inline T& front() {assert(count); return storage[head];}
+        inline const T& front() const {assert(count); return storage[head];}
+        inline T& back() {assert(count); return storage[Slot(count - 1)];}
+        inline const T& back() const {assert(count); return storage[Slot(count - 1)];}
+        inline T& operator[](std::size_t index) {assert(index < count); return storage[Slot(index)];}
+        inline const T& operator[](std::size_t index) const {assert(index < count); return storage[Slot(index)];}
+
+        template<typename... Args>
+        inline T& emplace_back(Args&&... args)
+        {
+            if(count == capacity)
+                Reserve(capacity ? capacity * 2 : kInitialCapacity);
+            T* element = ::new (static_cast<void*>(storage + Slot(count))) T(std::forward<Args>(args)...);
+            count++;
+            return *element;
+        }
+        inline void push_back(const T& element) {emplace_back(element);}
+        inline void push_back(T&& element) {emplace_back(std::move(element));}
+        inline void pop_front()
+        {
+            assert(count);
+            storage[head].~T();
+            head = (head + 1) & (capacity - 1);
+            count--;
+        }
+        inline void clear()
+        {
+            while(count)
+                pop_front();
+        }
+
+        template<typename Queue, typename Value>
+        class Iterator
+        {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = T;
+                using difference_type = std::ptrdiff_t;
+                using pointer = Value*;
+                using reference = Value&;
+
+                Iterator(Queue* queue, std::size_t index): queue(queue), index(index) {}
+                inline reference operator*() const {return (*queue)[index];}
+                inline pointer operator->() const {return &(*queue)[index];}
+                inline Iterator& operator++() {index++; return *this;}
+                inline bool operator==(const Iterator& other) const {return index == other.index;}
+                inline bool operator!=(const Iterator& other) const {return index != other.index;}
+            private:
+                Queue* queue;
+                std::size_t index;
+        };
+        using iterator = Iterator<RingQueue, T>;
+        using const_iterator = Iterator<const RingQueue, const T>;
+        inline iterator begin() {return iterator(this, 0);}
+        inline iterator end() {return iterator(this, count);}
+        inline const_iterator begin() const {return const_iterator(this, 0);}
+        inline const_iterator end() const {return const_iterator(this, count);}
+
+        // 容量按 2 的幂取整
+        void Reserve(std::size_t min_capacity)
+        {
+            if(min_capacity <= capacity)
+                return;
+            std::size_t new_capacity = kInitialCapacity;
+            while(new_capacity < min_capacity)
+                new_capacity *= 2;
+            T* new_storage = std::allocator<T>().allocate(new_capacity);
+            for(std::size_t i = 0; i < count; i++)
+            {
+                ::new (static_cast<void*>(new_storage + i)) T(std::move(storage[Slot(i)]));
+                storage[Slot(i)].~T();
+            }
+            std::allocator<T>().deallocate(storage, capacity);
+            storage = new_storage;
+            capacity = new_capacity;
+            head = 0;
+        }
+
+    private:
+        static constexpr std::size_t kInitialCapacity = 8;
+        inline std::size_t Slot(std::size_t index) const {return (head + index) & (capacity - 1);}
+
+        T* storage{nullptr};
+        std::size_t capacity{0};
+        std::size_t head{0};
+        std::size_t count{0};
+};
+
+} // dmu
+
+#endif
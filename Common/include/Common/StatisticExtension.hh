@@ -81,6 +81,8 @@ class StatisticExtension: public tlm::tlm_extension<StatisticExtension>
         inline unsigned GetTransactionId() const { return transaction_id; }
         inline const DecodedAddress& GetDecodedAddress() const { return m_decoded_address; }
         inline void RecordTransactionId(unsigned id) { transaction_id = id; }
+        // ExtensionPool 回收时调用, 清空记录但保留 m_cmd_time_vec 的容量
+        void Reset();
 
 
         // 添加打印统计信息到指定文件的功能
@@ -0,0 +1,95 @@
+#ifndef __TRACE_FORMAT_HH__
+#define __TRACE_FORMAT_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace dmu{
+    namespace trace{
+
+// 二进制 trace 文件格式, 由 TraceLog 写出, 由 dmu_trace_decode 离线解析
+// 不依赖 SystemC, decoder 只需要包含这个头文件
+//
+// File   := Header Block*
+// Header := magic[8] "DMUTRACE" | u32 version
+// Block  := u8 BlockType | payload
+//   String     : u32 id | u16 len | char[len]            (fmt / name 字符串表)
+//   Resolution : u64 time resolution in fs                (sc_time value 的单位)
+//   Records    : u32 thread ordinal | u32 len | Record*  (一个 ring buffer drain 出来的数据)
+// Record := u16 size | u8 level | u8 nargs | u32 category | u32 name_id | u32 fmt_id | u64 time_value | Arg*
+// Arg    := u8 ArgTag | payload (i64 / u64 / f64 / u16 len + char[len])
+//
+// 所有整数都是 little-endian host order, 文件只在同一类机器上解析
+
+constexpr char kTraceMagic[8] = {'D','M','U','T','R','A','C','E'};
+constexpr uint32_t kTraceVersion = 1;
+
+enum class BlockType : uint8_t
+{
+    String = 1,
+    Resolution = 2,
+    Records = 3,
+};
+
+enum class ArgTag : uint8_t
+{
+    I64 = 0,
+    U64 = 1,
+    F64 = 2,
+    Str = 3,
+};
+
+enum class Level : uint8_t
+{
+    INFO = 0,
+    WARNING = 1,
+};
+
+constexpr size_t kRecordHeaderSize = 2 + 1 + 1 + 4 + 4 + 4 + 8;
+constexpr size_t kMaxRecordSize = 1024;
+constexpr size_t kMaxStrArgSize = 255;
+
+// debug category, 每个 category 占一个 bit, CommonDefine.hh 中的 debug flag 就是这些 bit
+enum Category : uint32_t
+{
+    kPort               = 1u << 0,
+    kTopDebug           = 1u << 1,
+    kWrCam              = 1u << 2,
+    kRdCam              = 1u << 3,
+    kBankSlice          = 1u << 4,
+    kBankSliceManager   = 1u << 5,
+    kCmdSelect          = 1u << 6,
+    kModeSwitch         = 1u << 7,
+    kTimeConstraint     = 1u << 8,
+    kDevice             = 1u << 9,
+    kMemoryController   = 1u << 10,
+    kNtt                = 1u << 11,
+    kPhyDelayModel      = 1u << 12,
+    kUif                = 1u << 13,
+    kNumOfCategories    = 14,
+    kAllCategories      = (1u << 14) - 1,
+};
+
+// 与 Category 的 bit 顺序一一对应, DMU_TRACE 环境变量和 decoder 都使用这些名字
+constexpr const char* kCategoryNames[kNumOfCategories] = {
+    "PORT",
+    "TOP_DEBUG",
+    "WR_CAM",
+    "RD_CAM",
+    "BANK_SLICE",
+    "BANK_SLICE_MANAGER",
+    "CMD_SELECT",
+    "MODE_SWITCH",
+    "TIME_CONSTRAINT",
+    "DEVICE",
+    "MEMORY_CONTROLLER",
+    "NTT",
+    "PHY_DELAY_MODEL",
+    "UIF",
+};
+
+    } // trace
+} // dmu
+
+#endif
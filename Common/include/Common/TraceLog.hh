@@ -0,0 +1,194 @@
+#ifndef __TRACE_LOG_HH__
+#define __TRACE_LOG_HH__
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#include <systemc>
+
+#include "Common/TraceFormat.hh"
+
+namespace dmu{
+    namespace trace{
+
+// 单生产者/单消费者的字节 ring buffer, 生产者(仿真线程)写入时不加锁
+// 消费者(Drain)在 TraceLog 的 sink 锁内执行, 把数据写到二进制文件
+class TraceRing
+{
+public:
+    explicit TraceRing(size_t capacity_pow2);
+    ~TraceRing();
+    TraceRing(const TraceRing&) = delete;
+    TraceRing& operator=(const TraceRing&) = delete;
+
+    // 空间不足时先同步 drain, 只有 ring 满的时候才会碰到 sink 锁
+    void Push(const uint8_t* data, size_t len);
+    // 把 [tail, head) 之间的数据交给 sink
+    void Drain();
+
+    uint32_t GetThreadOrdinal() const {return thread_ordinal;}
+
+private:
+    std::unique_ptr<uint8_t[]> buffer;
+    const size_t capacity;
+    const size_t mask;
+    std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> tail{0};
+    const uint32_t thread_ordinal;
+};
+
+// 记录编码器, 把 DPRINT 的参数按原始二进制编码, 不做任何格式化
+class RecordEncoder
+{
+public:
+    RecordEncoder(uint32_t category, Level level, uint32_t name_id, uint32_t fmt_id, uint64_t time_value)
+    {
+        pos = kRecordHeaderSize;
+        buf[2] = static_cast<uint8_t>(level);
+        buf[3] = 0;
+        std::memcpy(buf + 4, &category, 4);
+        std::memcpy(buf + 8, &name_id, 4);
+        std::memcpy(buf + 12, &fmt_id, 4);
+        std::memcpy(buf + 16, &time_value, 8);
+    }
+
+    template<typename T>
+    void Put(const T& value)
+    {
+        using DT = std::decay_t<T>;
+        if constexpr (std::is_same_v<DT, const char*> || std::is_same_v<DT, char*>)
+        {
+            PutStr(value, value == nullptr ? 0 : std::strlen(value));
+        }
+        else if constexpr (std::is_same_v<DT, std::string>)
+        {
+            PutStr(value.data(), value.size());
+        }
+        else if constexpr (std::is_floating_point_v<DT>)
+        {
+            PutScalar(ArgTag::F64, static_cast<double>(value));
+        }
+        else if constexpr (std::is_enum_v<DT>)
+        {
+            PutScalar(ArgTag::I64, static_cast<int64_t>(value));
+        }
+        else if constexpr (std::is_integral_v<DT> && std::is_signed_v<DT>)
+        {
+            PutScalar(ArgTag::I64, static_cast<int64_t>(value));
+        }
+        else if constexpr (std::is_integral_v<DT>)
+        {
+            PutScalar(ArgTag::U64, static_cast<uint64_t>(value));
+        }
+        else if constexpr (std::is_pointer_v<DT>)
+        {
+            PutScalar(ArgTag::U64, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(value)));
+        }
+        else
+        {
+            static_assert(std::is_pointer_v<DT>, "unsupported DPRINT argument type");
+        }
+    }
+
+    const uint8_t* Finish(size_t& len)
+    {
+        uint16_t size = static_cast<uint16_t>(pos);
+        std::memcpy(buf, &size, 2);
+        len = pos;
+        return buf;
+    }
+
+private:
+    template<typename V>
+    void PutScalar(ArgTag tag, V value)
+    {
+        if(pos + 1 + sizeof(V) > kMaxRecordSize)
+        {
+            return;
+        }
+        buf[pos++] = static_cast<uint8_t>(tag);
+        std::memcpy(buf + pos, &value, sizeof(V));
+        pos += sizeof(V);
+        buf[3]++;
+    }
+
+    void PutStr(const char* str, size_t len)
+    {
+        len = std::min(len, kMaxStrArgSize);
+        if(pos + 3 + len > kMaxRecordSize)
+        {
+            len = (pos + 3 < kMaxRecordSize) ? kMaxRecordSize - pos - 3 : 0;
+            if(pos + 3 > kMaxRecordSize)
+            {
+                return;
+            }
+        }
+        uint16_t str_len = static_cast<uint16_t>(len);
+        buf[pos++] = static_cast<uint8_t>(ArgTag::Str);
+        std::memcpy(buf + pos, &str_len, 2);
+        pos += 2;
+        if(len != 0)
+        {
+            std::memcpy(buf + pos, str, len);
+        }
+        pos += len;
+        buf[3]++;
+    }
+
+    uint8_t buf[kMaxRecordSize];
+    size_t pos;
+};
+
+// 全局 trace 控制:
+//   runtime mask  : 每个 category 一个 bit, 运行时可改 (环境变量 DMU_TRACE 或 SetMask)
+//   compile mask  : DMU_TRACE_COMPILE_MASK, 不在其中的 category 会被编译器整个删掉
+//   binary sink   : 打开后 DPRINT 只把参数写进 thread local ring buffer, 由 dmu_trace_decode 离线格式化
+//                   (环境变量 DMU_TRACE_FILE 或 OpenBinary)
+// 未打开 binary sink 时保持原来的 SC_REPORT 文本输出
+class TraceLog
+{
+public:
+    static uint32_t RuntimeMask() {return runtime_mask.load(std::memory_order_relaxed);}
+    static void SetMask(uint32_t mask) {runtime_mask.store(mask, std::memory_order_relaxed);}
+    // 解析 "all" / "none" / "0x..." / "MEMORY_CONTROLLER,NTT" 格式的 mask
+    static uint32_t ParseMask(const std::string& spec);
+
+    static bool IsBinary() {return binary_enable.load(std::memory_order_relaxed);}
+    static bool OpenBinary(const std::string& path);
+    static void Close();
+    // drain 所有 ring buffer 并 flush 文件
+    static void Flush();
+
+    // fmt 与 name 共用一张字符串表, 按指针缓存, 同一个调用点只做一次
+    static uint32_t InternString(const char* str);
+
+    template<typename... Args>
+    static void Record(uint32_t category, Level level, const char* name, uint32_t fmt_id, const Args&... args)
+    {
+        RecordEncoder encoder(category, level, InternString(name), fmt_id, sc_core::sc_time_stamp().value());
+        (encoder.Put(args), ...);
+        size_t len = 0;
+        const uint8_t* data = encoder.Finish(len);
+        GetThreadRing().Push(data, len);
+    }
+
+    static void WriteRecords(uint32_t thread_ordinal, const uint8_t* first, size_t first_len,
+                             const uint8_t* second, size_t second_len);
+    static uint32_t AllocateThreadOrdinal();
+
+private:
+    static TraceRing& GetThreadRing();
+
+    static std::atomic<uint32_t> runtime_mask;
+    static std::atomic<bool> binary_enable;
+};
+
+    } // trace
+} // dmu
+
+#endif
@@ -15,6 +15,8 @@ struct UifInfo{
     bool is_rmw{false};
     bool is_burst_chop{false};
     unsigned cmd_id{0}; // for rd or wr transaction
+    unsigned data_bytes{0}; // 请求的字节数, payload 的 data_length 中是 CHI size 编码
+    unsigned src_id{0}; // CHI 请求的 srcid, 只用于统计
     sc_core::sc_time expired_time{sc_core::sc_max_time()};
     Qos qos{0,true};
     CmdType cmd_type{CmdType::Invalid};
@@ -46,6 +48,7 @@ class UifSideBandExtension: public tlm::tlm_extension<UifSideBandExtension>
 {
 
 public:
+    UifSideBandExtension() = default;
     explicit UifSideBandExtension(const UifSideBandInfo& uif_side_band_info)
     : _uif_side_band_info(uif_side_band_info)
     {
@@ -62,6 +65,9 @@ public:
         ;
     }
 
+    // ExtensionPool 回收时调用
+    void Reset() { _uif_side_band_info = UifSideBandInfo(); }
+
 public:
     UifSideBandInfo _uif_side_band_info;
 };
@@ -70,6 +76,7 @@ class UifExtension: public tlm::tlm_extension<UifExtension>
 {
 
 public:
+    UifExtension() = default;
     explicit UifExtension(const UifInfo& uif_info)
     : _uif_info(uif_info)
     {
@@ -95,6 +102,9 @@ public:
     {
         _uif_info.wr_cam_index = index;
     }
+
+    // ExtensionPool 回收时调用
+    void Reset() { _uif_info = UifInfo(); }
 public:
     UifInfo _uif_info;
 };
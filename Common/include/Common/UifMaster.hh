@@ -327,7 +327,7 @@ class UifMaster: public sc_core::sc_module
             }
             else
             {
-                DPRINT_FATAL(TOP_DEBUG,name(),"Traffic type is not supported");
+                DPRINT_FATAL(name(),"Traffic type is not supported");
             }
         }
 
@@ -391,17 +391,17 @@ class UifMaster: public sc_core::sc_module
                 auto uif_sideband_info = trans.get_extension<dmu::UifSideBandExtension>()->_uif_side_band_info;
                 if(uif_sideband_info.lpr_credit_valid)
                 {
-                    DPRINT_INFO(true, "Uif Credit Channel", "Receive Lpr Credit");
+                    DPRINT_INFO(UIF, "Uif Credit Channel", "Receive Lpr Credit");
                     lpr_queue.ReceiveCredit();
                 }
                 if(uif_sideband_info.hpr_credit_valid)
                 {
-                    DPRINT_INFO(true, "Uif Credit Channel", "Receive Hpr Credit");
+                    DPRINT_INFO(UIF, "Uif Credit Channel", "Receive Hpr Credit");
                     hpr_queue.ReceiveCredit();
                 }
                 if(uif_sideband_info.tpw_credit_valid)
                 {
-                    DPRINT_INFO(true, "Uif Credit Channel", "Receive Tpw Credit");
+                    DPRINT_INFO(UIF, "Uif Credit Channel", "Receive Tpw Credit");
                     tpw_queue.ReceiveCredit();
                 }
             }
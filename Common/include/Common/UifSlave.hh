@@ -24,7 +24,6 @@ public:
     // 定义目标socket
     tlm_utils::simple_target_socket<UifSlave> target_socket;
     sc_core::sc_in<bool> dfi_clk;
-    bool UIF_SLAVE_FLAG = true;
     sc_core::sc_event_queue pop_request;
     const sc_core::sc_time cycle;
 
@@ -64,10 +63,19 @@ public:
                                        sc_core::sc_time& delay)
     {
         // std::cout << "UIF Slave" << ": " << "call the nb_transport_fw() function" << std::endl;
-        peq_callback.notify(trans, phase, delay);
+        Notify(trans, phase, delay);
         return tlm::TLM_ACCEPTED;
     }
 
+    // payload 在 event queue 中时持有一个引用, pipline_process 处理完后 release
+    // 另外从 UIF_REQ 到 UIF_RDAT_END / WR_RESPONSE_COMPLETE 持有一个引用: 写数据传完后 upstream 就 release 了, payload 还在 tpw_queue 中
+    void Notify(tlm::tlm_generic_payload& trans, const tlm::tlm_phase& phase, const sc_core::sc_time& delay)
+    {
+        if(trans.has_mm())
+            trans.acquire();
+        peq_callback.notify(trans, phase, delay);
+    }
+
     void Send_Credit()// send UIF credit to upstream
     {
         auto credit_ext = credit_trans->get_extension<UifSideBandExtension>();
@@ -104,7 +112,7 @@ public:
         {
             tlm::tlm_phase phase = UIF_CREDIT;
             sc_core::sc_time delay = sc_core::SC_ZERO_TIME;
-            DPRINT_INFO(UIF_SLAVE_FLAG, "UifSlave", "send credit to upstream");
+            DPRINT_INFO(UIF, "UifSlave", "send credit to upstream");
             target_socket->nb_transport_bw(*credit_trans, phase, delay);
         }
     }
@@ -123,14 +131,14 @@ public:
                         tlm::tlm_generic_payload* trans = hpr_queue.front();
                         hpr_queue.pop_front();
                         arbit = index;
-                        peq_callback.notify(*trans, UIF_RDAT_BEGIN,15*cycle);
+                        Notify(*trans, UIF_RDAT_BEGIN,15*cycle);
                         if(trans->get_data_length() > 32)
                         {
-                            peq_callback.notify(*trans, UIF_RDAT_END,(15 + 1)*cycle);
+                            Notify(*trans, UIF_RDAT_END,(15 + 1)*cycle);
                         }
                         else
                         {
-                            peq_callback.notify(*trans, UIF_RDAT_END,15 *cycle);
+                            Notify(*trans, UIF_RDAT_END,15 *cycle);
                         }
                         break;
                     }
@@ -143,14 +151,14 @@ public:
                         tlm::tlm_generic_payload* trans = lpr_queue.front();
                         lpr_queue.pop_front();
                         arbit = index;
-                        peq_callback.notify(*trans, UIF_RDAT_BEGIN,15*cycle);
+                        Notify(*trans, UIF_RDAT_BEGIN,15*cycle);
                         if(trans->get_data_length() > 32)
                         {
-                            peq_callback.notify(*trans, UIF_RDAT_END,(15 + 1 )*cycle);
+                            Notify(*trans, UIF_RDAT_END,(15 + 1 )*cycle);
                         }
                         else
                         {
-                            peq_callback.notify(*trans, UIF_RDAT_END,15*cycle);
+                            Notify(*trans, UIF_RDAT_END,15*cycle);
                         }
                         break;
                     }
@@ -163,7 +171,7 @@ public:
                         tlm::tlm_generic_payload* trans = tpw_queue.front();
                         tpw_queue.pop_front();
                         arbit = index;
-                        peq_callback.notify(*trans, WR_RESPONSE_COMPLETE,15*cycle);
+                        Notify(*trans, WR_RESPONSE_COMPLETE,15*cycle);
                         break;
                     }
                     continue;
@@ -176,30 +184,32 @@ public:
     {
         if (phase == UIF_REQ)
         {
+            if(payload.has_mm())
+                payload.acquire();
             auto uif_extension = payload.get_extension<UifExtension>();
             PriorityClass priority_class = uif_extension->GetQosLevel();
             if(priority_class == PriorityClass::HPR)
             {
-                DPRINT_INFO(UIF_SLAVE_FLAG, "UIF Slave", "Get request: HPR, addr: 0x%llx", payload.get_address());
+                DPRINT_INFO(UIF, "UIF Slave", "Get request: HPR, addr: 0x%llx", payload.get_address());
                 hpr_queue.push_back(&payload);
                 m_hpr_credit_send_upstream--;
                 pop_request.notify(10*cycle);
             }
             else if(priority_class == PriorityClass::LPR || priority_class == PriorityClass::GPR)
             {
-                DPRINT_INFO(UIF_SLAVE_FLAG, "UIF Slave", "Get request: LPR or GPR, addr: 0x%llx", payload.get_address());
+                DPRINT_INFO(UIF, "UIF Slave", "Get request: LPR or GPR, addr: 0x%llx", payload.get_address());
                 lpr_queue.push_back(&payload);
                 m_lpr_credit_send_upstream--;
                 pop_request.notify(10*cycle);
             }
             else if(priority_class == PriorityClass::TPW || priority_class == PriorityClass::GPW)
             {
-                DPRINT_INFO(UIF_SLAVE_FLAG, "UIF Slave", "Get request: TPW or GPW, addr: 0x%llx", payload.get_address());
+                DPRINT_INFO(UIF, "UIF Slave", "Get request: TPW or GPW, addr: 0x%llx", payload.get_address());
                 tpw_queue.push_back(&payload);
                 m_tpw_credit_send_upstream--;
                 auto uif_ext = payload.get_extension<UifExtension>();
                 // uif_ext->SetWrDatRequestIndex();
-                peq_callback.notify(payload, UIF_WDAT_REQ, cycle);
+                Notify(payload, UIF_WDAT_REQ, cycle);
                 pop_request.notify(10*cycle);
             }
             else {
@@ -215,12 +225,12 @@ public:
         else if(phase == UIF_WDAT_BEGIN)
         {
             auto uif_extension = payload.get_extension<UifExtension>();
-            DPRINT_INFO(UIF_SLAVE_FLAG, "UIF Slave", "Get write data request: %d", uif_extension->_uif_info.cmd_id);
+            DPRINT_INFO(UIF, "UIF Slave", "Get write data request: %d", uif_extension->_uif_info.cmd_id);
         }
         else if(phase == UIF_WDAT_END)
         {
             auto uif_extension = payload.get_extension<UifExtension>();
-            DPRINT_INFO(UIF_SLAVE_FLAG, "UIF Slave", "Get write data request: %d", uif_extension->_uif_info.cmd_id);
+            DPRINT_INFO(UIF, "UIF Slave", "Get write data request: %d", uif_extension->_uif_info.cmd_id);
         }
         else if(phase == UIF_RDAT_BEGIN)
         {
@@ -233,17 +243,23 @@ public:
             tlm::tlm_phase sending_phase = phase;
             sc_core::sc_time delay = sc_core::SC_ZERO_TIME;
             target_socket->nb_transport_bw(payload, sending_phase, delay);
+            if(payload.has_mm())
+                payload.release();
         }
         else if(phase == WR_RESPONSE_COMPLETE)
         {
             tlm::tlm_phase sending_phase = phase;
             sc_core::sc_time delay = sc_core::SC_ZERO_TIME;
             target_socket->nb_transport_bw(payload, sending_phase, delay);
+            if(payload.has_mm())
+                payload.release();
         }
         else
         {
             DPRINT_FATAL("UifSlave", "Invalid phase: %s", phase.get_name() );
         }
+        if(payload.has_mm())
+            payload.release();
     }
 
 private:
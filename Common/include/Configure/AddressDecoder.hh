@@ -1,6 +1,8 @@
 #ifndef __ADDRESS_DECODER_H__
 #define __ADDRESS_DECODER_H__
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <utility>
 #include <vector>
@@ -107,7 +109,7 @@ struct DecodedAddress
         return cs == comp.cs
             && cid == comp.cid
             && bankgroup == comp.bankgroup
-            && bank == comp.bankgroup
+            && bank == comp.bank
             && row == comp.row
             && column == comp.column;
     }
@@ -116,24 +118,75 @@ struct DecodedAddress
         return !(cs == comp.cs
             && cid == comp.cid
             && bankgroup == comp.bankgroup
-            && bank == comp.bankgroup
+            && bank == comp.bank
             && row == comp.row
             && column == comp.column);
     }
 };
 
 
+/*
+decodeAddress 不再逐 bit 遍历 vXxxBits, 构造时把 address mapping 编译成:
+    Lut:  按地址字节查表, 每个字节 256 项, 表项是该字节对各 field 的贡献, 所有 field 按 field 顺序 pack 在一个 64-bit word 里
+    Pext: 每个 field 一个地址 mask, 用 BMI2 _pext_u64 直接取出, 要求 field 的地址 bit 递增排列 (否则取出的 bit 顺序不对)
+CPU 支持 BMI2 且 mapping 满足条件时默认用 Pext, 否则用 Lut; 环境变量 DMU_ADDR_DECODE=lut 强制使用 Lut
+
+bank_hash_enable 时, field 取出后再按 AddressMapping 的 bank hash 配置把 row bit xor 进 bankgroup/bank/cid,
+DecodedAddress 中的 bankgroup/bank/cid 及 real_xx 都是 hash 之后 (device 看到) 的值.
+hash 只依赖 row, 是线性的, 可以预先算成 row 按字节查表的 xor 值; encodeAddress 先用同一个 xor 还原再拼地址
+*/
 class AddressDecoder{
 public:
+    enum class DecodeMethod {Lut, Pext};
+
     // explicit AddressDecoder(const AddressMapping& address_mapping);
     // AddressDecoder(const AddressMapping& address_mapping,const Controller::DDR5MemSpec3ds& mem_spec);
     AddressDecoder(const AddressMapping& address_mapping,const Controller::DDR5MemSpec3ds& mem_spec, bool bank_hash_enable);
     DecodedAddress decodeAddress(uint64_t encAddr) const;
+    // 批量译码 count 个地址到 decAddrs, 供 trace 预处理使用, 译码方式的分支提到循环外
+    void decodeBatch(const uint64_t* encAddrs, std::size_t count, DecodedAddress* decAddrs) const;
     unsigned decodeChannel(uint64_t encAddr) const;
     uint64_t encodeAddress(const DecodedAddress& decodedAddress) const;
     void print() const;
 
+    // Pext 不可用时返回 false, 译码方式保持不变
+    bool setDecodeMethod(DecodeMethod method);
+    inline DecodeMethod getDecodeMethod() const { return decodeMethod; }
+    inline bool isPextAvailable() const { return pextAvailable; }
+    inline uint64_t getMaximumAddress() const { return maximumAddress; }
+    // CHANNEL_BIT 译出的 channel 数, 大于 1 时 DramManagerUnit 每个 sub-channel 一套 controller / device
+    inline unsigned getNumOfChannels() const { return 1u << vChannelBits.size(); }
+    inline bool isBankHashEnabled() const { return hashEnabled; }
+    inline BankHashMode getBankHashMode() const { return hashEnabled ? bankHashMode : BankHashMode::None; }
+
 private:
+    // field 顺序与 fieldBits() / kFieldMember 一致
+    enum Field : unsigned {Channel, Cs, Cid, BankGroup, Bank, Row, Column, Byte, NumOfFields};
+    struct FieldLayout
+    {
+        unsigned offset = 0;  // 在 Lut packed word 中的起始 bit
+        unsigned width = 0;
+    };
+
+    std::array<const std::vector<unsigned>*, NumOfFields> fieldBits() const;
+    void compileMapping();
+    void compileBankHash(const AddressMapping& address_mapping);
+    void applyBankHash(DecodedAddress& decAddr) const;
+    void decodeFieldsLut(uint64_t encAddr, DecodedAddress& decAddr) const;
+    void decodeFieldsPext(uint64_t encAddr, DecodedAddress& decAddr) const;
+    void checkRange(uint64_t encAddr) const;
+    void fillRealAddress(DecodedAddress& decAddr) const;
+
+    std::array<FieldLayout, NumOfFields> fieldLayout;
+    std::array<uint64_t, NumOfFields> fieldMask{}; // 每个 field 占用的地址 bit, Pext 使用
+    std::vector<std::array<uint64_t, 256>> byteLut; // (地址字节, 字节值) -> packed fields
+    bool pextAvailable = false;
+    DecodeMethod decodeMethod = DecodeMethod::Lut;
+
+    bool hashEnabled = false;
+    BankHashMode bankHashMode = BankHashMode::None;
+    std::vector<std::array<uint32_t, 256>> hashLut; // (row 字节, 字节值) -> bank | bankgroup << nBa | cid << (nBa + nBg) 的 xor 值
+
     unsigned banksPerGroup;
     unsigned bankgroupsPerCid;
     unsigned bankgroupsPerCs;
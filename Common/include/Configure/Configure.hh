@@ -29,10 +29,12 @@ namespace dmu
                 mem_spec          = std::make_unique<Controller::DDR5MemSpec3ds>(loader.load_mem_spec->mem_spec, output_dir);
                 controller_config = std::make_unique<Controller::McConfig>(loader.load_controller_config->controller_config);
                 address_decoder   = std::make_unique<AddressDecoder>(loader.load_address_map->address_mapping,*mem_spec.get(),controller_config->BANK_HASH_ENABLE);
+                config_hash       = loader.GetConfigHash();
             }
             std::unique_ptr<Controller::DDR5MemSpec3ds> mem_spec;
             std::unique_ptr<AddressDecoder> address_decoder;
             std::unique_ptr<Controller::McConfig> controller_config;
+            uint64_t config_hash{0}; // 配置文件内容的 hash, 写在 DfiTrace.bin 的 header 中
 
     };
 
@@ -7,6 +7,7 @@
 
 #include <systemc>
 
+#include "Common/Common.hh"
 #include "Configure/LoadMemSpec.hh"
 
 namespace dmu{
@@ -45,6 +46,12 @@ static uint64_t Tranform2McClk(uint64_t ddr_clk, unsigned freq_ratio)
     return static_cast<uint64_t>(std::ceil(result));
 }
 
+// MC clock domain timing in tick(number of tCK_mc), the timing must be multiple of tCK_mc
+static Tick ToMcTick(const sc_core::sc_time& mc_timing, const sc_core::sc_time& tck_mc)
+{
+    assert(mc_timing.value() % tck_mc.value() == 0);
+    return mc_timing.value() / tck_mc.value();
+}
 
 enum class RefModeTypeDDR5{
     Normal,
@@ -140,6 +147,13 @@ public:
     const sc_core::sc_time tCL_mc;
     const sc_core::sc_time tCWL_mc;
 
+    // MC clock domain in tick, used by the controller core
+    const Tick nRCD_mc;
+    const Tick nRASmin_mc;
+    const Tick nRP_mc;
+    const Tick nCL_mc;
+    const Tick nCWL_mc;
+
 protected:
 
     DDR5MemSpec(const DDR5MemConfig& mem_spec_base);
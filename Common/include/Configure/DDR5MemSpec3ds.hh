@@ -128,6 +128,55 @@ namespace dmu{
         sc_core::sc_time tRFC_dlr_mc;
         sc_core::sc_time tRFC_dpr_mc;
 
+        // MC clock domain in tick, used by the controller core
+        const Tick      nCCD_L_slr_mc;
+        const Tick      nCCD_L_WR_slr_mc;
+        const Tick      nCCD_L_WR2_slr_mc;
+        const Tick      nCCD_L_RTW_slr_mc;
+        const Tick      nCCD_L_WTR_slr_mc;
+        const Tick      nCCD_M_slr_mc;
+        const Tick      nCCD_M_WR_slr_mc;
+        const Tick      nCCD_M_WTR_slr_mc;
+        const Tick      nCCD_S_slr_mc;
+        const Tick      nCCD_S_WR_slr_mc;
+        const Tick      nCCD_S_RTW_slr_mc;
+        const Tick      nCCD_S_WTR_slr_mc;
+        const Tick      nCCD_WTRA_slr_mc;
+        const Tick      nRRD_L_slr_mc;
+        const Tick      nRRD_S_slr_mc;
+        const Tick      nFAW_slr_mc;
+        const Tick      nRTP_slr_mc;
+        const Tick      nPPD_slr_mc;
+        const Tick      nWR_slr_mc;
+        const Tick      nCCD_dlr_mc;
+        const Tick      nCCD_WR_dlr_mc;
+        const Tick      nCCD_RTW_dlr_mc;
+        const Tick      nCCD_WTR_dlr_mc;
+        const Tick      nRRD_dlr_mc;
+        const Tick      nFAW_dlr_mc;
+        const Tick      nPPD_dlr_mc;
+        const Tick      nCCD_WR_dpr_mc;
+        const Tick      nDCAW_mc;
+        const Tick      nBurst_mc;
+        const Tick      nREFI1_mc;
+        const Tick      nREFI2_mc;
+        const Tick      nRFC1_slr_mc;
+        const Tick      nRFC2_slr_mc;
+        const Tick      nRFCsb_slr_mc;
+        const Tick      nRFC1_dlr_mc;
+        const Tick      nRFC1_dpr_mc;
+        const Tick      nRFC2_dlr_mc;
+        const Tick      nRFC2_dpr_mc;
+        const Tick      nRFCsb_dlr_mc;
+        const Tick      nREFSBRD_slr_mc;
+        const Tick      nREFSBRD_dlr_mc;
+        const Tick      nREFABRD_dlr_mc;
+
+        Tick nREFI_mc;
+        Tick nRFC_slr_mc;
+        Tick nRFC_dlr_mc;
+        Tick nRFC_dpr_mc;
+
         explicit DDR5MemSpec3ds(const DDR5MemConfig& mem_spec, const std::string& output_dir);
 
     };
@@ -17,6 +17,10 @@
 #include "Configure/LoadConfigFromJson.hh"
 namespace dmu{
 
+// bank hash 的方式: Xor 把 row hash bit 逐位 (超出 target 宽度时折叠) xor 进 target bit,
+// Poly 把 row hash bit 看作 GF(2) 多项式, 对 target 宽度的本原多项式取模后 xor 进 target bit (PAE 风格)
+enum class BankHashMode {None, Xor, Poly};
+
 struct AddressMapping
 {
     static constexpr std::string_view SUB_DIR = "addressmapping";
@@ -26,7 +30,6 @@ struct AddressMapping
     */
     // std::vector<unsigned> vBaMaskBits;
     // std::vector<unsigned> vCidMaskBits;
-    // std::vector<unsigned> vRowHashBits;
     // std::vector<unsigned> vAddrMaskBits;
 
     std::vector<unsigned> vChannelBits;
@@ -38,6 +41,15 @@ struct AddressMapping
     std::vector<unsigned> vColumnBits;
     std::vector<unsigned> vByteBits;
 
+    /* bank hash, 只在 controller config 的 BANK_HASH_ENABLE 打开时生效
+    hash 源只能是 row bit, row 本身不被修改, 所以 hash 可以用同样的 xor 还原, encodeAddress 总是可逆
+    target bit 按 bankgroup, bank, cid 的顺序排列 (只包含打开的 field)
+    */
+    BankHashMode bankHashMode = BankHashMode::Xor; // 没有 BANK_HASH 配置时, BANK_HASH_ENABLE 默认用 Xor
+    std::vector<unsigned> vRowHashBits; // 为空时取最低的 target 宽度个 row bit
+    bool hashBankGroup = true;
+    bool hashBank = true;
+    bool hashCid = false;
 };
 
 class AddressMapConfig: public LoadConfigFromJson
@@ -136,6 +148,61 @@ class AddressMapConfig: public LoadConfigFromJson
                         }
                     }
                 }
+
+                /*
+                "BANK_HASH": {
+                    "MODE": "xor",                      // none / xor / poly
+                    "ROW_HASH_BIT": [19, 20, 21, 22, 23],
+                    "TARGET": ["BANKGROUP", "BANK"]     // BANKGROUP / BANK / CID
+                }
+                */
+                if(AddressMapping.HasMember("BANK_HASH") && AddressMapping["BANK_HASH"].IsObject())
+                {
+                    const rapidjson::Value& bank_hash = AddressMapping["BANK_HASH"];
+                    if(bank_hash.HasMember("MODE") && bank_hash["MODE"].IsString())
+                    {
+                        std::string mode = bank_hash["MODE"].GetString();
+                        if(mode == "none")
+                            address_mapping.bankHashMode = BankHashMode::None;
+                        else if(mode == "xor")
+                            address_mapping.bankHashMode = BankHashMode::Xor;
+                        else if(mode == "poly")
+                            address_mapping.bankHashMode = BankHashMode::Poly;
+                        else{
+                            std::cerr<< "Unknown BANK_HASH MODE " << mode << ", expect none/xor/poly" <<std::endl;
+                            std::abort();
+                        }
+                    }
+                    if(bank_hash.HasMember("ROW_HASH_BIT") && bank_hash["ROW_HASH_BIT"].IsArray())
+                    {
+                        const rapidjson::Value& row_hash_bit = bank_hash["ROW_HASH_BIT"];
+                        for (rapidjson::SizeType i = 0; i < row_hash_bit.Size(); ++i) {
+                            if (row_hash_bit[i].IsUint()) {
+                                (address_mapping.vRowHashBits).push_back(row_hash_bit[i].GetUint());
+                            }
+                        }
+                    }
+                    if(bank_hash.HasMember("TARGET") && bank_hash["TARGET"].IsArray())
+                    {
+                        const rapidjson::Value& target = bank_hash["TARGET"];
+                        address_mapping.hashBankGroup = false;
+                        address_mapping.hashBank = false;
+                        address_mapping.hashCid = false;
+                        for (rapidjson::SizeType i = 0; i < target.Size(); ++i) {
+                            std::string field = target[i].IsString() ? target[i].GetString() : "";
+                            if(field == "BANKGROUP")
+                                address_mapping.hashBankGroup = true;
+                            else if(field == "BANK")
+                                address_mapping.hashBank = true;
+                            else if(field == "CID")
+                                address_mapping.hashCid = true;
+                            else{
+                                std::cerr<< "Unknown BANK_HASH TARGET " << field << ", expect BANKGROUP/BANK/CID" <<std::endl;
+                                std::abort();
+                            }
+                        }
+                    }
+                }
             }
             else{
                 std::cerr<< "Address Mapping Json File ont have adress mapping OBJ" <<std::endl;
@@ -63,9 +63,13 @@ class LoadConfigFromJson{
     protected:
         rapidjson::Document doc;
         std::string _filename;
+        uint64_t content_hash{0};
         virtual ~LoadConfigFromJson(){}
 
     public:
+        // 配置文件内容的 FNV-1a hash, 用于标记 trace 等输出文件对应的配置
+        inline uint64_t GetContentHash() const { return content_hash; }
+
         virtual void LoadFromJson(const std::string& filename)
         {
             _filename = filename;
@@ -76,6 +80,12 @@ class LoadConfigFromJson{
             }
 
             std::string buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            content_hash = 14695981039346656037ull;
+            for(unsigned char c: buffer)
+            {
+                content_hash ^= c;
+                content_hash *= 1099511628211ull;
+            }
 
             // rapidjson::Document doc;
             doc.Parse(buffer.c_str());
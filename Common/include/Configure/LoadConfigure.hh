@@ -90,6 +90,19 @@ class LoadConfigure: public LoadConfigFromJson
             load_controller_config->ParseJson();
 
         }
+
+        // 顶层配置文件和 memspec / address map / controller config 文件内容的组合 hash
+        uint64_t GetConfigHash() const
+        {
+            uint64_t hash = GetContentHash();
+            for(const LoadConfigFromJson* loader: {static_cast<const LoadConfigFromJson*>(load_mem_spec.get()),
+                                                   static_cast<const LoadConfigFromJson*>(load_address_map.get()),
+                                                   static_cast<const LoadConfigFromJson*>(load_controller_config.get())})
+            {
+                hash = (hash ^ (loader ? loader->GetContentHash() : 0)) * 1099511628211ull;
+            }
+            return hash;
+        }
 };
 
 } // dmu
@@ -0,0 +1,122 @@
+#include "Common/BackingStore.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace dmu{
+
+BackingStore::~BackingStore()
+{
+    FreeNode(&root, 0);
+}
+
+void
+BackingStore::FreeNode(Node* node, unsigned level)
+{
+    for(void* slot: node->slots)
+    {
+        if(slot == nullptr)
+            continue;
+        if(level + 1 == kNumOfLevels)
+        {
+            delete[] static_cast<uint8_t*>(slot);
+        }
+        else
+        {
+            FreeNode(static_cast<Node*>(slot), level + 1);
+            delete static_cast<Node*>(slot);
+        }
+    }
+}
+
+uint8_t*
+BackingStore::FindPage(uint64_t page_number, bool create)
+{
+    if(page_number == cachedPageNumber)
+        return cachedPage;
+
+    Node* node = &root;
+    for(unsigned level = 0; level < kNumOfLevels; level++)
+    {
+        unsigned index = (page_number >> (kLevelBits * (kNumOfLevels - 1 - level))) & (kFanout - 1);
+        void*& slot = node->slots[index];
+        if(slot == nullptr)
+        {
+            if(!create)
+                return nullptr;
+            if(level + 1 == kNumOfLevels)
+            {
+                slot = new uint8_t[kPageSize]();
+                numOfPages++;
+            }
+            else
+            {
+                slot = new Node();
+                numOfNodes++;
+            }
+        }
+        if(level + 1 == kNumOfLevels)
+        {
+            cachedPageNumber = page_number;
+            cachedPage = static_cast<uint8_t*>(slot);
+            return cachedPage;
+        }
+        node = static_cast<Node*>(slot);
+    }
+    return nullptr;
+}
+
+BackingStore::Span
+BackingStore::GetSpan(uint64_t address, std::size_t length, bool create)
+{
+    assert((address >> kAddressBits) == 0 && "address out of backing store range");
+    std::size_t offset = address & (kPageSize - 1);
+    Span span;
+    span.length = std::min(length, kPageSize - offset);
+    uint8_t* page = FindPage(address >> kPageBits, create);
+    if(page != nullptr)
+        span.data = page + offset;
+    return span;
+}
+
+void
+BackingStore::Write(uint64_t address, const uint8_t* data, std::size_t length,
+                    const uint8_t* byte_enable, std::size_t byte_enable_length)
+{
+    std::size_t done = 0;
+    while(done < length)
+    {
+        Span span = GetSpan(address + done, length - done, true);
+        if(byte_enable == nullptr || byte_enable_length == 0)
+        {
+            std::memcpy(span.data, data + done, span.length);
+        }
+        else
+        {
+            for(std::size_t i = 0; i < span.length; i++)
+            {
+                if(byte_enable[(done + i) % byte_enable_length] == 0xff)
+                    span.data[i] = data[done + i];
+            }
+        }
+        done += span.length;
+    }
+}
+
+void
+BackingStore::Read(uint64_t address, uint8_t* data, std::size_t length)
+{
+    std::size_t done = 0;
+    while(done < length)
+    {
+        Span span = GetSpan(address + done, length - done, false);
+        if(span.data != nullptr)
+            std::memcpy(data + done, span.data, span.length);
+        else
+            std::memset(data + done, 0, span.length);
+        done += span.length;
+    }
+}
+
+} // namespace dmu
@@ -0,0 +1,123 @@
+#include "Common/DfiTraceWriter.hh"
+
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+#include "Common/LzBlock.hh"
+
+namespace dmu{
+    namespace trace{
+
+DfiTraceWriter::~DfiTraceWriter()
+{
+    Close();
+}
+
+bool
+DfiTraceWriter::Open(const std::string& path, const uint64_t time_resolution_fs, const uint64_t config_hash, const bool compress_enable)
+{
+    Close();
+    file = std::fopen(path.c_str(), "wb");
+    if(file == nullptr)
+        return false;
+    DfiTraceHeader header{};
+    std::memcpy(header.magic, kDfiTraceMagic, sizeof(header.magic));
+    header.version = kDfiTraceVersion;
+    header.flags = compress_enable ? kDfiTraceFlagCompressed : 0;
+    header.time_resolution_fs = time_resolution_fs;
+    header.config_hash = config_hash;
+    header.block_size = kDfiTraceBlockSize;
+    header.num_of_records = 0;
+    std::fwrite(&header, sizeof(header), 1, file);
+
+    compress = compress_enable;
+    num_of_records = 0;
+    closing = false;
+    current.reserve(kDfiTraceBlockSize);
+    writer_thread = std::thread(&DfiTraceWriter::WriterThread, this);
+    return true;
+}
+
+void
+DfiTraceWriter::Close()
+{
+    if(file == nullptr)
+        return;
+    if(!current.empty())
+        SubmitCurrent();
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        closing = true;
+    }
+    queue_not_empty.notify_one();
+    writer_thread.join();
+
+    // record 数目在 header 的最后 8 个字节
+    std::fseek(file, offsetof(DfiTraceHeader, num_of_records), SEEK_SET);
+    std::fwrite(&num_of_records, sizeof(num_of_records), 1, file);
+    std::fclose(file);
+    file = nullptr;
+    current.clear();
+    free_blocks.clear();
+}
+
+void
+DfiTraceWriter::SubmitCurrent()
+{
+    std::vector<uint8_t> next;
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        queue_not_full.wait(lock, [this] { return pending_blocks.size() < kMaxPendingBlocks; });
+        pending_blocks.push_back(std::move(current));
+        if(!free_blocks.empty())
+        {
+            next = std::move(free_blocks.back());
+            free_blocks.pop_back();
+        }
+    }
+    queue_not_empty.notify_one();
+    next.clear();
+    next.reserve(kDfiTraceBlockSize);
+    current = std::move(next);
+}
+
+void
+DfiTraceWriter::WriterThread()
+{
+    std::vector<uint8_t> compressed(compress ? kDfiTraceBlockSize : 0);
+    while(true)
+    {
+        std::vector<uint8_t> block;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_not_empty.wait(lock, [this] { return !pending_blocks.empty() || closing; });
+            if(pending_blocks.empty())
+                return;
+            block = std::move(pending_blocks.front());
+            pending_blocks.pop_front();
+        }
+        queue_not_full.notify_one();
+        WriteBlock(block, compressed);
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            free_blocks.push_back(std::move(block));
+        }
+    }
+}
+
+void
+DfiTraceWriter::WriteBlock(const std::vector<uint8_t>& block, std::vector<uint8_t>& compressed)
+{
+    DfiTraceBlockHeader block_header;
+    block_header.raw_size = static_cast<uint32_t>(block.size());
+    const std::size_t compressed_size = compress ? LzCompress(block.data(), block.size(), compressed.data(), compressed.size()) : 0;
+    // 压缩后没有变小时保存原数据, stored size == raw size
+    const uint8_t* data = compressed_size != 0 ? compressed.data() : block.data();
+    block_header.stored_size = static_cast<uint32_t>(compressed_size != 0 ? compressed_size : block.size());
+    std::fwrite(&block_header, sizeof(block_header), 1, file);
+    std::fwrite(data, 1, block_header.stored_size, file);
+}
+
+    } // trace
+} // dmu
@@ -0,0 +1,94 @@
+#include "Common/LatencyHistogram.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace dmu{
+
+// value < kSubBucketCount: index = value
+// 否则取 value 最高的 kSubBucketBits 位, 第 k 个 2 的幂区间 [2^(kSubBucketBits + k - 1), 2^(kSubBucketBits + k))
+// 占 kSubBucketHalf 个 bucket, 每个 bucket 宽 2^k
+unsigned
+LatencyHistogram::GetBucketIndex(const uint64_t value)
+{
+    if(value < kSubBucketCount)
+        return static_cast<unsigned>(value);
+    const unsigned msb = 63 - __builtin_clzll(value);
+    const unsigned shift = msb + 1 - kSubBucketBits;
+    return static_cast<unsigned>(kSubBucketCount + (shift - 1) * kSubBucketHalf + ((value >> shift) - kSubBucketHalf));
+}
+
+uint64_t
+LatencyHistogram::GetBucketUpperBound(const unsigned index)
+{
+    if(index < kSubBucketCount)
+        return index;
+    const unsigned shift = (index - kSubBucketCount) / kSubBucketHalf + 1;
+    const uint64_t sub_bucket = (index - kSubBucketCount) % kSubBucketHalf + kSubBucketHalf;
+    return ((sub_bucket + 1) << shift) - 1;
+}
+
+// 扩到 index 所在 2 的幂区间的下一个区间末尾, 延迟在 2 倍以内波动时 bucket 数组不再扩容
+unsigned
+LatencyHistogram::GetGrowSize(const unsigned index)
+{
+    if(index < kSubBucketCount)
+        return static_cast<unsigned>(kSubBucketCount + kSubBucketHalf);
+    const unsigned range = (index - kSubBucketCount) / kSubBucketHalf;
+    return static_cast<unsigned>(kSubBucketCount + (range + 2) * kSubBucketHalf);
+}
+
+void
+LatencyHistogram::Record(const uint64_t value)
+{
+    const unsigned index = GetBucketIndex(value);
+    if(index >= buckets.size())
+        buckets.resize(GetGrowSize(index), 0);
+    buckets[index]++;
+    count++;
+    sum += value;
+    min = std::min(min, value);
+    max = std::max(max, value);
+}
+
+void
+LatencyHistogram::Merge(const LatencyHistogram& other)
+{
+    if(other.buckets.size() > buckets.size())
+        buckets.resize(other.buckets.size(), 0);
+    for(std::size_t index = 0; index < other.buckets.size(); index++)
+        buckets[index] += other.buckets[index];
+    count += other.count;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+void
+LatencyHistogram::Reset()
+{
+    buckets.clear();
+    count = 0;
+    sum = 0;
+    min = UINT64_MAX;
+    max = 0;
+}
+
+uint64_t
+LatencyHistogram::GetValueAtPercentile(const double percentile) const
+{
+    if(count == 0)
+        return 0;
+    const double clamped = std::min(std::max(percentile, 0.0), 100.0);
+    const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * count)));
+    uint64_t accumulated = 0;
+    for(unsigned index = 0; index < buckets.size(); index++)
+    {
+        accumulated += buckets[index];
+        if(accumulated >= target)
+            return std::min(GetBucketUpperBound(index), max);
+    }
+    return max;
+}
+
+}
@@ -0,0 +1,191 @@
+#include "Common/LatencyStatistics.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+#include "rapidjson/ostreamwrapper.h"
+#include "rapidjson/prettywriter.h"
+
+namespace dmu{
+
+namespace {
+
+using JsonWriter = rapidjson::PrettyWriter<rapidjson::OStreamWrapper>;
+
+constexpr double kPercentiles[] = {50.0, 90.0, 99.0, 99.9};
+constexpr const char* kPercentileNames[] = {"p50", "p90", "p99", "p99.9"};
+
+inline uint64_t
+ToPs(const sc_core::sc_time& time)
+{
+    return time.value() / sc_core::sc_time(1, sc_core::SC_PS).value();
+}
+
+inline double
+ToNs(uint64_t ps)
+{
+    return ps / 1000.0;
+}
+
+void
+WriteHistogram(JsonWriter& writer, const LatencyHistogram& histogram)
+{
+    writer.StartObject();
+    writer.Key("count");
+    writer.Uint64(histogram.GetCount());
+    writer.Key("mean");
+    writer.Double(histogram.GetMean() / 1000.0);
+    writer.Key("min");
+    writer.Double(ToNs(histogram.GetMin()));
+    for(std::size_t i = 0; i < std::size(kPercentiles); i++)
+    {
+        writer.Key(kPercentileNames[i]);
+        writer.Double(ToNs(histogram.GetValueAtPercentile(kPercentiles[i])));
+    }
+    writer.Key("max");
+    writer.Double(ToNs(histogram.GetMax()));
+    writer.EndObject();
+}
+
+bool
+IsEmpty(const LatencyStatistics::StageHistograms& histograms)
+{
+    return std::all_of(histograms.begin(), histograms.end(), [](const LatencyHistogram& histogram) { return histogram.GetCount() == 0; });
+}
+
+// 没有样本的阶段不输出
+void
+WriteStages(JsonWriter& writer, const LatencyStatistics::StageHistograms& histograms)
+{
+    writer.StartObject();
+    for(std::size_t stage = 0; stage < histograms.size(); stage++)
+    {
+        if(histograms[stage].GetCount() == 0)
+            continue;
+        writer.Key(toString(static_cast<LatencyStage>(stage)).c_str());
+        WriteHistogram(writer, histograms[stage]);
+    }
+    writer.EndObject();
+}
+
+} // namespace
+
+void
+LatencyStatistics::Record(const StatisticExtension& statistic, const PriorityClass qos_level, const CmdType cmd_type, const unsigned src_id)
+{
+    StageHistograms& qos_histograms = byQos[std::min(static_cast<std::size_t>(qos_level), byQos.size() - 1)];
+    StageHistograms& opcode_histograms = byOpcode[std::min(static_cast<std::size_t>(cmd_type), byOpcode.size() - 1)];
+    StageHistograms& source_histograms = bySource[src_id];
+    auto record = [&](LatencyStage stage, const sc_core::sc_time& begin, const sc_core::sc_time& end) {
+        // 没有记录的时间 (例如 UIF 直接发给 controller 的请求没有 port 时间) 会使 end < begin, 跳过
+        if(end < begin)
+            return;
+        const uint64_t latency = ToPs(end - begin);
+        const std::size_t index = static_cast<std::size_t>(stage);
+        all[index].Record(latency);
+        qos_histograms[index].Record(latency);
+        opcode_histograms[index].Record(latency);
+        source_histograms[index].Record(latency);
+    };
+
+    record(LatencyStage::EndToEnd, statistic.GetInPortTime(), statistic.GetDfiDataEndTime());
+    record(LatencyStage::PortQueue, statistic.GetInPortTime(), statistic.GetOutPortTime());
+    record(LatencyStage::CamWait, statistic.GetInCamTime(), statistic.GetOutCamTime());
+    record(LatencyStage::Data, statistic.GetDfiDataBeginTime(), statistic.GetDfiDataEndTime());
+
+    // cmd_time_vec 按发送顺序记录 ACT / PRE / CAS
+    const sc_core::sc_time* act_time = nullptr;
+    for(const auto& [time, command]: statistic.GetCmdTimeVec())
+    {
+        if(command == DramCommand::ACT)
+        {
+            act_time = &time;
+        }
+        else if(command == DramCommand::RD || command == DramCommand::RDA || command == DramCommand::WR || command == DramCommand::WRA)
+        {
+            if(act_time != nullptr)
+                record(LatencyStage::ActToCas, *act_time, time);
+            break;
+        }
+    }
+    numOfTransactions++;
+}
+
+void
+LatencyStatistics::Merge(const LatencyStatistics& other)
+{
+    auto merge = [](StageHistograms& histograms, const StageHistograms& other_histograms) {
+        for(std::size_t stage = 0; stage < histograms.size(); stage++)
+            histograms[stage].Merge(other_histograms[stage]);
+    };
+    merge(all, other.all);
+    for(std::size_t qos = 0; qos < byQos.size(); qos++)
+        merge(byQos[qos], other.byQos[qos]);
+    for(std::size_t opcode = 0; opcode < byOpcode.size(); opcode++)
+        merge(byOpcode[opcode], other.byOpcode[opcode]);
+    for(const auto& [src_id, histograms]: other.bySource)
+        merge(bySource[src_id], histograms);
+    numOfTransactions += other.numOfTransactions;
+}
+
+void
+LatencyStatistics::WriteJson(std::ostream& os) const
+{
+    rapidjson::OStreamWrapper stream(os);
+    JsonWriter writer(stream);
+    writer.StartObject();
+    writer.Key("unit");
+    writer.String("ns");
+    writer.Key("transactions");
+    writer.Uint64(numOfTransactions);
+
+    writer.Key("all");
+    WriteStages(writer, all);
+
+    writer.Key("qos");
+    writer.StartObject();
+    for(std::size_t qos = 0; qos < byQos.size(); qos++)
+    {
+        if(IsEmpty(byQos[qos]))
+            continue;
+        writer.Key(toString(static_cast<PriorityClass>(qos)).c_str());
+        WriteStages(writer, byQos[qos]);
+    }
+    writer.EndObject();
+
+    writer.Key("opcode");
+    writer.StartObject();
+    for(std::size_t opcode = 0; opcode < byOpcode.size(); opcode++)
+    {
+        if(IsEmpty(byOpcode[opcode]))
+            continue;
+        writer.Key(toString(static_cast<CmdType>(opcode)).c_str());
+        WriteStages(writer, byOpcode[opcode]);
+    }
+    writer.EndObject();
+
+    writer.Key("src_id");
+    writer.StartObject();
+    for(const auto& [src_id, histograms]: bySource)
+    {
+        writer.Key(std::to_string(src_id).c_str());
+        WriteStages(writer, histograms);
+    }
+    writer.EndObject();
+
+    writer.EndObject();
+    os << std::endl;
+}
+
+bool
+LatencyStatistics::WriteJson(const std::string& filename) const
+{
+    std::ofstream file(filename, std::ios::out | std::ios::trunc);
+    if(!file.is_open())
+        return false;
+    WriteJson(file);
+    return true;
+}
+
+}
@@ -8,7 +8,25 @@ namespace dmu {
 // StatisticExtension构造函数
 StatisticExtension::StatisticExtension()
 {
-    // 默认构造函数实现
+    // 一个 transaction 的命令数 (ACT / RD / WR / PRE ...) 一般不超过这个数, pool 中的 extension 不需要再扩容
+    m_cmd_time_vec.reserve(8);
+}
+
+void StatisticExtension::Reset()
+{
+    transaction_id = 0;
+    m_entering_port_time = sc_core::SC_ZERO_TIME;
+    m_leaving_port_time = sc_core::SC_ZERO_TIME;
+    m_entering_cam_time = sc_core::SC_ZERO_TIME;
+    m_leaveing_cam_time = sc_core::SC_ZERO_TIME;
+    m_cmd_time_vec.clear();
+    m_uif_data_begin_time = sc_core::SC_ZERO_TIME;
+    m_uif_data_end_time = sc_core::SC_ZERO_TIME;
+    m_dfi_data_begin_time = sc_core::SC_ZERO_TIME;
+    m_dfi_data_end_time = sc_core::SC_ZERO_TIME;
+    m_dq_data_begin_time = sc_core::SC_ZERO_TIME;
+    m_dq_data_end_time = sc_core::SC_ZERO_TIME;
+    m_decoded_address = DecodedAddress();
 }
 
 // 将统计信息打印到指定文件
@@ -0,0 +1,336 @@
+#include "Common/TraceLog.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace dmu{
+    namespace trace{
+
+std::atomic<uint32_t> TraceLog::runtime_mask{kAllCategories};
+std::atomic<bool> TraceLog::binary_enable{false};
+
+namespace {
+
+constexpr size_t kThreadRingCapacity = 1u << 20; // 1MB per simulation thread
+
+// sink 的所有状态都由 sink_mutex 保护, 只有 ring drain / 字符串注册 / open close 会用到
+struct TraceSink
+{
+    std::mutex sink_mutex;
+    std::FILE* file{nullptr};
+    bool resolution_written{false};
+    std::vector<std::string> strings;
+    std::unordered_map<const char*, uint32_t> string_ids;
+    std::vector<TraceRing*> rings;
+    uint32_t next_thread_ordinal{0};
+};
+
+TraceSink&
+GetSink()
+{
+    static TraceSink sink;
+    return sink;
+}
+
+void
+WriteStringBlock(std::FILE* file, uint32_t id, const std::string& str)
+{
+    uint8_t type = static_cast<uint8_t>(BlockType::String);
+    uint16_t len = static_cast<uint16_t>(std::min<size_t>(str.size(), UINT16_MAX));
+    std::fwrite(&type, 1, 1, file);
+    std::fwrite(&id, 4, 1, file);
+    std::fwrite(&len, 2, 1, file);
+    std::fwrite(str.data(), 1, len, file);
+}
+
+void
+RegisterRing(TraceRing* ring)
+{
+    auto& sink = GetSink();
+    std::lock_guard<std::mutex> lock(sink.sink_mutex);
+    sink.rings.push_back(ring);
+}
+
+void
+UnregisterRing(TraceRing* ring)
+{
+    auto& sink = GetSink();
+    std::lock_guard<std::mutex> lock(sink.sink_mutex);
+    for(auto it = sink.rings.begin(); it != sink.rings.end(); ++it)
+    {
+        if(*it == ring)
+        {
+            sink.rings.erase(it);
+            break;
+        }
+    }
+}
+
+// 进程启动时从环境变量读取配置, 进程退出时把剩余数据写出
+struct TraceEnvInit
+{
+    TraceEnvInit()
+    {
+        // sink 要先于本对象构造完成, 保证析构时 sink 仍然有效
+        GetSink();
+        if(const char* mask_spec = std::getenv("DMU_TRACE"))
+        {
+            TraceLog::SetMask(TraceLog::ParseMask(mask_spec));
+        }
+        if(const char* path = std::getenv("DMU_TRACE_FILE"))
+        {
+            TraceLog::OpenBinary(path);
+        }
+    }
+    ~TraceEnvInit()
+    {
+        TraceLog::Close();
+    }
+};
+
+TraceEnvInit trace_env_init;
+
+} // namespace
+
+TraceRing::TraceRing(size_t capacity_pow2)
+: buffer(new uint8_t[capacity_pow2])
+, capacity(capacity_pow2)
+, mask(capacity_pow2 - 1)
+, thread_ordinal(TraceLog::AllocateThreadOrdinal())
+{
+    assert((capacity_pow2 & mask) == 0 && "trace ring capacity must be power of 2");
+    RegisterRing(this);
+}
+
+TraceRing::~TraceRing()
+{
+    Drain();
+    UnregisterRing(this);
+}
+
+void
+TraceRing::Push(const uint8_t* data, size_t len)
+{
+    uint64_t cur_head = head.load(std::memory_order_relaxed);
+    if(cur_head + len - tail.load(std::memory_order_acquire) > capacity)
+    {
+        Drain();
+    }
+    size_t offset = cur_head & mask;
+    size_t first = std::min(len, capacity - offset);
+    std::memcpy(buffer.get() + offset, data, first);
+    if(first < len)
+    {
+        std::memcpy(buffer.get(), data + first, len - first);
+    }
+    head.store(cur_head + len, std::memory_order_release);
+}
+
+void
+TraceRing::Drain()
+{
+    uint64_t cur_tail = tail.load(std::memory_order_relaxed);
+    uint64_t cur_head = head.load(std::memory_order_acquire);
+    if(cur_head == cur_tail)
+    {
+        return;
+    }
+    size_t len = cur_head - cur_tail;
+    size_t offset = cur_tail & mask;
+    size_t first = std::min(len, capacity - offset);
+    TraceLog::WriteRecords(thread_ordinal, buffer.get() + offset, first, buffer.get(), len - first);
+    tail.store(cur_head, std::memory_order_release);
+}
+
+uint32_t
+TraceLog::ParseMask(const std::string& spec)
+{
+    if(spec.empty() || spec == "none" || spec == "NONE")
+    {
+        return 0;
+    }
+    if(spec == "all" || spec == "ALL")
+    {
+        return kAllCategories;
+    }
+    if(spec.size() > 2 && spec[0] == '0' && (spec[1] == 'x' || spec[1] == 'X'))
+    {
+        return static_cast<uint32_t>(std::strtoul(spec.c_str(), nullptr, 16));
+    }
+    uint32_t mask = 0;
+    size_t begin = 0;
+    while(begin <= spec.size())
+    {
+        size_t end = spec.find(',', begin);
+        if(end == std::string::npos)
+        {
+            end = spec.size();
+        }
+        std::string name = spec.substr(begin, end - begin);
+        bool found = false;
+        for(unsigned i = 0; i < kNumOfCategories; i++)
+        {
+            if(name == kCategoryNames[i])
+            {
+                mask |= (1u << i);
+                found = true;
+            }
+        }
+        if(!found && !name.empty())
+        {
+            std::cerr << "[TraceLog] unknown trace category: " << name << std::endl;
+        }
+        begin = end + 1;
+    }
+    return mask;
+}
+
+bool
+TraceLog::OpenBinary(const std::string& path)
+{
+    Close();
+    auto& sink = GetSink();
+    std::lock_guard<std::mutex> lock(sink.sink_mutex);
+    sink.file = std::fopen(path.c_str(), "wb");
+    if(sink.file == nullptr)
+    {
+        std::cerr << "[TraceLog] unable to open trace file: " << path << std::endl;
+        return false;
+    }
+    std::fwrite(kTraceMagic, 1, sizeof(kTraceMagic), sink.file);
+    std::fwrite(&kTraceVersion, 4, 1, sink.file);
+    sink.resolution_written = false;
+    // 在打开文件之前已经注册的字符串也要写出
+    for(uint32_t id = 0; id < sink.strings.size(); id++)
+    {
+        WriteStringBlock(sink.file, id, sink.strings[id]);
+    }
+    binary_enable.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void
+TraceLog::Flush()
+{
+    auto& sink = GetSink();
+    std::vector<TraceRing*> rings;
+    {
+        std::lock_guard<std::mutex> lock(sink.sink_mutex);
+        rings = sink.rings;
+    }
+    for(auto ring: rings)
+    {
+        ring->Drain();
+    }
+    std::lock_guard<std::mutex> lock(sink.sink_mutex);
+    if(sink.file != nullptr)
+    {
+        std::fflush(sink.file);
+    }
+}
+
+void
+TraceLog::Close()
+{
+    if(!IsBinary())
+    {
+        return;
+    }
+    Flush();
+    binary_enable.store(false, std::memory_order_relaxed);
+    auto& sink = GetSink();
+    std::lock_guard<std::mutex> lock(sink.sink_mutex);
+    if(sink.file != nullptr)
+    {
+        std::fclose(sink.file);
+        sink.file = nullptr;
+    }
+}
+
+uint32_t
+TraceLog::InternString(const char* str)
+{
+    // 每个线程缓存指针到 id 的映射, 命中时不需要加锁
+    thread_local std::unordered_map<const char*, uint32_t> local_ids;
+    auto it = local_ids.find(str);
+    if(it != local_ids.end())
+    {
+        return it->second;
+    }
+
+    auto& sink = GetSink();
+    std::lock_guard<std::mutex> lock(sink.sink_mutex);
+    uint32_t id;
+    auto global_it = sink.string_ids.find(str);
+    if(global_it != sink.string_ids.end() && sink.strings[global_it->second] == str)
+    {
+        id = global_it->second;
+    }
+    else
+    {
+        id = static_cast<uint32_t>(sink.strings.size());
+        sink.strings.emplace_back(str == nullptr ? "" : str);
+        sink.string_ids[str] = id;
+        if(sink.file != nullptr)
+        {
+            WriteStringBlock(sink.file, id, sink.strings.back());
+        }
+    }
+    local_ids[str] = id;
+    return id;
+}
+
+void
+TraceLog::WriteRecords(uint32_t thread_ordinal, const uint8_t* first, size_t first_len,
+                       const uint8_t* second, size_t second_len)
+{
+    auto& sink = GetSink();
+    std::lock_guard<std::mutex> lock(sink.sink_mutex);
+    if(sink.file == nullptr)
+    {
+        return;
+    }
+    if(!sink.resolution_written)
+    {
+        uint8_t type = static_cast<uint8_t>(BlockType::Resolution);
+        uint64_t resolution_fs = static_cast<uint64_t>(std::llround(sc_core::sc_get_time_resolution().to_seconds() * 1e15));
+        std::fwrite(&type, 1, 1, sink.file);
+        std::fwrite(&resolution_fs, 8, 1, sink.file);
+        sink.resolution_written = true;
+    }
+    uint8_t type = static_cast<uint8_t>(BlockType::Records);
+    uint32_t len = static_cast<uint32_t>(first_len + second_len);
+    std::fwrite(&type, 1, 1, sink.file);
+    std::fwrite(&thread_ordinal, 4, 1, sink.file);
+    std::fwrite(&len, 4, 1, sink.file);
+    std::fwrite(first, 1, first_len, sink.file);
+    if(second_len != 0)
+    {
+        std::fwrite(second, 1, second_len, sink.file);
+    }
+}
+
+uint32_t
+TraceLog::AllocateThreadOrdinal()
+{
+    auto& sink = GetSink();
+    std::lock_guard<std::mutex> lock(sink.sink_mutex);
+    return sink.next_thread_ordinal++;
+}
+
+TraceRing&
+TraceLog::GetThreadRing()
+{
+    thread_local TraceRing ring(kThreadRingCapacity);
+    return ring;
+}
+
+    } // trace
+} // dmu
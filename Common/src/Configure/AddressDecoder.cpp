@@ -1,11 +1,19 @@
+#include <algorithm>
 #include <bitset>
 #include <cmath>
 #include <cstdint>
+#include <cstdlib>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <string>
 #include <systemc>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define DMU_ADDR_DECODE_PEXT 1
+#endif
+
 #include "Configure/AddressDecoder.hh"
 #include "Configure/DDR5MemSpec.hh"
 #include "Configure/DDR5MemSpec3ds.hh"
@@ -13,6 +21,29 @@
 
 namespace dmu{
 
+namespace {
+
+// Field 顺序对应的 DecodedAddress 成员
+constexpr unsigned DecodedAddress::* kFieldMember[] = {
+    &DecodedAddress::channel, &DecodedAddress::cs, &DecodedAddress::cid, &DecodedAddress::bankgroup,
+    &DecodedAddress::bank, &DecodedAddress::row, &DecodedAddress::column, &DecodedAddress::byte
+};
+
+#ifdef DMU_ADDR_DECODE_PEXT
+// 只有这个函数用 BMI2 编译, 调用前由 __builtin_cpu_supports 确认 CPU 支持
+__attribute__((target("bmi2"))) void
+PextFields(uint64_t encAddr, const uint64_t* masks, unsigned* fields, unsigned numOfFields)
+{
+    for (unsigned field = 0; field < numOfFields; field++)
+        fields[field] = static_cast<unsigned>(_pext_u64(encAddr, masks[field]));
+}
+#endif
+
+// GF(2) 本原多项式, 下标为多项式次数 (即 target 宽度), 含最高次项
+constexpr uint32_t kPrimitivePolynomial[] = {0x0, 0x3, 0x7, 0xb, 0x13, 0x25, 0x43, 0x83, 0x11d};
+
+} // namespace
+
 AddressDecoder::
 AddressDecoder(const AddressMapping& address_mapping, const Controller::DDR5MemSpec3ds& mem_spec, bool bank_hash_enable)
 : bank_hash_enable(bank_hash_enable)
@@ -111,10 +142,12 @@ AddressDecoder(const AddressMapping& address_mapping, const Controller::DDR5MemS
 
 
     // 修改为更详细的错误报告，指出具体哪个条件不满足
-    if (mem_spec.NumOfChannels != channels) {
+    // CHANNEL_BIT 可以不配置 (只模拟一个 sub-channel), 或者按 NumOfSubChannels 配置, 由 channel 选择 sub-channel
+    if (mem_spec.NumOfChannels != channels && mem_spec.NumOfSubChannels != channels) {
         SC_REPORT_FATAL("AddressDecoder",
-            ("MemSpec and address mapping do not match: NumOfChannels mismatch. MemSpec: " +
-            std::to_string(mem_spec.NumOfChannels) + ", AddressMapping: " + std::to_string(channels)).c_str());
+            ("MemSpec and address mapping do not match: NumOfChannels / NumOfSubChannels mismatch. MemSpec: " +
+            std::to_string(mem_spec.NumOfChannels) + " / " + std::to_string(mem_spec.NumOfSubChannels) +
+            ", AddressMapping: " + std::to_string(channels)).c_str());
     }
     if (mem_spec.NumOfPhysicalRanksPerChannel != cs) {
         SC_REPORT_FATAL("AddressDecoder",
@@ -150,6 +183,145 @@ AddressDecoder(const AddressMapping& address_mapping, const Controller::DDR5MemS
     //     SC_REPORT_FATAL("AddressDecoder", "MemSpec and address mapping do not match");
     // }
 
+    compileMapping();
+    compileBankHash(address_mapping);
+}
+
+std::array<const std::vector<unsigned>*, AddressDecoder::NumOfFields>
+AddressDecoder::fieldBits() const
+{
+    return {&vChannelBits, &vCsBits, &vCidBits, &vBankGroupBits, &vBankBits, &vRowBits, &vColumnBits, &vByteBits};
+}
+
+void
+AddressDecoder::compileMapping()
+{
+    // field 按 Field 顺序 pack, field 第 it 位放在 offset + it, 与原来逐 bit 译码的结果一致
+    unsigned offset = 0;
+    unsigned highestAddressBit = 0;
+    bool allAscending = true;
+    const auto bits = fieldBits();
+    for (unsigned field = 0; field < NumOfFields; field++)
+    {
+        FieldLayout& layout = fieldLayout[field];
+        layout.offset = offset;
+        layout.width = static_cast<unsigned>(bits[field]->size());
+        for (unsigned it = 0; it < bits[field]->size(); it++)
+        {
+            unsigned bitPosition = (*bits[field])[it];
+            if (bitPosition >= 64)
+                SC_REPORT_FATAL("AddressDecoder", ("Address bit " + std::to_string(bitPosition) + " exceeds 64-bit address").c_str());
+            fieldMask[field] |= UINT64_C(1) << bitPosition;
+            highestAddressBit = std::max(highestAddressBit, bitPosition);
+            if (it > 0 && bitPosition <= (*bits[field])[it - 1])
+                allAscending = false;
+        }
+        offset += layout.width;
+    }
+    if (offset > 64)
+        SC_REPORT_FATAL("AddressDecoder", ("Address mapping has " + std::to_string(offset) + " bits, exceeds 64").c_str());
+
+    byteLut.assign(highestAddressBit / 8 + 1, {});
+    for (unsigned field = 0; field < NumOfFields; field++)
+    {
+        for (unsigned it = 0; it < bits[field]->size(); it++)
+        {
+            unsigned bitPosition = (*bits[field])[it];
+            auto& table = byteLut[bitPosition / 8];
+            uint64_t packedBit = UINT64_C(1) << (fieldLayout[field].offset + it);
+            for (unsigned value = 0; value < 256; value++)
+            {
+                if ((value >> (bitPosition % 8)) & 1)
+                    table[value] |= packedBit;
+            }
+        }
+    }
+
+#ifdef DMU_ADDR_DECODE_PEXT
+    pextAvailable = allAscending && __builtin_cpu_supports("bmi2");
+#else
+    (void)allAscending;
+    pextAvailable = false;
+#endif
+    decodeMethod = pextAvailable ? DecodeMethod::Pext : DecodeMethod::Lut;
+    const char* decodeEnv = std::getenv("DMU_ADDR_DECODE");
+    if (decodeEnv != nullptr && std::string(decodeEnv) == "lut")
+        decodeMethod = DecodeMethod::Lut;
+}
+
+void
+AddressDecoder::compileBankHash(const AddressMapping& address_mapping)
+{
+    vRowHashBits = address_mapping.vRowHashBits;
+    bankHashMode = address_mapping.bankHashMode;
+    hashEnabled = bank_hash_enable && bankHashMode != BankHashMode::None;
+    if (!hashEnabled)
+        return;
+
+    // target bit 按 bankgroup, bank, cid 排列, 记录每个 target bit 在 xor 值中的位置
+    std::vector<unsigned> targetPositions;
+    const unsigned bankgroupOffset = static_cast<unsigned>(vBankBits.size());
+    const unsigned cidOffset = bankgroupOffset + static_cast<unsigned>(vBankGroupBits.size());
+    if (address_mapping.hashBankGroup)
+        for (unsigned it = 0; it < vBankGroupBits.size(); it++)
+            targetPositions.push_back(bankgroupOffset + it);
+    if (address_mapping.hashBank)
+        for (unsigned it = 0; it < vBankBits.size(); it++)
+            targetPositions.push_back(it);
+    if (address_mapping.hashCid)
+        for (unsigned it = 0; it < vCidBits.size(); it++)
+            targetPositions.push_back(cidOffset + it);
+    const unsigned width = static_cast<unsigned>(targetPositions.size());
+    if (width == 0)
+        SC_REPORT_FATAL("AddressDecoder", "Bank hash has no target bit");
+    if (bankHashMode == BankHashMode::Poly && width >= std::size(kPrimitivePolynomial))
+        SC_REPORT_FATAL("AddressDecoder", ("Bank hash poly mode supports at most " +
+            std::to_string(std::size(kPrimitivePolynomial) - 1) + " target bits, got " + std::to_string(width)).c_str());
+
+    if (vRowHashBits.empty())
+        vRowHashBits.assign(vRowBits.begin(), vRowBits.begin() + std::min<std::size_t>(width, vRowBits.size()));
+
+    // 每个 row field bit 对 xor 值的贡献; hash 源必须是 row bit, 否则 hash 会改变自己的输入, 无法还原
+    std::vector<uint32_t> rowContribution(vRowBits.size(), 0);
+    uint32_t power = 1; // Poly: x^j mod P
+    for (unsigned j = 0; j < vRowHashBits.size(); j++)
+    {
+        auto rowBit = std::find(vRowBits.begin(), vRowBits.end(), vRowHashBits[j]);
+        if (rowBit == vRowBits.end())
+            SC_REPORT_FATAL("AddressDecoder", ("Row hash bit " + std::to_string(vRowHashBits[j]) +
+                " is not a row bit, bank hash would not be invertible").c_str());
+
+        uint32_t targetValue = bankHashMode == BankHashMode::Xor ? UINT32_C(1) << (j % width) : power;
+        power <<= 1;
+        if (power & (UINT32_C(1) << width))
+            power ^= kPrimitivePolynomial[width];
+
+        uint32_t contribution = 0;
+        for (unsigned it = 0; it < width; it++)
+            if ((targetValue >> it) & 1)
+                contribution |= UINT32_C(1) << targetPositions[it];
+        rowContribution[rowBit - vRowBits.begin()] ^= contribution;
+    }
+
+    hashLut.assign((vRowBits.size() + 7) / 8, {});
+    for (unsigned rowBit = 0; rowBit < vRowBits.size(); rowBit++)
+    {
+        auto& table = hashLut[rowBit / 8];
+        for (unsigned value = 0; value < 256; value++)
+        {
+            if ((value >> (rowBit % 8)) & 1)
+                table[value] ^= rowContribution[rowBit];
+        }
+    }
+}
+
+bool
+AddressDecoder::setDecodeMethod(DecodeMethod method)
+{
+    if (method == DecodeMethod::Pext && !pextAvailable)
+        return false;
+    decodeMethod = method;
+    return true;
 }
 
 void
@@ -231,11 +403,20 @@ AddressDecoder::print() const
                   << std::endl;
     }
 
+    if (hashEnabled)
+    {
+        std::cout << " Bank hash " << (bankHashMode == BankHashMode::Xor ? "xor" : "poly") << ", row hash bits:";
+        for (auto bitPosition: vRowHashBits)
+            std::cout << " " << bitPosition;
+        std::cout << std::endl;
+    }
+
     std::cout << std::endl;
 }
 
-DecodedAddress
-AddressDecoder::decodeAddress(uint64_t encAddr) const
+// 以下 inline helper 只在本文件内使用, 声明为 inline 让编译器在 -fPIC 下也能内联进 decodeAddress / decodeBatch
+inline void
+AddressDecoder::checkRange(uint64_t encAddr) const
 {
     if(encAddr > maximumAddress)
     {
@@ -243,32 +424,53 @@ AddressDecoder::decodeAddress(uint64_t encAddr) const
                         ("Address " + std::to_string(encAddr) + " out of range (maximum addrss is " + std::to_string(maximumAddress) + ")"
                         ).c_str());
     }
-    DecodedAddress decAddr;
-
-    for (unsigned it = 0; it < vChannelBits.size(); it++)
-        decAddr.channel |= ((encAddr >> vChannelBits[it]) & UINT64_C(1)) << it;
-
-    for (unsigned it = 0; it < vCsBits.size(); it++)
-        decAddr.cs |= ((encAddr >> vCsBits[it]) & UINT64_C(1)) << it;
-
-    for (unsigned it = 0; it < vCidBits.size(); it++)
-        decAddr.cid |= ((encAddr >> vCidBits[it]) & UINT64_C(1)) << it;
-
-    for (unsigned it = 0; it < vBankGroupBits.size(); it++)
-        decAddr.bankgroup |= ((encAddr >> vBankGroupBits[it]) & UINT64_C(1)) << it;
+}
 
-    for (unsigned it = 0; it < vBankBits.size(); it++)
-        decAddr.bank |= ((encAddr >> vBankBits[it]) & UINT64_C(1)) << it;
+inline void
+AddressDecoder::decodeFieldsLut(uint64_t encAddr, DecodedAddress& decAddr) const
+{
+    uint64_t packed = 0;
+    for (unsigned byteIndex = 0; byteIndex < byteLut.size(); byteIndex++)
+        packed |= byteLut[byteIndex][(encAddr >> (byteIndex * 8)) & 0xff];
 
-    for (unsigned it = 0; it < vRowBits.size(); it++)
-        decAddr.row |= ((encAddr >> vRowBits[it]) & UINT64_C(1)) << it;
+    for (unsigned field = 0; field < NumOfFields; field++)
+    {
+        const FieldLayout& layout = fieldLayout[field];
+        uint64_t fieldMask = layout.width == 64 ? ~UINT64_C(0) : (UINT64_C(1) << layout.width) - 1;
+        decAddr.*kFieldMember[field] = static_cast<unsigned>((packed >> layout.offset) & fieldMask);
+    }
+}
 
-    for (unsigned it = 0; it < vColumnBits.size(); it++)
-        decAddr.column |= ((encAddr >> vColumnBits[it]) & UINT64_C(1)) << it;
+inline void
+AddressDecoder::decodeFieldsPext(uint64_t encAddr, DecodedAddress& decAddr) const
+{
+#ifdef DMU_ADDR_DECODE_PEXT
+    unsigned fields[NumOfFields];
+    PextFields(encAddr, fieldMask.data(), fields, NumOfFields);
+    for (unsigned field = 0; field < NumOfFields; field++)
+        decAddr.*kFieldMember[field] = fields[field];
+#else
+    decodeFieldsLut(encAddr, decAddr);
+#endif
+}
 
-    for (unsigned it = 0; it < vByteBits.size(); it++)
-        decAddr.byte |= ((encAddr >> vByteBits[it]) & UINT64_C(1)) << it;
+inline void
+AddressDecoder::applyBankHash(DecodedAddress& decAddr) const
+{
+    uint32_t hash = 0;
+    for (unsigned byteIndex = 0; byteIndex < hashLut.size(); byteIndex++)
+        hash ^= hashLut[byteIndex][(decAddr.row >> (byteIndex * 8)) & 0xff];
+
+    const unsigned bankWidth = static_cast<unsigned>(vBankBits.size());
+    const unsigned bankgroupWidth = static_cast<unsigned>(vBankGroupBits.size());
+    decAddr.bank ^= hash & ((UINT32_C(1) << bankWidth) - 1);
+    decAddr.bankgroup ^= (hash >> bankWidth) & ((UINT32_C(1) << bankgroupWidth) - 1);
+    decAddr.cid ^= hash >> (bankWidth + bankgroupWidth);
+}
 
+inline void
+AddressDecoder::fillRealAddress(DecodedAddress& decAddr) const
+{
     decAddr.real_ba      = decAddr.bank | (decAddr.bankgroup << (vBankBits.size())) |
                            (decAddr.cid << (vBankGroupBits.size() + vBankBits.size())) |
                            (decAddr.cs << (vCidBits.size() + vBankGroupBits.size() + (vBankBits.size())));
@@ -282,10 +484,52 @@ AddressDecoder::decodeAddress(uint64_t encAddr) const
     //TODO: Need to add the bank address and
     // decAddr.bankgroup = decAddr.bankgroup + decAddr.rank * bankgroupsPerRank;
     // decAddr.bank = decAddr.bank + decAddr.bankgroup * banksPerGroup;
+}
 
+DecodedAddress
+AddressDecoder::decodeAddress(uint64_t encAddr) const
+{
+    checkRange(encAddr);
+    DecodedAddress decAddr;
+    if (decodeMethod == DecodeMethod::Pext)
+        decodeFieldsPext(encAddr, decAddr);
+    else
+        decodeFieldsLut(encAddr, decAddr);
+    if (hashEnabled)
+        applyBankHash(decAddr);
+    fillRealAddress(decAddr);
     return decAddr;
 }
 
+void
+AddressDecoder::decodeBatch(const uint64_t* encAddrs, std::size_t count, DecodedAddress* decAddrs) const
+{
+    if (decodeMethod == DecodeMethod::Pext)
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            checkRange(encAddrs[i]);
+            decAddrs[i] = DecodedAddress();
+            decodeFieldsPext(encAddrs[i], decAddrs[i]);
+            if (hashEnabled)
+                applyBankHash(decAddrs[i]);
+            fillRealAddress(decAddrs[i]);
+        }
+    }
+    else
+    {
+        for (std::size_t i = 0; i < count; i++)
+        {
+            checkRange(encAddrs[i]);
+            decAddrs[i] = DecodedAddress();
+            decodeFieldsLut(encAddrs[i], decAddrs[i]);
+            if (hashEnabled)
+                applyBankHash(decAddrs[i]);
+            fillRealAddress(decAddrs[i]);
+        }
+    }
+}
+
 unsigned
 AddressDecoder::decodeChannel(uint64_t encAddr) const
 {
@@ -304,8 +548,13 @@ AddressDecoder::decodeChannel(uint64_t encAddr) const
 }
 
 uint64_t
-AddressDecoder::encodeAddress(const DecodedAddress &decodedAddress) const
+AddressDecoder::encodeAddress(const DecodedAddress &hashedAddress) const
 {
+    // hash 是只依赖 row 的 xor, 再做一次即还原出 hash 前的 bankgroup/bank/cid
+    DecodedAddress decodedAddress = hashedAddress;
+    if (hashEnabled)
+        applyBankHash(decodedAddress);
+
     uint64_t encodedAddress = 0;
     for (unsigned it = 0; it < vChannelBits.size(); it++)
         encodedAddress |= ((decodedAddress.channel >> it) & UINT64_C(1)) << vChannelBits[it];
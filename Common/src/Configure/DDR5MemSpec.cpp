@@ -64,6 +64,12 @@ namespace dmu{
     ,tCL_mc(Tranform2McClk(mem_spec_base.SpeedBins.CL,mem_spec_base.FreqRatio) * tCK_mc)
     ,tCWL_mc(Tranform2McClk(mem_spec_base.SpeedBins.CWL,mem_spec_base.FreqRatio) * tCK_mc)
 
+    ,nRCD_mc(ToMcTick(tRCD_mc,tCK_mc))
+    ,nRASmin_mc(ToMcTick(tRASmin_mc,tCK_mc))
+    ,nRP_mc(ToMcTick(tRP_mc,tCK_mc))
+    ,nCL_mc(ToMcTick(tCL_mc,tCK_mc))
+    ,nCWL_mc(ToMcTick(tCWL_mc,tCK_mc))
+
 
     {
         if(mem_spec_base.CmdMode == 0)
@@ -113,6 +113,49 @@ DDR5MemSpec3ds::DDR5MemSpec3ds(const DDR5MemConfig& mem_spec, const std::string&
 ,tREFSBRD_dlr_mc(Tranform2McClk(AcTimingRounding(tREFSBRD_dlr.to_double(),tCK.to_double(),true),FreqRatio) * tCK_mc)
 ,tREFABRD_dlr_mc(Tranform2McClk(AcTimingRounding(tREFABRD_dlr.to_double(),tCK.to_double(),true),FreqRatio) * tCK_mc)
 
+,nCCD_L_slr_mc(ToMcTick(tCCD_L_slr_mc,tCK_mc))
+,nCCD_L_WR_slr_mc(ToMcTick(tCCD_L_WR_slr_mc,tCK_mc))
+,nCCD_L_WR2_slr_mc(ToMcTick(tCCD_L_WR2_slr_mc,tCK_mc))
+,nCCD_L_RTW_slr_mc(ToMcTick(tCCD_L_RTW_slr_mc,tCK_mc))
+,nCCD_L_WTR_slr_mc(ToMcTick(tCCD_L_WTR_slr_mc,tCK_mc))
+,nCCD_M_slr_mc(ToMcTick(tCCD_M_slr_mc,tCK_mc))
+,nCCD_M_WR_slr_mc(ToMcTick(tCCD_M_WR_slr_mc,tCK_mc))
+,nCCD_M_WTR_slr_mc(ToMcTick(tCCD_M_WTR_slr_mc,tCK_mc))
+,nCCD_S_slr_mc(ToMcTick(tCCD_S_slr_mc,tCK_mc))
+,nCCD_S_WR_slr_mc(ToMcTick(tCCD_S_WR_slr_mc,tCK_mc))
+,nCCD_S_RTW_slr_mc(ToMcTick(tCCD_S_RTW_slr_mc,tCK_mc))
+,nCCD_S_WTR_slr_mc(ToMcTick(tCCD_S_WTR_slr_mc,tCK_mc))
+,nCCD_WTRA_slr_mc(ToMcTick(tCCD_WTRA_slr_mc,tCK_mc))
+,nRRD_L_slr_mc(ToMcTick(tRRD_L_slr_mc,tCK_mc))
+,nRRD_S_slr_mc(ToMcTick(tRRD_S_slr_mc,tCK_mc))
+,nFAW_slr_mc(ToMcTick(tFAW_slr_mc,tCK_mc))
+,nRTP_slr_mc(ToMcTick(tRTP_slr_mc,tCK_mc))
+,nPPD_slr_mc(ToMcTick(tPPD_slr_mc,tCK_mc))
+,nWR_slr_mc(ToMcTick(tWR_slr_mc,tCK_mc))
+,nCCD_dlr_mc(ToMcTick(tCCD_dlr_mc,tCK_mc))
+,nCCD_WR_dlr_mc(ToMcTick(tCCD_WR_dlr_mc,tCK_mc))
+,nCCD_RTW_dlr_mc(ToMcTick(tCCD_RTW_dlr_mc,tCK_mc))
+,nCCD_WTR_dlr_mc(ToMcTick(tCCD_WTR_dlr_mc,tCK_mc))
+,nRRD_dlr_mc(ToMcTick(tRRD_dlr_mc,tCK_mc))
+,nFAW_dlr_mc(ToMcTick(tFAW_dlr_mc,tCK_mc))
+,nPPD_dlr_mc(ToMcTick(tPPD_dlr_mc,tCK_mc))
+,nCCD_WR_dpr_mc(ToMcTick(tCCD_WR_dpr_mc,tCK_mc))
+,nDCAW_mc(ToMcTick(tDCAW_mc,tCK_mc))
+,nBurst_mc(ToMcTick(tBurst_mc,tCK_mc))
+,nREFI1_mc(ToMcTick(tREFI1_mc,tCK_mc))
+,nREFI2_mc(ToMcTick(tREFI2_mc,tCK_mc))
+,nRFC1_slr_mc(ToMcTick(tRFC1_slr_mc,tCK_mc))
+,nRFC2_slr_mc(ToMcTick(tRFC2_slr_mc,tCK_mc))
+,nRFCsb_slr_mc(ToMcTick(tRFCsb_slr_mc,tCK_mc))
+,nRFC1_dlr_mc(ToMcTick(tRFC1_dlr_mc,tCK_mc))
+,nRFC1_dpr_mc(ToMcTick(tRFC1_dpr_mc,tCK_mc))
+,nRFC2_dlr_mc(ToMcTick(tRFC2_dlr_mc,tCK_mc))
+,nRFC2_dpr_mc(ToMcTick(tRFC2_dpr_mc,tCK_mc))
+,nRFCsb_dlr_mc(ToMcTick(tRFCsb_dlr_mc,tCK_mc))
+,nREFSBRD_slr_mc(ToMcTick(tREFSBRD_slr_mc,tCK_mc))
+,nREFSBRD_dlr_mc(ToMcTick(tREFSBRD_dlr_mc,tCK_mc))
+,nREFABRD_dlr_mc(ToMcTick(tREFABRD_dlr_mc,tCK_mc))
+
 {
 
     if(RefMode == RefModeTypeDDR5::Normal)
@@ -134,6 +177,10 @@ DDR5MemSpec3ds::DDR5MemSpec3ds(const DDR5MemConfig& mem_spec, const std::string&
         std::cerr<< "Sdram Constraint use invalid RefMode"<<std::endl;
         std::abort();
     }
+    nREFI_mc = ToMcTick(tREFI_mc,tCK_mc);
+    nRFC_slr_mc = ToMcTick(tRFC_slr_mc,tCK_mc);
+    nRFC_dlr_mc = ToMcTick(tRFC_dlr_mc,tCK_mc);
+    nRFC_dpr_mc = ToMcTick(tRFC_dpr_mc,tCK_mc);
 
     DeviceMemorySizeBytes = static_cast<uint64_t>(width /8 * NumOfColumns * NumOfRows * TotalNumOfBanksPerDevice);
     MemorySizeBytes = TotalNumOfDevices * DeviceMemorySizeBytes;
@@ -0,0 +1,136 @@
+// BackingStore 单元测试: page 分配, byte enable 部分写, 没有写过的地址读出 0
+// 失败时返回非 0
+#include "Common/BackingStore.hh"
+#include <systemc>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+unsigned numOfFailures = 0;
+
+void Check(bool condition, const char* what)
+{
+    if(!condition)
+    {
+        std::printf("  FAIL: %s\n", what);
+        numOfFailures++;
+    }
+}
+
+using dmu::BackingStore;
+constexpr std::size_t kPageSize = BackingStore::kPageSize;
+
+void TestUnwrittenRead()
+{
+    BackingStore store;
+    std::vector<uint8_t> data(256, 0xa5);
+    store.Read(0x40001000, data.data(), data.size());
+    bool all_zero = true;
+    for(uint8_t byte: data)
+        all_zero &= byte == 0;
+    Check(all_zero, "unwritten read returns 0");
+    Check(store.GetNumOfPages() == 0, "unwritten read allocates no page");
+    Check(store.GetSpan(0x40001000, 64, false).data == nullptr, "GetSpan(create=false) on missing page returns nullptr");
+    Check(store.GetNumOfPages() == 0, "GetSpan(create=false) allocates no page");
+}
+
+void TestPageAllocation()
+{
+    BackingStore store;
+    std::size_t empty_bytes = store.GetNumOfBytes();
+    Check(empty_bytes > 0, "GetNumOfBytes counts the root node of an empty store");
+    std::vector<uint8_t> data(64);
+    for(std::size_t i = 0; i < data.size(); i++)
+        data[i] = uint8_t(i + 1);
+
+    store.Write(0x1000, data.data(), data.size());
+    Check(store.GetNumOfPages() == 1, "write inside one page allocates one page");
+    store.Write(0x1040, data.data(), data.size());
+    Check(store.GetNumOfPages() == 1, "second write to the same page allocates nothing");
+    // 跨 page 边界: 0x2fe0 .. 0x301f
+    store.Write(0x3000 - 32, data.data(), data.size());
+    Check(store.GetNumOfPages() == 3, "write crossing a page boundary allocates two pages");
+    Check(store.GetNumOfBytes() >= empty_bytes + 3 * kPageSize, "GetNumOfBytes counts pages");
+
+    std::vector<uint8_t> readback(64);
+    store.Read(0x3000 - 32, readback.data(), readback.size());
+    Check(readback == data, "read across the written page boundary");
+
+    BackingStore::Span span = store.GetSpan(0x3000 - 32, 64, false);
+    Check(span.data != nullptr && span.length == 32, "GetSpan stops at the page end");
+
+    // 地址空间上限附近
+    uint64_t high = (uint64_t(1) << BackingStore::kAddressBits) - kPageSize;
+    store.Write(high + kPageSize - 64, data.data(), data.size());
+    Check(store.GetNumOfPages() == 4, "write near the top of the address space");
+    store.Read(high + kPageSize - 64, readback.data(), readback.size());
+    Check(readback == data, "read near the top of the address space");
+}
+
+void TestPartialWrite()
+{
+    BackingStore store;
+    std::vector<uint8_t> full(64, 0x11);
+    store.Write(0x8000, full.data(), full.size());
+
+    // 只写后 32 字节 (RMW 的 PTL 写)
+    std::vector<uint8_t> data(64, 0x22);
+    std::vector<uint8_t> byte_enable(64, 0);
+    for(std::size_t i = 32; i < 64; i++)
+        byte_enable[i] = 0xff;
+    store.Write(0x8000, data.data(), data.size(), byte_enable.data(), byte_enable.size());
+
+    std::vector<uint8_t> readback(64);
+    store.Read(0x8000, readback.data(), readback.size());
+    bool merged = true;
+    for(std::size_t i = 0; i < 64; i++)
+        merged &= readback[i] == (i < 32 ? 0x11 : 0x22);
+    Check(merged, "byte enable partial write keeps disabled bytes");
+
+    // byte enable 比 data 短时按周期重复: 每 4 字节写前 2 个
+    const uint8_t periodic[4] = {0xff, 0xff, 0x00, 0x00};
+    std::vector<uint8_t> data3(64, 0x33);
+    store.Write(0x8000, data3.data(), data3.size(), periodic, sizeof(periodic));
+    store.Read(0x8000, readback.data(), readback.size());
+    bool periodic_ok = true;
+    for(std::size_t i = 0; i < 64; i++)
+        periodic_ok &= readback[i] == (i % 4 < 2 ? 0x33 : (i < 32 ? 0x11 : 0x22));
+    Check(periodic_ok, "periodic byte enable");
+
+    // 没有写过的 page 上的部分写: 未使能的字节为 0
+    store.Write(0x9000, data.data(), data.size(), byte_enable.data(), byte_enable.size());
+    store.Read(0x9000, readback.data(), readback.size());
+    bool zero_filled = true;
+    for(std::size_t i = 0; i < 64; i++)
+        zero_filled &= readback[i] == (i < 32 ? 0x00 : 0x22);
+    Check(zero_filled, "partial write to a new page leaves disabled bytes 0");
+}
+
+void TestMixedRead()
+{
+    // 一半在写过的 page, 一半在没写过的 page
+    BackingStore store;
+    std::vector<uint8_t> data(64, 0x44);
+    store.Write(0xa000 - 64, data.data(), data.size());
+    std::vector<uint8_t> readback(128, 0xa5);
+    store.Read(0xa000 - 64, readback.data(), readback.size());
+    bool ok = true;
+    for(std::size_t i = 0; i < readback.size(); i++)
+        ok &= readback[i] == (i < 64 ? 0x44 : 0x00);
+    Check(ok, "read across a written and an unwritten page");
+    Check(store.GetNumOfPages() == 1, "read does not allocate the unwritten page");
+}
+
+} // namespace
+
+int sc_main(int argc, char** argv)
+{
+    TestUnwrittenRead();
+    TestPageAllocation();
+    TestPartialWrite();
+    TestMixedRead();
+    std::printf("[BackingStore test] %s (%u failures)\n", numOfFailures == 0 ? "PASS" : "FAIL", numOfFailures);
+    return numOfFailures == 0 ? 0 : 1;
+}
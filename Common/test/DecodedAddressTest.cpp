@@ -0,0 +1,64 @@
+// DecodedAddress 比较的回归检查: operator== / operator!= 必须逐个字段比较 (bank 与 bank 比较, 不是与 bankgroup 比较)
+// 失败时返回非 0
+#include "Configure/AddressDecoder.hh"
+#include <systemc>
+#include <cstdio>
+
+namespace {
+
+unsigned numOfFailures = 0;
+
+void Check(bool condition, const char* what)
+{
+    if(!condition)
+    {
+        std::printf("  FAIL: %s\n", what);
+        numOfFailures++;
+    }
+}
+
+using dmu::DecodedAddress;
+
+DecodedAddress MakeAddress(unsigned bankgroup, unsigned bank, unsigned row, unsigned column)
+{
+    // channel, cs, cid, bankgroup, bank, row, column, byte
+    return DecodedAddress(0, 1, 1, bankgroup, bank, row, column, 0);
+}
+
+void TestSameAddress()
+{
+    // bank 与 bankgroup 不同的地址也要与自己相等
+    DecodedAddress a = MakeAddress(2, 3, 0x100, 0x40);
+    DecodedAddress b = MakeAddress(2, 3, 0x100, 0x40);
+    Check(a == b, "same address with bank != bankgroup compares equal");
+    Check(!(a != b), "operator!= agrees with operator== on equal addresses");
+}
+
+void TestDifferentBank()
+{
+    // 只有 bank 不同: 不是同一个地址, 即使 a.bank 等于 b.bankgroup
+    DecodedAddress a = MakeAddress(2, 2, 0x100, 0x40);
+    DecodedAddress b = MakeAddress(2, 1, 0x100, 0x40);
+    Check(!(a == b), "addresses in different banks compare unequal");
+    Check(!(b == a), "operator== is symmetric on the bank field");
+    Check(a != b && b != a, "operator!= agrees with operator== on different banks");
+}
+
+void TestOtherFields()
+{
+    DecodedAddress a = MakeAddress(2, 3, 0x100, 0x40);
+    Check(a != MakeAddress(1, 3, 0x100, 0x40), "different bankgroup compares unequal");
+    Check(a != MakeAddress(2, 3, 0x101, 0x40), "different row compares unequal");
+    Check(a != MakeAddress(2, 3, 0x100, 0x48), "different column compares unequal");
+}
+
+} // namespace
+
+int sc_main(int argc, char** argv)
+{
+    TestSameAddress();
+    TestDifferentBank();
+    TestOtherFields();
+    std::printf("[DecodedAddress test] %s (%u failures)\n", numOfFailures == 0 ? "PASS" : "FAIL", numOfFailures);
+    return numOfFailures == 0 ? 0 : 1;
+}
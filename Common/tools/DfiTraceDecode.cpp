@@ -0,0 +1,290 @@
+// 离线解析 MemoryDevice 写出的 DfiTrace.bin, 还原与文本模式相同格式的 DfiCmd.txt 和 TransInfo.txt
+// usage: dmu_dfi_decode <DfiTrace.bin> [output_dir]
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Common/DfiTraceFormat.hh"
+#include "Common/LzBlock.hh"
+
+using namespace dmu::trace;
+
+namespace {
+
+struct Address
+{
+    unsigned channel;
+    unsigned cs;
+    unsigned cid;
+    unsigned bankgroup;
+    unsigned bank;
+    unsigned row;
+    unsigned column;
+    unsigned byte;
+};
+
+// 与 DecodedAddress 的 operator<< 一致
+void
+PrintDecodedAddress(std::ostream& os, const Address& da)
+{
+    os << std::left << "{"
+       << "channel: " << da.channel << ",\t"
+       << "cs: " << da.cs << ",\t"
+       << "cid: " << da.cid << ",\t"
+       << "bankgroup: " << da.bankgroup << ",\t"
+       << "bank: " << da.bank << ",\t"
+       << "row: " << std::setw(8)<< da.row << ",\t"
+       << "column: " << std::setw(6)<< da.column << ",\t"
+       << "byte: " << da.byte
+       << "}";
+}
+
+// 与 Controller::BankAddress 的 operator<< 一致
+void
+PrintBankAddress(std::ostream& os, const DfiCmdRecord& record)
+{
+    os << "BankAddress {\t"
+       << " ch: " << unsigned(record.channel) << "\t"
+       << " cs: " << unsigned(record.cs) << "\t"
+       << " cid: " << unsigned(record.cid) << "\t"
+       << " bankgroup: " << unsigned(record.bankgroup) << "\t"
+       << " bank: " << unsigned(record.bank) << "\t"
+       << " real_ba: "<< record.real_ba << "\t"
+       << " real_bg: "<< unsigned(record.real_bg) << "\t"
+       << " real_cid: "<< unsigned(record.real_cid) << "\t"
+       << "}";
+}
+
+const char*
+DfiCommandName(uint8_t command)
+{
+    return command < std::size(kDfiCommandNames) ? kDfiCommandNames[command] : "???";
+}
+
+const char*
+DramCommandName(uint8_t command)
+{
+    return command < std::size(kDramCommandNames) ? kDramCommandNames[command] : "Invalid";
+}
+
+class Decoder
+{
+public:
+    Decoder(std::ostream& dfi_cmd, std::ostream& trans_info): dfi_cmd(dfi_cmd), trans_info(trans_info) {}
+
+    // 解析一个解压后的 block, 格式错误时返回 false
+    bool DecodeBlock(const uint8_t* data, size_t size)
+    {
+        size_t pos = 0;
+        while(pos < size)
+        {
+            const RecordType type = static_cast<RecordType>(data[pos]);
+            size_t record_size = 0;
+            if(type == RecordType::DfiCmd)
+                record_size = sizeof(DfiCmdRecord);
+            else if(type == RecordType::Trans)
+                record_size = sizeof(TransRecord);
+            else if(type == RecordType::TransCmd)
+                record_size = sizeof(TransCmdRecord);
+            if(record_size == 0 || pos + record_size > size)
+                return false;
+
+            if(type == RecordType::DfiCmd)
+            {
+                DfiCmdRecord record;
+                std::memcpy(&record, data + pos, sizeof(record));
+                FlushTrans();
+                PrintDfiCmd(record);
+            }
+            else if(type == RecordType::Trans)
+            {
+                FlushTrans();
+                std::memcpy(&trans, data + pos, sizeof(trans));
+                has_trans = true;
+                commands.clear();
+                for(unsigned i = 0; i < kTransInlineCmds && i < trans.num_of_cmds; i++)
+                    commands.emplace_back(trans.command_times[i], trans.commands[i]);
+            }
+            else
+            {
+                TransCmdRecord record;
+                std::memcpy(&record, data + pos, sizeof(record));
+                if(!has_trans || record.trans_id != trans.trans_id)
+                    return false;
+                for(unsigned i = 0; i < kTransCmdRecordCmds && commands.size() < trans.num_of_cmds; i++)
+                    commands.emplace_back(record.command_times[i], record.commands[i]);
+            }
+            pos += record_size;
+            num_of_records++;
+        }
+        return true;
+    }
+
+    // 请求的命令可能跟在后面的 TransCmdRecord 中, 遇到下一个 record 或结束时才输出
+    void FlushTrans()
+    {
+        if(!has_trans)
+            return;
+        PrintTrans();
+        has_trans = false;
+    }
+
+    inline uint64_t GetNumOfRecords() const { return num_of_records; }
+
+private:
+    // 与 MemoryDevice::PrintDfiCmd 和 refresh 命令的输出一致
+    void PrintDfiCmd(const DfiCmdRecord& record)
+    {
+        dfi_cmd << std::left << "Trans Id: " << std::setw(8);
+        if(record.is_rank)
+            dfi_cmd << -1;
+        else
+            dfi_cmd << record.trans_id;
+        dfi_cmd << " Cmd: " << std::setw(6) << DfiCommandName(record.command)
+                << " Time: " << std::setw(10) << record.time << " ps"
+                << " Last Cmd Delay: " << std::setw(10) << (last_cmd_time == 0 ? 0 : record.time - last_cmd_time) << " ps";
+        if(record.is_rank)
+        {
+            dfi_cmd << " Real Rank Index: " << std::setw(3) << unsigned(record.real_cid) << " ";
+            PrintBankAddress(dfi_cmd, record);
+        }
+        else
+        {
+            dfi_cmd << " Real Bank Index: " << std::setw(3) << record.real_ba << " ";
+            PrintDecodedAddress(dfi_cmd, Address{record.channel, record.cs, record.cid, record.bankgroup, record.bank,
+                                                 record.row, record.column, record.byte});
+        }
+        dfi_cmd << " " << std::endl;
+        last_cmd_time = record.time;
+    }
+
+    // 与 StatisticExtension::PrintStatistics 一致
+    void PrintTrans()
+    {
+        std::ostream& os = trans_info;
+        os << "===== Transaction Statistics =====" << std::endl;
+        os << "Transaction ID: " << trans.trans_id << std::endl;
+        os << "Transaction Sdram Address: ";
+        PrintDecodedAddress(os, Address{trans.channel, trans.cs, trans.cid, trans.bankgroup, trans.bank,
+                                        trans.row, trans.column, trans.byte});
+        os << std::endl;
+        os << "Entering Port Time: " << trans.times[kInPortTime] << " ps" << std::endl;
+        os << "Leaving Port Time: " << trans.times[kOutPortTime] << " ps" << std::endl;
+        os << "Entering CAM Time: " << trans.times[kInCamTime] << " ps" << std::endl;
+        os << "Leaving CAM Time: " << trans.times[kOutCamTime] << " ps" << std::endl;
+        os << "Command Times:" << std::endl;
+        for(const auto& [time, command]: commands)
+            os << "  Time: " << time << " ps" << ", Command: " << DramCommandName(command) << std::endl;
+        os << "UIF Data Begin Time: " << trans.times[kUifDataBeginTime] << " ps" << std::endl;
+        os << "UIF Data End Time: " << trans.times[kUifDataEndTime] << " ps" << std::endl;
+        os << "DFI Data Begin Time: " << trans.times[kDfiDataBeginTime] << " ps" << std::endl;
+        os << "DFI Data End Time: " << trans.times[kDfiDataEndTime] << " ps" << std::endl;
+        os << "DQ Data Begin Time: " << trans.times[kDqDataBeginTime] << " ps" << std::endl;
+        os << "DQ Data End Time: " << trans.times[kDqDataEndTime] << " ps" << std::endl;
+        os << "=================================" << std::endl;
+    }
+
+    std::ostream& dfi_cmd;
+    std::ostream& trans_info;
+    uint64_t last_cmd_time{0};
+    uint64_t num_of_records{0};
+
+    bool has_trans{false};
+    TransRecord trans{};
+    std::vector<std::pair<uint64_t, uint8_t>> commands;
+};
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    if(argc < 2 || argc > 3)
+    {
+        std::cerr << "usage: " << argv[0] << " <DfiTrace.bin> [output_dir]" << std::endl;
+        return 1;
+    }
+    const std::string output_dir = argc == 3 ? argv[2] : ".";
+
+    std::ifstream input(argv[1], std::ios::binary);
+    if(!input.is_open())
+    {
+        std::cerr << "Unable to open " << argv[1] << std::endl;
+        return 1;
+    }
+    DfiTraceHeader header;
+    if(!input.read(reinterpret_cast<char*>(&header), sizeof(header))
+       || std::memcmp(header.magic, kDfiTraceMagic, sizeof(kDfiTraceMagic)) != 0)
+    {
+        std::cerr << "Not a dmu dfi trace file: " << argv[1] << std::endl;
+        return 1;
+    }
+    if(header.version != kDfiTraceVersion)
+    {
+        std::cerr << "Unsupported dfi trace version: " << header.version << std::endl;
+        return 1;
+    }
+
+    std::ofstream dfi_cmd(output_dir + "/DfiCmd.txt", std::ios::out | std::ios::trunc);
+    std::ofstream trans_info(output_dir + "/TransInfo.txt", std::ios::out | std::ios::trunc);
+    if(!dfi_cmd.is_open() || !trans_info.is_open())
+    {
+        std::cerr << "Unable to write DfiCmd.txt / TransInfo.txt in " << output_dir << std::endl;
+        return 1;
+    }
+
+    Decoder decoder(dfi_cmd, trans_info);
+    std::vector<uint8_t> stored;
+    std::vector<uint8_t> raw;
+    uint64_t num_of_blocks = 0;
+    DfiTraceBlockHeader block_header;
+    while(input.read(reinterpret_cast<char*>(&block_header), sizeof(block_header)))
+    {
+        if(block_header.raw_size > header.block_size || block_header.stored_size > block_header.raw_size)
+        {
+            std::cerr << "Corrupted block " << num_of_blocks << std::endl;
+            return 1;
+        }
+        stored.resize(block_header.stored_size);
+        if(!input.read(reinterpret_cast<char*>(stored.data()), stored.size()))
+        {
+            std::cerr << "Truncated block " << num_of_blocks << std::endl;
+            return 1;
+        }
+        const uint8_t* data = stored.data();
+        if(block_header.stored_size != block_header.raw_size)
+        {
+            raw.resize(block_header.raw_size);
+            if(!LzDecompress(stored.data(), stored.size(), raw.data(), raw.size()))
+            {
+                std::cerr << "Corrupted compressed block " << num_of_blocks << std::endl;
+                return 1;
+            }
+            data = raw.data();
+        }
+        if(!decoder.DecodeBlock(data, block_header.raw_size))
+        {
+            std::cerr << "Corrupted record in block " << num_of_blocks << std::endl;
+            return 1;
+        }
+        num_of_blocks++;
+    }
+    decoder.FlushTrans();
+
+    std::fprintf(stderr, "decoded %" PRIu64 " records in %" PRIu64 " blocks, config hash 0x%016" PRIx64 "%s\n",
+                 decoder.GetNumOfRecords(), num_of_blocks, header.config_hash,
+                 (header.flags & kDfiTraceFlagCompressed) ? ", compressed" : "");
+    if(header.num_of_records != decoder.GetNumOfRecords())
+    {
+        std::cerr << "record count mismatch, header: " << header.num_of_records << " (trace not closed?)" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+// payload event queue microbenchmark: tlm_utils::peq_with_cb_and_phase 与 CalendarPeq 的 notify / dispatch 吞吐对比
+// 每个 payload 在回调中按伪随机 delay 再次 notify, 排队的事件数一直保持为 outstanding
+// delay 多数是 dfi cycle 的整数倍, 少数带半个 cycle 或者超出 calendar 范围; 两种 PEQ 的回调顺序和时刻必须完全一致
+// 每个 outstanding 跑 kNumOfRounds 轮, 两种 PEQ 轮流先跑 (先跑的一方会受 kernel 状态 / cache 的影响), 取每种最快的一轮
+// usage: dmu_peq_bench [events_per_run]
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <systemc>
+#include <tlm>
+#include <tlm_utils/peq_with_cb_and_phase.h>
+
+#include "Common/CalendarPeq.hh"
+
+using namespace dmu;
+
+namespace {
+
+const sc_core::sc_time kDfiCycle(1250, sc_core::SC_PS);
+constexpr unsigned kNumOfRounds = 5;
+
+// 与 CalendarPeq 相同的构造参数, resolution 不使用
+template<typename OWNER>
+struct StockPeq : public tlm_utils::peq_with_cb_and_phase<OWNER>
+{
+    StockPeq(OWNER* owner, void (OWNER::*callback)(tlm::tlm_generic_payload&, const tlm::tlm_phase&), const sc_core::sc_time&)
+    : tlm_utils::peq_with_cb_and_phase<OWNER>(owner, callback)
+    {}
+};
+
+template<typename OWNER>
+using CalendarQueue = CalendarPeq<OWNER>;
+
+template<template<typename> class Queue>
+class PeqDriver : public sc_core::sc_module
+{
+    public:
+        PeqDriver(const sc_core::sc_module_name& name, unsigned outstanding, uint64_t num_of_events)
+        : sc_core::sc_module(name)
+        , queue(this, &PeqDriver::Callback, kDfiCycle)
+        , payloads(outstanding)
+        , num_of_events(num_of_events)
+        {}
+
+        // 仿真暂停时调用, 之后 sc_start() 运行到所有事件处理完
+        void Start()
+        {
+            start_time = sc_core::sc_time_stamp();
+            for(auto& payload: payloads)
+            {
+                queue.notify(payload, tlm::BEGIN_REQ, NextDelay());
+                issued++;
+            }
+        }
+
+        uint64_t dispatched{0};
+        uint64_t checksum{0};
+
+    private:
+        Queue<PeqDriver> queue;
+        std::vector<tlm::tlm_generic_payload> payloads;
+        const uint64_t num_of_events;
+        uint64_t issued{0};
+        sc_core::sc_time start_time;
+        std::mt19937 rng{2024};
+
+        sc_core::sc_time NextDelay()
+        {
+            const unsigned value = rng();
+            if(value % 64 == 0)
+                return kDfiCycle * 300;
+            return kDfiCycle * (value / 64 % 16 + 1) + (value / 1024 % 4 == 0 ? kDfiCycle / 2 : sc_core::SC_ZERO_TIME);
+        }
+
+        void Callback(tlm::tlm_generic_payload& trans, const tlm::tlm_phase& phase)
+        {
+            dispatched++;
+            checksum = checksum * 131 + static_cast<uint64_t>(&trans - payloads.data()) * 257 + (sc_core::sc_time_stamp() - start_time).value();
+            if(issued < num_of_events)
+            {
+                queue.notify(trans, phase, NextDelay());
+                issued++;
+            }
+        }
+};
+
+template<typename Driver>
+double
+Run(Driver& driver)
+{
+    driver.Start();
+    auto begin = std::chrono::steady_clock::now();
+    sc_core::sc_start();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - begin).count();
+}
+
+} // namespace
+
+int
+sc_main(int argc, char** argv)
+{
+    const uint64_t num_of_events = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const unsigned outstanding_list[] = {1, 8, 64};
+
+    // driver 只能在 elaboration 时创建, 每一轮各一个
+    std::vector<std::unique_ptr<PeqDriver<StockPeq>>> stock_drivers;
+    std::vector<std::unique_ptr<PeqDriver<CalendarQueue>>> calendar_drivers;
+    for(auto outstanding: outstanding_list)
+    {
+        for(unsigned round = 0; round < kNumOfRounds; round++)
+        {
+            stock_drivers.push_back(std::make_unique<PeqDriver<StockPeq>>(
+                sc_core::sc_gen_unique_name("stock"), outstanding, num_of_events));
+            calendar_drivers.push_back(std::make_unique<PeqDriver<CalendarQueue>>(
+                sc_core::sc_gen_unique_name("calendar"), outstanding, num_of_events));
+        }
+    }
+
+    std::printf("%" PRIu64 " events per run, delay 1 ~ 16 dfi cycles (1/4 with half a cycle, 1/64 with 300 cycles), best of %u rounds\n",
+                num_of_events, kNumOfRounds);
+    std::printf("%-12s %-10s %14s %10s  %s\n", "outstanding", "peq", "Mevents/s", "speedup", "checksum");
+    for(unsigned index = 0; index < std::size(outstanding_list); index++)
+    {
+        double stock_seconds = 0;
+        double calendar_seconds = 0;
+        for(unsigned round = 0; round < kNumOfRounds; round++)
+        {
+            auto& stock = *stock_drivers[index * kNumOfRounds + round];
+            auto& calendar = *calendar_drivers[index * kNumOfRounds + round];
+            double seconds[2];
+            if(round % 2 == 0)
+            {
+                seconds[0] = Run(stock);
+                seconds[1] = Run(calendar);
+            }
+            else
+            {
+                seconds[1] = Run(calendar);
+                seconds[0] = Run(stock);
+            }
+            stock_seconds = round == 0 ? seconds[0] : std::min(stock_seconds, seconds[0]);
+            calendar_seconds = round == 0 ? seconds[1] : std::min(calendar_seconds, seconds[1]);
+            if(stock.dispatched != calendar.dispatched || stock.checksum != calendar.checksum)
+            {
+                std::fprintf(stderr, "dispatch order mismatch between peq_with_cb_and_phase and CalendarPeq at outstanding %u\n",
+                             outstanding_list[index]);
+                return 1;
+            }
+        }
+        const auto& stock = *stock_drivers[index * kNumOfRounds];
+        const auto& calendar = *calendar_drivers[index * kNumOfRounds];
+        std::printf("%-12u %-10s %14.2f %10s  %016" PRIx64 "\n", outstanding_list[index], "stock",
+                    stock.dispatched / stock_seconds / 1e6, "", stock.checksum);
+        std::printf("%-12u %-10s %14.2f %9.2fx  %016" PRIx64 "\n", outstanding_list[index], "calendar",
+                    calendar.dispatched / calendar_seconds / 1e6, stock_seconds / calendar_seconds, calendar.checksum);
+    }
+    return 0;
+}
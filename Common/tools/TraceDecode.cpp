@@ -0,0 +1,276 @@
+// 离线解析 TraceLog 写出的二进制 trace 文件, 输出与 SC_REPORT 文本模式相同格式的日志
+// usage: dmu_trace_decode <trace.bin> [category,category,...]
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Common/TraceFormat.hh"
+
+using namespace dmu::trace;
+
+namespace {
+
+struct Arg
+{
+    ArgTag tag;
+    int64_t i64{0};
+    uint64_t u64{0};
+    double f64{0.0};
+    std::string str;
+};
+
+template<typename T>
+T
+Load(const uint8_t* p)
+{
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+// 与 sc_time::to_string 一致: 选择能整除的最大单位
+std::string
+FormatTime(uint64_t value, uint64_t resolution_fs)
+{
+    static const char* units[] = {"fs", "ps", "ns", "us", "ms", "s"};
+    unsigned __int128 fs = static_cast<unsigned __int128>(value) * resolution_fs;
+    unsigned unit = 0;
+    while(unit < 5 && fs != 0 && fs % 1000 == 0)
+    {
+        fs /= 1000;
+        unit++;
+    }
+    if(fs == 0)
+    {
+        unit = 0;
+        while(unit < 5 && resolution_fs >= 1000 && resolution_fs % 1000 == 0)
+        {
+            resolution_fs /= 1000;
+            unit++;
+        }
+    }
+    return std::to_string(static_cast<uint64_t>(fs)) + " " + units[unit];
+}
+
+// 按 printf 格式逐个 conversion 重新格式化, 长度修饰符统一替换为 64 bit
+std::string
+FormatMessage(const std::string& fmt, const std::vector<Arg>& args)
+{
+    std::string out;
+    size_t arg_index = 0;
+    char piece[512];
+    for(size_t i = 0; i < fmt.size(); i++)
+    {
+        if(fmt[i] != '%')
+        {
+            out.push_back(fmt[i]);
+            continue;
+        }
+        if(i + 1 < fmt.size() && fmt[i + 1] == '%')
+        {
+            out.push_back('%');
+            i++;
+            continue;
+        }
+        size_t j = i + 1;
+        std::string spec = "%";
+        while(j < fmt.size() && std::strchr("-+ #0123456789.", fmt[j]))
+        {
+            spec.push_back(fmt[j++]);
+        }
+        while(j < fmt.size() && std::strchr("hlLqjzt", fmt[j]))
+        {
+            j++;
+        }
+        if(j >= fmt.size())
+        {
+            out += fmt.substr(i);
+            break;
+        }
+        char conv = fmt[j];
+        i = j;
+        if(arg_index >= args.size())
+        {
+            out += "<missing>";
+            continue;
+        }
+        const Arg& arg = args[arg_index++];
+        int64_t as_i64 = arg.tag == ArgTag::U64 ? static_cast<int64_t>(arg.u64)
+                       : arg.tag == ArgTag::F64 ? static_cast<int64_t>(arg.f64) : arg.i64;
+        uint64_t as_u64 = arg.tag == ArgTag::I64 ? static_cast<uint64_t>(arg.i64)
+                        : arg.tag == ArgTag::F64 ? static_cast<uint64_t>(arg.f64) : arg.u64;
+        double as_f64 = arg.tag == ArgTag::I64 ? static_cast<double>(arg.i64)
+                      : arg.tag == ArgTag::U64 ? static_cast<double>(arg.u64) : arg.f64;
+        switch(conv)
+        {
+            case 'd': case 'i':
+                std::snprintf(piece, sizeof(piece), (spec + "lld").c_str(), static_cast<long long>(as_i64));
+                break;
+            case 'u': case 'x': case 'X': case 'o':
+                std::snprintf(piece, sizeof(piece), (spec + "ll" + conv).c_str(), static_cast<unsigned long long>(as_u64));
+                break;
+            case 'c':
+                std::snprintf(piece, sizeof(piece), (spec + "c").c_str(), static_cast<int>(as_i64));
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                std::snprintf(piece, sizeof(piece), (spec + conv).c_str(), as_f64);
+                break;
+            case 'p':
+                std::snprintf(piece, sizeof(piece), "0x%llx", static_cast<unsigned long long>(as_u64));
+                break;
+            case 's':
+                if(arg.tag == ArgTag::Str)
+                {
+                    std::snprintf(piece, sizeof(piece), (spec + "s").c_str(), arg.str.c_str());
+                }
+                else
+                {
+                    std::snprintf(piece, sizeof(piece), "%lld", static_cast<long long>(as_i64));
+                }
+                break;
+            default:
+                std::snprintf(piece, sizeof(piece), "%%%c", conv);
+                break;
+        }
+        out += piece;
+    }
+    return out;
+}
+
+} // namespace
+
+int
+main(int argc, char** argv)
+{
+    if(argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <trace.bin> [category,category,...]" << std::endl;
+        return 1;
+    }
+    std::ifstream file(argv[1], std::ios::binary);
+    if(!file.is_open())
+    {
+        std::cerr << "Unable to open file: " << argv[1] << std::endl;
+        return 1;
+    }
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    uint32_t filter = kAllCategories;
+    if(argc >= 3)
+    {
+        filter = 0;
+        std::string spec = argv[2];
+        size_t begin = 0;
+        while(begin <= spec.size())
+        {
+            size_t end = spec.find(',', begin);
+            end = end == std::string::npos ? spec.size() : end;
+            std::string name = spec.substr(begin, end - begin);
+            for(unsigned i = 0; i < kNumOfCategories; i++)
+            {
+                if(name == kCategoryNames[i])
+                {
+                    filter |= (1u << i);
+                }
+            }
+            begin = end + 1;
+        }
+    }
+
+    if(data.size() < sizeof(kTraceMagic) + 4 || std::memcmp(data.data(), kTraceMagic, sizeof(kTraceMagic)) != 0)
+    {
+        std::cerr << "Not a dmu trace file: " << argv[1] << std::endl;
+        return 1;
+    }
+    size_t pos = sizeof(kTraceMagic);
+    uint32_t version = Load<uint32_t>(data.data() + pos);
+    pos += 4;
+    if(version != kTraceVersion)
+    {
+        std::cerr << "Unsupported trace version: " << version << std::endl;
+        return 1;
+    }
+
+    std::unordered_map<uint32_t, std::string> strings;
+    uint64_t resolution_fs = 1000; // SystemC 默认 1ps
+    uint64_t record_count = 0;
+
+    while(pos < data.size())
+    {
+        BlockType type = static_cast<BlockType>(data[pos++]);
+        if(type == BlockType::String)
+        {
+            uint32_t id = Load<uint32_t>(data.data() + pos);
+            uint16_t len = Load<uint16_t>(data.data() + pos + 4);
+            pos += 6;
+            strings[id] = std::string(reinterpret_cast<const char*>(data.data() + pos), len);
+            pos += len;
+        }
+        else if(type == BlockType::Resolution)
+        {
+            resolution_fs = Load<uint64_t>(data.data() + pos);
+            pos += 8;
+        }
+        else if(type == BlockType::Records)
+        {
+            uint32_t len = Load<uint32_t>(data.data() + pos + 4);
+            pos += 8;
+            size_t end = pos + len;
+            while(pos < end)
+            {
+                const uint8_t* rec = data.data() + pos;
+                uint16_t size = Load<uint16_t>(rec);
+                Level level = static_cast<Level>(rec[2]);
+                uint8_t nargs = rec[3];
+                uint32_t category = Load<uint32_t>(rec + 4);
+                uint32_t name_id = Load<uint32_t>(rec + 8);
+                uint32_t fmt_id = Load<uint32_t>(rec + 12);
+                uint64_t time_value = Load<uint64_t>(rec + 16);
+                size_t arg_pos = kRecordHeaderSize;
+                std::vector<Arg> args;
+                for(unsigned i = 0; i < nargs; i++)
+                {
+                    Arg arg;
+                    arg.tag = static_cast<ArgTag>(rec[arg_pos++]);
+                    if(arg.tag == ArgTag::Str)
+                    {
+                        uint16_t str_len = Load<uint16_t>(rec + arg_pos);
+                        arg.str.assign(reinterpret_cast<const char*>(rec + arg_pos + 2), str_len);
+                        arg_pos += 2 + str_len;
+                    }
+                    else
+                    {
+                        arg.i64 = Load<int64_t>(rec + arg_pos);
+                        arg.u64 = Load<uint64_t>(rec + arg_pos);
+                        arg.f64 = Load<double>(rec + arg_pos);
+                        arg_pos += 8;
+                    }
+                    args.push_back(std::move(arg));
+                }
+                pos += size;
+                record_count++;
+                if((category & filter) == 0)
+                {
+                    continue;
+                }
+                std::cout << (level == Level::WARNING ? "Warning: " : "Info: ")
+                          << strings[name_id] << ": @" << FormatTime(time_value, resolution_fs) << ":"
+                          << FormatMessage(strings[fmt_id], args) << "\n\n";
+            }
+            pos = end;
+        }
+        else
+        {
+            std::cerr << "Corrupted trace file at offset " << pos - 1 << std::endl;
+            return 1;
+        }
+    }
+    std::cerr << "decoded " << record_count << " records" << std::endl;
+    return 0;
+}
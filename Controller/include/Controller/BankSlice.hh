@@ -8,6 +8,7 @@
 
 
 #include "Configure/AddressDecoder.hh"
+#include "Controller/PerformanceCounters.hh"
 #include "Controller/Scheduler.hh"
 #include "Controller/common/Command.hh"
 #include "Controller/common/ControllerCommon.hh"
@@ -70,31 +71,30 @@ private:
   Command::Type next_rd_command{Command::NOP}; // ACT PRE RD RDA WR WRA
   Command::Type next_wr_command{Command::NOP}; // ACT PRE RD RDA WR WRA
 
-  sc_core::sc_time next_rd_command_avail_time{sc_core::sc_max_time()};
-  sc_core::sc_time next_wr_command_avail_time{sc_core::sc_max_time()};
+  Tick next_rd_command_avail_time{MaxTick};
+  Tick next_wr_command_avail_time{MaxTick};
 
   // const Scheduler& _scheduler;
   RdCam *const _rd_cam;
   WrCam *const _wr_cam;
   const BSC_INDEX m_bsc_index;
+  PerformanceCounters &_perf_counters;
 
-  sc_core::sc_time act_tRCD_end_time{
-      sc_core::SC_ZERO_TIME}; // when send act cmd, then do mask with ntt update
-  sc_core::sc_time act_tRAS_end_time{sc_core::sc_max_time()};
+  Tick act_tRCD_end_time{0}; // when send act cmd, then do mask with ntt update
+  Tick act_tRAS_end_time{MaxTick};
 
-  const sc_core::sc_time Max_time{sc_core::sc_max_time()};
-
-  const sc_core::sc_time tRCD_mc;
-  const sc_core::sc_time tRAS_max_mc;
+  const McClock mc_clock;
+  const Tick nRCD_mc;
+  const Tick nRAS_max_mc;
 
   bool is_refresh_waiting{false};
 
 public:
   BankSlice(const Scheduler &scheduler, const Configure &config,
-            BSC_INDEX bsc_index)
+            BSC_INDEX bsc_index, PerformanceCounters &perf_counters)
       : _rd_cam(scheduler.GetRdCam()), _wr_cam(scheduler.GetWrCam()),
-        m_bsc_index(bsc_index), tRCD_mc(config.mem_spec->tRCD_mc),
-        tRAS_max_mc(config.mem_spec->tCK_mc * 251),
+        m_bsc_index(bsc_index), _perf_counters(perf_counters), mc_clock(config.mem_spec->tCK_mc),
+        nRCD_mc(config.mem_spec->nRCD_mc), nRAS_max_mc(251),
         raa_threshold(config.controller_config->RAA_THRESHOLD),
         raa_imt(config.controller_config->RAAIMT),
         raa_mmt(config.controller_config->RAAMMT),
@@ -102,7 +102,7 @@ public:
   ~BankSlice() = default;
 
   inline bool IsNeedForcePre() const {
-    return sc_core::sc_time_stamp() > act_tRAS_end_time;
+    return mc_clock.Now() > act_tRAS_end_time;
   }
   inline void SetRefreshWaiting() { is_refresh_waiting = true; }
   inline void ClearRefreshWaiting() { is_refresh_waiting = false; }
@@ -139,10 +139,11 @@ public:
 
   CommandTuple::Type GetNextCommand(GlobalRdWrState global_rdwr_mode);
 
-  ReadyCommands GetAvailCommand(GlobalRdWrState global_rdwr_mode);
+  // 追加到 ready_commands 末尾, 不在每个 cycle 构造临时 vector
+  void GetAvailCommand(GlobalRdWrState global_rdwr_mode, ReadyCommands& ready_commands);
 
   // Updated the Bsc rd or wr sending avail time
-  void UpdateBscAvailTime(const sc_core::sc_time &updated_time, bool is_rd);
+  void UpdateBscAvailTime(Tick updated_time, bool is_rd);
 
   // before get cmd, based on the bsc state, decide what the bsc candidate cmd
   void Evaluate();
@@ -166,18 +167,18 @@ public:
 
   // Note: this is the interface to get bsc static info
   inline bool IsActiving() const {
-    return sc_core::sc_time_stamp() < act_tRCD_end_time;
+    return mc_clock.Now() < act_tRCD_end_time;
   } // to show whether the BSC bank is in activing time
-  inline sc_core::sc_time GetActEndTime() const { return act_tRCD_end_time; }
+  inline Tick GetActEndTime() const { return act_tRCD_end_time; }
   inline bool IsPageOpen() const { return page_info.is_open; }
   inline Row GetOpenPage() const { return page_info.open_page; }
   CAM_INDEX GetNttCamIndex(bool is_rd_mode);
   const BankAddress &GetBaAddr() const;
 
-  inline sc_core::sc_time &GetRdCmdAvailTime() {
+  inline Tick &GetRdCmdAvailTime() {
     return next_rd_command_avail_time;
   }
-  inline sc_core::sc_time &GetWrCmdAvailTime() {
+  inline Tick &GetWrCmdAvailTime() {
     return next_wr_command_avail_time;
   }
 
@@ -186,14 +187,14 @@ public:
 
   inline bool IsWrCmdAvail() const {
     if (candidate_wr_cmd.is_valid && next_wr_command != Command::NOP &&
-        next_wr_command_avail_time <= sc_core::sc_time_stamp()) {
+        next_wr_command_avail_time <= mc_clock.Now()) {
       return true;
     }
     return false;
   }
   inline bool IsRdCmdAvail() const {
     if (candidate_rd_cmd.is_valid && next_rd_command != Command::NOP &&
-        next_rd_command_avail_time <= sc_core::sc_time_stamp()) {
+        next_rd_command_avail_time <= mc_clock.Now()) {
       return true;
     }
     return false;
@@ -205,7 +206,7 @@ public:
     return candidate_wr_cmd.is_valid &&
            (next_wr_command == Command::PRE ||
             next_wr_command == Command::ACT) &&
-           next_wr_command_avail_time <= sc_core::sc_time_stamp() &&
+           next_wr_command_avail_time <= mc_clock.Now() &&
            is_act_allowed;
   }
   inline bool IsRdRowCmdAvail() const {
@@ -214,7 +215,7 @@ public:
     return candidate_rd_cmd.is_valid &&
            (next_rd_command == Command::PRE ||
             next_rd_command == Command::ACT) &&
-           next_rd_command_avail_time <= sc_core::sc_time_stamp() &&
+           next_rd_command_avail_time <= mc_clock.Now() &&
            is_act_allowed;
   }
 
@@ -222,13 +223,13 @@ public:
     return candidate_wr_cmd.is_valid &&
            (next_wr_command == Command::WR ||
             next_wr_command == Command::WRA) &&
-           next_wr_command_avail_time <= sc_core::sc_time_stamp();
+           next_wr_command_avail_time <= mc_clock.Now();
   }
   inline bool IsRdColCmdAvail() const {
     return candidate_rd_cmd.is_valid &&
            (next_rd_command == Command::RD ||
             next_rd_command == Command::RDA) &&
-           next_rd_command_avail_time <= sc_core::sc_time_stamp();
+           next_rd_command_avail_time <= mc_clock.Now();
   }
 
   inline bool IsRdPageClosePending() const {
@@ -268,7 +269,7 @@ public:
   // Implement with Codex
   // TODO: how to implement force precharge due to tRASmax
 
-  inline sc_core::sc_time GetNextCommandTriggerTime() {
+  inline Tick GetNextCommandTriggerTime() {
     return std::min(next_wr_command_avail_time, next_rd_command_avail_time);
   }
 
@@ -280,11 +281,11 @@ public:
               << "wr ntt valid: " << candidate_wr_cmd.is_valid
               << ", wr ntt cam index: " << candidate_wr_cmd.cam_index
               << "wr cmd: " << Command(next_wr_command).to_string()
-              << ", wr cmd avail time: " << next_wr_command_avail_time << "; \t"
+              << ", wr cmd avail time: " << mc_clock.ToTime(next_wr_command_avail_time) << "; \t"
               << "rd ntt valid: " << candidate_rd_cmd.is_valid
               << ", rd ntt cam index: " << candidate_rd_cmd.cam_index
               << "rd cmd: " << Command(next_rd_command).to_string()
-              << ", rd cmd avail time: " << next_rd_command_avail_time << "; \t"
+              << ", rd cmd avail time: " << mc_clock.ToTime(next_rd_command_avail_time) << "; \t"
               << std::endl;
   }
 };
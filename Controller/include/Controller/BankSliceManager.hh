@@ -1,13 +1,13 @@
 #ifndef __BANK_SLICE_MANAGER_HH__
 #define __BANK_SLICE_MANAGER_HH__
 
-#include <set>
-#include <deque>
-#include <unordered_map>
 #include <memory>
+#include <vector>
 
+#include "Common/RingQueue.hh"
 #include "Configure/Configure.hh"
 #include "Controller/BankSlice.hh"
+#include "Controller/PerformanceCounters.hh"
 #include "Controller/Scheduler.hh"
 namespace dmu{
     namespace Controller{
@@ -30,18 +30,19 @@ class BankSliceManager{
     using CAM_INDEX = unsigned;
     using BSC_INDEX = unsigned;
     public:
-        explicit BankSliceManager(Scheduler& scheduler, const Configure& config);
+        explicit BankSliceManager(Scheduler& scheduler, const Configure& config, PerformanceCounters& perf_counters);
         ~BankSliceManager()=default;
 
     private:
         const Configure& _config;
-        std::deque<BSC_INDEX> unallocated_bsc_index_queue;
-        std::set<BSC_INDEX> allocated_bsc_index_set;
-        std::unordered_map<BSC_INDEX, std::unique_ptr<BankSlice>> bsc_index_2_bankslice; // Bankslice is not equal to Bank
-        std::unordered_map<BSC_INDEX, BankAddress> bsc_table; // bankslice index map to Bank address
-        std::unordered_map<RealBaIndex,BSC_INDEX> ba2bsc_table;
-
-        std::set<BSC_INDEX> empty_bsc_set; // store the empty and idle bsc
+        RingQueue<BSC_INDEX> unallocated_bsc_index_queue;
+        BscMask allocated_bsc_mask; // 按 bsc index 从小到大遍历, 与原 std::set 顺序一致
+        BankSliceTable bsc_index_2_bankslice; // Bankslice is not equal to Bank
+        std::vector<BankAddress> bsc_table; // bankslice index map to Bank address, (bsc index), 只有已分配的 bsc 有效
+        Ba2BscTable ba2bsc_table;
+
+        BscMask empty_bsc_mask; // store the empty and idle bsc
+        BscMask rfm_req_bsc_mask; // rfm_req 可能置位的 bsc, 是 rfm_req 置位 bsc 的超集
         BSC_INDEX last_released_bsc_index{0};
 
 
@@ -68,9 +69,12 @@ class BankSliceManager{
         void BankSliceRelease();
         bool IsNeedBankSliceRelease();
 
-        inline bool IsAllocatedBscEmpty() {
-            return allocated_bsc_index_set.empty();
+        inline bool IsAllocatedBscEmpty() const {
+            return allocated_bsc_mask.None();
         }
+        inline unsigned GetNumOfAllocatedBsc() const { return allocated_bsc_mask.Count(); }
+        inline bool IsBscAllocated(BSC_INDEX bsc_index) const { return allocated_bsc_mask.Test(bsc_index); }
+        inline bool IsBankAllocated(RealBaIndex real_ba) const { return ba2bsc_table[real_ba] != kInvalidBscIndex; }
 
         inline BSC_INDEX GetRdOldestPageHitBsc(){
             return _scheduler.GetRdCam()->GetOldestPageHitCmdBsc();
@@ -87,7 +91,7 @@ class BankSliceManager{
 
         inline bool IsRdAccess()
         {
-            for(auto& bsc_index: allocated_bsc_index_set)
+            for(auto bsc_index: allocated_bsc_mask)
             {
                 BankSlice* bank_slice = bsc_index_2_bankslice[bsc_index].get();
                 if(bank_slice->IsRdRowCmdAvail())
@@ -97,7 +101,7 @@ class BankSliceManager{
         }
         inline bool IsWrAccess()
         {
-            for(auto& bsc_index: allocated_bsc_index_set)
+            for(auto bsc_index: allocated_bsc_mask)
             {
                 BankSlice* bank_slice = bsc_index_2_bankslice[bsc_index].get();
                 if(bank_slice->IsWrRowCmdAvail())
@@ -108,7 +112,7 @@ class BankSliceManager{
 
         inline bool IsRdWait()
         {
-            for(auto& bsc_index: allocated_bsc_index_set)
+            for(auto bsc_index: allocated_bsc_mask)
             {
                 BankSlice* bank_slice = bsc_index_2_bankslice[bsc_index].get();
                 if(bank_slice->IsRdColCmdAvail())
@@ -118,7 +122,7 @@ class BankSliceManager{
         }
         inline bool IsWrWait()
         {
-            for(auto& bsc_index: allocated_bsc_index_set)
+            for(auto bsc_index: allocated_bsc_mask)
             {
                 BankSlice* bank_slice = bsc_index_2_bankslice[bsc_index].get();
                 if(bank_slice->IsWrColCmdAvail())
@@ -128,8 +132,15 @@ class BankSliceManager{
         }
 
 
-        inline std::set<BSC_INDEX> GetAllocatedBscSet(){   return allocated_bsc_index_set; }
-        inline BankSlice* GetBsc(BSC_INDEX bsc_index) { return bsc_index_2_bankslice.at(bsc_index).get(); }
+        // 已分配的 bsc, 直接引用内部 mask, 遍历期间不能分配/释放 bsc
+        inline const BscMask& GetAllocatedBscMask() const { return allocated_bsc_mask; }
+        inline BankSlice* GetBsc(BSC_INDEX bsc_index) const { return bsc_index_2_bankslice[bsc_index].get(); }
+        // ba 已分配 bsc 时返回对应的 BankSlice, 否则返回 nullptr
+        inline BankSlice* GetBaBsc(RealBaIndex real_ba) const
+        {
+            BSC_INDEX bsc_index = ba2bsc_table[real_ba];
+            return bsc_index == kInvalidBscIndex ? nullptr : bsc_index_2_bankslice[bsc_index].get();
+        }
 
 
         void NttUpdate();
@@ -164,7 +175,7 @@ class BankSliceManager{
 
         bool IsReadyCommandsEmpty(GlobalRdWrState global_rdwr_mode);
 
-        sc_core::sc_time GetNextCommandTriggerTime(); // if the cmd is not zero, then should get the last cmd sending time;
+        Tick GetNextCommandTriggerTime(); // if the cmd is not zero, then should get the last cmd sending time;
 
         ReadyCommands& GetReadyCommands();
 
@@ -174,8 +185,26 @@ class BankSliceManager{
         void AllocationUpdate();
 
 
-        std::unordered_map<RealBaIndex,BSC_INDEX>* GetBa2BscTable() { return &ba2bsc_table;}
-        std::unordered_map<BSC_INDEX, std::unique_ptr<BankSlice>>* GetBankSliceMap() { return &bsc_index_2_bankslice;}
+        // rfm_req 只在 ACT 时置位 (CommandUpdate 中记录), 被 RFM / RAADEC 清除的 bsc 在这里剔除
+        inline const BscMask& GetRfmReqBscMask()
+        {
+            BscMask rfm_req_candidates = rfm_req_bsc_mask;
+            for(auto bsc_index: rfm_req_candidates)
+            {
+                if(!bsc_index_2_bankslice[bsc_index]->IsRfmReq())
+                    rfm_req_bsc_mask.Reset(bsc_index);
+            }
+            return rfm_req_bsc_mask;
+        }
+
+        const Ba2BscTable* GetBa2BscTable() const { return &ba2bsc_table;}
+        // ba 当前映射的 bsc, ba 必须已分配 bsc
+        inline BSC_INDEX GetBscIndex(RealBaIndex real_ba) const
+        {
+            assert(real_ba < ba2bsc_table.size() && ba2bsc_table[real_ba] != kInvalidBscIndex);
+            return ba2bsc_table[real_ba];
+        }
+        const BankSliceTable* GetBankSliceMap() const { return &bsc_index_2_bankslice;}
 
 };
 
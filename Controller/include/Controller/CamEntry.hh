@@ -12,6 +12,7 @@
 
 #include "Controller/common/ControllerCommon.hh"
 #include "Configure/AddressDecoder.hh"
+#include "Controller/CamMask.hh"
 
 namespace dmu{
     namespace Controller{
@@ -48,6 +49,7 @@ namespace dmu{
 
         private:
             tlm::tlm_generic_payload* _request;
+            CamAttributeMask* attribute_mask{nullptr}; // 所属 cam 的属性 mask, link 进 cam 时绑定
         public:
             inline tlm::tlm_generic_payload* GetRequest() const { return _request; }
         public:
@@ -59,18 +61,22 @@ namespace dmu{
             void SetReleaseBsc();
             void SetAllocateBsc(BSC_INDEX allocated_bsc_index);
             void SetBaMatch(BSC_INDEX matched_bsc_index, bool _is_page_hit);
+            // 绑定时按当前属性置位, 解绑时清掉这个 cam index 的所有属性位
+            void BindAttributeMask(CamAttributeMask* _attribute_mask);
+            void UnbindAttributeMask();
 
             inline RealBaIndex GetCamEntryRealBa() const {return sdram_addr.real_ba;}
             inline bool IsPageHit() const {return is_page_hit;}
-            inline void SetPageOpen() { is_page_hit = true; }
-            inline void SetPageClose() { is_page_hit = false; }
+            inline void SetPageOpen() { is_page_hit = true; SyncAttributeMask(); }
+            inline void SetPageClose() { is_page_hit = false; SyncAttributeMask(); }
             inline bool IsAllocated() const {return is_allocated;}
 
-            inline void SetCollision() {is_addr_collision = true;}
+            inline void SetCollision() {is_addr_collision = true; SyncAttributeMask();}
             inline void SetCollision(AddrCollisionType _addr_collision_type)
             {
                 collision_type = _addr_collision_type;
                 is_addr_collision = (_addr_collision_type != AddrCollisionType::No_Collision && _addr_collision_type != AddrCollisionType::Invalid);
+                SyncAttributeMask();
             }
             inline bool IsAddrCollision() const {return is_addr_collision;}
             inline PriorityClass GetQosLevel() const {return qos.GetQosLevel();}
@@ -83,6 +89,15 @@ namespace dmu{
                        (qos.GetQosLevel() == PriorityClass::GPR || qos.GetQosLevel() == PriorityClass::GPW))
                        || ahead_scheduled_cmd_num >= cmd_aging_limit;
             }
+            // 可变属性 (allocated/page hit/collision) 改动后同步到 cam 的属性 mask
+            inline void SyncAttributeMask()
+            {
+                if(attribute_mask == nullptr)
+                    return;
+                attribute_mask->Assign(CamAttribute::Allocated, allocated_cam_index, is_allocated);
+                attribute_mask->Assign(CamAttribute::PageHit, allocated_cam_index, is_page_hit);
+                attribute_mask->Assign(CamAttribute::Collision, allocated_cam_index, is_addr_collision);
+            }
             void print(){
                 std::cout << "[Cam Entry]: { "
                           <<"cam index: "<<std::setw(3) << this->allocated_cam_index << "\t"
@@ -1,22 +1,22 @@
 #ifndef __CAM_FILTER_HH__
 #define __CAM_FILTER_HH__
 
-#include <unordered_set>
-
+#include "Controller/CamMask.hh"
 #include "Controller/WrCam.hh"
 #include "Controller/RdCam.hh"
 
 namespace dmu{
     namespace Controller{
 
+// 候选集合都是 cam 属性 mask 与 waiting mask 的位运算结果, 同一优先级内用 cam 的 age matrix 选最老的
 class WrCamFilter{
-    using Candidate_Cmd = std::unordered_set<CAM_INDEX>;
     public:
         explicit WrCamFilter(WrCam& wr_cam): _wr_cam(wr_cam) {}
         ~WrCamFilter() = default;
-        CAM_INDEX GetSelectedWrCamIndex(const WaitingList& wr_waiting_list, bool IsPageHitLimit);
-        CAM_INDEX GetSelectedWrCamIndex(const WaitingList& wr_waiting_list);
-        CAM_INDEX GetOldestCamIndex(const Candidate_Cmd& candidate_cmd);
+        // wr_waiting_mask: 参与仲裁的 cam index, 如 GetBaMask / GetUnallocatedBscMask
+        CAM_INDEX GetSelectedWrCamIndex(const CamMask& wr_waiting_mask, bool IsPageHitLimit);
+        CAM_INDEX GetSelectedWrCamIndex(const CamMask& wr_waiting_mask);
+        CAM_INDEX GetOldestCamIndex(const CamMask& candidate_cmd);
 
     private:
         WrCam& _wr_cam;
@@ -24,7 +24,6 @@ class WrCamFilter{
 };
 
 class RdCamFilter{
-    using Candidate_Cmd = std::unordered_set<CAM_INDEX>;
     private:
         RdCam& _rd_cam;
         const bool is_prefer_hit_than_hpr; // reg configure
@@ -36,9 +35,10 @@ class RdCamFilter{
         , is_prefer_hit_than_hpr(_is_prefer_hit_than_hpr)
         {}
         ~RdCamFilter() = default;
-        CAM_INDEX GetSelectedRdCamIndex(const WaitingList& rd_waiting_list,bool IsPageHitLimit);
-        CAM_INDEX GetSelectedRdCamIndex(const WaitingList& rd_waiting_list);
-        CAM_INDEX GetOldestCamIndex(const Candidate_Cmd& candidate_cmd);
+        // rd_waiting_mask: 参与仲裁的 cam index, 如 GetBaMask / GetUnallocatedBscMask
+        CAM_INDEX GetSelectedRdCamIndex(const CamMask& rd_waiting_mask,bool IsPageHitLimit);
+        CAM_INDEX GetSelectedRdCamIndex(const CamMask& rd_waiting_mask);
+        CAM_INDEX GetOldestCamIndex(const CamMask& candidate_cmd);
 
 };
 
@@ -1,14 +1,19 @@
 #ifndef __CAM_IF_HH__
 #define __CAM_IF_HH__
 
-#include <unordered_map>
-
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <limits>
 #include <list>
 #include <deque>
 #include <set>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "Controller/CamEntry.hh"
+#include "Controller/CamMask.hh"
 
 namespace dmu{
     namespace Controller{
@@ -19,25 +24,147 @@ using OrderList = std::list<CAM_INDEX>;
 using OrderEntryList = std::list<CamEntry*>;
 using UnallocatedCamIndex = std::set<CAM_INDEX>;
 using RealBaIndex = uint64_t;
+
+constexpr CAM_INDEX kInvalidCamIndex = std::numeric_limits<CAM_INDEX>::max();
+constexpr BSC_INDEX kInvalidBscIndex = std::numeric_limits<BSC_INDEX>::max();
+
+// 侵入式双向链表节点, 与 cam slot 一一对应
+struct CamLink
+{
+    CAM_INDEX prev{kInvalidCamIndex};
+    CAM_INDEX next{kInvalidCamIndex};
+};
+
+struct CamLinkHead
+{
+    CAM_INDEX head{kInvalidCamIndex};
+    CAM_INDEX tail{kInvalidCamIndex};
+    unsigned size{0};
+};
+
+// 按链表顺序遍历 cam index, 直接引用 CamIF 内部的链表, 不拷贝也不分配内存
+class CamIndexList
+{
+    public:
+        class Iterator
+        {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = CAM_INDEX;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const CAM_INDEX*;
+                using reference = const CAM_INDEX&;
+
+                Iterator(const CamLink* links, const CAM_INDEX* current): links(links), current(current) {}
+                inline const CAM_INDEX& operator*() const {return *current;}
+                inline Iterator& operator++() {current = &links[*current].next; return *this;}
+                inline bool operator==(const Iterator& other) const {return *current == *other.current;}
+                inline bool operator!=(const Iterator& other) const {return *current != *other.current;}
+            private:
+                const CamLink* links;
+                const CAM_INDEX* current;
+        };
+
+        CamIndexList(const CamLink* links, const CamLinkHead* list): links(links), list(list) {}
+        inline Iterator begin() const {return Iterator(links, &list->head);}
+        inline Iterator end() const {return Iterator(links, &kEndOfList);}
+        inline unsigned size() const {return list->size;}
+        inline bool empty() const {return list->size == 0;}
+        inline CAM_INDEX front() const {return list->head;}
+
+    private:
+        inline static constexpr CAM_INDEX kEndOfList = kInvalidCamIndex;
+        const CamLink* links;
+        const CamLinkHead* list;
+};
+
+// 按 cam index 从小到大遍历所有已使用的 slot
+class UsedCamIndexList
+{
+    public:
+        class Iterator
+        {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = CAM_INDEX;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const CAM_INDEX*;
+                using reference = CAM_INDEX;
+
+                Iterator(const CamEntry* const* slots, CAM_INDEX depth, CAM_INDEX index)
+                : slots(slots), depth(depth), index(index) {SkipEmpty();}
+                inline CAM_INDEX operator*() const {return index;}
+                inline Iterator& operator++() {index++; SkipEmpty(); return *this;}
+                inline bool operator==(const Iterator& other) const {return index == other.index;}
+                inline bool operator!=(const Iterator& other) const {return index != other.index;}
+            private:
+                inline void SkipEmpty()
+                {
+                    while(index < depth && slots[index] == nullptr)
+                    {
+                        index++;
+                    }
+                }
+                const CamEntry* const* slots;
+                CAM_INDEX depth;
+                CAM_INDEX index;
+        };
+
+        UsedCamIndexList(const CamEntry* const* slots, CAM_INDEX depth, const unsigned* num_of_entries)
+        : slots(slots), depth(depth), num_of_entries(num_of_entries) {}
+        inline Iterator begin() const {return Iterator(slots, depth, 0);}
+        inline Iterator end() const {return Iterator(slots, depth, depth);}
+        inline unsigned size() const {return *num_of_entries;}
+        inline bool empty() const {return *num_of_entries == 0;}
+
+    private:
+        const CamEntry* const* slots;
+        CAM_INDEX depth;
+        const unsigned* num_of_entries;
+};
+
+// cam 存储: 按 cam index 寻址的定长 slot array (entry 本身由 RdCam/WrCam 的 slot 原地构造)
+// 进入顺序与每个 bank 的进入顺序用 slot 旁边的侵入式双向链表维护, 插入/删除/遍历都不分配内存
+// 同时按 cam index 维护属性 bitmask / bank bitmask / age matrix, CamFilter 用位运算选出最老的候选
+// 地址冲突检测用按地址 hash 分桶的侵入式链表, 只需比较同一个桶里的 entry
+// 冲突按 burst 比较: 同一个 burst 内 column 不同的请求 (例如 64B 读与其后半 32B 的写) 地址重叠, 也算冲突
 class CamIF
 {
     public:
         CamIF() = delete;
         virtual ~CamIF() = default;
-        explicit CamIF(const unsigned& _cam_depth)
-        : is_cam_collision(false)
+        CamIF(const unsigned& _cam_depth, unsigned _num_of_banks, unsigned _burst_length)
+        : cam_depth(_cam_depth)
+        , cam_slot(_cam_depth, nullptr)
+        , age_link(_cam_depth)
+        , bank_link(_cam_depth)
+        , bank_list(_num_of_banks)
+        , bank_mask(_num_of_banks)
+        , age_matrix(_cam_depth)
+        , addr_link(_cam_depth)
+        , addr_bucket_bits(AddrBucketBits(_cam_depth))
+        , addr_bucket(std::size_t(1) << addr_bucket_bits)
+        , burst_column_mask(~(_burst_length - 1))
+        , is_cam_collision(false)
         , is_cam_expired(false)
-        , cam_depth(_cam_depth)
         {
-            // cam_store.reserve(cam_depth);
         }
 
     protected:
         const unsigned cam_depth; // the cam depth
-        std::unordered_map<CAM_INDEX, std::unique_ptr<CamEntry>> cam_store; // store the CamEntry and build the CamIndex <--> CamEntry map
-        std::set<CAM_INDEX> used_allocated_cam_index; // record the used cam index
-        OrderList cam_order_list; // record the cam entering order
-        std::unordered_map<RealBaIndex,OrderList> ba_cmds_order_list; // store the Ba Addr related Cam Cmd Order
+        std::vector<CamEntry*> cam_slot; // (cam index), nullptr 表示 slot 空闲
+        unsigned num_of_entries{0};
+        std::vector<CamLink> age_link; // (cam index) record the cam entering order
+        CamLinkHead age_list;
+        std::vector<CamLink> bank_link; // (cam index) store the Ba Addr related Cam Cmd Order
+        std::vector<CamLinkHead> bank_list; // (real ba)
+        CamAttributeMask attribute_mask; // (attribute)(cam index)
+        std::vector<CamMask> bank_mask; // (real ba)(cam index)
+        CamAgeMatrix age_matrix;
+        std::vector<CamLink> addr_link; // (cam index) 同一 hash 桶内的 entry
+        const unsigned addr_bucket_bits;
+        std::vector<CamLinkHead> addr_bucket; // (addr hash)
+        const unsigned burst_column_mask; // 去掉 burst 内的 column bit
 
         CAM_INDEX oldest_page_hit_cam_index; // find oldest page-hit and allocated
         CAM_INDEX oldest_page_miss_cam_index; // find oldest page-miss and allocated
@@ -47,35 +174,122 @@ class CamIF
 
         std::unordered_map<RealBaIndex,unsigned> num_of_page_hit_cmd_per_bank; // record the
 
+        // 派生类在自己的 slot 中构造好 entry 之后调用, 挂到进入顺序链表和 bank 链表的尾部
+        inline void LinkCamEntry(CAM_INDEX cam_index, CamEntry* cam_entry)
+        {
+            assert(cam_index < cam_depth && cam_slot[cam_index] == nullptr);
+            assert(cam_entry->GetCamEntryRealBa() < bank_list.size());
+            cam_slot[cam_index] = cam_entry;
+            num_of_entries++;
+            PushBack(age_link, age_list, cam_index);
+            PushBack(bank_link, bank_list[cam_entry->GetCamEntryRealBa()], cam_index);
+            age_matrix.Insert(cam_index, attribute_mask[CamAttribute::Valid]);
+            bank_mask[cam_entry->GetCamEntryRealBa()].Set(cam_index);
+            PushBack(addr_link, addr_bucket[AddrBucket(cam_entry->sdram_addr)], cam_index);
+            cam_entry->BindAttributeMask(&attribute_mask);
+        }
+        // 派生类销毁 slot 中的 entry 之前调用
+        inline void UnlinkCamEntry(CAM_INDEX cam_index)
+        {
+            assert(IsCamExist(cam_index));
+            cam_slot[cam_index]->UnbindAttributeMask();
+            bank_mask[cam_slot[cam_index]->GetCamEntryRealBa()].Reset(cam_index);
+            age_matrix.Remove(cam_index);
+            Remove(addr_link, addr_bucket[AddrBucket(cam_slot[cam_index]->sdram_addr)], cam_index);
+            Remove(bank_link, bank_list[cam_slot[cam_index]->GetCamEntryRealBa()], cam_index);
+            Remove(age_link, age_list, cam_index);
+            cam_slot[cam_index] = nullptr;
+            num_of_entries--;
+        }
+
+    private:
+        // 桶数取不小于 2 * cam depth 的 2 的幂, 平均每个桶不到一个 entry
+        static inline unsigned AddrBucketBits(unsigned cam_depth)
+        {
+            unsigned bits = 1;
+            while((1u << bits) < 2 * cam_depth)
+                bits++;
+            return bits;
+        }
+        // 只用 IsSameBurst 比较的字段, 保证同一个 burst 的地址一定落在同一个桶, 桶内再用 IsSameBurst 确认
+        inline std::size_t AddrBucket(const DecodedAddress& addr) const
+        {
+            uint64_t key = (uint64_t(addr.row) << 32) ^ (uint64_t(addr.column & burst_column_mask) << 12)
+                         ^ (uint64_t(addr.bankgroup) << 6) ^ (uint64_t(addr.bank) << 9) ^ (uint64_t(addr.cid) << 3) ^ uint64_t(addr.cs);
+            return (key * 0x9E3779B97F4A7C15ull) >> (64 - addr_bucket_bits);
+        }
+        inline bool IsSameBurst(const DecodedAddress& a, const DecodedAddress& b) const
+        {
+            return a.cs == b.cs && a.cid == b.cid && a.bankgroup == b.bankgroup && a.bank == b.bank && a.row == b.row
+                && (a.column & burst_column_mask) == (b.column & burst_column_mask);
+        }
+        static inline void PushBack(std::vector<CamLink>& links, CamLinkHead& list, CAM_INDEX cam_index)
+        {
+            links[cam_index].prev = list.tail;
+            links[cam_index].next = kInvalidCamIndex;
+            if(list.tail == kInvalidCamIndex)
+                list.head = cam_index;
+            else
+                links[list.tail].next = cam_index;
+            list.tail = cam_index;
+            list.size++;
+        }
+        static inline void Remove(std::vector<CamLink>& links, CamLinkHead& list, CAM_INDEX cam_index)
+        {
+            CamLink& link = links[cam_index];
+            if(link.prev == kInvalidCamIndex)
+                list.head = link.next;
+            else
+                links[link.prev].next = link.next;
+            if(link.next == kInvalidCamIndex)
+                list.tail = link.prev;
+            else
+                links[link.next].prev = link.prev;
+            link = CamLink();
+            list.size--;
+        }
+
     public:
         // get the cam cmd entring order
-        inline const OrderList& GetOrderList() const {return this->cam_order_list;}
+        inline CamIndexList GetOrderList() const {return CamIndexList(age_link.data(), &age_list);}
         // whether the Cam OrderList is empty, also mean whether the cam is empty
-        inline bool IsOrderListEmpty() const {return this->cam_order_list.empty();}
+        inline bool IsOrderListEmpty() const {return age_list.size == 0;}
         // decide the ba address related cam order list is whether empty
         inline bool IsBaOrderListEmpty(RealBaIndex ba_addr) const
         {
-            if(ba_cmds_order_list.find(ba_addr) == ba_cmds_order_list.end())
-            {
-                return true;
-            }
-            return this->ba_cmds_order_list.at(ba_addr).empty();
+            return ba_addr >= bank_list.size() || bank_list[ba_addr].size == 0;
         }
         // get the (ba address/ bank slice) related cam order list
-        inline const OrderList& GetBaOrderList(RealBaIndex ba_addr)
+        inline CamIndexList GetBaOrderList(RealBaIndex ba_addr) const
         {
-            // DPRINT_INFO(true, "Wr Cam Ba Get: ", "stage 0");
-            // assert(ba_cmds_order_list.find(ba_addr) != ba_cmds_order_list.end());
-            return ba_cmds_order_list.at(ba_addr);
+            assert(ba_addr < bank_list.size());
+            return CamIndexList(bank_link.data(), &bank_list[ba_addr]);
+        }
+        // (ba address/ bank slice) related cam index mask
+        inline const CamMask& GetBaMask(RealBaIndex ba_addr) const
+        {
+            assert(ba_addr < bank_mask.size());
+            return bank_mask[ba_addr];
+        }
+        inline const CamMask& GetAttributeMask(CamAttribute attribute) const {return attribute_mask[attribute];}
+        // 还没有分配 bsc 的 cam index
+        inline CamMask GetUnallocatedBscMask() const
+        {
+            return AndNot(attribute_mask[CamAttribute::Valid], attribute_mask[CamAttribute::Allocated]);
+        }
+        // candidate 中最早进入 cam 的 cam index, candidate 为空时返回 kInvalidCamIndex
+        inline CAM_INDEX GetOldestCamIndex(const CamMask& candidate) const
+        {
+            unsigned cam_index = age_matrix.Oldest(candidate);
+            return cam_index == CamMask::kNone ? kInvalidCamIndex : cam_index;
         }
         inline void SetBaPageHit(RealBaIndex ba_addr, unsigned open_page)
         {
             if(IsBaOrderListEmpty(ba_addr))
                 return;
-            auto ba_order_list = this->GetBaOrderList(ba_addr);
-            for(auto cam_index: ba_order_list)
+            for(auto cam_index: this->GetBaOrderList(ba_addr))
             {
-                auto cam_enrty = cam_store.at(cam_index).get();
+                auto cam_enrty = cam_slot[cam_index];
                 if(cam_enrty->sdram_addr.row == open_page)
                 {
                     cam_enrty->SetPageOpen();
@@ -90,27 +304,50 @@ class CamIF
         {
             if(IsBaOrderListEmpty(ba_addr))
                 return;
-            auto ba_order_list = this->GetBaOrderList(ba_addr);
-            for(auto cam_index: ba_order_list)
+            for(auto cam_index: this->GetBaOrderList(ba_addr))
             {
-                auto cam_enrty = cam_store.at(cam_index).get();
+                auto cam_enrty = cam_slot[cam_index];
                 cam_enrty->SetPageClose();
             }
         }
 
+        // 与 addr 地址冲突的 cam index (entry.sdram_addr == addr), 只遍历 addr 所在的 hash 桶
+        inline CamMask GetAddrMatchMask(const DecodedAddress& addr) const
+        {
+            CamMask addr_match_mask;
+            for(auto cam_index: CamIndexList(addr_link.data(), &addr_bucket[AddrBucket(addr)]))
+            {
+                if(IsSameBurst(cam_slot[cam_index]->sdram_addr, addr))
+                    addr_match_mask.Set(cam_index);
+            }
+            return addr_match_mask;
+        }
+        // 清掉上一次冲突检测留下的 collision 标记
+        inline void ResetAddrCollision()
+        {
+            CamMask collision_mask = attribute_mask[CamAttribute::Collision];
+            collision_mask.FindIf([&](unsigned cam_index) {
+                cam_slot[cam_index]->SetCollision(AddrCollisionType::No_Collision);
+                return false;
+            });
+        }
+
         // get the used cam index for cam
-        inline const std::set<unsigned>& GetUsedCamIndex() const {return used_allocated_cam_index;}
+        inline UsedCamIndexList GetUsedCamIndex() const {return UsedCamIndexList(cam_slot.data(), cam_depth, &num_of_entries);}
         inline bool IsCamExist(CAM_INDEX cam_index) const {
-            return used_allocated_cam_index.find(cam_index) != used_allocated_cam_index.end()
-                   && cam_store.count(cam_index) !=0;
+            return cam_index < cam_depth && cam_slot[cam_index] != nullptr;
+        }
+        // cam index 上有 entry, 且 entry 在 real_ba 这个 bank
+        inline bool IsCamEntryInBank(CAM_INDEX cam_index, RealBaIndex real_ba) const {
+            return IsCamExist(cam_index) && cam_slot[cam_index]->GetCamEntryRealBa() == real_ba;
         }
 
         inline OrderEntryList GetBaOrderEntryList(RealBaIndex ba_addr)
         {
             OrderEntryList ba_order_entry_list;
-            for(auto& cam_index: this->ba_cmds_order_list.at(ba_addr))
+            for(auto cam_index: this->GetBaOrderList(ba_addr))
             {
-                ba_order_entry_list.emplace_back(cam_store.at(cam_index).get());
+                ba_order_entry_list.emplace_back(cam_slot[cam_index]);
             }
             return ba_order_entry_list;
         }
@@ -128,7 +365,7 @@ class CamIF
         const WaitingList GetUnallocatedBscCamIndex()
         {
             std::list<CAM_INDEX> unallocated_bsc_cam_index;
-            for(const auto& cam_index: cam_order_list)
+            for(const auto& cam_index: this->GetOrderList())
             {
                 CamEntry* cam_entry = this->GetCamEntry(cam_index);
                 if(!cam_entry->IsAllocated())
@@ -143,32 +380,25 @@ class CamIF
             return unallocated_bsc_cam_index;
         }
 
-        BSC_INDEX GetOldestPageHitCmdBsc() // this situation may be empty value
+        // 最早的已分配 bsc 的 page hit 命令所在的 bsc, 没有时返回 kInvalidBscIndex
+        inline BSC_INDEX GetOldestPageHitCmdBsc() const
         {
-            for(auto it = cam_order_list.cbegin(); it != cam_order_list.cend();it++)
-            {
-                if(this->GetCamEntry(*it)->IsPageHit() && (this->GetCamEntry(*it)->IsAllocated()))
-                {
-                    return this->GetCamEntry(*it)->allocated_bsc_index;
-                }
-            }
-            // Implement with Codex
-            //TODO: return empty value
+            CamMask candidate = attribute_mask[CamAttribute::PageHit] & attribute_mask[CamAttribute::Allocated];
+            return GetAllocatedBscIndex(GetOldestCamIndex(candidate));
         }
-        BSC_INDEX GetOldestPageMissCmdBsc() // this situation may be empty value
+        // 最早的已分配 bsc 的 page miss 命令所在的 bsc, 没有时返回 kInvalidBscIndex
+        inline BSC_INDEX GetOldestPageMissCmdBsc() const
         {
-            for(auto it = cam_order_list.cbegin(); it != cam_order_list.cend();it++)
-            {
-                if(!(this->GetCamEntry(*it)->IsPageHit()) && (this->GetCamEntry(*it)->IsAllocated()))
-                {
-                    return this->GetCamEntry(*it)->allocated_bsc_index;
-                }
-            }
-            // Implement with Codex
-            //TODO: return empty value
+            CamMask candidate = AndNot(attribute_mask[CamAttribute::Allocated], attribute_mask[CamAttribute::PageHit]);
+            return GetAllocatedBscIndex(GetOldestCamIndex(candidate));
+        }
+        inline BSC_INDEX GetAllocatedBscIndex(CAM_INDEX cam_index) const
+        {
+            return cam_index == kInvalidCamIndex ? kInvalidBscIndex : cam_slot[cam_index]->allocated_bsc_index;
         }
         // Is Cam Empty
-        inline bool IsCamEmpty() const { return cam_store.empty();}
+        inline bool IsCamEmpty() const { return num_of_entries == 0;}
+        inline unsigned GetNumOfEntries() const { return num_of_entries;}
 
 
 };
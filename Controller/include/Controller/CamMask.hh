@@ -0,0 +1,224 @@
+#ifndef __CAM_MASK_HH__
+#define __CAM_MASK_HH__
+
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace dmu{
+    namespace Controller{
+
+// cam entry 的属性, 每个属性对应一个按 cam index 排列的 CamMask
+// expired 与时间相关, 不在这里维护, 由 CamFilter 在候选集合上现算
+enum class CamAttribute : unsigned
+{
+    Valid,
+    Allocated,
+    PageHit,
+    Collision,
+    Hpr, // HPR
+    Lpr, // LPR + GPR
+    NumOfAttributes
+};
+
+// 按 cam index 排列的定长 bitmask, bit i 对应 cam index i
+// 定长 4 个 64-bit word, 循环次数是编译期常量, 编译器可以直接展开/向量化 (-mavx2 时一条 256-bit 指令)
+class CamMask
+{
+    public:
+        static constexpr unsigned kBitsPerWord = 64;
+        static constexpr unsigned kNumOfWords = 4;
+        static constexpr unsigned kMaxCamDepth = kBitsPerWord * kNumOfWords;
+        static constexpr unsigned kNone = kMaxCamDepth; // FindFirst 没有找到时的返回值
+
+        CamMask() = default;
+
+        inline void Set(unsigned index) {assert(index < kMaxCamDepth); words[index / kBitsPerWord] |= Bit(index);}
+        inline void Reset(unsigned index) {assert(index < kMaxCamDepth); words[index / kBitsPerWord] &= ~Bit(index);}
+        inline void Assign(unsigned index, bool value) {if(value) Set(index); else Reset(index);}
+        // 超出范围 (如 kInvalidBscIndex) 时返回 false
+        inline bool Test(unsigned index) const {return index < kMaxCamDepth && (words[index / kBitsPerWord] & Bit(index)) != 0;}
+
+        inline bool Any() const
+        {
+            uint64_t any = 0;
+            for(unsigned i = 0; i < kNumOfWords; i++)
+                any |= words[i];
+            return any != 0;
+        }
+        inline bool None() const {return !Any();}
+        inline bool Intersects(const CamMask& other) const
+        {
+            uint64_t any = 0;
+            for(unsigned i = 0; i < kNumOfWords; i++)
+                any |= words[i] & other.words[i];
+            return any != 0;
+        }
+        inline unsigned Count() const
+        {
+            unsigned count = 0;
+            for(unsigned i = 0; i < kNumOfWords; i++)
+                count += __builtin_popcountll(words[i]);
+            return count;
+        }
+        // 最小的置位 cam index, 没有则返回 kNone
+        inline unsigned FindFirst() const
+        {
+            for(unsigned i = 0; i < kNumOfWords; i++)
+            {
+                if(words[i])
+                    return i * kBitsPerWord + __builtin_ctzll(words[i]);
+            }
+            return kNone;
+        }
+        // 不小于 from 的最小置位 index, 没有则返回 kNone (round-robin 用)
+        inline unsigned FindNext(unsigned from) const
+        {
+            if(from >= kMaxCamDepth)
+                return kNone;
+            unsigned i = from / kBitsPerWord;
+            uint64_t word = words[i] & (~uint64_t(0) << (from % kBitsPerWord));
+            while(true)
+            {
+                if(word)
+                    return i * kBitsPerWord + __builtin_ctzll(word);
+                if(++i == kNumOfWords)
+                    return kNone;
+                word = words[i];
+            }
+        }
+        // round-robin: 不小于 from 的最小置位, 没有则回绕到最小的置位, mask 为空时返回 kNone
+        inline unsigned FindNextWrap(unsigned from) const
+        {
+            unsigned index = FindNext(from);
+            return index != kNone ? index : FindFirst();
+        }
+        // 按 cam index 从小到大遍历置位, func 返回 true 时提前结束, 返回结束时的 cam index (没有则 kNone)
+        template<typename Func>
+        inline unsigned FindIf(Func func) const
+        {
+            for(unsigned i = 0; i < kNumOfWords; i++)
+            {
+                for(uint64_t word = words[i]; word; word &= word - 1)
+                {
+                    unsigned index = i * kBitsPerWord + __builtin_ctzll(word);
+                    if(func(index))
+                        return index;
+                }
+            }
+            return kNone;
+        }
+
+        // 按 index 从小到大遍历置位, 遍历期间 mask 不能修改
+        class Iterator
+        {
+            public:
+                Iterator(const CamMask* mask, unsigned word_index)
+                : mask(mask), word_index(word_index), word(word_index < kNumOfWords ? mask->words[word_index] : 0) {SkipEmpty();}
+                inline unsigned operator*() const {return word_index * kBitsPerWord + __builtin_ctzll(word);}
+                inline Iterator& operator++() {word &= word - 1; SkipEmpty(); return *this;}
+                inline bool operator==(const Iterator& other) const {return word_index == other.word_index && word == other.word;}
+                inline bool operator!=(const Iterator& other) const {return !(*this == other);}
+            private:
+                inline void SkipEmpty()
+                {
+                    while(word == 0 && word_index < kNumOfWords)
+                    {
+                        word_index++;
+                        word = word_index < kNumOfWords ? mask->words[word_index] : 0;
+                    }
+                }
+                const CamMask* mask;
+                unsigned word_index;
+                uint64_t word;
+        };
+        inline Iterator begin() const {return Iterator(this, 0);}
+        inline Iterator end() const {return Iterator(this, kNumOfWords);}
+
+        inline CamMask& operator&=(const CamMask& other)
+        {
+            for(unsigned i = 0; i < kNumOfWords; i++)
+                words[i] &= other.words[i];
+            return *this;
+        }
+        inline CamMask& operator|=(const CamMask& other)
+        {
+            for(unsigned i = 0; i < kNumOfWords; i++)
+                words[i] |= other.words[i];
+            return *this;
+        }
+        // this & ~other
+        inline CamMask& AndNot(const CamMask& other)
+        {
+            for(unsigned i = 0; i < kNumOfWords; i++)
+                words[i] &= ~other.words[i];
+            return *this;
+        }
+        friend inline CamMask operator&(CamMask lhs, const CamMask& rhs) {return lhs &= rhs;}
+        friend inline CamMask operator|(CamMask lhs, const CamMask& rhs) {return lhs |= rhs;}
+        friend inline CamMask AndNot(CamMask lhs, const CamMask& rhs) {return lhs.AndNot(rhs);}
+        inline bool operator==(const CamMask& other) const {return words == other.words;}
+        inline bool operator!=(const CamMask& other) const {return words != other.words;}
+
+    private:
+        static inline uint64_t Bit(unsigned index) {return uint64_t(1) << (index % kBitsPerWord);}
+        std::array<uint64_t, kNumOfWords> words{};
+};
+
+// 一个 cam 的全部属性 mask, entry 的 setter 通过它同步自己的那一位
+class CamAttributeMask
+{
+    public:
+        inline CamMask& operator[](CamAttribute attribute) {return masks[static_cast<unsigned>(attribute)];}
+        inline const CamMask& operator[](CamAttribute attribute) const {return masks[static_cast<unsigned>(attribute)];}
+        inline void Assign(CamAttribute attribute, unsigned cam_index, bool value) {(*this)[attribute].Assign(cam_index, value);}
+        inline void Reset(unsigned cam_index)
+        {
+            for(auto& mask: masks)
+                mask.Reset(cam_index);
+        }
+    private:
+        std::array<CamMask, static_cast<unsigned>(CamAttribute::NumOfAttributes)> masks;
+};
+
+// age matrix: older[i] 记录比 entry i 更早进入 cam 的 entry
+// 候选集合 C 中最老的 entry 即 C 中唯一满足 older[i] & C == 0 的 i
+class CamAgeMatrix
+{
+    public:
+        explicit CamAgeMatrix(unsigned cam_depth): older(cam_depth)
+        {
+            if(cam_depth > CamMask::kMaxCamDepth)
+            {
+                std::cerr << "cam depth " << cam_depth << " exceeds CamMask::kMaxCamDepth " << CamMask::kMaxCamDepth << std::endl;
+                std::abort();
+            }
+        }
+        // valid 为插入前 cam 中已有的 entry
+        inline void Insert(unsigned cam_index, const CamMask& valid)
+        {
+            older[cam_index] = valid;
+            older[cam_index].Reset(cam_index);
+        }
+        inline void Remove(unsigned cam_index)
+        {
+            for(auto& row: older)
+                row.Reset(cam_index);
+            older[cam_index] = CamMask();
+        }
+        // candidate 中最老的 cam index, candidate 为空时返回 CamMask::kNone
+        inline unsigned Oldest(const CamMask& candidate) const
+        {
+            return candidate.FindIf([&](unsigned cam_index) {return !older[cam_index].Intersects(candidate);});
+        }
+    private:
+        std::vector<CamMask> older; // (cam index)
+};
+
+    } // namespace Controller
+} // namespace dmu
+
+#endif
@@ -26,15 +26,21 @@ namespace dmu{
 class CmdSelect
 {
     using Rank_INDEX = unsigned;
+    using RankMask = CamMask; // (rank index), TotalNumOfLogicalRanks 不超过 CamMask::kMaxCamDepth
     public:
         explicit CmdSelect(const Configure& config, BankSliceManager& bank_slice_manager)
         : _config(config)
         , _bank_slice_manager(bank_slice_manager)
+        , mc_clock(config.mem_spec->tCK_mc)
+        , row_bsc2row_cmd(config.controller_config->BSC_NUM, nullptr)
+        , col_bsc2col_cmd(config.controller_config->BSC_NUM, nullptr)
+        , rank_index2rank_cmd(config.mem_spec->TotalNumOfLogicalRanks, nullptr)
         {};
         CommandTuple::Type SelectCommand(const ReadyCommands& ready_commands, GlobalRdWrState global_rdwr_state);
     private:
         BankSliceManager& _bank_slice_manager;
         const Configure& _config;
+        const McClock mc_clock;
 
         // ReadyCommands readyRasCommands;
         // ReadyCommands readyCasCommands;
@@ -45,7 +51,15 @@ class CmdSelect
 
         Rank_INDEX last_selected_rank_index{100};
 
-        const sc_core::sc_time MaxTime = sc_core::sc_max_time();
+        // 每次 SelectCommand 复用的仲裁表, 只有 mask 中置位的项有效, 指向本次的 ready_commands
+        std::vector<const CommandTuple::Type*> row_bsc2row_cmd; // (bsc index)
+        std::vector<const CommandTuple::Type*> col_bsc2col_cmd; // (bsc index)
+        std::vector<const CommandTuple::Type*> rank_index2rank_cmd; // (rank index)
+        BscMask row_bsc_mask;
+        BscMask col_bsc_mask;
+        RankMask rank_index_mask;
+
+        const Tick MaxTime = MaxTick;
 
 };
 
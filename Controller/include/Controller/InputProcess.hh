@@ -3,7 +3,6 @@
 
 #include <set>
 #include <vector>
-#include <deque>
 #include <tlm>
 
 #include "Configure/Configure.hh"
@@ -11,6 +10,8 @@
 #include "Configure/AddressDecoder.hh"
 #include "Controller/common/MemoryManager.hh"
 #include "Controller/common/ControllerCommon.hh"
+#include "Controller/CamMask.hh"
+#include "Common/RingQueue.hh"
 
 namespace dmu{
     namespace Controller{
@@ -74,7 +75,7 @@ class InputProcess
         inline bool IsPipBufferEmpty(){return rd_pip_buffer.empty() && wr_pip_buffer.empty(); }
         inline void ReleaseRdCamIndex(unsigned released_rd_cam_index)
         {
-            unallocated_rd_cam_index_set.insert(released_rd_cam_index);
+            unallocated_rd_cam_index_mask.Set(released_rd_cam_index);
         }
         inline void ReleaseWrCamIndex(unsigned released_wr_cam_index)
         {
@@ -87,23 +88,16 @@ class InputProcess
     private:
         const Configure& _config;
         // rd
-        std::set<unsigned> unallocated_rd_cam_index_set;
-        unsigned last_allocated_rd_cam_index;
+        // 空闲 cam index 用 bitmask 记录, 分配/释放不走堆
+        CamMask unallocated_rd_cam_index_mask;
+        unsigned last_allocated_rd_cam_index{0};
         inline unsigned AllocateRdCamIndex()
         {
-            assert(!unallocated_rd_cam_index_set.empty());
-            unsigned allocated_rd_cam_index;
-            auto bigger_than_last_granted = unallocated_rd_cam_index_set.lower_bound(last_allocated_rd_cam_index);
-            if(bigger_than_last_granted != unallocated_rd_cam_index_set.end())
-            {
-                allocated_rd_cam_index = *bigger_than_last_granted;
-            }
-            else
-            {
-                allocated_rd_cam_index = *unallocated_rd_cam_index_set.begin();
-            }
+            assert(unallocated_rd_cam_index_mask.Any());
+            // 不小于上次分配的最小空闲 index, 没有则回绕
+            unsigned allocated_rd_cam_index = unallocated_rd_cam_index_mask.FindNextWrap(last_allocated_rd_cam_index);
             UpdateLastAllocatedRdCamIndex(allocated_rd_cam_index);
-            unallocated_rd_cam_index_set.erase(allocated_rd_cam_index);
+            unallocated_rd_cam_index_mask.Reset(allocated_rd_cam_index);
             return allocated_rd_cam_index;
         }
         inline void UpdateLastAllocatedRdCamIndex(unsigned allocated_rd_cam_index)
@@ -114,15 +108,15 @@ class InputProcess
 
 
         // wr
-        std::set<unsigned> unallocated_wr_cam_index_set;
-        std::deque<unsigned> second_unallocated_wr_cam_index_vec;
+        CamMask unallocated_wr_cam_index_mask;
+        RingQueue<unsigned> second_unallocated_wr_cam_index_vec;
         inline unsigned AllocateWrCamIndex()
         {
             unsigned allocated_wr_cam_index;
-            if(!unallocated_wr_cam_index_set.empty())
+            if(unallocated_wr_cam_index_mask.Any())
             {
-                allocated_wr_cam_index = *unallocated_wr_cam_index_set.begin();
-                unallocated_wr_cam_index_set.erase(allocated_wr_cam_index);
+                allocated_wr_cam_index = unallocated_wr_cam_index_mask.FindFirst();
+                unallocated_wr_cam_index_mask.Reset(allocated_wr_cam_index);
             }
             else
             {
@@ -135,15 +129,16 @@ class InputProcess
         //first decide released_wr_cam_index,and then decide combinded_wr_cam_index;
 
     private:
-        std::deque<tlm::tlm_generic_payload*> interface_buffer;
-        std::deque<tlm::tlm_generic_payload*> temp_buffer;
-        std::deque<InputProcessReq> rd_pip_buffer;
-        std::deque<InputProcessReq> wr_pip_buffer;
+        RingQueue<tlm::tlm_generic_payload*> interface_buffer;
+        RingQueue<tlm::tlm_generic_payload*> temp_buffer;
+        RingQueue<InputProcessReq> rd_pip_buffer;
+        RingQueue<InputProcessReq> wr_pip_buffer;
         bool is_busy;
 
     private:
         // this function is about to split rmw transaction, or split the long transaction into short transactions.
         void SplitTrans(tlm::tlm_generic_payload& trans);
+        std::vector<tlm::tlm_generic_payload*> split_child_transes; // SplitTrans 的临时 buffer, 保留容量
 
     private:
         const AddressDecoder& _address_decoder;
@@ -21,6 +21,7 @@
 #include "Controller/Scheduler.hh"
 #include "Controller/BankSliceManager.hh"
 #include "Controller/ModeSwitch.hh"
+#include "Controller/PerformanceCounters.hh"
 #include "Controller/CmdSelect.hh"
 #include "Controller/RefreshMachineManager.hh"
 
@@ -30,7 +31,7 @@
 #include "tlm_core/tlm_2/tlm_2_interfaces/tlm_fw_bw_ifs.h"
 #include "tlm_core/tlm_2/tlm_generic_payload/tlm_gp.h"
 #include "tlm_core/tlm_2/tlm_generic_payload/tlm_phase.h"
-#include "tlm_utils/peq_with_cb_and_phase.h"
+#include "Common/CalendarPeq.hh"
 
 namespace dmu{
     namespace Controller{
@@ -44,14 +45,17 @@ class MemoryController: public sc_core::sc_module{
 public:
     tlm_utils::simple_target_socket<MemoryController> tSocket;
     tlm_utils::simple_initiator_socket<MemoryController> iSocket;
-    MemoryController(const sc_core::sc_module_name& name, const Configure& config, SdramConstraintIF* sdram_constraint)
+    // external_step 时不注册 ControllerMethod, 由外部 (DMU 的 ChannelStepper) 在 ctrl_event 触发时依次调用 StepPrepare / StepCommit
+    MemoryController(const sc_core::sc_module_name& name, const Configure& config, SdramConstraintIF* sdram_constraint,
+                     bool external_step = false)
     : sc_module(name)
     , tSocket("tSocket")
     , iSocket("iSocket")
     , _config(config)
-    , _sdram_constraint(dynamic_cast<SdramConstraintDDR5_3ds*>(sdram_constraint))
-    , payload_event_queue(this, &MemoryController::pipline_method)
+    , _sdram_constraint(sdram_constraint)
+    , payload_event_queue(this, &MemoryController::pipline_method, config.mem_spec->tCK_mc)
     , dfi_cycle_time(config.mem_spec->tCK_mc)
+    , mc_clock(config.mem_spec->tCK_mc)
     , ddr_cycle_time(config.mem_spec->tCK)
     , phy_cmd_delay(config.controller_config->PHY_CMD_DELAY * config.mem_spec->tCK)
     , phy_wdat_delay(config.controller_config->PHY_WDAT_DELAY * config.mem_spec->tCK)
@@ -60,21 +64,27 @@ public:
 
         iSocket.register_nb_transport_bw(this, &MemoryController::nb_transport_bw);
 
+        _perf_counters = std::make_unique<PerformanceCounters>(config);
         _scheduler = std::make_unique<Scheduler>(config);
         _input_process = std::make_unique<InputProcess>(config, *_scheduler);
-        _bankslice_manager = std::make_unique<BankSliceManager>(*_scheduler, config);
-        _mode_switch = std::make_unique<ModeSwitch>(*_scheduler, *_bankslice_manager, config);
+        _bankslice_manager = std::make_unique<BankSliceManager>(*_scheduler, config, *_perf_counters);
+        _mode_switch = std::make_unique<ModeSwitch>(*_scheduler, *_bankslice_manager, config, *_perf_counters);
         _cmd_select = std::make_unique<CmdSelect>(config, *_bankslice_manager);
         _refresh_machine_manager = std::make_unique<RefreshMachineManager>(*_bankslice_manager, config);
 
         _scheduler->RegisterBa2BscTable(_bankslice_manager->GetBa2BscTable());
         _scheduler->RegisterBscSliceMap(_bankslice_manager->GetBankSliceMap());
+        // refresh 与 bank slice 的 ready command 合在一起, 上限与两者各自 reserve 的容量之和相同
+        ready_commands.reserve(3 * config.controller_config->BSC_NUM + config.mem_spec->TotalNumOfLogicalRanks);
         SC_HAS_PROCESS(MemoryController);
 
 
-        SC_METHOD(ControllerMethod);
-        sensitive<< ctrl_event;
-        dont_initialize();
+        if(!external_step)
+        {
+            SC_METHOD(ControllerMethod);
+            sensitive<< ctrl_event;
+            dont_initialize();
+        }
 
         SC_METHOD(CreditSend);
         sensitive<< dfi_clock.neg();
@@ -97,22 +107,39 @@ public:
     {
         dfi_clock.bind(clk);
     }
+    // bank / mode switch 计数由 controller 记录, refresh / data bus 计数由 device 记录
+    inline PerformanceCounters& GetPerformanceCounters() { return *_perf_counters; }
+
+    // ControllerMethod 拆成两步, 供外部在 ctrl_event 触发时调用
+    inline const sc_core::sc_event& GetCtrlEvent() const { return ctrl_event; }
+    // bank slice release 和 AcTimingUpdate: 只读写本 controller / sdram constraint 的状态, 不调用 SystemC kernel 和 TLM 接口
+    void StepPrepare();
+    // 命令选择发送 / ntt 更新 / 请求入 cam / ctrl_event, 只能在仿真线程中调用
+    void StepCommit();
 
 private:
     const Configure& _config;
+    std::unique_ptr<PerformanceCounters> _perf_counters;
     std::unique_ptr<InputProcess> _input_process;
     std::unique_ptr<Scheduler> _scheduler;
     std::unique_ptr<BankSliceManager> _bankslice_manager;
     std::unique_ptr<ModeSwitch> _mode_switch;
     std::unique_ptr<CmdSelect> _cmd_select;
     std::unique_ptr<RefreshMachineManager> _refresh_machine_manager;
-    SdramConstraintDDR5_3ds* _sdram_constraint{nullptr};
+    SdramConstraintIF* _sdram_constraint{nullptr};
 
-    tlm_utils::peq_with_cb_and_phase<MemoryController> payload_event_queue;
+    CalendarPeq<MemoryController> payload_event_queue; // calendar 以 dfi cycle 为单位
     void pipline_method(tlm::tlm_generic_payload& trans, const tlm::tlm_phase& phase);
 private:
+    // credit 只在命令发出(cam entry 释放)时归还, 没有 credit 时不再每个 dfi cycle 唤醒
+    // 被 credit_event 唤醒后等到下一个 dfi 下降沿再发送, 与时钟驱动时的发送时刻一致
     void CreditSend()
     {
+        if(credit_event.triggered())
+        {
+            next_trigger(dfi_clock.negedge_event());
+            return;
+        }
         UifSideBandInfo uif_side_band_info;
         uif_side_band_info.hpr_credit_valid = _scheduler->HasHprCredit();
         if(uif_side_band_info.hpr_credit_valid)
@@ -131,13 +158,18 @@ private:
         }
         if(uif_side_band_info.hpr_credit_valid || uif_side_band_info.lpr_credit_valid || uif_side_band_info.tpw_credit_valid)
         {
-            UifSideBandExtension* uif_side_band_extension = new UifSideBandExtension(uif_side_band_info);
-            auto credit_trans = _input_process->GetMemoryManager().getDummyPayload();
-            credit_trans->set_extension<UifSideBandExtension>(uif_side_band_extension);
+            // dummy payload 上原来的 extension 已经被 CHIPort 读过, Attach 时放回 pool
+            auto& memory_manager = _input_process->GetMemoryManager();
+            auto credit_trans = memory_manager.getDummyPayload();
+            memory_manager.GetSideBandExtensionPool().Attach(*credit_trans)->_uif_side_band_info = uif_side_band_info;
             tlm::tlm_phase phase = UIF_CREDIT;
             sc_core::sc_time delay{sc_core::SC_ZERO_TIME};
             tSocket->nb_transport_bw(*credit_trans, phase, delay);
         }
+        if(!_scheduler->HasHprCredit() && !_scheduler->HasLprCredit() && !_scheduler->HasTpwCredit())
+        {
+            next_trigger(credit_event);
+        }
     }
 
 
@@ -160,13 +192,20 @@ private:
     void RdataProcess();
 
     void ControllerFinishCheck();
+    // RMW child (读/写) 完成, 两个 child 都完成后 release SplitTrans 时持有的 parent 引用
+    void CompleteChildTrans(tlm::tlm_generic_payload& child_trans);
     ReadyCommands ready_commands;
 
     sc_core::sc_event ctrl_event;
+    sc_core::sc_event credit_event; // credit returned, wake up CreditSend
+
+    // convert the next trigger tick of refresh/bank command to ctrl_event delay, MaxTick means no need to wake up
+    sc_core::sc_time WakeupDelay(Tick wakeup_time) const;
 
     sc_core::sc_time next_trigger_delay;
 
     const sc_core::sc_time dfi_cycle_time; // dfi clk time
+    const McClock mc_clock; // controller core time base, sc_time is only used at the TLM boundary
     const sc_core::sc_time ddr_cycle_time;
 
     const sc_core::sc_time phy_cmd_delay;
@@ -178,17 +217,21 @@ private:
 
     unsigned trans_send{0};
 
-    std::unordered_map<unsigned, tlm::tlm_generic_payload*> resp_queue;
+    // 已发 CAS 等待数据的 trans 数; payload 由 acquire/release 持有, 不需要按 id 查表
+    // (RMW 的两个 child 共用 parent 的 trans id, 按 id 建表本来也会互相覆盖)
+    unsigned outstanding_resp_num{0};
 
     inline void AddTrans2ResonseQueue(unsigned trans_id, tlm::tlm_generic_payload* trans)
     {
-        resp_queue.insert(std::make_pair(trans_id,trans));
+        (void)trans_id;
+        ++outstanding_resp_num;
         trans->acquire();
     }
     void RemoveTransFromResonseQueue(unsigned trans_id, tlm::tlm_generic_payload* trans)
     {
-        // trans->release();
-        resp_queue.erase(trans_id);
+        (void)trans_id;
+        --outstanding_resp_num;
+        trans->release();
     }
 };
 
@@ -15,7 +15,11 @@
 #include "tlm_core/tlm_2/tlm_generic_payload/tlm_gp.h"
 #include <tlm_utils/peq_with_cb_and_phase.h>
 
+#include "Common/BackingStore.hh"
+#include "Common/DfiTraceWriter.hh"
+#include "Common/LatencyStatistics.hh"
 #include "Configure/Configure.hh"
+#include "Controller/PerformanceCounters.hh"
 namespace dmu
 {
     namespace Controller
@@ -35,6 +39,17 @@ public:
     tlm_utils::simple_target_socket<MemoryDevice> tSocket;
 
     void PrintDfiCmd(tlm::tlm_generic_payload& trans);
+    // 写数据在 DFI_WDAT_END 写入 backing store, 读数据在 DFI_RDAT_BEGIN 从 backing store 取出; payload 需要带 data buffer
+    void EnableBackingStore();
+    inline const BackingStore* GetBackingStore() const { return backing_store.get(); }
+    // 关闭后不再把每个请求的 StatisticExtension 写到 TransInfo.txt, 延迟统计 (LatencyStats.json) 不受影响
+    void SetTransInfoEnabled(bool enable);
+    inline const LatencyStatistics& GetLatencyStatistics() const { return latency_statistics; }
+    // 记录 refresh / data bus 计数, 析构时把完整的计数写到 PerfCounters.json; counters 需要比 device 后析构
+    void RegisterPerformanceCounters(PerformanceCounters* counters);
+    // DfiCmd.txt / TransInfo.txt 改为写二进制的 DfiTrace.bin (compress 时按 block 压缩), 由 dmu_dfi_decode 还原
+    // 文件打不开时返回 false, 保持文本输出
+    bool EnableBinaryTrace(bool compress);
 
     MemoryDevice(const MemoryDevice&) = delete;
     MemoryDevice(MemoryDevice&&) = delete;
@@ -56,6 +71,18 @@ private:
     std::ofstream outFile_dfi_cmd;
 
     sc_core::sc_time record_last_trans_time{sc_core::SC_ZERO_TIME};
+
+    std::unique_ptr<BackingStore> backing_store;
+
+    // 请求的数据传输结束时调用: 记录延迟, 按需写 TransInfo.txt
+    void FinishTransaction(tlm::tlm_generic_payload& trans);
+    void PrintRefreshCmd(tlm::tlm_generic_payload& trans);
+    void TraceStatistics(const StatisticExtension& statistic);
+    std::unique_ptr<trace::DfiTraceWriter> dfi_trace;
+    bool trans_info_enable{true};
+    LatencyStatistics latency_statistics;
+    PerformanceCounters* perf_counters{nullptr};
+    static uint64_t GetDataAddress(tlm::tlm_generic_payload& trans, unsigned& length);
 };
 
     }
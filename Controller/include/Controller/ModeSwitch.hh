@@ -6,6 +6,7 @@
 
 #include "Controller/common/ControllerCommon.hh"
 #include "Controller/BankSliceManager.hh"
+#include "Controller/PerformanceCounters.hh"
 #include "Controller/Scheduler.hh"
 
 namespace dmu{
@@ -16,10 +17,11 @@ class ModeSwitch
 
     public:
         ModeSwitch() = delete;
-        explicit ModeSwitch(Scheduler& scheduler, BankSliceManager& bank_slice_manager, const Configure& config)
+        explicit ModeSwitch(Scheduler& scheduler, BankSliceManager& bank_slice_manager, const Configure& config, PerformanceCounters& perf_counters)
         : _scheduler(scheduler)
         , _bank_slice_manager(bank_slice_manager)
         , _config(config)
+        , _perf_counters(perf_counters)
         {}
 
         ~ModeSwitch() = default;
@@ -44,6 +46,7 @@ class ModeSwitch
         Scheduler& _scheduler; //
         BankSliceManager& _bank_slice_manager;
         const Configure& _config;
+        PerformanceCounters& _perf_counters;
 
 
         GlobalState st{GlobalState::RD};
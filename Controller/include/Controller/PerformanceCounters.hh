@@ -0,0 +1,130 @@
+#ifndef __PERFORMANCE_COUNTERS_HH__
+#define __PERFORMANCE_COUNTERS_HH__
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Configure/Configure.hh"
+#include "Controller/common/Command.hh"
+#include "Controller/common/ControllerCommon.hh"
+#include "sysc/kernel/sc_time.h"
+
+namespace dmu{
+    namespace Controller{
+
+/*
+controller 在线性能计数器, 取代离线解析 DfiCmd.txt
+    bank (real_ba):  rd / wr, page hit / miss / conflict, ACT / PRE 数目, 由 BankSlice::Update 记录
+    rank (real_cid): REFab / REFsb / RFMab / RFMsb 数目以及 refresh 阻塞的时间, 由 MemoryDevice 记录
+    mode switch:     Rd2Wr / Wr2Rd 切换次数, 各个 GlobalRdWrState 停留的时间, 由 ModeSwitch::UpdateGlobalState 记录
+    data bus:        rd / wr burst 数目, busy / idle 时间, 读写方向切换次数和切换间隔, 由 MemoryDevice 记录
+时间统一用 controller 时钟 (tCK_mc) 的 cycle 数输出
+WriteJson 输出结束时的完整报告; EnableSnapshot 后每隔 interval 追加一行累计的汇总值 (JSON lines)
+*/
+class PerformanceCounters
+{
+    public:
+        struct BankCounters
+        {
+            uint64_t reads{0};
+            uint64_t writes{0};
+            uint64_t hits{0};      // CAS 之前没有 ACT / PRE
+            uint64_t misses{0};    // bank 已经关闭, CAS 之前只需要 ACT
+            uint64_t conflicts{0}; // 打开的是其他 row, CAS 之前需要 PRE + ACT
+            uint64_t acts{0};
+            uint64_t pres{0};
+            // 上一次 CAS 之后是否发过 PRE / ACT, 下一个 CAS 据此分类
+            bool pending_pre{false};
+            bool pending_act{false};
+        };
+
+        struct RankCounters
+        {
+            uint64_t ref_ab{0};
+            uint64_t ref_sb{0};
+            uint64_t rfm_ab{0};
+            uint64_t rfm_sb{0};
+            sc_core::sc_time all_bank_blocked{sc_core::SC_ZERO_TIME};  // REFab / RFMab, 整个 rank 不可访问 tRFC
+            sc_core::sc_time same_bank_blocked{sc_core::SC_ZERO_TIME}; // REFsb / RFMsb, 每个 bank group 的一个 bank 不可访问 tRFCsb
+        };
+
+        struct DataBusCounters
+        {
+            uint64_t read_bursts{0};
+            uint64_t write_bursts{0};
+            uint64_t rd2wr_turnarounds{0};
+            uint64_t wr2rd_turnarounds{0};
+            sc_core::sc_time busy{sc_core::SC_ZERO_TIME};
+            sc_core::sc_time turnaround_gap{sc_core::SC_ZERO_TIME}; // 方向切换时前一个 burst 结束到下一个 burst 开始的间隔
+        };
+
+        explicit PerformanceCounters(const Configure& config);
+        ~PerformanceCounters() = default;
+
+        PerformanceCounters(const PerformanceCounters&) = delete;
+        PerformanceCounters& operator=(const PerformanceCounters&) = delete;
+
+        // BankSlice 发送 ACT / PRE / RD / RDA / WR / WRA 时调用
+        void RecordBankCommand(unsigned real_ba, Command::Type cmd);
+        // ModeSwitch 每次更新状态后调用, 上一次调用到现在的时间记到上一个状态
+        void RecordModeState(GlobalRdWrState state);
+        // MemoryDevice 收到 REFab / REFsb / RFMab / RFMsb 时调用
+        void RecordRefresh(unsigned real_cid, Command::Type cmd);
+        // MemoryDevice 在 DFI 数据开始时调用, burst 占用 [begin, begin + tBurst)
+        void RecordDataBurst(bool is_read, const sc_core::sc_time& begin);
+
+        // 每隔 interval 向 filename 追加一行汇总, 文件打不开时返回 false
+        bool EnableSnapshot(const std::string& filename, const sc_core::sc_time& interval);
+
+        inline const std::vector<BankCounters>& GetBankCounters() const { return banks; }
+        inline const std::vector<RankCounters>& GetRankCounters() const { return ranks; }
+        inline const DataBusCounters& GetDataBusCounters() const { return data_bus; }
+        BankCounters GetTotalBankCounters() const;
+
+        void WriteJson(std::ostream& os) const;
+        // 文件打不开时返回 false
+        bool WriteJson(const std::string& filename) const;
+
+    private:
+        const McClock mc_clock;
+        const sc_core::sc_time t_burst;
+        const sc_core::sc_time t_rfc;
+        const sc_core::sc_time t_rfc_sb;
+
+        std::vector<BankCounters> banks;
+        std::vector<RankCounters> ranks;
+        DataBusCounters data_bus;
+
+        static constexpr std::size_t kNumOfModeStates = static_cast<std::size_t>(GlobalRdWrState::Invalid);
+        std::array<Tick, kNumOfModeStates> mode_cycles{};
+        GlobalRdWrState mode_state{GlobalRdWrState::Rd};
+        Tick mode_state_tick{0};
+        uint64_t rd2wr_switches{0};
+        uint64_t wr2rd_switches{0};
+
+        bool has_last_burst{false};
+        bool last_burst_is_read{false};
+        sc_core::sc_time last_burst_end{sc_core::SC_ZERO_TIME};
+
+        std::ofstream snapshot_file;
+        sc_core::sc_time snapshot_interval{sc_core::SC_ZERO_TIME};
+        sc_core::sc_time next_snapshot_time{sc_core::sc_max_time()};
+        // 记录事件之前检查是否越过了 snapshot 时刻, 不单独起进程 (不影响仿真在没有事件时结束)
+        void CheckSnapshot();
+        void WriteSnapshot(const sc_core::sc_time& time);
+
+        BankCounters& GetBank(unsigned real_ba);
+        RankCounters& GetRank(unsigned real_cid);
+        // 当前状态已经停留的时间也计入
+        std::array<Tick, kNumOfModeStates> GetModeCycles() const;
+        inline Tick ToCycles(const sc_core::sc_time& time) const { return mc_clock.ToTick(time); }
+};
+
+    }
+}
+
+#endif
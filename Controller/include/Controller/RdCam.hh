@@ -5,7 +5,9 @@
 #include <unordered_map>
 #include <list>
 #include <vector>
+#include <cassert>
 #include <deque>
+#include <optional>
 #include <set>
 
 #include "Configure/Configure.hh"
@@ -37,7 +39,11 @@ class RdCam: public CamIF
 
         void StoreRequest(InputProcessReq& rd_request) override;
 
-        RdCamEntry* GetCamEntry(const CAM_INDEX& cam_index) override { return dynamic_cast<RdCamEntry*>(cam_store.at(cam_index).get());}
+        RdCamEntry* GetCamEntry(const CAM_INDEX& cam_index) override
+        {
+            assert(IsCamExist(cam_index));
+            return &*rd_cam_slot[cam_index];
+        }
 
         void DeleteCamEntry(CAM_INDEX removed_cam_index) override;
 
@@ -57,12 +63,11 @@ class RdCam: public CamIF
 
         inline bool IsBaListAvail(RealBaIndex ba_addr)
         {
-            if(ba_cmds_order_list.find(ba_addr) == ba_cmds_order_list.end())
+            if(IsBaOrderListEmpty(ba_addr))
             {
                 return false;
             }
-            auto ba_list = GetBaOrderList(ba_addr);
-            for(auto cam_index : ba_list)
+            for(auto cam_index : GetBaOrderList(ba_addr))
             {
                 if(GetCamEntry(cam_index)->is_allocated)
                     return true;
@@ -70,8 +75,8 @@ class RdCam: public CamIF
             return false;
         }
 
-        inline bool IsHprFull() const { return hpr_cmd_set.size() >= _config.controller_config->HPR_CREDIT; }
-        inline bool IsLprFull() const { return lpr_cmd_set.size() >= _config.controller_config->LPR_CREDIT; }
+        inline bool IsHprFull() const { return num_of_hpr_cmd >= _config.controller_config->HPR_CREDIT; }
+        inline bool IsLprFull() const { return num_of_lpr_cmd >= _config.controller_config->LPR_CREDIT; }
         bool IsRdCamExpired() const;
         inline bool IsRdCamCollision() const { return !collision_rd_cam_index_vec.empty(); }
 
@@ -80,18 +85,18 @@ class RdCam: public CamIF
 
         inline bool IsPageHitLimit() const { return true; }
 
-        inline unsigned GetHprSize() const { return hpr_cmd_set.size(); }
-        inline unsigned GetLprSize() const { return lpr_cmd_set.size(); }
+        inline unsigned GetHprSize() const { return num_of_hpr_cmd; }
+        inline unsigned GetLprSize() const { return num_of_lpr_cmd; }
         inline bool IsHprAlmostFull() const { return hpr_fill_level_pos; } // detect the fill level exceed high threshold
         inline bool IsLprAlmostFull() const { return lpr_fill_level_pos; } // detect the fill level exceed high threshold
 
         inline void UpdateHprFillLevel()
         {
-            if(hpr_cmd_set.size() < _config.controller_config->HPR_LOW_THRESHOLD)
+            if(num_of_hpr_cmd < _config.controller_config->HPR_LOW_THRESHOLD)
             {
                 hpr_fill_level = false;
             }
-            else if(hpr_cmd_set.size() >= _config.controller_config->HPR_HIGH_THRESHOLD)
+            else if(num_of_hpr_cmd >= _config.controller_config->HPR_HIGH_THRESHOLD)
             {
                 hpr_fill_level_pos = !hpr_fill_level;
                 hpr_fill_level = true;
@@ -100,11 +105,11 @@ class RdCam: public CamIF
 
         inline void UpdateLprFillLevel()
         {
-            if(lpr_cmd_set.size() < _config.controller_config->LPR_LOW_THRESHOLD)
+            if(num_of_lpr_cmd < _config.controller_config->LPR_LOW_THRESHOLD)
             {
                 lpr_fill_level = false;
             }
-            else if(lpr_cmd_set.size() >= _config.controller_config->LPR_HIGH_THRESHOLD)
+            else if(num_of_lpr_cmd >= _config.controller_config->LPR_HIGH_THRESHOLD)
             {
                 lpr_fill_level_pos = !lpr_fill_level;
                 lpr_fill_level = true;
@@ -158,7 +163,7 @@ class RdCam: public CamIF
             else
             {
                 if(!IsHprStarve())
-                    hpr_starve_vec.push_back(sc_core::sc_time_stamp());
+                    hpr_starve_vec.push_back(mc_clock.Now());
             }
         }
         // lpr cmd exe
@@ -186,7 +191,7 @@ class RdCam: public CamIF
             else
             {
                 if(!IsLprStarve())
-                    lpr_starve_vec.push_back(sc_core::sc_time_stamp());
+                    lpr_starve_vec.push_back(mc_clock.Now());
             }
         }
 
@@ -194,24 +199,20 @@ class RdCam: public CamIF
 
         inline bool IsHprAvailable()
         {
-            for(auto& hpr_cam_index: hpr_cmd_set)
+            for(auto& rd_cam_entry: rd_cam_slot)
             {
-                if(GetCamEntry(hpr_cam_index)->is_allocated)
+                if(rd_cam_entry && rd_cam_entry->GetQosLevel() == PriorityClass::HPR && rd_cam_entry->is_allocated)
                     return true;
-                else
-                    continue;
             }
             return false;
         }
 
         inline bool IsLprAvailable()
         {
-            for(auto& lpr_cam_index: lpr_cmd_set)
+            for(auto& rd_cam_entry: rd_cam_slot)
             {
-                if(GetCamEntry(lpr_cam_index)->is_allocated)
+                if(rd_cam_entry && rd_cam_entry->GetQosLevel() != PriorityClass::HPR && rd_cam_entry->is_allocated)
                     return true;
-                else
-                    continue;
             }
             return false;
         }
@@ -220,15 +221,17 @@ class RdCam: public CamIF
         inline void AddRdCollisionCamIndex(CAM_INDEX collision_cam_index) { collision_rd_cam_index_vec.push_back(collision_cam_index); }
         // clear all the collision cam index
         inline void ClearRdCollisionCamIndex() { collision_rd_cam_index_vec.clear(); }
-        inline std::vector<CAM_INDEX> GetRdCollisionCamIndex() const { return collision_rd_cam_index_vec; }
+        inline const std::vector<CAM_INDEX>& GetRdCollisionCamIndex() const { return collision_rd_cam_index_vec; }
 
         inline bool IsRdCamBusy() const { return !collision_rd_cam_index_vec.empty(); }
 
     private:
         const Configure& _config;
+        const McClock mc_clock;
 
-        std::set<CAM_INDEX> hpr_cmd_set;
-        std::set<CAM_INDEX> lpr_cmd_set; // for lpr and gpr
+        std::vector<std::optional<RdCamEntry>> rd_cam_slot; // (cam index) entry 原地构造, 不做堆分配
+        unsigned num_of_hpr_cmd{0};
+        unsigned num_of_lpr_cmd{0}; // for lpr and gpr
 
         std::deque<CAM_INDEX> collison_cam_index;
         std::deque<CAM_INDEX> time_expired_cam_index;
@@ -251,19 +254,19 @@ class RdCam: public CamIF
         unsigned hpr_run_lenth_cnt{0};
         unsigned lpr_run_lenth_cnt{0};
 
-        std::vector<sc_core::sc_time> hpr_starve_vec;
-        std::vector<sc_core::sc_time> lpr_starve_vec;
+        std::vector<Tick> hpr_starve_vec;
+        std::vector<Tick> lpr_starve_vec;
 
         inline bool IsHprStarve()
         {
             return _config.controller_config->HPR_STARVE_COUNT_MODE ? hpr_starve_vec.size() >= _config.controller_config->HPR_MAX_STARVE
-                 : (*hpr_starve_vec.begin()) + _config.controller_config->HPR_MAX_STARVE * _config.mem_spec->tCK_mc >= sc_core::sc_time_stamp();
+                 : (*hpr_starve_vec.begin()) + _config.controller_config->HPR_MAX_STARVE >= mc_clock.Now();
         }
 
         inline bool IsLprStarve()
         {
             return _config.controller_config->LPR_STARVE_COUNT_MODE ? lpr_starve_vec.size() >= _config.controller_config->LPR_MAX_STARVE
-                 : (*lpr_starve_vec.begin()) + _config.controller_config->LPR_MAX_STARVE * _config.mem_spec->tCK_mc >= sc_core::sc_time_stamp();
+                 : (*lpr_starve_vec.begin()) + _config.controller_config->LPR_MAX_STARVE >= mc_clock.Now();
         }
 
         bool hpr_cam_full{false};
@@ -25,6 +25,7 @@ class RefreshMachine{
         , cid(rank_id % config.mem_spec->NumOfLogicalRanksPerPhysicalRank)
         , _bank_slice_manager(bank_slice_manager)
         , _configure(config)
+        , mc_clock(config.mem_spec->tCK_mc)
         , post_pone_threshold(
             (config.mem_spec->RefMode == RefModeTypeDDR5::FGR)
                 ? config.controller_config->REFRESH_PENDING_THRESHOLD_FGR  // MaxPostpone2x
@@ -33,7 +34,7 @@ class RefreshMachine{
         {
             unsigned temp_multiplier = config.controller_config->MR4_TEMP_MULTIPLIER;
             if (temp_multiplier == 0) temp_multiplier = 1;
-            current_trefi = config.mem_spec->tREFI_mc / temp_multiplier;
+            current_trefi = config.mem_spec->nREFI_mc / temp_multiplier;
 
             // unsigned RankBits = config.address_decoder;
             for(unsigned bank_id = rank_id * config.mem_spec->NumOfBankPerLogicalRank; bank_id < (rank_id+1) * config.mem_spec->NumOfBankPerLogicalRank; bank_id++)
@@ -46,17 +47,17 @@ class RefreshMachine{
                     // RTL 对齐：读取 RANK_TREFI_START_VALUES 数组，每个 Rank 独立配置偏移（对应 Rank${i}TrefiStartValue 寄存器）
                     const auto& start_values = config.controller_config->RANK_TREFI_START_VALUES;
                     double offset_ns = (rank_id < start_values.size()) ? start_values[rank_id]
-                                     : (current_trefi.to_seconds() * 1e9 / config.mem_spec->TotalNumOfLogicalRanks * rank_id);
-                    next_refresh_trigger_time = current_trefi + sc_core::sc_time(offset_ns, sc_core::SC_NS);
-                    std::cout << "[RefreshMachine Init] RankId: " << rank_id << " StaggerOffset: " << offset_ns << " ns NextTriggerTime: " << next_refresh_trigger_time << std::endl;
+                                     : (mc_clock.ToTime(current_trefi).to_seconds() * 1e9 / config.mem_spec->TotalNumOfLogicalRanks * rank_id);
+                    next_refresh_trigger_time = current_trefi + mc_clock.ToTickCeil(sc_core::sc_time(offset_ns, sc_core::SC_NS));
+                    std::cout << "[RefreshMachine Init] RankId: " << rank_id << " StaggerOffset: " << offset_ns << " ns NextTriggerTime: " << mc_clock.ToTime(next_refresh_trigger_time) << std::endl;
                 } else {
                     next_refresh_trigger_time = current_trefi;
-                    std::cout << "[RefreshMachine Init] RankId: " << rank_id << " NextTriggerTime: " << next_refresh_trigger_time << std::endl;
+                    std::cout << "[RefreshMachine Init] RankId: " << rank_id << " NextTriggerTime: " << mc_clock.ToTime(next_refresh_trigger_time) << std::endl;
                 }
             }
             else
             {
-                next_refresh_trigger_time = sc_core::sc_max_time();
+                next_refresh_trigger_time = MaxTick;
             }
 
             rank_address = BankAddress(0,cs,cid,rank_id);
@@ -82,7 +83,7 @@ class RefreshMachine{
 
         void UpdateTempRefreshMultiplier(unsigned multiplier) {
             if (multiplier == 0) multiplier = 1;
-            current_trefi = _configure.mem_spec->tREFI_mc / multiplier;
+            current_trefi = _configure.mem_spec->nREFI_mc / multiplier;
         }
 
         // check the rank bank is closed, so that the refresh command can be issued
@@ -93,16 +94,13 @@ class RefreshMachine{
         // if set bsc waiting for refresh, the active bsc should send precharge command, and then keep idle
         bool IsAllBanksClosed()
         {
-            auto ba2bsc_index_table = _bank_slice_manager.GetBa2BscTable();
-            auto bank_slice_map = _bank_slice_manager.GetBankSliceMap();
             for(auto bank_id: rank_banks)
             {
-                if(ba2bsc_index_table->find(bank_id) == ba2bsc_index_table->end())
+                auto bank_slice = _bank_slice_manager.GetBaBsc(bank_id);
+                if(bank_slice == nullptr)
                 {
                     continue;
                 }
-                auto bsc_index = ba2bsc_index_table->at(bank_id);
-                auto bank_slice = bank_slice_map->at(bsc_index).get();
 
                 if (!_configure.controller_config->REFAB_ENABLE) {
                     if (bank_slice->GetBaAddr().bank != current_refsb_ba) {
@@ -120,16 +118,13 @@ class RefreshMachine{
 
         void SetBankInRefreshWaiting()
         {
-            auto ba2bsc_index_table = _bank_slice_manager.GetBa2BscTable();
-            auto bank_slice_map = _bank_slice_manager.GetBankSliceMap();
             for(auto bank_id: rank_banks)
             {
-                if(ba2bsc_index_table->find(bank_id) == ba2bsc_index_table->end())
+                auto bank_slice = _bank_slice_manager.GetBaBsc(bank_id);
+                if(bank_slice == nullptr)
                 {
                     continue;
                 }
-                auto bsc_index = ba2bsc_index_table->at(bank_id);
-                auto bank_slice = bank_slice_map->at(bsc_index).get();
 
                 if (!_configure.controller_config->REFAB_ENABLE) {
                     if (bank_slice->GetBaAddr().bank != current_refsb_ba) {
@@ -137,14 +132,14 @@ class RefreshMachine{
                     }
                 }
 
-                (bank_slice_map->at(bsc_index))->SetRefreshWaiting();
+                bank_slice->SetRefreshWaiting();
             }
         }
 
         void Evaluate()
         {
             next_command = Command::NOP;
-            if(sc_core::sc_time_stamp() >= next_refresh_trigger_time)
+            if(mc_clock.Now() >= next_refresh_trigger_time)
             {
                 next_refresh_trigger_time += current_trefi;
                 refresh_pending_count++;
@@ -152,12 +147,12 @@ class RefreshMachine{
             if(refresh_pending_count > 0)
             {
                 // H: 协议合规检查——连续两次刷新间隔不得超过 5×tREFI（JEDEC 4.13.6）
-                if (!is_critical && last_ref_sent_time != sc_core::SC_ZERO_TIME) {
-                    sc_core::sc_time gap = sc_core::sc_time_stamp() - last_ref_sent_time;
+                if (!is_critical && last_ref_sent_time != 0) {
+                    Tick gap = mc_clock.Now() - last_ref_sent_time;
                     if (gap > current_trefi * 5) {
                         is_critical = true;
-                        std::cout << "@" << sc_core::sc_time_stamp() << ": [JEDEC] Refresh gap " << gap
-                                  << " exceeds 5*tREFI=" << current_trefi * 5 << ", Critical Enter (protocol compliance)!" << std::endl;
+                        std::cout << "@" << sc_core::sc_time_stamp() << ": [JEDEC] Refresh gap " << mc_clock.ToTime(gap)
+                                  << " exceeds 5*tREFI=" << mc_clock.ToTime(current_trefi * 5) << ", Critical Enter (protocol compliance)!" << std::endl;
                     }
                 }
 
@@ -230,9 +225,9 @@ class RefreshMachine{
                 }
 
                 std::cout << "@" << sc_core::sc_time_stamp() << ": Send " << (update_cmd == Command::REFab ? "REFab" : "REFsb") << std::endl;
-                last_ref_sent_time = sc_core::sc_time_stamp(); // H: 记录用于 5×tREFI 合规检查
+                last_ref_sent_time = mc_clock.Now(); // H: 记录用于 5×tREFI 合规检查
 
-                recent_ref_timestamps.push_back(sc_core::sc_time_stamp());
+                recent_ref_timestamps.push_back(mc_clock.Now());
                 size_t burst_limit = (_configure.mem_spec->RefMode == RefModeTypeDDR5::FGR) ? 9 : 5;
                 if (recent_ref_timestamps.size() > burst_limit) {
                     recent_ref_timestamps.pop_front();
@@ -248,13 +243,11 @@ class RefreshMachine{
 
                 // RTL 对齐：普通 REF 发出后，对 rank 内所有 bank 触发 RAADEC 退火（cnt_raa -= RAADEC）
                 {
-                    auto ba2bsc_index_table = _bank_slice_manager.GetBa2BscTable();
-                    auto bank_slice_map = _bank_slice_manager.GetBankSliceMap();
                     unsigned raadec = _configure.controller_config->RAADEC;
                     for (auto bank_id : rank_banks) {
-                        if (ba2bsc_index_table->find(bank_id) == ba2bsc_index_table->end()) continue;
-                        auto bsc_index = ba2bsc_index_table->at(bank_id);
-                        bank_slice_map->at(bsc_index)->DecreaseRaa(raadec);
+                        auto bank_slice = _bank_slice_manager.GetBaBsc(bank_id);
+                        if (bank_slice == nullptr) continue;
+                        bank_slice->DecreaseRaa(raadec);
                     }
                 }
 
@@ -275,16 +268,13 @@ class RefreshMachine{
 
         void FreeRefreshCritical()
         {
-            auto ba2bsc_index_table = _bank_slice_manager.GetBa2BscTable();
-            auto bank_slice_map = _bank_slice_manager.GetBankSliceMap();
             for(auto bank_id: rank_banks)
             {
-                if(ba2bsc_index_table->find(bank_id) == ba2bsc_index_table->end())
+                auto bank_slice = _bank_slice_manager.GetBaBsc(bank_id);
+                if(bank_slice == nullptr)
                 {
                     continue;
                 }
-                auto bsc_index = ba2bsc_index_table->at(bank_id);
-                auto bank_slice = bank_slice_map->at(bsc_index).get();
 
                 // REFsb 模式下只解锁目标 Bank，其他 Bank 的 waiting 状态保持不变
                 if (!_configure.controller_config->REFAB_ENABLE) {
@@ -293,7 +283,7 @@ class RefreshMachine{
                     }
                 }
 
-                (bank_slice_map->at(bsc_index))->ClearRefreshWaiting();
+                bank_slice->ClearRefreshWaiting();
             }
         }
 
@@ -302,7 +292,7 @@ class RefreshMachine{
             return next_command;
         }
 
-        sc_core::sc_time& GetRefreshCommandAvailTime() { return command_avail_time; } // this function will return the command can be sent available time based on the AC Timing, if the command is NOP, return sc_max_time()
+        Tick& GetRefreshCommandAvailTime() { return command_avail_time; } // this function will return the command can be sent available time based on the AC Timing, if the command is NOP, return MaxTick
 
         inline unsigned GetRankId() const { return rank_id; }
         inline unsigned GetCs() const { return cs; }
@@ -313,40 +303,41 @@ class RefreshMachine{
         inline bool IsRefreshCritical() const { return is_critical; }
 
         inline bool IsRefreshCommandAvail() const { 
-            if (next_command == Command::NOP || command_avail_time > sc_core::sc_time_stamp()) return false;
+            if (next_command == Command::NOP || command_avail_time > mc_clock.Now()) return false;
             
             size_t burst_limit = (_configure.mem_spec->RefMode == RefModeTypeDDR5::FGR) ? 9 : 5;
             if (recent_ref_timestamps.size() == burst_limit) {
-                if (sc_core::sc_time_stamp() - recent_ref_timestamps.front() < current_trefi) {
+                if (mc_clock.Now() - recent_ref_timestamps.front() < current_trefi) {
                     return false; // Burst limit reached
                 }
             }
             return true;
         }
 
-        ReadyCommands GetRefreshAvailCommand()
+        // refresh command 可以发送时追加到 ready_commands
+        bool GetRefreshAvailCommand(ReadyCommands& ready_commands)
         {
-            ReadyCommands ready_commands;
-            if(IsRefreshCommandAvail())
-            {
-                ready_commands.emplace_back(next_command, 0, rank_address, command_avail_time, false);
-            }
-            return ready_commands;
+            if(!IsRefreshCommandAvail())
+                return false;
+            ready_commands.emplace_back(next_command, 0, rank_address, command_avail_time, false);
+            return true;
         }
 
-        sc_core::sc_time GetNextRefreshTriggerTime()
+        Tick GetNextRefreshTriggerTime()
         {
             return std::min(next_refresh_trigger_time, command_avail_time);
         }
+        // 下一次 tREFI 到期的时间, RefreshMachineManager 以它登记 timer wheel
+        inline Tick GetRefreshDeadline() const { return next_refresh_trigger_time; }
 
         void Print()
         {
             std::cout << "RankId: " << rank_id
             << " RankAddress: " << rank_address
             << " RefreshPendingCount: " << refresh_pending_count
-            << " NextTriggerTime: " << next_refresh_trigger_time
+            << " NextTriggerTime: " << mc_clock.ToTime(next_refresh_trigger_time)
             << " Next Command: " << next_command.to_string()
-            << " Command availalbe time: " << command_avail_time
+            << " Command availalbe time: " << mc_clock.ToTime(command_avail_time)
             << " Is Related Bank Closed: " << IsAllBanksClosed()
             << "\t";
             std::cout << "Related Bank Index: { ";
@@ -372,18 +363,19 @@ class RefreshMachine{
         const unsigned cs;
         const unsigned cid;
         Command next_command{Command::NOP};
-        sc_core::sc_time current_trefi;
+        Tick current_trefi;
 
         BankSliceManager& _bank_slice_manager;
         const Configure& _configure;
+        const McClock mc_clock;
 
         BankAddress rank_address;
 
         tlm::tlm_generic_payload* _refresh_trans;
         DfiExtension* dfi_extension;
 
-        sc_core::sc_time command_avail_time{sc_core::sc_max_time()};
-        sc_core::sc_time next_refresh_trigger_time; // the initial refresh trigger time should be set to staggered, based on the rank id and total rank number to decide the stagger time;
+        Tick command_avail_time{MaxTick};
+        Tick next_refresh_trigger_time; // the initial refresh trigger time should be set to staggered, based on the rank id and total rank number to decide the stagger time;
         std::vector<unsigned> rank_banks; // banks belongs to the logical rank, the recorded bank id should be real ba
         std::vector<unsigned> allocated_banks; // record the banks that are allocated bsc
 
@@ -394,18 +386,16 @@ class RefreshMachine{
         const unsigned post_pone_low_threshold;
         unsigned current_refsb_ba{0};
 
-        std::deque<sc_core::sc_time> recent_ref_timestamps;
+        RingQueue<Tick> recent_ref_timestamps;
 
         // H: 记录上一次实际发出 REF 的时间戳，用于 5×tREFI 合规检查
-        sc_core::sc_time last_ref_sent_time{sc_core::SC_ZERO_TIME};
+        Tick last_ref_sent_time{0};
 
         // A: 推测性刷新——检测系统是否空闲（无已分配的 BSC 正在处理交易）
         bool IsSystemIdle() const {
-            auto allocated_bsc = _bank_slice_manager.GetAllocatedBscSet();
-            if (allocated_bsc.empty()) return true;
-            auto bank_slice_map = _bank_slice_manager.GetBankSliceMap();
-            for (auto bsc_index : allocated_bsc) {
-                auto bs = bank_slice_map->at(bsc_index).get();
+            if (_bank_slice_manager.IsAllocatedBscEmpty()) return true;
+            for (auto bsc_index : _bank_slice_manager.GetAllocatedBscMask()) {
+                auto bs = _bank_slice_manager.GetBsc(bsc_index);
                 // 只要有任何 BSC 还有有效的读写命令待发，就不算空闲
                 if (bs->IsRdCmdAvail() || bs->IsWrCmdAvail() ||
                     bs->IsRdRowCmdAvail() || bs->IsWrRowCmdAvail()) {
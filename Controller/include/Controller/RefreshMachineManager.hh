@@ -2,27 +2,49 @@
 #define __REFRESHMACHINEMANAGER_HH__
 
 #include "Controller/BankSliceManager.hh"
+#include "Controller/CamMask.hh"
 #include "Controller/RefreshMachine.hh"
+#include "Controller/TimerWheel.hh"
 #include "Controller/common/Command.hh"
 #include "tlm_core/tlm_2/tlm_generic_payload/tlm_gp.h"
-#include <iterator>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 namespace dmu{
     namespace Controller{
 
+/*
+refresh 不再每个周期遍历所有 RefreshMachine:
+    每个 logical rank 的下一次 tREFI deadline 登记在 timer wheel 中, deadline 到期的 rank 进入 active
+    active rank 每个周期 Evaluate (等待 bank 关闭 / 发出 REF), 没有 pending refresh 之后退出 active, 直到下一次 deadline
+    非 active rank 的 refresh command 保持 NOP, 不需要 Evaluate
+    rfm_req 只在 ACT 时置位, 由 BankSliceManager 记录可能置位的 bsc, 不再遍历所有已分配的 bsc
+*/
 class RefreshMachineManager{
 
     public:
+        using RankMask = CamMask; // (logical rank id)
+
         RefreshMachineManager( BankSliceManager& bank_slice_manager,const Configure& config)
         : _bank_slice_manager(bank_slice_manager)
         , _config(config)
+        , mc_clock(config.mem_spec->tCK_mc)
+        , refresh_timer_wheel(config.mem_spec->TotalNumOfLogicalRanks)
         {
-            for(int i = 0; i < config.mem_spec->TotalNumOfLogicalRanks; i++){
+            if(config.mem_spec->TotalNumOfLogicalRanks > RankMask::kMaxCamDepth)
+            {
+                std::cerr << "TotalNumOfLogicalRanks " << config.mem_spec->TotalNumOfLogicalRanks << " exceeds RankMask::kMaxCamDepth " << RankMask::kMaxCamDepth << std::endl;
+                std::abort();
+            }
+            for(unsigned i = 0; i < config.mem_spec->TotalNumOfLogicalRanks; i++){
                 refresh_rank_ids.emplace_back(i);
-                refreshMachines.emplace(i,std::make_unique<RefreshMachine>(i, bank_slice_manager,config));
+                refresh_rank_mask.Set(i);
+                refreshMachines.emplace_back(std::make_unique<RefreshMachine>(i, bank_slice_manager,config));
+                refresh_timer_wheel.Schedule(i, refreshMachines[i]->GetRefreshDeadline());
             }
+            refresh_ready_commands.reserve(config.controller_config->BSC_NUM + config.mem_spec->TotalNumOfLogicalRanks);
         }
 
         // ReadyCommands GetRefreshReadyCommands(){
@@ -33,21 +55,38 @@ class RefreshMachineManager{
         //     }
         //     return ready_commands;
         // }
-        std::vector<unsigned> GetRefreshRankIds(){
+        inline const std::vector<unsigned>& GetRefreshRankIds() const {
             return refresh_rank_ids;
         }
+        inline const RankMask& GetRefreshRankMask() const { return refresh_rank_mask; }
         RefreshMachine* GetRefreshMachine(unsigned rank_index)
         {
             return refreshMachines.at(rank_index).get();
         }
 
+        // 推进 timer wheel, deadline 到期的 rank 进入 active; 返回本周期需要 Evaluate 的 rank
+        const RankMask& AdvanceRefreshTimer()
+        {
+            refresh_timer_wheel.Advance(mc_clock.Now(), [this](unsigned rank_index) {active_rank_mask.Set(rank_index);});
+            return active_rank_mask;
+        }
+        inline bool IsRankActive(unsigned rank_index) const { return active_rank_mask.Test(rank_index); }
+        // rank Evaluate 之后调用: 重新登记 deadline, 没有 pending refresh 的 rank 退出 active
+        void RefreshTimerUpdate(unsigned rank_index)
+        {
+            RefreshMachine* refresh_machine = refreshMachines[rank_index].get();
+            Tick deadline = refresh_machine->GetRefreshDeadline();
+            if(refresh_timer_wheel.GetDeadline(rank_index) != deadline)
+                refresh_timer_wheel.Schedule(rank_index, deadline);
+            if(refresh_machine->GetPendingCount() == 0)
+                active_rank_mask.Reset(rank_index);
+        }
+
         bool IsRefreshReadyCommandsEmpty(){
             refresh_ready_commands.clear();
 
-            auto bsc_map = _bank_slice_manager.GetBankSliceMap();
-            auto allocated_bsc = _bank_slice_manager.GetAllocatedBscSet();
-            for (auto bsc_index : allocated_bsc) {
-                auto bs = bsc_map->at(bsc_index).get();
+            for (auto bsc_index : _bank_slice_manager.GetRfmReqBscMask() & _bank_slice_manager.GetAllocatedBscMask()) {
+                auto bs = _bank_slice_manager.GetBsc(bsc_index);
                 if (bs->IsRfmReq()) {
                     Command cmd = _config.controller_config->REFAB_ENABLE ? Command::RFMab : Command::RFMsb;
                     // RTL 对齐：RFMsb 仅在 FGR 模式下允许（表 2-7），非 FGR 强制降级为 RFMab
@@ -56,16 +95,13 @@ class RefreshMachineManager{
                         std::cout << "@" << sc_core::sc_time_stamp() << ": [RFM] WARNING: RFMsb not allowed in non-FGR mode, fallback to RFMab" << std::endl;
                     }
                     BankAddress ba = bs->GetBaAddr();
-                    refresh_ready_commands.emplace_back(cmd, 0, ba, sc_core::sc_time_stamp(), false);
+                    refresh_ready_commands.emplace_back(cmd, 0, ba, mc_clock.Now(), false);
                 }
             }
 
-            for(auto& refresh_machine : refreshMachines){
-                auto refresh_commands = refresh_machine.second->GetRefreshAvailCommand();
-                if(!refresh_commands.empty())
-                {
-                    refresh_ready_commands.insert(refresh_ready_commands.end(), std::make_move_iterator(refresh_commands.begin()),std::make_move_iterator(refresh_commands.end()));
-                }
+            // 非 active rank 的 refresh command 是 NOP
+            for(auto rank_index : active_rank_mask){
+                refreshMachines[rank_index]->GetRefreshAvailCommand(refresh_ready_commands);
             }
             return refresh_ready_commands.empty();
         }
@@ -74,11 +110,11 @@ class RefreshMachineManager{
             return refresh_ready_commands;
         }
 
-        sc_core::sc_time GetNextRefreshTriggerTime(){
-            sc_core::sc_time next_refresh_time = sc_core::sc_time::from_value(std::numeric_limits<sc_dt::uint64>::max());
-            for(auto& refresh_machine : refreshMachines){
-                auto refresh_time = refresh_machine.second->GetNextRefreshTriggerTime();
-                next_refresh_time = std::min(next_refresh_time, refresh_time);
+        // 非 active rank 的 command avail time 是 MaxTick, 只需要看 timer wheel 中最早的 deadline
+        Tick GetNextRefreshTriggerTime(){
+            Tick next_refresh_time = refresh_timer_wheel.NextDeadline();
+            for(auto rank_index : active_rank_mask){
+                next_refresh_time = std::min(next_refresh_time, refreshMachines[rank_index]->GetNextRefreshTriggerTime());
             }
             return next_refresh_time;
         }
@@ -87,17 +123,12 @@ class RefreshMachineManager{
             Command sending_cmd_type = std::get<CommandTuple::Command>(sending_cmd);
             BankAddress sending_cmd_ba_addr = std::get<CommandTuple::BaAddress>(sending_cmd);
             unsigned sending_cmd_rank_index = sending_cmd_ba_addr.real_cid;
-            for(auto& refresh_machine : refreshMachines){
-                if(refresh_machine.first == sending_cmd_rank_index)
-                    refresh_machine.second->Update(sending_cmd);
-            }
+            refreshMachines.at(sending_cmd_rank_index)->Update(sending_cmd);
 
             // RFM 发送后清理对应 BankSlice 的 rfm_req 标志并重置 act_counter
             if (sending_cmd_type == Command::RFMab || sending_cmd_type == Command::RFMsb) {
-                auto bsc_map = _bank_slice_manager.GetBankSliceMap();
-                auto allocated_bsc = _bank_slice_manager.GetAllocatedBscSet();
-                for (auto bsc_index : allocated_bsc) {
-                    auto bs = bsc_map->at(bsc_index).get();
+                for (auto bsc_index : _bank_slice_manager.GetAllocatedBscMask()) {
+                    auto bs = _bank_slice_manager.GetBsc(bsc_index);
                     if (bs->GetBaAddr().real_cid == sending_cmd_ba_addr.real_cid) {
                         bs->ClearRfmReq();
                     }
@@ -106,10 +137,15 @@ class RefreshMachineManager{
         }
 
     private:
-        std::unordered_map<unsigned,std::unique_ptr<RefreshMachine>> refreshMachines;
+        std::vector<std::unique_ptr<RefreshMachine>> refreshMachines; // (logical rank id)
         std::vector<unsigned> refresh_rank_ids;
+        RankMask refresh_rank_mask;
         BankSliceManager& _bank_slice_manager;
         const Configure& _config;
+        const McClock mc_clock;
+
+        TimerWheel refresh_timer_wheel; // (logical rank id) -> 下一次 tREFI deadline
+        RankMask active_rank_mask; // deadline 已到期, 还有 pending refresh 的 rank
 
         ReadyCommands refresh_ready_commands;
 
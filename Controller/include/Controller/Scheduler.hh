@@ -1,10 +1,14 @@
 #ifndef __SCHEDULER_HH__
 #define __SCHEDULER_HH__
 
+#include <array>
 #include <cassert>
+#include <cstdlib>
+#include <iostream>
 #include <memory>
 #include <deque>
 #include <set>
+#include <vector>
 /*
  scheduler is will include
  1. WR CAM and RD CAM
@@ -28,6 +32,10 @@ namespace dmu{
     namespace Controller{
 class BankSlice;
 
+using BscMask = CamMask; // (bsc index), BSC_NUM 不超过 CamMask::kMaxCamDepth
+using Ba2BscTable = std::vector<BSC_INDEX>; // (real ba), 未分配 bsc 的 ba 为 kInvalidBscIndex
+using BankSliceTable = std::vector<std::unique_ptr<BankSlice>>; // (bsc index)
+
 class Scheduler{
 
     public:
@@ -35,12 +43,12 @@ class Scheduler{
         ~Scheduler();
 
         // Get all Rd Cam used cam index
-        inline const std::set<unsigned>& GetRdCamIndex() { return rd_cam->GetUsedCamIndex(); }
+        inline UsedCamIndexList GetRdCamIndex() { return rd_cam->GetUsedCamIndex(); }
         // Get all Wr Cam used cam index
-        inline const std::set<unsigned>& GetWrCamIndex() { return wr_cam->GetUsedCamIndex(); }
+        inline UsedCamIndexList GetWrCamIndex() { return wr_cam->GetUsedCamIndex(); }
         RdCam* GetRdCam() const{ return rd_cam.get(); }
         WrCam* GetWrCam() const{ return wr_cam.get(); }
-        inline bool IsBscMatch(RealBaIndex ba_addr) { return ba2bsc_table->count(ba_addr)>0; }
+        inline bool IsBscMatch(RealBaIndex ba_addr) { return (*ba2bsc_table)[ba_addr] != kInvalidBscIndex; }
         void StoreRdRequest(InputProcessReq& rd_input_request);
         void StoreWrRequest(InputProcessReq& wr_input_request);
 
@@ -81,9 +89,9 @@ class Scheduler{
         // inline bool IsNeedUpdate() {return !rd_updated_bsc_set.empty() | !wr_updated_bsc_set.empty();}
         inline bool IsNeedUpdate()
         {
-            return ntt_store.NextTriggerTime() == sc_core::sc_time_stamp();
+            return ntt_store.NextTriggerTime() == mc_clock.Now();
         }
-        inline sc_core::sc_time GetNextUpdateTime() {return ntt_store.NextTriggerTime();}
+        inline Tick GetNextUpdateTime() {return ntt_store.NextTriggerTime();}
 
         // inline void ResetUpdate()
         // {
@@ -95,10 +103,10 @@ class Scheduler{
             ntt_store.ClearNtt();
         }
         // inline const std::set<BSC_INDEX>& GetUpdatedBscSet(bool is_rd) {return is_rd ? rd_updated_bsc_set : wr_updated_bsc_set;}
-        inline const std::set<BSC_INDEX>& GetUpdatedBscSet(bool is_rd)
+        inline const BscMask& GetUpdatedBscMask(bool is_rd)
         {
-            auto& ntt_info = ntt_store.ntt_temp_store.at(sc_core::sc_time_stamp());
-            return is_rd ? ntt_info.rd_updated_bsc_set : ntt_info.wr_updated_bsc_set;
+            auto& ntt_info = ntt_store.GetNtt(mc_clock.Now());
+            return is_rd ? ntt_info.rd_updated_bsc_mask : ntt_info.wr_updated_bsc_mask;
         }
 
         const CAM_INDEX GetUpdateNttTemp(BSC_INDEX bsc_index, bool is_rd);
@@ -106,9 +114,9 @@ class Scheduler{
         const CAM_INDEX GetUpdateWrNttTemp(BSC_INDEX bsc_index);
 
         // Get the Real Bank Index 2 Bsc index mapping table
-        void RegisterBa2BscTable(std::unordered_map<RealBaIndex,BSC_INDEX>* _ba2bsc_table) { ba2bsc_table = _ba2bsc_table;}
+        void RegisterBa2BscTable(const Ba2BscTable* _ba2bsc_table) { ba2bsc_table = _ba2bsc_table;}
         // Get the Bsc Slice pointer
-        void RegisterBscSliceMap(std::unordered_map<BSC_INDEX, std::unique_ptr<BankSlice>>* _bsc_index_2_bankslice) { bsc_index_2_bankslice = _bsc_index_2_bankslice;}
+        void RegisterBscSliceMap(const BankSliceTable* _bsc_index_2_bankslice) { bsc_index_2_bankslice = _bsc_index_2_bankslice;}
         // Real Bank Index Map function
 
     private:
@@ -120,10 +128,10 @@ class Scheduler{
         // WrCam wr_cam;
         std::unique_ptr<WrCamFilter> wr_cam_filter;
         // WrCamFilter wr_cam_filter;
-        const sc_core::sc_time mc_cycle_time;
+        const McClock mc_clock;
 
-        std::unordered_map<RealBaIndex,BSC_INDEX>* ba2bsc_table{nullptr};
-        std::unordered_map<BSC_INDEX, std::unique_ptr<BankSlice>>* bsc_index_2_bankslice{nullptr};
+        const Ba2BscTable* ba2bsc_table{nullptr};
+        const BankSliceTable* bsc_index_2_bankslice{nullptr};
     private:
         // std::vector<std::vector<std::deque<CAM_INDEX>>> rd_update_ntt_temp; // bsc -
         // std::vector<std::vector<std::deque<CAM_INDEX>>> wr_update_ntt_temp;
@@ -131,95 +139,157 @@ class Scheduler{
         // std::set<BSC_INDEX> rd_updated_bsc_set;
         // std::set<BSC_INDEX> wr_updated_bsc_set;
 
+        // NTT 暂存: 更新在 kUpdateLatency 个 cycle 之后生效, 按生效时间排成定长 ring, 每个 cycle 不再分配内存
+        // 每个 bsc 的每种 UpdateType 只保留第一次写入的 cam index, 读取时按 UpdateType 优先级取
         class Ntt
         {
-            using ntt_updated_cam_index = std::deque<CAM_INDEX>; // store the updated selected cam index
-            using ntt_updated_type_vec = std::vector<ntt_updated_cam_index>; // store the different type of ntt update
-            using ntt_updated_bsc_vec = std::vector<ntt_updated_type_vec>; // store different bsc of ntt update
             public:
-            // store rd ntt update temp info
-            // store wr ntt update temp info
+            // 所有 NTT 更新的 updating_time 都是 Now + kUpdateLatency
+            static constexpr Tick kUpdateLatency = 1;
+            static constexpr unsigned kNumOfSlots = 4;
+            // 当前 cycle 还未 ClearNtt 的一项加上之后 kUpdateLatency 个 cycle 各一项
+            static_assert(kNumOfSlots >= kUpdateLatency + 1, "ntt ring is smaller than the pending update times of kUpdateLatency");
+            static constexpr size_t kNumOfUpdateTypes = static_cast<size_t>(UpdateType::Invalid);
+            using NttTemp = std::array<CAM_INDEX, kNumOfUpdateTypes>; // (update type), kInvalidCamIndex 表示没有更新
+
             struct NttUpdateInfo
             {
-                // std::vector<std::vector<std::deque<CAM_INDEX>>> updated_ntt_temp;
-                // std::set<BSC_INDEX> updated_bsc_set; // record the which bsc do the ntt updated action
-                
-                std::vector<std::vector<std::deque<CAM_INDEX>>> rd_updated_ntt_temp;
-                std::set<BSC_INDEX> rd_updated_bsc_set;
-                std::vector<std::vector<std::deque<CAM_INDEX>>> wr_updated_ntt_temp;
-                std::set<BSC_INDEX> wr_updated_bsc_set;
+                Tick updating_time{MaxTick};
+                BscMask rd_updated_bsc_mask; // record the which bsc do the ntt updated action
+                BscMask wr_updated_bsc_mask;
+                std::vector<NttTemp> rd_updated_ntt_temp; // (bsc)
+                std::vector<NttTemp> wr_updated_ntt_temp; // (bsc)
                 explicit NttUpdateInfo(unsigned bsc_num)
+                : rd_updated_ntt_temp(bsc_num, EmptyNttTemp())
+                , wr_updated_ntt_temp(bsc_num, EmptyNttTemp())
+                {
+                }
+                // 只清理被更新过的 bsc
+                inline void Reset()
                 {
-                    wr_updated_ntt_temp = std::vector<std::vector<std::deque<BSC_INDEX>>>(bsc_num,
-                                          std::vector<std::deque<CAM_INDEX>>(static_cast<size_t>(UpdateType::Invalid)));
-                    rd_updated_ntt_temp = std::vector<std::vector<std::deque<BSC_INDEX>>>(bsc_num,
-                                          std::vector<std::deque<CAM_INDEX>>(static_cast<size_t>(UpdateType::Invalid)));
+                    for(auto bsc_index: rd_updated_bsc_mask)
+                        rd_updated_ntt_temp[bsc_index] = EmptyNttTemp();
+                    for(auto bsc_index: wr_updated_bsc_mask)
+                        wr_updated_ntt_temp[bsc_index] = EmptyNttTemp();
+                    rd_updated_bsc_mask = BscMask();
+                    wr_updated_bsc_mask = BscMask();
+                    updating_time = MaxTick;
                 }
             };
-            std::map<sc_core::sc_time, NttUpdateInfo> ntt_temp_store;
-            std::deque<sc_core::sc_time> ntt_time_deque;
+            static inline NttTemp EmptyNttTemp()
+            {
+                NttTemp ntt_temp;
+                ntt_temp.fill(kInvalidCamIndex);
+                return ntt_temp;
+            }
+
+            std::vector<NttUpdateInfo> ntt_ring; // 按 updating time 先后排列
+            unsigned ntt_ring_head{0};
+            unsigned ntt_ring_size{0};
             const BSC_INDEX _bsc_num;
-            explicit Ntt(unsigned bsc_num): _bsc_num(bsc_num){}
-            inline const sc_core::sc_time NextTriggerTime() {return ntt_time_deque.empty() ? sc_core::sc_max_time() : *(ntt_time_deque.begin());}
-            inline void RecordNttsBsc(bool is_rd, BSC_INDEX updated_bsc, const sc_core::sc_time& updating_time)
+            const McClock mc_clock;
+            Ntt(unsigned bsc_num, const sc_core::sc_time& tck_mc)
+            : ntt_ring(kNumOfSlots, NttUpdateInfo(bsc_num))
+            , _bsc_num(bsc_num)
+            , mc_clock(tck_mc)
+            {
+                if(bsc_num > CamMask::kMaxCamDepth)
+                {
+                    std::cerr << "Scheduler: BSC_NUM " << bsc_num << " exceeds the ntt bsc mask width " << CamMask::kMaxCamDepth << std::endl;
+                    std::abort();
+                }
+            }
+            inline Tick NextTriggerTime() {return ntt_ring_size == 0 ? MaxTick : ntt_ring[ntt_ring_head].updating_time;}
+            // updating time 对应的 slot, 不存在返回 nullptr
+            inline NttUpdateInfo* FindNtt(Tick updating_time)
+            {
+                for(unsigned i = 0; i < ntt_ring_size; i++)
+                {
+                    NttUpdateInfo& ntt_update_info = ntt_ring[(ntt_ring_head + i) % kNumOfSlots];
+                    if(ntt_update_info.updating_time == updating_time)
+                        return &ntt_update_info;
+                }
+                return nullptr;
+            }
+            inline NttUpdateInfo& GetNtt(Tick updating_time)
+            {
+                NttUpdateInfo* ntt_update_info = FindNtt(updating_time);
+                if(ntt_update_info == nullptr)
+                {
+                    std::cerr << "Scheduler: no ntt update recorded at tick " << updating_time << std::endl;
+                    std::abort();
+                }
+                return *ntt_update_info;
+            }
+            inline void RecordNttsBsc(bool is_rd, BSC_INDEX updated_bsc, Tick updating_time)
             {
-                if(ntt_temp_store.find(updating_time) == ntt_temp_store.end())
+                assert(updating_time >= mc_clock.Now() && updating_time <= mc_clock.Now() + kUpdateLatency);
+                NttUpdateInfo* ntt_update_info = FindNtt(updating_time);
+                if(ntt_update_info == nullptr)
                 {
-                    ntt_temp_store.emplace(updating_time,NttUpdateInfo(_bsc_num));
-                    ntt_time_deque.push_back(updating_time);
+                    if(ntt_ring_size == kNumOfSlots)
+                    {
+                        std::cerr << "Scheduler: ntt ring overflow, " << kNumOfSlots << " pending update times" << std::endl;
+                        std::abort();
+                    }
+                    ntt_update_info = &ntt_ring[(ntt_ring_head + ntt_ring_size) % kNumOfSlots];
+                    ntt_update_info->updating_time = updating_time;
+                    ntt_ring_size++;
                 }
-                auto& ntt_update_info = ntt_temp_store.at(updating_time);
+                assert(updated_bsc < _bsc_num);
                 if(is_rd)
-                    ntt_update_info.rd_updated_bsc_set.insert(updated_bsc);
+                    ntt_update_info->rd_updated_bsc_mask.Set(updated_bsc);
                 else
-                    ntt_update_info.wr_updated_bsc_set.insert(updated_bsc);
+                    ntt_update_info->wr_updated_bsc_mask.Set(updated_bsc);
             }
-            inline void WrNttStore(BSC_INDEX bsc_index, UpdateType update_type, CAM_INDEX updated_cam_index,const sc_core::sc_time& updating_time)
+            inline void WrNttStore(BSC_INDEX bsc_index, UpdateType update_type, CAM_INDEX updated_cam_index,Tick updating_time)
             {
-                auto& ntt_update_info = ntt_temp_store.at(updating_time);
-                ntt_update_info.wr_updated_ntt_temp.at(bsc_index).at(static_cast<size_t>(update_type)).push_back(updated_cam_index);
+                CAM_INDEX& ntt_slot = GetNtt(updating_time).wr_updated_ntt_temp.at(bsc_index).at(static_cast<size_t>(update_type));
+                if(ntt_slot == kInvalidCamIndex)
+                    ntt_slot = updated_cam_index;
             }
-            inline void RdNttStore(BSC_INDEX bsc_index, UpdateType update_type, CAM_INDEX updated_cam_index,const sc_core::sc_time& updating_time)
+            inline void RdNttStore(BSC_INDEX bsc_index, UpdateType update_type, CAM_INDEX updated_cam_index,Tick updating_time)
             {
-                auto& ntt_update_info = ntt_temp_store.at(updating_time);
-                ntt_update_info.rd_updated_ntt_temp.at(bsc_index).at(static_cast<size_t>(update_type)).push_back(updated_cam_index);
+                CAM_INDEX& ntt_slot = GetNtt(updating_time).rd_updated_ntt_temp.at(bsc_index).at(static_cast<size_t>(update_type));
+                if(ntt_slot == kInvalidCamIndex)
+                    ntt_slot = updated_cam_index;
             }
             inline void ClearNtt()
             {
-                sc_core::sc_time current_time = sc_core::sc_time_stamp();
-                sc_assert(ntt_time_deque.front() == current_time);
-                ntt_time_deque.pop_front();
-                ntt_temp_store.erase(current_time);
+                Tick current_time = mc_clock.Now();
+                sc_assert(ntt_ring_size > 0 && ntt_ring[ntt_ring_head].updating_time == current_time);
+                ntt_ring[ntt_ring_head].Reset();
+                ntt_ring_head = (ntt_ring_head + 1) % kNumOfSlots;
+                ntt_ring_size--;
             }
             inline const CAM_INDEX GetRdNtt(BSC_INDEX updated_bsc_index)
             {
-                sc_core::sc_time current_time = sc_core::sc_time_stamp();
-                auto& rd_ntt_update_info = ntt_temp_store.at(current_time).rd_updated_ntt_temp;
-                auto& ntt_temp = rd_ntt_update_info.at(updated_bsc_index);
+                Tick current_time = mc_clock.Now();
+                const NttTemp& ntt_temp = GetNtt(current_time).rd_updated_ntt_temp.at(updated_bsc_index);
                 CAM_INDEX selected_ntt_cam_index;
-                if(!ntt_temp.at(static_cast<size_t>(UpdateType::CmdExe)).empty())
+                if(ntt_temp[static_cast<size_t>(UpdateType::CmdExe)] != kInvalidCamIndex)
                 {
-                    selected_ntt_cam_index = ntt_temp.at(static_cast<size_t>(UpdateType::CmdExe)).front();
+                    selected_ntt_cam_index = ntt_temp[static_cast<size_t>(UpdateType::CmdExe)];
                     DPRINT_INFO(TOP_DEBUG, "Ntt", "Get Rd Ntt, Type: CmdExe, selected ntt cam index: %d",selected_ntt_cam_index);
                 }
-                else if(!ntt_temp.at(static_cast<size_t>(UpdateType::Pre_Act)).empty())
+                else if(ntt_temp[static_cast<size_t>(UpdateType::Pre_Act)] != kInvalidCamIndex)
                 {
-                    selected_ntt_cam_index = ntt_temp.at(static_cast<size_t>(UpdateType::Pre_Act)).front();
+                    selected_ntt_cam_index = ntt_temp[static_cast<size_t>(UpdateType::Pre_Act)];
                     DPRINT_INFO(TOP_DEBUG, "Ntt", "Get Rd Ntt, Type: Pre_Act, selected ntt cam index: %d",selected_ntt_cam_index);
                 }
-                else if(!ntt_temp.at(static_cast<size_t>(UpdateType::NewCmdStore)).empty())
+                else if(ntt_temp[static_cast<size_t>(UpdateType::NewCmdStore)] != kInvalidCamIndex)
                 {
-                    selected_ntt_cam_index = ntt_temp.at(static_cast<size_t>(UpdateType::NewCmdStore)).front();
+                    selected_ntt_cam_index = ntt_temp[static_cast<size_t>(UpdateType::NewCmdStore)];
                     DPRINT_INFO(TOP_DEBUG, "Ntt", "Get Rd Ntt, Type: NewCmdStore, selected ntt cam index: %d",selected_ntt_cam_index);
                 }
-                else if(!ntt_temp.at(static_cast<size_t>(UpdateType::BscAllocate)).empty())
+                else if(ntt_temp[static_cast<size_t>(UpdateType::BscAllocate)] != kInvalidCamIndex)
                 {
-                    selected_ntt_cam_index = ntt_temp.at(static_cast<size_t>(UpdateType::BscAllocate)).front();
+                    selected_ntt_cam_index = ntt_temp[static_cast<size_t>(UpdateType::BscAllocate)];
                     DPRINT_INFO(TOP_DEBUG, "Ntt", "Get Rd Ntt, Type: BscAllocate, selected ntt cam index: %d",selected_ntt_cam_index);
                 }
-                else if(!ntt_temp.at(static_cast<size_t>(UpdateType::BrokenTerminate)).empty())
+                else if(ntt_temp[static_cast<size_t>(UpdateType::BrokenTerminate)] != kInvalidCamIndex)
                 {
-                    selected_ntt_cam_index = ntt_temp.at(static_cast<size_t>(UpdateType::BrokenTerminate)).front();
+                    selected_ntt_cam_index = ntt_temp[static_cast<size_t>(UpdateType::BrokenTerminate)];
                     DPRINT_INFO(TOP_DEBUG, "Ntt", "Get Rd Ntt, Type: BrokenTerminate, selected ntt cam index: %d",selected_ntt_cam_index);
                 }
                 else
@@ -231,38 +301,37 @@ class Scheduler{
             }
             inline const CAM_INDEX GetWrNtt(BSC_INDEX updated_bsc_index)
             {
-                sc_core::sc_time current_time = sc_core::sc_time_stamp();
-                auto& wr_ntt_update_info = ntt_temp_store.at(current_time).wr_updated_ntt_temp;
-                auto& ntt_temp = wr_ntt_update_info.at(updated_bsc_index);
+                Tick current_time = mc_clock.Now();
+                const NttTemp& ntt_temp = GetNtt(current_time).wr_updated_ntt_temp.at(updated_bsc_index);
                 CAM_INDEX selected_ntt_cam_index;
-                if(!ntt_temp.at(static_cast<size_t>(UpdateType::CmdExe)).empty())
+                if(ntt_temp[static_cast<size_t>(UpdateType::CmdExe)] != kInvalidCamIndex)
                 {
-                    selected_ntt_cam_index = ntt_temp.at(static_cast<size_t>(UpdateType::CmdExe)).front();
+                    selected_ntt_cam_index = ntt_temp[static_cast<size_t>(UpdateType::CmdExe)];
                     DPRINT_INFO(TOP_DEBUG, "Ntt", "Get Wr Ntt, Type: CmdExe, selected ntt cam index: %d",selected_ntt_cam_index);
                 }
-                else if(!ntt_temp.at(static_cast<size_t>(UpdateType::Pre_Act)).empty())
+                else if(ntt_temp[static_cast<size_t>(UpdateType::Pre_Act)] != kInvalidCamIndex)
                 {
-                    selected_ntt_cam_index = ntt_temp.at(static_cast<size_t>(UpdateType::Pre_Act)).front();
+                    selected_ntt_cam_index = ntt_temp[static_cast<size_t>(UpdateType::Pre_Act)];
                     DPRINT_INFO(TOP_DEBUG, "Ntt", "Get Wr Ntt, Type: Pre_Act, selected ntt cam index: %d",selected_ntt_cam_index);
                 }
-                else if(!ntt_temp.at(static_cast<size_t>(UpdateType::WrCombine)).empty())
+                else if(ntt_temp[static_cast<size_t>(UpdateType::WrCombine)] != kInvalidCamIndex)
                 {
-                    selected_ntt_cam_index = ntt_temp.at(static_cast<size_t>(UpdateType::WrCombine)).front();
+                    selected_ntt_cam_index = ntt_temp[static_cast<size_t>(UpdateType::WrCombine)];
                     DPRINT_INFO(TOP_DEBUG, "Ntt", "Get Wr Ntt, Type: WrCombine, selected ntt cam index: %d",selected_ntt_cam_index);
                 }
-                else if(!ntt_temp.at(static_cast<size_t>(UpdateType::NewCmdStore)).empty())
+                else if(ntt_temp[static_cast<size_t>(UpdateType::NewCmdStore)] != kInvalidCamIndex)
                 {
-                    selected_ntt_cam_index = ntt_temp.at(static_cast<size_t>(UpdateType::NewCmdStore)).front();
+                    selected_ntt_cam_index = ntt_temp[static_cast<size_t>(UpdateType::NewCmdStore)];
                     DPRINT_INFO(TOP_DEBUG, "Ntt", "Get Wr Ntt, Type: NewCmdStore, selected ntt cam index: %d",selected_ntt_cam_index);
                 }
-                else if(!ntt_temp.at(static_cast<size_t>(UpdateType::BscAllocate)).empty())
+                else if(ntt_temp[static_cast<size_t>(UpdateType::BscAllocate)] != kInvalidCamIndex)
                 {
-                    selected_ntt_cam_index = ntt_temp.at(static_cast<size_t>(UpdateType::BscAllocate)).front();
+                    selected_ntt_cam_index = ntt_temp[static_cast<size_t>(UpdateType::BscAllocate)];
                     DPRINT_INFO(TOP_DEBUG, "Ntt", "Get Wr Ntt, Type: BscAllocate, selected ntt cam index: %d",selected_ntt_cam_index);
                 }
-                else if(!ntt_temp.at(static_cast<size_t>(UpdateType::BrokenTerminate)).empty())
+                else if(ntt_temp[static_cast<size_t>(UpdateType::BrokenTerminate)] != kInvalidCamIndex)
                 {
-                    selected_ntt_cam_index = ntt_temp.at(static_cast<size_t>(UpdateType::BrokenTerminate)).front();
+                    selected_ntt_cam_index = ntt_temp[static_cast<size_t>(UpdateType::BrokenTerminate)];
                     DPRINT_INFO(TOP_DEBUG, "Ntt", "Get Wr Ntt, Type: BrokenTerminate, selected ntt cam index: %d",selected_ntt_cam_index);
                 }
                 else
@@ -1,10 +1,16 @@
 #ifndef __SDRAM_CONSTRAINT_HH__
 #define __SDRAM_CONSTRAINT_HH__
-#include <vector>
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <deque>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 #include "Configure/DDR5MemSpec3ds.hh"
 #include "Controller/BankSlice.hh"
+#include "Controller/SdramTimingRule.hh"
 
 namespace dmu{
     namespace Controller{
@@ -25,7 +31,8 @@ namespace dmu{
         public:
             SdramConstraintIF() = default;
             virtual ~SdramConstraintIF() = default;
-            virtual sc_core::sc_time TimeToSatisfyConstraints(Command command,BankAddress address) const = 0;
+            // return the earliest tick the command can be sent, all the ac timing are in mc clock tick
+            virtual Tick TimeToSatisfyConstraints(Command command,BankAddress address) const = 0;
             virtual void InsertCommand(Command command,BankAddress address) = 0;
 
     };
@@ -37,7 +44,7 @@ namespace dmu{
     public:
         explicit SdramConstraintDDR5_3ds(const DDR5MemSpec3ds& ddr5_memspec_3ds);
         ~SdramConstraintDDR5_3ds(){}
-        sc_core::sc_time TimeToSatisfyConstraints(Command command,BankAddress address) const override;
+        Tick TimeToSatisfyConstraints(Command command,BankAddress address) const override;
         void InsertCommand(Command command,BankAddress address) override;
         std::vector<BankIndex> GetSameBgBankVec(BankAddress address) const;
         std::vector<BankGroupIndex> GetSameBgVec(BankAddress address) const;
@@ -45,27 +52,518 @@ namespace dmu{
     private:
         const DDR5MemSpec3ds& _ddr5_memspec_3ds;
         const bool is_x4_device;
-        const sc_core::sc_time MaxTime = sc_core::sc_max_time();
+        const McClock mc_clock;
+        const Tick MaxTime = MaxTick;
+
+
+        std::vector<std::vector<Tick>> previous_command_time4bank; // (banks,command)
+        std::vector<std::vector<Tick>> previous_command_time4bg; // (bg, command)
+        std::vector<std::vector<Tick>> previous_command_time4lrank; // (lranks, command)
+        std::vector<std::vector<Tick>> previous_command_time4prank; // (pranks, command)
+
+        std::vector<std::vector<std::vector<Tick>>> previous_command_time4prank_lrank; //(pranks, lranks, command)
+
+        std::vector<std::vector<Tick>> previous_command_time4channel; // (channels, command)
+
+        std::vector<std::vector<std::vector<Tick>>> previous_command_time4channel_prank; //(channels, pranks, command)
+
+        std::vector<Tick> previous_command_time4channel_onbus;
+
+        std::vector<std::deque<Tick>> last_4Activates4lrank;
+        std::vector<std::deque<Tick>> last_4Activates4prank;
+
+        std::vector<Tick> last_Activates4dimm;
+
+    };
+
+    // push model: InsertCommand 时把每条 timing rule 的结果直接写进 earliest issue tick 表,
+    // TimeToSatisfyConstraints 只需要查 bank / lrank / (channel, lrank) / channel 四个表项
+    // rule 来自 constexpr 表 (SdramTimingRule.hh), 编译期按命令展开成 Insert<C>:
+    // 每个 Insert<C> 只包含 prev 为 C 的 rule, target/scope 都是模板参数, 插入时没有按 rule 的运行时分支
+    // 同一命令中 scope / window 相同的 rule 编译期合并成一组, 每组只遍历一次 scope 内的表项;
+    // 表项按 (bank 或 rank, class) 排列, 一个表项的各命令类相邻, 一组 rule 更新的是同一处的几个 class;
+    // scope 都可以表示成至多两段等间隔的表项, 由地址算一次, 更新时没有除法和逐个表项的函数调用
+    template<typename MemSpec, const auto& Rules>
+    class SdramConstraintTable: public SdramConstraintIF
+    {
+    public:
+        explicit SdramConstraintTable(const MemSpec& memspec);
+        ~SdramConstraintTable(){}
+        Tick TimeToSatisfyConstraints(Command command,BankAddress address) const override;
+        void InsertCommand(Command command,BankAddress address) override;
+
+    private:
+        using TimingClass = timing::TimingClass;
+        using TimingScope = timing::TimingScope;
+        using TimingWindow = timing::TimingWindow;
+        using InsertKernel = void (SdramConstraintTable::*)(const BankAddress&, Tick);
+
+        static constexpr size_t kNumOfRules = std::size(Rules);
+        static constexpr unsigned kNumOfClasses = timing::ClassIndex(TimingClass::NumOfClasses);
+
+        static constexpr bool RuleMatches(size_t rule, unsigned command)
+        {
+            return Rules[rule].prev == Command::Invalid || Rules[rule].prev == command;
+        }
+        // target 为 NumOfClasses 的 rule 对所有类生效, 单独成组
+        static constexpr bool SameGroup(size_t lhs, size_t rhs)
+        {
+            return Rules[lhs].scope == Rules[rhs].scope && Rules[lhs].window == Rules[rhs].window &&
+                   (Rules[lhs].next == TimingClass::NumOfClasses) == (Rules[rhs].next == TimingClass::NumOfClasses);
+        }
+        // 第一个属于该组的 rule 代表这一组
+        static constexpr bool IsGroupLeader(size_t rule, unsigned command)
+        {
+            for(size_t i = 0; i < rule; i++)
+            {
+                if(RuleMatches(i, command) && SameGroup(i, rule))
+                {
+                    return false;
+                }
+            }
+            return RuleMatches(rule, command);
+        }
+        static constexpr size_t NumOfGroupsFor(unsigned command)
+        {
+            size_t num = 0;
+            for(size_t i = 0; i < kNumOfRules; i++)
+            {
+                num += IsGroupLeader(i, command) ? 1 : 0;
+            }
+            return num;
+        }
+        struct RuleGroup
+        {
+            TimingScope scope{TimingScope::Bank};
+            TimingWindow window{TimingWindow::None};
+            bool all_classes{false};
+            size_t num_of_rules{0};
+            size_t rules[kNumOfRules]{};
+            unsigned classes[kNumOfRules]{}; // 每条 rule 的 target class
+        };
+        template<unsigned C>
+        static constexpr std::array<RuleGroup, NumOfGroupsFor(C)> GroupsFor()
+        {
+            std::array<RuleGroup, NumOfGroupsFor(C)> groups{};
+            size_t num = 0;
+            for(size_t leader = 0; leader < kNumOfRules; leader++)
+            {
+                if(!IsGroupLeader(leader, C))
+                {
+                    continue;
+                }
+                RuleGroup& group = groups[num++];
+                group.scope = Rules[leader].scope;
+                group.window = Rules[leader].window;
+                group.all_classes = Rules[leader].next == TimingClass::NumOfClasses;
+                for(size_t i = leader; i < kNumOfRules; i++)
+                {
+                    if(RuleMatches(i, C) && SameGroup(leader, i))
+                    {
+                        group.classes[group.num_of_rules] = timing::ClassIndex(Rules[i].next);
+                        group.rules[group.num_of_rules++] = i;
+                    }
+                }
+            }
+            return groups;
+        }
+        // 命令有某个窗口的 rule 时就记录进该窗口
+        static constexpr bool UsesWindow(unsigned command, TimingWindow window)
+        {
+            for(size_t i = 0; i < kNumOfRules; i++)
+            {
+                if(RuleMatches(i, command) && Rules[i].window == window)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+        template<size_t... C>
+        static constexpr std::array<InsertKernel, sizeof...(C)> MakeKernels(std::index_sequence<C...>)
+        {
+            return {&SdramConstraintTable::Insert<C>...};
+        }
+
+        static Command MapRfm(Command command);
+        // 返回 NumOfClasses 表示不是需要检查 timing 的命令
+        static TimingClass ClassOf(Command command);
+
+        // 各 scope 的第一个表项, 每次插入由地址算一次, 该命令的所有 rule 共用, rule 中不再做除法 / 取模
+        struct ScopeIndex
+        {
+            BankIndex bank;
+            BankIndex same_bg_bank; // SameBgBank 的第一个 bank, 之后每隔 num_of_banks_per_bg 一个
+            BankIndex bg_bank;      // Bg 的第一个 bank
+            BankIndex lrank_bank;   // LrankBg 的第一个 bank
+            ChannelIndex ch;
+            LrankIndex lrank;
+            LrankIndex prank_lrank; // 同一个 physical rank 的第一个 logical rank
+            LrankIndex cid;
+        };
+
+        ScopeIndex MakeScopeIndex(const BankAddress& address) const;
+        template<unsigned C>
+        void Insert(const BankAddress& address, Tick record_time);
+        template<unsigned C, size_t... G>
+        void ApplyGroups(const BankAddress& address, const ScopeIndex& index, Tick record_time, std::index_sequence<G...>);
+        template<unsigned C, size_t G>
+        void ApplyGroup(const BankAddress& address, const ScopeIndex& index, Tick record_time);
+        // 表中 first, first + stride, ... 共 count 个表项, 偏移指向表项的 class 0
+        struct ScopeRange
+        {
+            unsigned first;
+            unsigned stride;
+            unsigned count;
+        };
+        // scope 对应的表和表项, 返回 range 的个数 (1 或 2, Other* scope 去掉中间一段)
+        template<TimingScope scope>
+        unsigned MakeScopeRanges(const ScopeIndex& index, Tick*& table, ScopeRange* ranges);
+
+        static inline void UpdateEntry(Tick& entry, Tick earliest)
+        {
+            entry = entry < earliest ? earliest : entry;
+        }
+
+        // 最近 4 个记录时间, Front 为最早的一个, 不足 4 个时为 MaxTick
+        struct ActivateWindow
+        {
+            std::array<Tick, 4> record_time{MaxTick, MaxTick, MaxTick, MaxTick};
+            unsigned head{0};
+            Tick Front() const {return record_time[head];}
+            void Push(Tick time)
+            {
+                record_time[head] = time;
+                head = (head + 1) % 4;
+            }
+        };
+
+        const McClock mc_clock;
+        const unsigned num_of_banks;
+        const unsigned num_of_channels;
+        const unsigned num_of_lranks;
+        const unsigned num_of_lranks_per_prank;
+        const unsigned num_of_banks_per_bg;
+        const unsigned num_of_bg_per_lrank;
+        const unsigned num_of_banks_per_lrank;
 
+        Tick delays[kNumOfRules]; // 按 memspec 解析后的每条 rule 的 delay
 
-        std::vector<std::vector<sc_core::sc_time>> previous_command_time4bank; // (banks,command)
-        std::vector<std::vector<sc_core::sc_time>> previous_command_time4bg; // (bg, command)
-        std::vector<std::vector<sc_core::sc_time>> previous_command_time4lrank; // (lranks, command)
-        std::vector<std::vector<sc_core::sc_time>> previous_command_time4prank; // (pranks, command)
+        std::vector<BankIndex> same_bg_bank4bank; // (bank), SameBgBank 的第一个 bank
+        std::vector<BankIndex> lrank_bank4bg; // (bg), bg 所在 logical rank 的第一个 bank
 
-        std::vector<std::vector<std::vector<sc_core::sc_time>>> previous_command_time4prank_lrank; //(pranks, lranks, command)
+        std::vector<Tick> earliest4bank; // (bank, class)
+        std::vector<Tick> earliest4lrank; // (lrank, class), lrank / prank scope 的 rule 对所有 channel 相同
+        std::vector<Tick> earliest4rank; // (channel, lrank, class), channel scope 的 rule
+        std::vector<Tick> earliest4channel; // (channel), 所有命令类共用
 
-        std::vector<std::vector<sc_core::sc_time>> previous_command_time4channel; // (channels, command)
+        std::vector<ActivateWindow> activate_window4lrank;
+        std::vector<ActivateWindow> activate_window4prank;
+    };
+
+    template<typename MemSpec, const auto& Rules>
+    SdramConstraintTable<MemSpec, Rules>::SdramConstraintTable(const MemSpec& memspec)
+    : mc_clock(memspec.tCK_mc)
+    , num_of_banks(memspec.NumOfTotalBanks)
+    , num_of_channels(std::max<unsigned>(memspec.NumOfChannels, memspec.NumOfSubChannels))
+    , num_of_lranks(memspec.TotalNumOfLogicalRanks)
+    , num_of_lranks_per_prank(memspec.NumOfLogicalRanksPerPhysicalRank)
+    , num_of_banks_per_bg(memspec.NumOfBanksPerBg)
+    , num_of_bg_per_lrank(memspec.NumOfBgPerLogicalRank)
+    , num_of_banks_per_lrank(memspec.NumOfBanksPerBg * memspec.NumOfBgPerLogicalRank)
+    , same_bg_bank4bank(memspec.NumOfTotalBanks)
+    , lrank_bank4bg(memspec.NumOfTotalBanks / memspec.NumOfBanksPerBg)
+    , earliest4bank(kNumOfClasses * num_of_banks, 0)
+    , earliest4lrank(kNumOfClasses * num_of_lranks, 0)
+    , earliest4rank(kNumOfClasses * num_of_channels * num_of_lranks, 0)
+    , earliest4channel(num_of_channels, 0)
+    , activate_window4lrank(memspec.TotalNumOfLogicalRanks)
+    , activate_window4prank(memspec.NumOfPhysicalRanksPerChannel)
+    {
+        for(size_t i = 0; i < kNumOfRules; i++)
+        {
+            delays[i] = Rules[i].Resolve(memspec);
+        }
+        for(BankIndex bank = 0; bank < num_of_banks; bank++)
+        {
+            same_bg_bank4bank[bank] = bank - bank % num_of_banks_per_lrank + bank % num_of_banks_per_bg;
+        }
+        for(BankGroupIndex bg = 0; bg < lrank_bank4bg.size(); bg++)
+        {
+            lrank_bank4bg[bg] = (bg - bg % num_of_bg_per_lrank) * num_of_banks_per_bg;
+        }
+    }
+
+    template<typename MemSpec, const auto& Rules>
+    Command
+    SdramConstraintTable<MemSpec, Rules>::MapRfm(Command command)
+    {
+        if(command == Command::RFMab)
+            return Command::REFab;
+        if(command == Command::RFMsb)
+            return Command::REFsb;
+        return command;
+    }
+
+    template<typename MemSpec, const auto& Rules>
+    timing::TimingClass
+    SdramConstraintTable<MemSpec, Rules>::ClassOf(Command command)
+    {
+        switch(MapRfm(command).to_type())
+        {
+            case Command::ACT:   return TimingClass::ACT;
+            case Command::PRE:   return TimingClass::PRE;
+            case Command::PREsb: return TimingClass::PREsb;
+            case Command::PREab: return TimingClass::PREab;
+            case Command::REFab: return TimingClass::REFab;
+            case Command::REFsb: return TimingClass::REFsb;
+            case Command::RD:
+            case Command::RDA:   return TimingClass::RD;
+            case Command::WR:
+            case Command::WRA:   return TimingClass::WR;
+            default:             return TimingClass::NumOfClasses;
+        }
+    }
+
+    template<typename MemSpec, const auto& Rules>
+    Tick
+    SdramConstraintTable<MemSpec, Rules>::TimeToSatisfyConstraints(Command command,BankAddress address) const
+    {
+        assert(address.real_ba < num_of_banks);
+        assert(address.real_cid < num_of_lranks);
+        assert(address.ch < num_of_channels);
+
+        TimingClass timing_class = ClassOf(command);
+        if(timing_class == TimingClass::NumOfClasses)
+        {
+            SC_REPORT_ERROR("SdramConstraint", "Unknown command!");
+            return MaxTick;
+        }
+        unsigned class_index = timing::ClassIndex(timing_class);
+        return std::max({mc_clock.Now(),
+                         earliest4bank[address.real_ba * kNumOfClasses + class_index],
+                         earliest4lrank[address.real_cid * kNumOfClasses + class_index],
+                         earliest4rank[(address.ch * num_of_lranks + address.real_cid) * kNumOfClasses + class_index],
+                         earliest4channel[address.ch]});
+    }
+
+    template<typename MemSpec, const auto& Rules>
+    void
+    SdramConstraintTable<MemSpec, Rules>::InsertCommand(Command command,BankAddress address)
+    {
+        static constexpr std::array<InsertKernel, Command::NumOfCommands()> kernels =
+            MakeKernels(std::make_index_sequence<Command::NumOfCommands()>{});
+
+        command = MapRfm(command);
+        assert(command < Command::NumOfCommands());
+        assert(mc_clock.IsAligned());
+        (this->*kernels[command])(address, mc_clock.Now());
+    }
 
-        std::vector<std::vector<std::vector<sc_core::sc_time>>> previous_command_time4channel_prank; //(channels, pranks, command)
+    template<typename MemSpec, const auto& Rules>
+    typename SdramConstraintTable<MemSpec, Rules>::ScopeIndex
+    SdramConstraintTable<MemSpec, Rules>::MakeScopeIndex(const BankAddress& address) const
+    {
+        assert(address.real_ba < num_of_banks);
+        assert(address.real_bg < lrank_bank4bg.size());
+        assert(address.real_cid < num_of_lranks);
+        assert(address.ch < num_of_channels);
+        assert(address.cid < num_of_lranks_per_prank);
+        assert((address.cs + 1) * num_of_lranks_per_prank <= num_of_lranks);
+        ScopeIndex index;
+        index.bank = address.real_ba;
+        index.same_bg_bank = same_bg_bank4bank[address.real_ba];
+        index.bg_bank = address.real_bg * num_of_banks_per_bg;
+        index.lrank_bank = lrank_bank4bg[address.real_bg];
+        index.ch = address.ch;
+        index.lrank = address.real_cid;
+        index.prank_lrank = address.cs * num_of_lranks_per_prank;
+        index.cid = address.cid;
+        return index;
+    }
 
-        std::vector<sc_core::sc_time> previous_command_time4channel_onbus;
+    template<typename MemSpec, const auto& Rules>
+    template<unsigned C>
+    void
+    SdramConstraintTable<MemSpec, Rules>::Insert(const BankAddress& address, Tick record_time)
+    {
+        // 先记录窗口, 窗口 rule 用记录之后的最早时间
+        if constexpr (UsesWindow(C, TimingWindow::Lrank))
+        {
+            activate_window4lrank[address.real_cid].Push(record_time);
+        }
+        if constexpr (UsesWindow(C, TimingWindow::Prank))
+        {
+            activate_window4prank[address.cs].Push(record_time);
+        }
+        ApplyGroups<C>(address, MakeScopeIndex(address), record_time, std::make_index_sequence<NumOfGroupsFor(C)>{});
+    }
 
-        std::vector<std::deque<sc_core::sc_time>> last_4Activates4lrank;
-        std::vector<std::deque<sc_core::sc_time>> last_4Activates4prank;
+    template<typename MemSpec, const auto& Rules>
+    template<unsigned C, size_t... G>
+    inline void
+    SdramConstraintTable<MemSpec, Rules>::ApplyGroups(const BankAddress& address, const ScopeIndex& index, Tick record_time, std::index_sequence<G...>)
+    {
+        (ApplyGroup<C, G>(address, index, record_time), ...);
+    }
 
-        std::vector<sc_core::sc_time> last_Activates4dimm;
+    template<typename MemSpec, const auto& Rules>
+    template<unsigned C, size_t G>
+    inline void
+    SdramConstraintTable<MemSpec, Rules>::ApplyGroup(const BankAddress& address, const ScopeIndex& index, Tick record_time)
+    {
+        static constexpr RuleGroup group = GroupsFor<C>()[G];
+        Tick begin = record_time;
+        if constexpr (group.window == TimingWindow::Lrank)
+        {
+            begin = activate_window4lrank[address.real_cid].Front();
+        }
+        else if constexpr (group.window == TimingWindow::Prank)
+        {
+            begin = activate_window4prank[address.cs].Front();
+        }
+        if constexpr (group.window != TimingWindow::None)
+        {
+            if(begin == MaxTick)
+            {
+                return;
+            }
+        }
+        if constexpr (group.all_classes && group.scope == TimingScope::Channel)
+        {
+            // 对所有命令类生效的 channel rule (command bus) 单独一个表项, 查询时多读一次
+            for(size_t i = 0; i < group.num_of_rules; i++)
+            {
+                UpdateEntry(earliest4channel[index.ch], begin + delays[group.rules[i]]);
+            }
+            return;
+        }
+
+        Tick* table;
+        ScopeRange ranges[2];
+        const unsigned num_of_ranges = MakeScopeRanges<group.scope>(index, table, ranges);
+        if constexpr (group.all_classes)
+        {
+            for(size_t i = 0; i < group.num_of_rules; i++)
+            {
+                const Tick earliest = begin + delays[group.rules[i]];
+                for(unsigned r = 0; r < num_of_ranges; r++)
+                {
+                    Tick* classes = table + ranges[r].first;
+                    for(unsigned e = 0; e < ranges[r].count; e++, classes += ranges[r].stride)
+                    {
+                        for(unsigned class_index = 0; class_index < kNumOfClasses; class_index++)
+                        {
+                            classes[class_index] = classes[class_index] < earliest ? earliest : classes[class_index];
+                        }
+                    }
+                }
+            }
+        }
+        else
+        {
+            Tick earliest[group.num_of_rules];
+            for(size_t i = 0; i < group.num_of_rules; i++)
+            {
+                earliest[i] = begin + delays[group.rules[i]];
+            }
+            for(unsigned r = 0; r < num_of_ranges; r++)
+            {
+                Tick* classes = table + ranges[r].first;
+                for(unsigned e = 0; e < ranges[r].count; e++, classes += ranges[r].stride)
+                {
+                    for(size_t i = 0; i < group.num_of_rules; i++)
+                    {
+                        Tick& entry = classes[group.classes[i]];
+                        entry = entry < earliest[i] ? earliest[i] : entry;
+                    }
+                }
+            }
+        }
+    }
+
+    template<typename MemSpec, const auto& Rules>
+    template<timing::TimingScope scope>
+    inline unsigned
+    SdramConstraintTable<MemSpec, Rules>::MakeScopeRanges(const ScopeIndex& index, Tick*& table, ScopeRange* ranges)
+    {
+        constexpr unsigned K = kNumOfClasses;
+        if constexpr (scope == TimingScope::Bank)
+        {
+            table = earliest4bank.data();
+            ranges[0] = {index.bank * K, K, 1};
+            return 1;
+        }
+        else if constexpr (scope == TimingScope::SameBgBank)
+        {
+            table = earliest4bank.data();
+            ranges[0] = {index.same_bg_bank * K, num_of_banks_per_bg * K, num_of_bg_per_lrank};
+            return 1;
+        }
+        else if constexpr (scope == TimingScope::Bg)
+        {
+            table = earliest4bank.data();
+            ranges[0] = {index.bg_bank * K, K, num_of_banks_per_bg};
+            return 1;
+        }
+        else if constexpr (scope == TimingScope::LrankBg)
+        {
+            table = earliest4bank.data();
+            ranges[0] = {index.lrank_bank * K, K, num_of_banks_per_lrank};
+            return 1;
+        }
+        else if constexpr (scope == TimingScope::Lrank)
+        {
+            table = earliest4lrank.data();
+            ranges[0] = {index.lrank * K, K, 1};
+            return 1;
+        }
+        else if constexpr (scope == TimingScope::Prank)
+        {
+            table = earliest4lrank.data();
+            ranges[0] = {index.prank_lrank * K, K, num_of_lranks_per_prank};
+            return 1;
+        }
+        else if constexpr (scope == TimingScope::PrankOtherLrank)
+        {
+            table = earliest4lrank.data();
+            ranges[0] = {index.prank_lrank * K, K, index.cid};
+            ranges[1] = {(index.prank_lrank + index.cid + 1) * K, K, num_of_lranks_per_prank - index.cid - 1};
+            return 2;
+        }
+        else if constexpr (scope == TimingScope::Channel)
+        {
+            table = earliest4rank.data();
+            ranges[0] = {index.ch * num_of_lranks * K, K, num_of_lranks};
+            return 1;
+        }
+        else
+        {
+            static_assert(scope == TimingScope::ChannelOtherPrank, "unknown timing scope");
+            const unsigned next_prank_lrank = index.prank_lrank + num_of_lranks_per_prank;
+            table = earliest4rank.data();
+            ranges[0] = {index.ch * num_of_lranks * K, K, index.prank_lrank};
+            ranges[1] = {(index.ch * num_of_lranks + next_prank_lrank) * K, K, num_of_lranks - next_prank_lrank};
+            return 2;
+        }
+    }
 
+    using SdramConstraintDDR5_3dsPush = SdramConstraintTable<DDR5MemSpec3ds, timing::kDDR5_3dsTimingRules>;
+    extern template class SdramConstraintTable<DDR5MemSpec3ds, timing::kDDR5_3dsTimingRules>;
+
+    // 差分检查: 同时运行 pull model 与 push model, 每次查询都比较两者结果, 不一致时直接报错
+    class SdramConstraintDiffCheck: public SdramConstraintIF
+    {
+    public:
+        explicit SdramConstraintDiffCheck(const DDR5MemSpec3ds& ddr5_memspec_3ds);
+        ~SdramConstraintDiffCheck();
+        Tick TimeToSatisfyConstraints(Command command,BankAddress address) const override;
+        void InsertCommand(Command command,BankAddress address) override;
+
+    private:
+        SdramConstraintDDR5_3ds pull_constraint;
+        SdramConstraintDDR5_3dsPush push_constraint;
+        mutable uint64_t num_of_checks{0};
     };
 
 
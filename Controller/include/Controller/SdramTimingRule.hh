@@ -0,0 +1,268 @@
+#ifndef __SDRAM_TIMING_RULE_HH__
+#define __SDRAM_TIMING_RULE_HH__
+
+#include <cstdint>
+#include <initializer_list>
+
+#include "Common/Common.hh"
+#include "Configure/DDR5MemSpec3ds.hh"
+#include "Controller/common/Command.hh"
+
+namespace dmu{
+    namespace Controller{
+        namespace timing{
+
+    // 被约束的命令类别, RDA/WRA 与 RD/WR 共用同一类, RFM 按 REF 处理
+    enum class TimingClass : unsigned
+    {
+        ACT = 0, PRE, PREsb, PREab, REFab, REFsb, RD, WR,
+        NumOfClasses // 作为 rule 的 next 时表示所有类别
+    };
+
+    // rule 生效的范围, 都是相对于前一个命令的地址
+    enum class TimingScope : unsigned
+    {
+        Bank,               // 同一个 bank
+        SameBgBank,         // 同一个 logical rank 中各 bg 的同号 bank
+        Bg,                 // 同一个 bg 的所有 bank
+        LrankBg,            // 同一个 logical rank 中所有 bg 的所有 bank
+        Lrank,              // 同一个 logical rank
+        Prank,              // 同一个 physical rank 的所有 logical rank
+        PrankOtherLrank,    // 同一个 physical rank 中的其他 logical rank
+        Channel,            // 同一个 channel 的所有 rank
+        ChannelOtherPrank   // 同一个 channel 中的其他 physical rank
+    };
+
+    // 只对特定颗粒位宽生效的 rule
+    enum class DeviceWidth : uint8_t
+    {
+        Any, X4, NotX4
+    };
+
+    // tFAW 类 rule: 起点不是前一个命令本身, 而是该窗口内最近 4 个命令中最早的一个
+    // 有窗口 rule 的命令会被记录进对应窗口
+    enum class TimingWindow : uint8_t
+    {
+        None, Lrank, Prank
+    };
+
+    constexpr unsigned
+    ClassIndex(TimingClass timing_class)
+    {
+        return static_cast<unsigned>(timing_class);
+    }
+
+    constexpr unsigned kMaxTimingTerms = 4;
+
+    // 一条 timing rule: prev 命令发出后, next 类命令在 scope 范围内至少等待 sum(terms) + offset 个 mc cycle
+    // prev 为 Command::Invalid 时匹配所有命令
+    template<typename MemSpec>
+    struct TimingRule
+    {
+        using Term = const Tick MemSpec::*;
+
+        Command::Type prev{Command::Invalid};
+        TimingClass next{TimingClass::NumOfClasses};
+        TimingScope scope{TimingScope::Bank};
+        Term terms[kMaxTimingTerms]{};
+        Tick offset{0};
+        DeviceWidth width{DeviceWidth::Any};
+        TimingWindow window{TimingWindow::None};
+
+        // 位宽不匹配的 rule 返回 0, 等价于不约束 (记录时间不会晚于之后的查询时间)
+        Tick Resolve(const MemSpec& memspec) const
+        {
+            if((width == DeviceWidth::X4 && memspec.width != 4) || (width == DeviceWidth::NotX4 && memspec.width == 4))
+            {
+                return 0;
+            }
+            Tick delay = offset;
+            for(Term term: terms)
+            {
+                if(term != nullptr)
+                {
+                    delay += memspec.*term;
+                }
+            }
+            return delay;
+        }
+    };
+
+    template<typename MemSpec>
+    constexpr TimingRule<MemSpec>
+    MakeRule(Command::Type prev, TimingClass next, TimingScope scope,
+             std::initializer_list<typename TimingRule<MemSpec>::Term> terms, Tick offset,
+             DeviceWidth width, TimingWindow window)
+    {
+        TimingRule<MemSpec> rule;
+        rule.prev = prev;
+        rule.next = next;
+        rule.scope = scope;
+        unsigned i = 0;
+        for(auto term: terms)
+        {
+            rule.terms[i++] = term;
+        }
+        rule.offset = offset;
+        rule.width = width;
+        rule.window = window;
+        return rule;
+    }
+
+    namespace ddr5_3ds{
+    using S = DDR5MemSpec3ds;
+    using C = TimingClass;
+    using Sc = TimingScope;
+
+    constexpr TimingRule<DDR5MemSpec3ds>
+    Rule(Command::Type prev, TimingClass next, TimingScope scope,
+         std::initializer_list<TimingRule<DDR5MemSpec3ds>::Term> terms, Tick offset = 0,
+         DeviceWidth width = DeviceWidth::Any, TimingWindow window = TimingWindow::None)
+    {
+        return MakeRule<DDR5MemSpec3ds>(prev, next, scope, terms, offset, width, window);
+    }
+
+    // DDR5 3DS timing rule 表, 与 SdramConstraintDDR5_3ds (pull model) 中的检查一一对应
+    // 新的 memspec 只需要提供一张同样格式的表
+    inline constexpr TimingRule<DDR5MemSpec3ds> kTimingRules[] = {
+        // ACT
+        Rule(Command::PRE,   C::ACT, Sc::Bank,              {&S::nRP_mc}),
+        Rule(Command::PREsb, C::ACT, Sc::SameBgBank,        {&S::nRP_mc}),
+        Rule(Command::PREab, C::ACT, Sc::Lrank,             {&S::nRP_mc}),
+        Rule(Command::ACT,   C::ACT, Sc::Bank,              {&S::nRCD_mc, &S::nRASmin_mc}),
+        Rule(Command::ACT,   C::ACT, Sc::Bg,                {&S::nRRD_L_slr_mc}),
+        Rule(Command::ACT,   C::ACT, Sc::Lrank,             {&S::nRRD_S_slr_mc}),
+        Rule(Command::ACT,   C::ACT, Sc::PrankOtherLrank,   {&S::nRRD_dlr_mc}),
+        Rule(Command::REFab, C::ACT, Sc::Lrank,             {&S::nRFC_slr_mc}),
+        Rule(Command::REFab, C::ACT, Sc::PrankOtherLrank,   {&S::nRFC_dlr_mc}),
+        Rule(Command::REFab, C::ACT, Sc::ChannelOtherPrank, {&S::nRFC_dpr_mc}),
+        Rule(Command::REFsb, C::ACT, Sc::SameBgBank,        {&S::nRFCsb_slr_mc}),
+        Rule(Command::REFsb, C::ACT, Sc::LrankBg,           {&S::nREFSBRD_slr_mc}),
+        Rule(Command::REFsb, C::ACT, Sc::PrankOtherLrank,   {&S::nREFSBRD_dlr_mc}),
+        Rule(Command::RDA,   C::ACT, Sc::Bank,              {&S::nRTP_slr_mc, &S::nRP_mc}),
+        Rule(Command::WRA,   C::ACT, Sc::Bank,              {&S::nCWL_mc, &S::nBurst_mc, &S::nWR_slr_mc, &S::nRP_mc}),
+
+        // PRE
+        Rule(Command::PRE,   C::PRE, Sc::Bg,                {&S::nPPD_slr_mc}),
+        Rule(Command::PRE,   C::PRE, Sc::Lrank,             {&S::nPPD_slr_mc}),
+        Rule(Command::PRE,   C::PRE, Sc::Prank,             {&S::nPPD_dlr_mc}),
+        Rule(Command::PREsb, C::PRE, Sc::LrankBg,           {&S::nPPD_slr_mc}),
+        Rule(Command::PREsb, C::PRE, Sc::Prank,             {&S::nPPD_dlr_mc}),
+        Rule(Command::PREab, C::PRE, Sc::Prank,             {&S::nPPD_dlr_mc}),
+        Rule(Command::ACT,   C::PRE, Sc::Bank,              {&S::nRASmin_mc}),
+        Rule(Command::RD,    C::PRE, Sc::Bank,              {&S::nRTP_slr_mc}),
+        Rule(Command::WR,    C::PRE, Sc::Bank,              {&S::nWR_slr_mc}),
+
+        // PREsb
+        Rule(Command::PRE,   C::PREsb, Sc::Lrank,           {&S::nPPD_slr_mc}),
+        Rule(Command::PRE,   C::PREsb, Sc::Prank,           {&S::nPPD_dlr_mc}),
+        Rule(Command::PREsb, C::PREsb, Sc::Lrank,           {&S::nPPD_slr_mc}),
+        Rule(Command::PREsb, C::PREsb, Sc::Prank,           {&S::nPPD_dlr_mc}),
+        Rule(Command::PREab, C::PREsb, Sc::Prank,           {&S::nPPD_dlr_mc}),
+        Rule(Command::ACT,   C::PREsb, Sc::SameBgBank,      {&S::nRASmin_mc}),
+        Rule(Command::RD,    C::PREsb, Sc::SameBgBank,      {&S::nRTP_slr_mc}),
+        Rule(Command::WR,    C::PREsb, Sc::SameBgBank,      {&S::nWR_slr_mc}),
+
+        // PREab
+        Rule(Command::PRE,   C::PREab, Sc::Lrank,           {&S::nPPD_slr_mc}),
+        Rule(Command::PRE,   C::PREab, Sc::Prank,           {&S::nPPD_dlr_mc}),
+        Rule(Command::PREsb, C::PREab, Sc::Lrank,           {&S::nPPD_slr_mc}),
+        Rule(Command::PREsb, C::PREab, Sc::Prank,           {&S::nPPD_dlr_mc}),
+        Rule(Command::PREab, C::PREab, Sc::Prank,           {&S::nPPD_dlr_mc}),
+        Rule(Command::ACT,   C::PREab, Sc::Lrank,           {&S::nRASmin_mc}),
+        Rule(Command::RD,    C::PREab, Sc::Lrank,           {&S::nRTP_slr_mc}),
+        Rule(Command::WR,    C::PREab, Sc::Lrank,           {&S::nWR_slr_mc}),
+
+        // REFab
+        Rule(Command::REFsb, C::REFab, Sc::PrankOtherLrank,   {&S::nRFCsb_dlr_mc}),
+        Rule(Command::REFab, C::REFab, Sc::PrankOtherLrank,   {&S::nRFC_dlr_mc}),
+        Rule(Command::ACT,   C::REFab, Sc::PrankOtherLrank,   {&S::nRRD_dlr_mc}),
+        Rule(Command::REFab, C::REFab, Sc::Lrank,             {&S::nRFC_slr_mc}),
+        Rule(Command::REFab, C::REFab, Sc::ChannelOtherPrank, {&S::nRFC_dpr_mc}),
+        Rule(Command::REFsb, C::REFab, Sc::Lrank,             {&S::nRFCsb_slr_mc}),
+        Rule(Command::PRE,   C::REFab, Sc::Lrank,             {&S::nRP_mc}),
+        Rule(Command::PREab, C::REFab, Sc::Lrank,             {&S::nRP_mc}),
+        Rule(Command::PREsb, C::REFab, Sc::Lrank,             {&S::nRP_mc}),
+        Rule(Command::RDA,   C::REFab, Sc::Lrank,             {&S::nRTP_slr_mc, &S::nRP_mc}),
+        Rule(Command::WRA,   C::REFab, Sc::Lrank,             {&S::nCWL_mc, &S::nBurst_mc, &S::nWR_slr_mc, &S::nRP_mc}),
+
+        // REFsb
+        Rule(Command::REFsb, C::REFsb, Sc::PrankOtherLrank,   {&S::nRFCsb_dlr_mc}),
+        Rule(Command::REFab, C::REFsb, Sc::PrankOtherLrank,   {&S::nRFC_dlr_mc}),
+        Rule(Command::ACT,   C::REFsb, Sc::PrankOtherLrank,   {&S::nRRD_dlr_mc}),
+        Rule(Command::REFab, C::REFsb, Sc::Lrank,             {&S::nRFC_slr_mc}),
+        Rule(Command::REFab, C::REFsb, Sc::ChannelOtherPrank, {&S::nRFC_dpr_mc}),
+        Rule(Command::REFsb, C::REFsb, Sc::Lrank,             {&S::nRFCsb_slr_mc}),
+        Rule(Command::ACT,   C::REFsb, Sc::Lrank,             {&S::nRRD_L_slr_mc}),
+        Rule(Command::RDA,   C::REFsb, Sc::SameBgBank,        {&S::nRTP_slr_mc, &S::nRP_mc}),
+        Rule(Command::WRA,   C::REFsb, Sc::SameBgBank,        {&S::nCWL_mc, &S::nBurst_mc, &S::nWR_slr_mc, &S::nRP_mc}),
+
+        // RD / RDA
+        Rule(Command::ACT,   C::RD, Sc::Bank,               {&S::nRCD_mc}),
+        Rule(Command::RD,    C::RD, Sc::Bg,                 {&S::nCCD_L_slr_mc}),
+        Rule(Command::RD,    C::RD, Sc::Lrank,              {&S::nCCD_S_slr_mc}),
+        Rule(Command::RD,    C::RD, Sc::PrankOtherLrank,    {&S::nCCD_dlr_mc}),
+        Rule(Command::RD,    C::RD, Sc::Channel,            {&S::nBurst_mc}),
+        Rule(Command::RDA,   C::RD, Sc::Bg,                 {&S::nCCD_L_slr_mc}),
+        Rule(Command::RDA,   C::RD, Sc::Lrank,              {&S::nCCD_S_slr_mc}),
+        Rule(Command::RDA,   C::RD, Sc::PrankOtherLrank,    {&S::nCCD_dlr_mc}),
+        Rule(Command::RDA,   C::RD, Sc::Channel,            {&S::nBurst_mc}),
+        Rule(Command::WR,    C::RD, Sc::Bg,                 {&S::nCCD_L_WTR_slr_mc}),
+        Rule(Command::WR,    C::RD, Sc::Lrank,              {&S::nCCD_S_WTR_slr_mc}),
+        Rule(Command::WR,    C::RD, Sc::PrankOtherLrank,    {&S::nCCD_WTR_dlr_mc}),
+        Rule(Command::WR,    C::RD, Sc::Channel,            {&S::nBurst_mc}),
+        Rule(Command::WRA,   C::RD, Sc::Bg,                 {&S::nCCD_L_WTR_slr_mc}),
+        Rule(Command::WRA,   C::RD, Sc::Lrank,              {&S::nCCD_S_WTR_slr_mc}),
+        Rule(Command::WRA,   C::RD, Sc::PrankOtherLrank,    {&S::nCCD_WTR_dlr_mc}),
+        Rule(Command::WRA,   C::RD, Sc::Channel,            {&S::nBurst_mc}),
+
+        // WR / WRA
+        Rule(Command::ACT,   C::WR, Sc::Bank,               {&S::nRCD_mc}),
+        Rule(Command::WR,    C::WR, Sc::Bg,                 {&S::nCCD_L_WR_slr_mc}, 0, DeviceWidth::X4),
+        Rule(Command::WR,    C::WR, Sc::Bg,                 {&S::nCCD_L_WR2_slr_mc}, 0, DeviceWidth::NotX4),
+        Rule(Command::WR,    C::WR, Sc::Lrank,              {&S::nCCD_S_WR_slr_mc}),
+        Rule(Command::WR,    C::WR, Sc::PrankOtherLrank,    {&S::nCCD_WR_dlr_mc}),
+        Rule(Command::WR,    C::WR, Sc::ChannelOtherPrank,  {&S::nCCD_WR_dpr_mc}),
+        Rule(Command::WR,    C::WR, Sc::Channel,            {&S::nBurst_mc}),
+        Rule(Command::WRA,   C::WR, Sc::Bg,                 {&S::nCCD_L_WR_slr_mc}, 0, DeviceWidth::X4),
+        Rule(Command::WRA,   C::WR, Sc::Bg,                 {&S::nCCD_L_WR2_slr_mc}, 0, DeviceWidth::NotX4),
+        Rule(Command::WRA,   C::WR, Sc::Lrank,              {&S::nCCD_S_WR_slr_mc}),
+        Rule(Command::WRA,   C::WR, Sc::PrankOtherLrank,    {&S::nCCD_WR_dlr_mc}),
+        Rule(Command::WRA,   C::WR, Sc::ChannelOtherPrank,  {&S::nCCD_WR_dpr_mc}),
+        Rule(Command::WRA,   C::WR, Sc::Channel,            {&S::nBurst_mc}),
+        Rule(Command::RD,    C::WR, Sc::Bg,                 {&S::nCCD_L_RTW_slr_mc}),
+        Rule(Command::RD,    C::WR, Sc::Lrank,              {&S::nCCD_S_RTW_slr_mc}),
+        Rule(Command::RD,    C::WR, Sc::PrankOtherLrank,    {&S::nCCD_RTW_dlr_mc}),
+        Rule(Command::RD,    C::WR, Sc::Channel,            {&S::nBurst_mc}, 1),
+        Rule(Command::RDA,   C::WR, Sc::Bg,                 {&S::nCCD_L_RTW_slr_mc}),
+        Rule(Command::RDA,   C::WR, Sc::Lrank,              {&S::nCCD_S_RTW_slr_mc}),
+        Rule(Command::RDA,   C::WR, Sc::PrankOtherLrank,    {&S::nCCD_RTW_dlr_mc}),
+        Rule(Command::RDA,   C::WR, Sc::Channel,            {&S::nBurst_mc}, 1),
+
+        // tFAW: ACT/REFsb 进入 logical rank 窗口, ACT/REFsb/REFab 进入 physical rank 窗口
+        Rule(Command::ACT,   C::ACT,   Sc::Lrank,           {&S::nFAW_slr_mc}, 0, DeviceWidth::Any, TimingWindow::Lrank),
+        Rule(Command::ACT,   C::REFsb, Sc::Lrank,           {&S::nFAW_slr_mc}, 0, DeviceWidth::Any, TimingWindow::Lrank),
+        Rule(Command::REFsb, C::ACT,   Sc::Lrank,           {&S::nFAW_slr_mc}, 0, DeviceWidth::Any, TimingWindow::Lrank),
+        Rule(Command::REFsb, C::REFsb, Sc::Lrank,           {&S::nFAW_slr_mc}, 0, DeviceWidth::Any, TimingWindow::Lrank),
+        Rule(Command::ACT,   C::ACT,   Sc::Prank,           {&S::nFAW_dlr_mc}, 0, DeviceWidth::Any, TimingWindow::Prank),
+        Rule(Command::ACT,   C::REFab, Sc::Prank,           {&S::nFAW_dlr_mc}, 0, DeviceWidth::Any, TimingWindow::Prank),
+        Rule(Command::ACT,   C::REFsb, Sc::Prank,           {&S::nFAW_dlr_mc}, 0, DeviceWidth::Any, TimingWindow::Prank),
+        Rule(Command::REFsb, C::ACT,   Sc::Prank,           {&S::nFAW_dlr_mc}, 0, DeviceWidth::Any, TimingWindow::Prank),
+        Rule(Command::REFsb, C::REFab, Sc::Prank,           {&S::nFAW_dlr_mc}, 0, DeviceWidth::Any, TimingWindow::Prank),
+        Rule(Command::REFsb, C::REFsb, Sc::Prank,           {&S::nFAW_dlr_mc}, 0, DeviceWidth::Any, TimingWindow::Prank),
+        Rule(Command::REFab, C::ACT,   Sc::Prank,           {&S::nFAW_dlr_mc}, 0, DeviceWidth::Any, TimingWindow::Prank),
+        Rule(Command::REFab, C::REFab, Sc::Prank,           {&S::nFAW_dlr_mc}, 0, DeviceWidth::Any, TimingWindow::Prank),
+        Rule(Command::REFab, C::REFsb, Sc::Prank,           {&S::nFAW_dlr_mc}, 0, DeviceWidth::Any, TimingWindow::Prank),
+
+        // command bus: 同一个 channel 每个 mc cycle 只能发一个命令
+        Rule(Command::Invalid, C::NumOfClasses, Sc::Channel, {}, 1),
+    };
+    } // ddr5_3ds
+
+    inline constexpr const auto& kDDR5_3dsTimingRules = ddr5_3ds::kTimingRules;
+
+        } // timing
+    } // Controller
+} // dmu
+
+#endif
@@ -0,0 +1,177 @@
+#ifndef __TIMER_WHEEL_HH__
+#define __TIMER_WHEEL_HH__
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Common/Common.hh"
+
+namespace dmu{
+    namespace Controller{
+
+/*
+分层 timer wheel, timer 以 id 索引 (如 logical rank id), 每个 id 同时最多有一个 deadline
+    第 level 层一个 slot 覆盖 2^(kSlotBits * level) 个 tick, deadline 与当前时间只在第 level 层的 slot bit 及以下不同时放在第 level 层
+    所以低层的 deadline 总是早于高层; 时间推进到高层的某个 slot 时, 其中的 timer 下放 (cascade) 到低层
+    超出 kNumOfLevels 层范围的 deadline 放在 overflow 中
+Schedule / Cancel 与 timer 数目无关, Advance 只访问经过的非空 slot
+*/
+class TimerWheel
+{
+    public:
+        static constexpr unsigned kSlotBits = 6;
+        static constexpr unsigned kNumOfSlots = 1u << kSlotBits;
+        static constexpr unsigned kNumOfLevels = 4;
+
+        // 每个 slot 按 timer 总数预留, Schedule/Advance 不再走堆
+        explicit TimerWheel(unsigned num_of_timers): timers(num_of_timers)
+        {
+            for(auto& level_slots: slots)
+                for(auto& slot: level_slots)
+                    slot.reserve(num_of_timers);
+            overflow.reserve(num_of_timers);
+            expired.reserve(num_of_timers);
+        }
+
+        // deadline 为 MaxTick 时等价于 Cancel; 不晚于当前时间的 deadline 在下一次 Advance 时触发
+        void Schedule(unsigned id, Tick deadline)
+        {
+            Cancel(id);
+            if(deadline == MaxTick)
+                return;
+            timers[id].deadline = deadline;
+            Insert(id);
+        }
+        void Cancel(unsigned id)
+        {
+            Timer& timer = timers[id];
+            if(timer.level == kUnscheduled)
+                return;
+            std::vector<unsigned>& slot = timer.level == kOverflow ? overflow : slots[timer.level][timer.slot];
+            *std::find(slot.begin(), slot.end(), id) = slot.back();
+            slot.pop_back();
+            if(slot.empty() && timer.level != kOverflow)
+                occupied[timer.level] &= ~(UINT64_C(1) << timer.slot);
+            timer.level = kUnscheduled;
+        }
+        inline bool IsScheduled(unsigned id) const { return timers[id].level != kUnscheduled; }
+        inline Tick GetDeadline(unsigned id) const { return IsScheduled(id) ? timers[id].deadline : MaxTick; }
+
+        // 时间推进到 now, 对 deadline <= now 的 timer 调用 func(id), 触发后的 timer 不再 scheduled
+        template<typename Func>
+        void Advance(Tick now, Func func)
+        {
+            Tick previous = current;
+            current = std::max(current, now);
+            expired.clear();
+            for(unsigned level = 0; level < kNumOfLevels; level++)
+            {
+                unsigned shift = kSlotBits * level;
+                // 第 0 层总是检查当前 slot (包含 Schedule 时已经过期的 timer), 高层只在 slot 变化时检查
+                if(level > 0 && (previous >> shift) == (current >> shift))
+                    break;
+                uint64_t slot_mask = ~UINT64_C(0);
+                if((previous >> (shift + kSlotBits)) == (current >> (shift + kSlotBits)))
+                {
+                    unsigned first = (previous >> shift) % kNumOfSlots;
+                    unsigned last = (current >> shift) % kNumOfSlots;
+                    slot_mask = (last == kNumOfSlots - 1 ? ~UINT64_C(0) : (UINT64_C(1) << (last + 1)) - 1) & (~UINT64_C(0) << first);
+                }
+                for(uint64_t pending = occupied[level] & slot_mask; pending; pending &= pending - 1)
+                    TakeSlot(level, __builtin_ctzll(pending));
+            }
+            if((previous >> (kSlotBits * kNumOfLevels)) != (current >> (kSlotBits * kNumOfLevels)))
+            {
+                for(auto id: overflow)
+                {
+                    timers[id].level = kUnscheduled;
+                    expired.push_back(id);
+                }
+                overflow.clear();
+            }
+
+            for(auto id: expired)
+            {
+                if(timers[id].deadline <= current)
+                    func(id);
+                else
+                    Insert(id);
+            }
+        }
+
+        // 最早的 deadline, 没有 timer 时返回 MaxTick
+        Tick NextDeadline() const
+        {
+            for(unsigned level = 0; level < kNumOfLevels; level++)
+            {
+                if(occupied[level])
+                    return MinDeadline(slots[level][__builtin_ctzll(occupied[level])]);
+            }
+            return MinDeadline(overflow);
+        }
+
+    private:
+        static constexpr unsigned kUnscheduled = kNumOfLevels + 1;
+        static constexpr unsigned kOverflow = kNumOfLevels;
+
+        struct Timer
+        {
+            Tick deadline = MaxTick;
+            unsigned level = kUnscheduled;
+            unsigned slot = 0;
+        };
+
+        void Insert(unsigned id)
+        {
+            Timer& timer = timers[id];
+            // 已经过期的 timer 放在当前时间的 slot, 下一次 Advance 时触发
+            Tick key = std::max(timer.deadline, current);
+            Tick diff = key ^ current;
+            for(unsigned level = 0; level < kNumOfLevels; level++)
+            {
+                unsigned shift = kSlotBits * level;
+                if((diff >> (shift + kSlotBits)) == 0)
+                {
+                    timer.level = level;
+                    timer.slot = (key >> shift) % kNumOfSlots;
+                    slots[level][timer.slot].push_back(id);
+                    occupied[level] |= UINT64_C(1) << timer.slot;
+                    return;
+                }
+            }
+            timer.level = kOverflow;
+            overflow.push_back(id);
+        }
+        void TakeSlot(unsigned level, unsigned slot_index)
+        {
+            std::vector<unsigned>& slot = slots[level][slot_index];
+            for(auto id: slot)
+            {
+                timers[id].level = kUnscheduled;
+                expired.push_back(id);
+            }
+            slot.clear();
+            occupied[level] &= ~(UINT64_C(1) << slot_index);
+        }
+        Tick MinDeadline(const std::vector<unsigned>& slot) const
+        {
+            Tick deadline = MaxTick;
+            for(auto id: slot)
+                deadline = std::min(deadline, timers[id].deadline);
+            return deadline;
+        }
+
+        std::vector<Timer> timers; // (timer id)
+        std::array<std::array<std::vector<unsigned>, kNumOfSlots>, kNumOfLevels> slots;
+        std::array<uint64_t, kNumOfLevels> occupied{}; // 每层非空 slot 的 bitmask
+        std::vector<unsigned> overflow;
+        std::vector<unsigned> expired; // Advance 时取出的 timer, 复用避免分配
+        Tick current = 0;
+};
+
+    } // namespace Controller
+} // namespace dmu
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef __WR_CAM_HH__
 #define __WR_CAM_HH__
 
+#include <cassert>
+#include <optional>
 #include <unordered_map>
 #include <set>
 #include <map>
@@ -30,13 +32,17 @@ class WrCam: public CamIF
         WrCam() = delete;
         ~WrCam() = default;
         explicit WrCam(const Configure& config)
-        : CamIF(config.controller_config->WR_CAM_DEPTH)
+        : CamIF(config.controller_config->WR_CAM_DEPTH, config.mem_spec->NumOfTotalBanks, config.mem_spec->BurstLenth)
         , _config(config)
+        , mc_clock(config.mem_spec->tCK_mc)
+        , wr_cam_slot(config.controller_config->WR_CAM_DEPTH)
         {
             tpw_cam_credit = _config.controller_config->TPW_CREDIT;
+            collision_wr_cam_index_vec.reserve(cam_depth);
+            write_combine_cam_index_vec.reserve(cam_depth);
         }
 
-        inline bool IsTpwFull() const {return cam_store.size() >= cam_depth;}
+        inline bool IsTpwFull() const {return num_of_entries >= cam_depth;}
         bool IsWrCamExpired() const;
         bool HasTpwCredit() const { return tpw_cam_credit >0;}
 
@@ -50,7 +56,11 @@ class WrCam: public CamIF
 
         void DeleteCamEntry(CAM_INDEX removed_cam_index) override;
 
-        WrCamEntry* GetCamEntry(const CAM_INDEX& cam_index) override { return dynamic_cast<WrCamEntry*>(cam_store.at(cam_index).get());}
+        WrCamEntry* GetCamEntry(const CAM_INDEX& cam_index) override
+        {
+            assert(IsCamExist(cam_index));
+            return &*wr_cam_slot[cam_index];
+        }
 
         // get the write data ready and bsc allocated cam index, and do filter in CamFilter
         OrderList GetAvailBaOrderList(RealBaIndex ba_addr) override;
@@ -63,12 +73,11 @@ class WrCam: public CamIF
         }
         inline bool IsBaListAvail(RealBaIndex ba_addr)
         {
-            if(ba_cmds_order_list.find(ba_addr) == ba_cmds_order_list.end())
+            if(IsBaOrderListEmpty(ba_addr))
             {
                 return false;
             }
-            auto ba_list = GetBaOrderList(ba_addr);
-            for(auto cam_index : ba_list)
+            for(auto cam_index : GetBaOrderList(ba_addr))
             {
                 if(GetCamEntry(cam_index)->is_allocated && GetCamEntry(cam_index)->data_ready) //FIX: Wr cmd should also be data ready
                     return true;
@@ -87,15 +96,15 @@ class WrCam: public CamIF
 
             );
         }
-        inline const unsigned GetTpwFillLevel() const { return used_allocated_cam_index.size();}
+        inline const unsigned GetTpwFillLevel() const { return num_of_entries;}
         inline bool IsTpwAlmostFull() const {return tpw_fill_level_pos;} // detect the fill level exceed high threshold
         inline void UpdateTpwFillLevel()
         {
-            if(cam_store.size() < _config.controller_config->TPW_LOW_THRESHOLD)
+            if(num_of_entries < _config.controller_config->TPW_LOW_THRESHOLD)
             {
                 tpw_fill_level = false;
             }
-            else if(cam_store.size() >= _config.controller_config->TPW_HIGH_THRESHOLD)
+            else if(num_of_entries >= _config.controller_config->TPW_HIGH_THRESHOLD)
             {
                 tpw_fill_level_pos = !tpw_fill_level;
                 tpw_fill_level = true;
@@ -112,7 +121,7 @@ class WrCam: public CamIF
                 tpw_cam_full = false;
             }
         }
-        inline unsigned GetTpwSize() const {return cam_store.size();}
+        inline unsigned GetTpwSize() const {return num_of_entries;}
 
         inline void TpwCmdExe()
         {
@@ -136,7 +145,7 @@ class WrCam: public CamIF
             else
             {
                 if(!IsTpwStarve())
-                    tpw_starve_vec.push_back(sc_core::sc_time_stamp());
+                    tpw_starve_vec.push_back(mc_clock.Now());
             }
         }
         // update the wr cam critical state;
@@ -144,9 +153,9 @@ class WrCam: public CamIF
 
         inline bool IsTpwAvailable()
         {
-            for(auto& tpw_cam_index: used_allocated_cam_index)
+            for(auto& wr_cam_entry: wr_cam_slot)
             {
-                if(GetCamEntry(tpw_cam_index)->is_allocated && GetCamEntry(tpw_cam_index)->data_ready) //FIX: need add the data ready decision
+                if(wr_cam_entry && wr_cam_entry->is_allocated && wr_cam_entry->data_ready) //FIX: need add the data ready decision
                     return true;
                 else
                     continue;
@@ -155,10 +164,9 @@ class WrCam: public CamIF
         }
         inline bool IsWrCamAvailable()
         {
-            for(auto tpw_cam_index: used_allocated_cam_index)
+            for(auto& wr_cam_entry: wr_cam_slot)
             {
-                auto wr_cam_entry = GetCamEntry(tpw_cam_index);
-                if( wr_cam_entry->is_allocated && wr_cam_entry->data_ready ) // FIX: wr_cam_entry->data_ready need add the data ready decision
+                if( wr_cam_entry && wr_cam_entry->is_allocated && wr_cam_entry->data_ready ) // FIX: wr_cam_entry->data_ready need add the data ready decision
                 {
                     return true;
                 }
@@ -174,12 +182,15 @@ class WrCam: public CamIF
         inline void ClearWrCollisionCamIndex() { collision_wr_cam_index_vec.clear();write_combine_cam_index_vec.clear();}
         // show the wr cam is collision busy with pip buffer, and stall the pip buffer req into cam
         inline bool IsWrCamBusy() const   {return !collision_wr_cam_index_vec.empty();}
-        inline std::vector<CAM_INDEX> GetWrCollisionCamIndex() const {return collision_wr_cam_index_vec;}
+        inline const std::vector<CAM_INDEX>& GetWrCollisionCamIndex() const {return collision_wr_cam_index_vec;}
         // show the wr cam happen the write combine
         inline bool HasWrCombine() const    {return !write_combine_cam_index_vec.empty();}
 
     private:
         const Configure& _config;
+        const McClock mc_clock;
+
+        std::vector<std::optional<WrCamEntry>> wr_cam_slot; // (cam index) entry 原地构造, 不做堆分配
 
         std::vector<unsigned> collison_cam_index;
         std::vector<unsigned> time_expired_cam_index;
@@ -196,11 +207,11 @@ class WrCam: public CamIF
         bool is_tpw_critical{false};
 
         // bool is_tpw_almost_full;
-        std::vector<sc_core::sc_time> tpw_starve_vec;
+        std::vector<Tick> tpw_starve_vec;
         inline bool IsTpwStarve()
         {
             return _config.controller_config->TPW_STARVE_COUNT_MODE ? tpw_starve_vec.size() >= _config.controller_config->TPW_MAX_STARVE
-                 : (*tpw_starve_vec.begin()) + _config.controller_config->TPW_MAX_STARVE * _config.mem_spec->tCK_mc >= sc_core::sc_time_stamp();
+                 : (*tpw_starve_vec.begin()) + _config.controller_config->TPW_MAX_STARVE >= mc_clock.Now();
         }
 
         bool tpw_cam_full{false};
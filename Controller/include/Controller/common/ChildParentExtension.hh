@@ -39,8 +39,9 @@ public:
     tlm::tlm_extension_base* clone() const override;
     void copy_from(const tlm::tlm_extension_base& ext) override;
 
+    // 已有 extension 时复用其 vector 的容量, pool 中的 payload 稳态下不再分配
     static void SetExtension(tlm::tlm_generic_payload& parentTrans,
-                             std::vector<tlm::tlm_generic_payload*> childTrans);
+                             const std::vector<tlm::tlm_generic_payload*>& childTrans);
 
     const std::vector<tlm::tlm_generic_payload*>& GetChildTrans();
     bool NotifyChildTransCompletion();
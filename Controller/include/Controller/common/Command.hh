@@ -66,12 +66,12 @@ namespace dmu{
         // bool operator==(const Command& other) const { return type == other.type; }
         // bool operator!=(const Command& other) const { return type != other.type; }
         constexpr operator uint8_t() const { return static_cast<uint8_t>(type); }
-        static unsigned NumOfCommands() { return 13;}
+        static constexpr unsigned NumOfCommands() { return 13;}
     };
 
     struct CommandTuple
     {
-        using Type = std::tuple<dmu::Controller::Command, unsigned ,BankAddress,sc_core::sc_time,bool>;
+        using Type = std::tuple<dmu::Controller::Command, unsigned ,BankAddress,Tick,bool>;
         enum Accessor
         {
             Command = 0,
@@ -137,6 +137,34 @@ public:
 // };
 
 
+// controller clock, Tick 和 sc_time 之间的转换只通过这个类完成
+class McClock
+{
+public:
+    explicit McClock(const sc_core::sc_time& tck_mc): period(tck_mc.value()) {}
+
+    // current simulation time in tick, the controller is always triggered at the mc clock edge
+    inline Tick Now() const {return sc_core::sc_time_stamp().value() / period;}
+    inline bool IsAligned() const {return sc_core::sc_time_stamp().value() % period == 0;}
+    // round down, sc_max_time() --> MaxTick
+    inline Tick ToTick(const sc_core::sc_time& time) const
+    {
+        return time == sc_core::sc_max_time() ? MaxTick : time.value() / period;
+    }
+    // round up, used for the configured time which may be not aligned with the mc clock
+    inline Tick ToTickCeil(const sc_core::sc_time& time) const
+    {
+        return time == sc_core::sc_max_time() ? MaxTick : (time.value() + period - 1) / period;
+    }
+    inline sc_core::sc_time ToTime(Tick tick) const
+    {
+        return tick == MaxTick ? sc_core::sc_max_time() : sc_core::sc_time::from_value(tick * period);
+    }
+
+private:
+    const sc_dt::uint64 period;
+};
+
 bool IsFullCycle(sc_core::sc_time time, sc_core::sc_time CycleTime);
 sc_core::sc_time AlignAtNext(sc_core::sc_time time, sc_core::sc_time alignment);
 
@@ -2,6 +2,7 @@
 #define __DFI_EXTENSION_HH__
 
 #include "Controller/common/ControllerCommon.hh"
+#include "Common/RingQueue.hh"
 #include "Common/UifExtension.hh"
 #include "sysc/utils/sc_report.h"
 #include "tlm_core/tlm_2/tlm_generic_payload/tlm_gp.h"
@@ -68,7 +69,7 @@ class DfiExtension: public tlm::tlm_extension<DfiExtension>
 
         DfiExtension() = default;
     private:
-        std::deque<Command> dfi_cmd_queue;
+        RingQueue<Command> dfi_cmd_queue;
         BankAddress cmd_address;
 
 };
@@ -4,9 +4,19 @@
 #include "tlm_core/tlm_2/tlm_generic_payload/tlm_gp.h"
 #include <tlm>
 #include <stack>
+#include <vector>
+
+#include "Common/ExtensionPool.hh"
+#include "Common/StatisticExtension.hh"
+#include "Common/UifExtension.hh"
+
 namespace dmu{
     namespace Controller{
 
+/*
+controller 内部 payload (RMW child, credit 用的 dummy payload) 的 pool
+child 的 UifExtension / StatisticExtension 与 dummy payload 的 UifSideBandExtension 来自 ExtensionPool, payload free 时 UifExtension / StatisticExtension 放回 pool
+*/
 
 class MemoryManager : public tlm::tlm_mm_interface
 {
@@ -53,6 +63,8 @@ class MemoryManager : public tlm::tlm_mm_interface
 
         void free(tlm::tlm_generic_payload* trans) override
         {
+            uifExtensionPool.Recycle(*trans);
+            statisticExtensionPool.Recycle(*trans);
             freePayloads.push(trans);
         }
 
@@ -61,9 +73,16 @@ class MemoryManager : public tlm::tlm_mm_interface
             return dummy_payload;
         }
 
+        inline ExtensionPool<UifExtension>& GetUifExtensionPool() { return uifExtensionPool; }
+        inline ExtensionPool<UifSideBandExtension>& GetSideBandExtensionPool() { return sideBandExtensionPool; }
+        inline ExtensionPool<StatisticExtension>& GetStatisticExtensionPool() { return statisticExtensionPool; }
+
     private:
-        std::stack<tlm::tlm_generic_payload*> freePayloads;
+        std::stack<tlm::tlm_generic_payload*, std::vector<tlm::tlm_generic_payload*>> freePayloads;
         tlm::tlm_generic_payload* dummy_payload;
+        ExtensionPool<UifExtension> uifExtensionPool;
+        ExtensionPool<UifSideBandExtension> sideBandExtensionPool;
+        ExtensionPool<StatisticExtension> statisticExtensionPool;
 
 };
 
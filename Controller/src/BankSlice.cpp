@@ -26,8 +26,8 @@ BankSlice::Release()
 {
     next_rd_command = Command::NOP;
     next_wr_command = Command::NOP;
-    next_rd_command_avail_time = sc_core::SC_ZERO_TIME;
-    next_wr_command_avail_time = sc_core::SC_ZERO_TIME;
+    next_rd_command_avail_time = 0;
+    next_wr_command_avail_time = 0;
     page_info.is_open = false;
     is_allocated = false;
     _ba_addr.ResetBankAddress();
@@ -37,6 +37,9 @@ void
 BankSlice::Update(const CommandTuple::Type& sending_cmd)
 {
     Command cmd = std::get<CommandTuple::Command>(sending_cmd);
+    // group / rank 命令 (PREsb / PREab / REF / RFM) 只更新已分配的 bsc, 由 device 按 rank 统计
+    if(cmd.IsBankCommand())
+        _perf_counters.RecordBankCommand(_ba_addr.real_ba, cmd.to_type());
     switch (cmd)
     {
         case Command::ACT:
@@ -87,15 +90,15 @@ BankSlice::Update(const CommandTuple::Type& sending_cmd)
             }
             assert(current_state != BankState::Actived && "Bank is already actived");
             current_state = BankState::Actived;
-            act_tRCD_end_time = sc_core::sc_time_stamp() + tRCD_mc;
-            act_tRAS_end_time = sc_core::sc_time_stamp() + tRAS_max_mc;
+            act_tRCD_end_time = mc_clock.Now() + nRCD_mc;
+            act_tRAS_end_time = mc_clock.Now() + nRAS_max_mc;
             break;
         case Command::PRE:
         case Command::PREsb:
         case Command::PREab:
             {
                 page_info.is_open = false;
-                act_tRAS_end_time = Max_time;
+                act_tRAS_end_time = MaxTick;
                 assert(current_state != BankState::Precharged && "Bank is already precharged");
                 current_state = BankState::Precharged;
                 _rd_cam->SetBaPageClose(_ba_addr.real_ba);
@@ -218,10 +221,9 @@ BankSlice::GetBaAddr() const
 }
 
 
-ReadyCommands
-BankSlice::GetAvailCommand(GlobalRdWrState global_rdwr_mode)
+void
+BankSlice::GetAvailCommand(GlobalRdWrState global_rdwr_mode, ReadyCommands& bank_ready_commands)
 {
-    ReadyCommands bank_ready_commands;
     if(global_rdwr_mode == GlobalRdWrState::Rd)
     {
         if(this->IsRdCmdAvail())
@@ -242,7 +244,7 @@ BankSlice::GetAvailCommand(GlobalRdWrState global_rdwr_mode)
     else if(global_rdwr_mode == GlobalRdWrState::Wr2Rd)
     {
         if(this->IsRdCmdAvail() && (next_rd_command == Command::ACT || next_rd_command == Command::PRE))
-            bank_ready_commands.emplace_back(next_rd_command,candidate_rd_cmd.cam_index,this->_ba_addr,next_rd_command_avail_time,false);
+            bank_ready_commands.emplace_back(next_rd_command,candidate_rd_cmd.cam_index,this->_ba_addr,next_rd_command_avail_time,true);
         if(this->IsWrCmdAvail() && (next_wr_command == Command::WR || next_wr_command == Command::WRA))
             bank_ready_commands.emplace_back(next_wr_command,candidate_wr_cmd.cam_index,this->_ba_addr,next_wr_command_avail_time,false);
     }
@@ -251,7 +253,6 @@ BankSlice::GetAvailCommand(GlobalRdWrState global_rdwr_mode)
         std::cerr << "Bank Slice get invalid global mode"<<std::endl;
         std::abort();
     }
-    return bank_ready_commands;
 }
 
 CAM_INDEX
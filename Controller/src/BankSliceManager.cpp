@@ -10,18 +10,24 @@
 namespace dmu{
     namespace Controller{
 using OrderList = std::list<CAM_INDEX>;
-BankSliceManager::BankSliceManager(Scheduler& scheduler, const Configure& config)
+BankSliceManager::BankSliceManager(Scheduler& scheduler, const Configure& config, PerformanceCounters& perf_counters)
 : _config(config)
+, bsc_table(config.controller_config->BSC_NUM)
+, ba2bsc_table(config.mem_spec->NumOfTotalBanks, kInvalidBscIndex)
 , _scheduler(scheduler)
 {
+    if(config.controller_config->BSC_NUM > BscMask::kMaxCamDepth)
+    {
+        std::cerr << "BSC_NUM " << config.controller_config->BSC_NUM << " exceeds BscMask::kMaxCamDepth " << BscMask::kMaxCamDepth << std::endl;
+        std::abort();
+    }
+    bsc_index_2_bankslice.reserve(config.controller_config->BSC_NUM);
     for(unsigned i = 0; i < config.controller_config->BSC_NUM; i++)
     {
         unallocated_bsc_index_queue.push_back(i);
-        bsc_index_2_bankslice.emplace(static_cast<BSC_INDEX>(i),std::make_unique<BankSlice>(scheduler,config,i));
+        bsc_index_2_bankslice.emplace_back(std::make_unique<BankSlice>(scheduler,config,i,perf_counters));
     }
-    bsc_table.reserve(config.controller_config->BSC_NUM);
-    ba2bsc_table.reserve(config.controller_config->BSC_NUM);
-    bsc_ready_commands.reserve(config.controller_config->BSC_NUM);
+    bsc_ready_commands.reserve(2*config.controller_config->BSC_NUM); // Rd2Wr/Wr2Rd 每个 bsc 最多两条
 }
 
 bool
@@ -30,49 +36,40 @@ BankSliceManager::IsNeedBankSliceRelease()
     // bank release will call the bank slice release
     // 1. bsc has no valid cmd in rd and wr cam, and bsc is used and idle state(also precharged)
     // 2. bsc mapped bank is in refreshing, the bsc can be released
-    empty_bsc_set.clear();
-    for(auto& bsc_index: allocated_bsc_index_set)
+    empty_bsc_mask = BscMask();
+    for(auto bsc_index: allocated_bsc_mask)
     {
         auto& bsc_ba_addr = bsc_table[bsc_index].real_ba;
         if(_scheduler.GetRdCam()->IsBaOrderListEmpty(bsc_ba_addr) &&
            _scheduler.GetWrCam()->IsBaOrderListEmpty(bsc_ba_addr) &&
            !bsc_index_2_bankslice[bsc_index]->IsPageOpen())
         {
-            empty_bsc_set.insert(bsc_index);
+            empty_bsc_mask.Set(bsc_index);
         }
     }
-    return !empty_bsc_set.empty();
+    return empty_bsc_mask.Any();
     // Implement with Codex
     // TODO: support force release
-    // if the empty_bsc_set is empty, but the bsc number if exceed the bsc_num_high_threshold
+    // if the empty_bsc_mask is empty, but the bsc number if exceed the bsc_num_high_threshold
     // will do the force release, will call the selected bank slice to enter bsc precharged state
 }
 
 void
 BankSliceManager::BankSliceRelease()
 {
-    auto find_rr_first_element = empty_bsc_set.lower_bound(last_released_bsc_index);
-    BSC_INDEX rr_released_bsc_index;
-    if(find_rr_first_element != empty_bsc_set.end())
-    {
-        rr_released_bsc_index = *find_rr_first_element;
-    }
-    else
-    {
-        rr_released_bsc_index = *empty_bsc_set.begin();
-    }
+    BSC_INDEX rr_released_bsc_index = empty_bsc_mask.FindNextWrap(last_released_bsc_index);
     last_released_bsc_index = rr_released_bsc_index;
 
     auto rr_released_bsc_ba = bsc_table[rr_released_bsc_index].real_ba;
-    bsc_table.erase(rr_released_bsc_index);
-    ba2bsc_table.erase(rr_released_bsc_ba);
+    bsc_table[rr_released_bsc_index] = BankAddress();
+    ba2bsc_table[rr_released_bsc_ba] = kInvalidBscIndex;
     bsc_index_2_bankslice[rr_released_bsc_index]->Release();
     unallocated_bsc_index_queue.push_back(rr_released_bsc_index);
-    allocated_bsc_index_set.erase(rr_released_bsc_index);
+    allocated_bsc_mask.Reset(rr_released_bsc_index);
 
     if(!_scheduler.GetRdCam()->IsBaOrderListEmpty(rr_released_bsc_ba))
     {
-        const OrderList& rd_cam_ba_order_list = _scheduler.GetRdCam()->GetBaOrderList(rr_released_bsc_ba);
+        CamIndexList rd_cam_ba_order_list = _scheduler.GetRdCam()->GetBaOrderList(rr_released_bsc_ba);
         for(auto& cam_index: rd_cam_ba_order_list)
         {
             RdCamEntry* rd_cam_entry = _scheduler.GetRdCam()->GetCamEntry(cam_index);
@@ -81,7 +78,7 @@ BankSliceManager::BankSliceRelease()
     }
     if(!_scheduler.GetWrCam()->IsBaOrderListEmpty(rr_released_bsc_ba))
     {
-        const OrderList& wr_cam_ba_order_list = _scheduler.GetWrCam()->GetBaOrderList(rr_released_bsc_ba);
+        CamIndexList wr_cam_ba_order_list = _scheduler.GetWrCam()->GetBaOrderList(rr_released_bsc_ba);
         for(auto& cam_index: wr_cam_ba_order_list)
         {
             WrCamEntry* wr_cam_entry = _scheduler.GetWrCam()->GetCamEntry(cam_index);
@@ -93,7 +90,7 @@ BankSliceManager::BankSliceRelease()
 bool
 BankSliceManager::IsNeedBankSliceAllocation()
 {
-    return !(_scheduler.GetRdCam()->GetUnallocatedBscCamIndex().empty() && _scheduler.GetWrCam()->GetUnallocatedBscCamIndex().empty())
+    return !(_scheduler.GetRdCam()->GetUnallocatedBscMask().None() && _scheduler.GetWrCam()->GetUnallocatedBscMask().None())
            && !unallocated_bsc_index_queue.empty();
     // Implement with Codex
     //TODO: Need to add a condition decide, when there is no avail bsc can be allocated
@@ -103,10 +100,10 @@ void
 BankSliceManager::BankSliceAllocation()
 {
     ResetAllocationState();
-    const WaitingList& rd_wating_list = _scheduler.GetRdCam()->GetUnallocatedBscCamIndex();
-    const WaitingList& wr_wating_list = _scheduler.GetWrCam()->GetUnallocatedBscCamIndex();
+    const CamMask rd_waiting_mask = _scheduler.GetRdCam()->GetUnallocatedBscMask();
+    const CamMask wr_waiting_mask = _scheduler.GetWrCam()->GetUnallocatedBscMask();
 
-    if(rd_wating_list.empty() && wr_wating_list.empty())
+    if(rd_waiting_mask.None() && wr_waiting_mask.None())
     {
         return;
     }
@@ -116,28 +113,28 @@ BankSliceManager::BankSliceAllocation()
         this->allocation_state.current_bsc_allocated = true;
         BankAddress& ba_addr = this->allocation_state.current_allocated_bank_address;
 
-        if(!rd_wating_list.empty() && wr_wating_list.empty())
+        if(!rd_waiting_mask.None() && wr_waiting_mask.None())
         {
-            CAM_INDEX winning_rd_cam_index = _scheduler.GetRdCamFilter()->GetSelectedRdCamIndex(rd_wating_list);
+            CAM_INDEX winning_rd_cam_index = _scheduler.GetRdCamFilter()->GetSelectedRdCamIndex(rd_waiting_mask);
             RdCamEntry* selected_rd_cam_entry = _scheduler.GetRdCam()->GetCamEntry(winning_rd_cam_index);
 
             ba_addr = BankAddress(selected_rd_cam_entry->sdram_addr);
             allocation_state.current_is_rd_allocated = true;
         }
-        else if(rd_wating_list.empty() && !wr_wating_list.empty())
+        else if(rd_waiting_mask.None() && !wr_waiting_mask.None())
         {
-            CAM_INDEX winning_wr_cam_index = _scheduler.GetWrCamFilter()->GetSelectedWrCamIndex(wr_wating_list);
+            CAM_INDEX winning_wr_cam_index = _scheduler.GetWrCamFilter()->GetSelectedWrCamIndex(wr_waiting_mask);
             WrCamEntry* selected_wr_cam_entry = _scheduler.GetWrCam()->GetCamEntry(winning_wr_cam_index);
 
             ba_addr = BankAddress(selected_wr_cam_entry->sdram_addr);
             allocation_state.current_is_rd_allocated = false;
         }
-        else if(!rd_wating_list.empty() && !wr_wating_list.empty())
+        else if(!rd_waiting_mask.None() && !wr_waiting_mask.None())
         {
-            CAM_INDEX winning_rd_cam_index = _scheduler.GetRdCamFilter()->GetSelectedRdCamIndex(rd_wating_list);
+            CAM_INDEX winning_rd_cam_index = _scheduler.GetRdCamFilter()->GetSelectedRdCamIndex(rd_waiting_mask);
             RdCamEntry* selected_rd_cam_entry = _scheduler.GetRdCam()->GetCamEntry(winning_rd_cam_index);
 
-            CAM_INDEX winning_wr_cam_index = _scheduler.GetWrCamFilter()->GetSelectedWrCamIndex(wr_wating_list);
+            CAM_INDEX winning_wr_cam_index = _scheduler.GetWrCamFilter()->GetSelectedWrCamIndex(wr_waiting_mask);
             WrCamEntry* selected_wr_cam_entry = _scheduler.GetWrCam()->GetCamEntry(winning_wr_cam_index);
 
             bool rd_urgent = selected_rd_cam_entry->is_expired || selected_rd_cam_entry->is_addr_collision;
@@ -174,10 +171,13 @@ BankSliceManager::BankSliceAllocation()
         // 先分配BSC索引
         this->BscIndexAllocate();
         // 不再需要重新设置current_allocated_bsc, 因为BscIndexAllocate()已经设置了该值
-        for(auto& bsc_index: allocated_bsc_index_set)
+        if(DPRINT_ENABLED(BANK_SLICE_MANAGER))
         {
-            std::cout << "Allocated BSC Index: " << bsc_index <<
-            " Allocated Bank Address: " << (bsc_index_2_bankslice.at(bsc_index))->GetBaAddr() << std::endl;
+            for(auto bsc_index: allocated_bsc_mask)
+            {
+                std::cout << "Allocated BSC Index: " << bsc_index <<
+                " Allocated Bank Address: " << (bsc_index_2_bankslice.at(bsc_index))->GetBaAddr() << std::endl;
+            }
         }
 
     }
@@ -220,9 +220,9 @@ BankSliceManager::GetAllocatedDirection()
 void
 BankSliceManager::NttUpdate()
 {
-    if(!_scheduler.GetUpdatedBscSet(true).empty())
+    if(_scheduler.GetUpdatedBscMask(true).Any())
     {
-        for(auto& bsc_index: _scheduler.GetUpdatedBscSet(true))
+        for(auto bsc_index: _scheduler.GetUpdatedBscMask(true))
         {
             CAM_INDEX selected_rd_cam_index = _scheduler.GetUpdateNttTemp(bsc_index,true);
             DPRINT_INFO(TOP_DEBUG,"BankSliceManager","update the rd ntt to the bsc: %d, with selected rd cam index: %d",bsc_index,selected_rd_cam_index);
@@ -240,9 +240,9 @@ BankSliceManager::NttUpdate()
             }
         }
     }
-    if(!_scheduler.GetUpdatedBscSet(false).empty())
+    if(_scheduler.GetUpdatedBscMask(false).Any())
     {
-        for(auto& bsc_index: _scheduler.GetUpdatedBscSet(false))
+        for(auto bsc_index: _scheduler.GetUpdatedBscMask(false))
         {
             CAM_INDEX selected_wr_cam_index = _scheduler.GetUpdateNttTemp(bsc_index,false);
             DPRINT_INFO(TOP_DEBUG,"BankSliceManager","update the wr ntt to the bsc: %d, with selected wr cam index: %d",bsc_index,selected_wr_cam_index);
@@ -279,24 +279,20 @@ BankSliceManager::IsReadyCommandsEmpty(GlobalRdWrState global_rdwr_mode)
     // }
 
     bsc_ready_commands.clear();
-    for(auto& bsc_index: allocated_bsc_index_set)
+    for(auto bsc_index: allocated_bsc_mask)
     {
         BankSlice* bank_slice = bsc_index_2_bankslice[bsc_index].get();
-        auto bank_ready_commands = bank_slice->GetAvailCommand(global_rdwr_mode);
-        if(!bank_ready_commands.empty())
-        {
-            bsc_ready_commands.insert(bsc_ready_commands.end(),std::make_move_iterator(bank_ready_commands.begin()),std::make_move_iterator(bank_ready_commands.end()));
-        }
+        bank_slice->GetAvailCommand(global_rdwr_mode,bsc_ready_commands);
     }
 
     return bsc_ready_commands.empty();
 }
 
-sc_core::sc_time
+Tick
 BankSliceManager::GetNextCommandTriggerTime()
 {
-    sc_core::sc_time trigger_time{sc_core::sc_max_time()};
-    for(auto& bsc_index: allocated_bsc_index_set)
+    Tick trigger_time{MaxTick};
+    for(auto bsc_index: allocated_bsc_mask)
     {
         BankSlice* bank_slice = bsc_index_2_bankslice[bsc_index].get();
         trigger_time = std::min(trigger_time,bank_slice->GetNextCommandTriggerTime());
@@ -319,14 +315,16 @@ BankSliceManager::CommandUpdate(const CommandTuple::Type& sending_cmd)
     if(sending_cmd_type.IsBankCommand())
     {
         RealBaIndex sending_cmd_real_ba = sending_cmd_ba_addr.real_ba;
-        BSC_INDEX sending_cmd_bsc_index = ba2bsc_table[sending_cmd_real_ba];
+        BSC_INDEX sending_cmd_bsc_index = GetBscIndex(sending_cmd_real_ba);
         bsc_index_2_bankslice[sending_cmd_bsc_index]->Update(sending_cmd);
+        if(bsc_index_2_bankslice[sending_cmd_bsc_index]->IsRfmReq())
+            rfm_req_bsc_mask.Set(sending_cmd_bsc_index);
     }
     else if(sending_cmd_type.IsGroupCommand())
     {
         // Implement with Codex
         //TODO: add the Group cmd update code
-        for(auto& bsc_index: allocated_bsc_index_set)
+        for(auto bsc_index: allocated_bsc_mask)
         {
             if(bsc_index_2_bankslice.at(bsc_index)->GetBaAddr().real_cid == sending_cmd_ba_addr.real_cid
             && bsc_index_2_bankslice.at(bsc_index)->GetBaAddr().bank == sending_cmd_ba_addr.bank)
@@ -339,7 +337,7 @@ BankSliceManager::CommandUpdate(const CommandTuple::Type& sending_cmd)
     {
         // Implement with Codex
         //TODO: add the rank cmd update code
-        for(auto& bsc_index: allocated_bsc_index_set)
+        for(auto bsc_index: allocated_bsc_mask)
         {
             if(bsc_index_2_bankslice.at(bsc_index)->GetBaAddr().real_cid == sending_cmd_ba_addr.real_cid)
             {
@@ -361,12 +359,11 @@ BankSliceManager::AllocationUpdate()
     if(allocation_state.current_bsc_allocated)
     {
         //update bsc table;
-        bsc_table.emplace(allocation_state.current_allocated_bsc,
-                          allocation_state.current_allocated_bank_address);
-        ba2bsc_table.emplace(allocation_state.current_allocated_bank_address.real_ba,
-                          allocation_state.current_allocated_bsc);
-        assert(!(allocated_bsc_index_set.count(allocation_state.current_allocated_bsc)>0));
-        allocated_bsc_index_set.insert(allocation_state.current_allocated_bsc);
+        bsc_table[allocation_state.current_allocated_bsc] = allocation_state.current_allocated_bank_address;
+        assert(ba2bsc_table[allocation_state.current_allocated_bank_address.real_ba] == kInvalidBscIndex);
+        ba2bsc_table[allocation_state.current_allocated_bank_address.real_ba] = allocation_state.current_allocated_bsc;
+        assert(!allocated_bsc_mask.Test(allocation_state.current_allocated_bsc));
+        allocated_bsc_mask.Set(allocation_state.current_allocated_bsc);
         // Implement with Codex
         //TODO: need to build a map:
         // 1. all same rank bankslice,based on the rank number can find all bankslice
@@ -376,7 +373,7 @@ BankSliceManager::AllocationUpdate()
         // for every cam entry need to update
         if(!_scheduler.GetRdCam()->IsBaOrderListEmpty(allocation_state.current_allocated_bank_address.real_ba))
         {
-            const OrderList& rd_cam_ba_order_list = _scheduler.GetRdCam()->GetBaOrderList(allocation_state.current_allocated_bank_address.real_ba);
+            CamIndexList rd_cam_ba_order_list = _scheduler.GetRdCam()->GetBaOrderList(allocation_state.current_allocated_bank_address.real_ba);
             for(auto& cam_index: rd_cam_ba_order_list)
             {
                 RdCamEntry* rd_cam_entry = _scheduler.GetRdCam()->GetCamEntry(cam_index);
@@ -388,7 +385,7 @@ BankSliceManager::AllocationUpdate()
 
         if(!_scheduler.GetWrCam()->IsBaOrderListEmpty(allocation_state.current_allocated_bank_address.real_ba))
         {
-            const OrderList& wr_cam_ba_order_list = _scheduler.GetWrCam()->GetBaOrderList(allocation_state.current_allocated_bank_address.real_ba);
+            CamIndexList wr_cam_ba_order_list = _scheduler.GetWrCam()->GetBaOrderList(allocation_state.current_allocated_bank_address.real_ba);
             for(auto& cam_index: wr_cam_ba_order_list)
             {
                 WrCamEntry* wr_cam_entry = _scheduler.GetWrCam()->GetCamEntry(cam_index);
@@ -405,7 +402,7 @@ unsigned
 BankSliceManager::GetRdNttPageHitNum()
 {
     unsigned rd_ntt_page_hit_num{0};
-    for(auto bsc_index: allocated_bsc_index_set)
+    for(auto bsc_index: allocated_bsc_mask)
     {
         if(bsc_index_2_bankslice.at(bsc_index)->IsRdNttPageHit())
         {
@@ -418,7 +415,7 @@ unsigned
 BankSliceManager::GetWrNttPageHitNum()
 {
     unsigned wr_ntt_page_hit_num{0};
-    for(auto bsc_index: allocated_bsc_index_set)
+    for(auto bsc_index: allocated_bsc_mask)
     {
         if(bsc_index_2_bankslice.at(bsc_index)->IsWrNttPageHit())
         {
@@ -431,7 +428,7 @@ BankSliceManager::GetWrNttPageHitNum()
 bool
 BankSliceManager::IsRdNttCmdAllPageHit()
 {
-    for(auto bsc_index: allocated_bsc_index_set)
+    for(auto bsc_index: allocated_bsc_mask)
     {
         if(!bsc_index_2_bankslice.at(bsc_index)->IsRdNttValid())
         {
@@ -451,7 +448,7 @@ BankSliceManager::IsRdNttCmdAllPageHit()
 bool
 BankSliceManager::IsWrNttCmdAllPageHit()
 {
-    for(auto bsc_index: allocated_bsc_index_set)
+    for(auto bsc_index: allocated_bsc_mask)
     {
         if(!bsc_index_2_bankslice.at(bsc_index)->IsWrNttValid())
         {
@@ -471,7 +468,7 @@ BankSliceManager::IsWrNttCmdAllPageHit()
 bool
 BankSliceManager::IsRdNttCmdExpired()
 {
-    for(auto bsc_index: allocated_bsc_index_set)
+    for(auto bsc_index: allocated_bsc_mask)
     {
         if(bsc_index_2_bankslice.at(bsc_index)->IsRdNttExpired())
         {
@@ -484,7 +481,7 @@ BankSliceManager::IsRdNttCmdExpired()
 bool
 BankSliceManager::IsWrNttCmdExpired()
 {
-    for(auto bsc_index: allocated_bsc_index_set)
+    for(auto bsc_index: allocated_bsc_mask)
     {
         if(bsc_index_2_bankslice.at(bsc_index)->IsWrNttExpired())
         {
@@ -497,7 +494,7 @@ BankSliceManager::IsWrNttCmdExpired()
 bool
 BankSliceManager::IsRdNttCmdPageHitExpired()
 {
-    for(auto bsc_index: allocated_bsc_index_set)
+    for(auto bsc_index: allocated_bsc_mask)
     {
         if(bsc_index_2_bankslice.at(bsc_index)->IsRdNttPageHit() &&
            bsc_index_2_bankslice.at(bsc_index)->IsRdNttExpired() )
@@ -509,7 +506,7 @@ BankSliceManager::IsRdNttCmdPageHitExpired()
 bool
 BankSliceManager::IsWrNttCmdPageHitExpired()
 {
-    for(auto bsc_index: allocated_bsc_index_set)
+    for(auto bsc_index: allocated_bsc_mask)
     {
         if(bsc_index_2_bankslice.at(bsc_index)->IsWrNttPageHit() &&
            bsc_index_2_bankslice.at(bsc_index)->IsWrNttExpired())
@@ -24,6 +24,7 @@ CamEntry::SetAllocateBsc(BSC_INDEX allocated_bsc_index)
     is_page_hit = false;
     allocated_bsc_index = allocated_bsc_index;
     is_allocated = true;
+    SyncAttributeMask();
 }
 
 void
@@ -32,6 +33,7 @@ CamEntry::SetReleaseBsc()
     is_page_hit = false;
     allocated_bsc_index = 0;
     is_allocated = false;
+    SyncAttributeMask();
 }
 
 void
@@ -40,6 +42,27 @@ CamEntry::SetBaMatch(BSC_INDEX matched_bsc_index, bool _is_page_hit)
     is_page_hit = _is_page_hit;
     is_allocated = true;
     allocated_bsc_index = matched_bsc_index;
+    SyncAttributeMask();
+}
+
+void
+CamEntry::BindAttributeMask(CamAttributeMask* _attribute_mask)
+{
+    attribute_mask = _attribute_mask;
+    attribute_mask->Assign(CamAttribute::Valid, allocated_cam_index, true);
+    attribute_mask->Assign(CamAttribute::Hpr, allocated_cam_index, qos.GetQosLevel() == PriorityClass::HPR);
+    attribute_mask->Assign(CamAttribute::Lpr, allocated_cam_index,
+                           qos.GetQosLevel() == PriorityClass::LPR || qos.GetQosLevel() == PriorityClass::GPR);
+    SyncAttributeMask();
+}
+
+void
+CamEntry::UnbindAttributeMask()
+{
+    if(attribute_mask == nullptr)
+        return;
+    attribute_mask->Reset(allocated_cam_index);
+    attribute_mask = nullptr;
 }
 
 RdCamEntry::RdCamEntry(InputProcessReq& pip_req)
@@ -4,52 +4,44 @@ namespace dmu{
     namespace Controller{
 
 CAM_INDEX
-WrCamFilter::GetSelectedWrCamIndex(const WaitingList& wr_waiting_list,bool IsPageHitLimit)
+WrCamFilter::GetSelectedWrCamIndex(const CamMask& wr_waiting_mask,bool IsPageHitLimit)
 {
-    Candidate_Cmd expired_candidate_cmd;
-    Candidate_Cmd expired_hit_candidate_cmd;
-    Candidate_Cmd collision_candidate_cmd;
-    Candidate_Cmd tpw_hit_candidate_cmd;
-    Candidate_Cmd tpw_candidate_cmd;
-    for(auto& cam_index: wr_waiting_list)
-    {
+    // expired 随时间变化, 只在 waiting 的 entry 上现算
+    CamMask expired_mask;
+    wr_waiting_mask.FindIf([&](unsigned cam_index) {
         WrCamEntry* wr_cam_entry = _wr_cam.GetCamEntry(cam_index);
         if(wr_cam_entry->qos.GetQosLevel() == PriorityClass::Invalid)
         {
             std::cerr << "Invalid Wr cmd Qos Level" <<std::endl;
             std::abort();
         }
-        tpw_candidate_cmd.insert(cam_index);
-        if(wr_cam_entry->IsExpired())
-        {
-            if(!IsPageHitLimit && wr_cam_entry->is_page_hit)
-                expired_hit_candidate_cmd.insert(cam_index);
-            else
-                expired_candidate_cmd.insert(cam_index);
-        }
-        else
-        {
-            tpw_hit_candidate_cmd.insert(cam_index);
-        }
-        if(wr_cam_entry->is_addr_collision)
-            collision_candidate_cmd.insert(cam_index);
-    }
+        expired_mask.Assign(cam_index, wr_cam_entry->IsExpired());
+        return false;
+    });
+
+    CamMask expired_hit_candidate_cmd;
+    if(!IsPageHitLimit)
+        expired_hit_candidate_cmd = expired_mask & _wr_cam.GetAttributeMask(CamAttribute::PageHit);
+    CamMask expired_candidate_cmd = AndNot(expired_mask, expired_hit_candidate_cmd);
+    CamMask collision_candidate_cmd = wr_waiting_mask & _wr_cam.GetAttributeMask(CamAttribute::Collision);
+    CamMask tpw_hit_candidate_cmd = AndNot(wr_waiting_mask, expired_mask);
+    const CamMask& tpw_candidate_cmd = wr_waiting_mask;
 
-    if(!expired_candidate_cmd.empty())
+    if(expired_candidate_cmd.Any())
     {
-        if(!expired_hit_candidate_cmd.empty())
+        if(expired_hit_candidate_cmd.Any())
             return GetOldestCamIndex(expired_hit_candidate_cmd);
         return GetOldestCamIndex(expired_candidate_cmd);
     }
-    if(!collision_candidate_cmd.empty())
+    if(collision_candidate_cmd.Any())
     {
         return GetOldestCamIndex(collision_candidate_cmd);
     }
-    if(!tpw_hit_candidate_cmd.empty())
+    if(tpw_hit_candidate_cmd.Any())
     {
         return GetOldestCamIndex(tpw_hit_candidate_cmd);
     }
-    if(!tpw_candidate_cmd.empty())
+    if(tpw_candidate_cmd.Any())
     {
         return GetOldestCamIndex(tpw_candidate_cmd);
     }
@@ -61,70 +53,31 @@ WrCamFilter::GetSelectedWrCamIndex(const WaitingList& wr_waiting_list,bool IsPag
 }
 
 CAM_INDEX
-WrCamFilter::GetSelectedWrCamIndex(const WaitingList& wr_waiting_list)
+WrCamFilter::GetSelectedWrCamIndex(const CamMask& wr_waiting_mask)
 {
-    return GetSelectedWrCamIndex(wr_waiting_list,true);
+    return GetSelectedWrCamIndex(wr_waiting_mask,true);
 }
 
 CAM_INDEX
-WrCamFilter::GetOldestCamIndex(const Candidate_Cmd& candidate_cmd)
+WrCamFilter::GetOldestCamIndex(const CamMask& candidate_cmd)
 {
-    for(auto& cam_index: _wr_cam.GetOrderList())
+    CAM_INDEX cam_index = _wr_cam.GetOldestCamIndex(candidate_cmd);
+    if(cam_index == kInvalidCamIndex)
     {
-        if(candidate_cmd.count(cam_index))
-        {
-            return cam_index;
-        }
+        std::cerr << "In Wr Cam Filter, the order list element dont in given candidate_cmd" <<std::endl;
+        std::abort();
     }
-    std::cerr << "In Wr Cam Filter, the order list element dont in given candidate_cmd" <<std::endl;
-    std::abort();
+    return cam_index;
 }
 
 
 CAM_INDEX
-RdCamFilter::GetSelectedRdCamIndex(const WaitingList& rd_waiting_list,bool IsPageHitLimit)
+RdCamFilter::GetSelectedRdCamIndex(const CamMask& rd_waiting_mask,bool IsPageHitLimit)
 {
-    Candidate_Cmd expired_candidate_cmd;
-    Candidate_Cmd expired_hit_candidate_cmd;
-    Candidate_Cmd collision_candidate_cmd;
-    Candidate_Cmd hpr_hit_candidate_cmd;
-    Candidate_Cmd lpr_candidate_cmd;
-    Candidate_Cmd hpr_candidate_cmd;
-    Candidate_Cmd lpr_hit_candidate_cmd;
-
-    for(auto& cam_index: rd_waiting_list)
-    {
+    // expired 随时间变化, 只在 waiting 的 entry 上现算
+    CamMask expired_candidate_cmd;
+    rd_waiting_mask.FindIf([&](unsigned cam_index) {
         RdCamEntry* rd_cam_entry = _rd_cam.GetCamEntry(cam_index);
-        if(rd_cam_entry->IsExpired())
-        {
-            if(!IsPageHitLimit && rd_cam_entry->is_page_hit)
-            {
-                expired_hit_candidate_cmd.insert(cam_index);
-            }
-            expired_candidate_cmd.insert(cam_index);
-        }
-        if(rd_cam_entry->is_addr_collision)
-        {
-            collision_candidate_cmd.insert(cam_index);
-        }
-
-        if(rd_cam_entry->qos.GetQosLevel() == PriorityClass::HPR)
-        {
-            if(rd_cam_entry->is_page_hit)
-            {
-                hpr_hit_candidate_cmd.insert(cam_index);
-            }
-            hpr_candidate_cmd.insert(cam_index);
-        }
-        if(rd_cam_entry->qos.GetQosLevel() == PriorityClass::LPR || 
-           rd_cam_entry->qos.GetQosLevel() == PriorityClass::GPR)
-        {
-            if(rd_cam_entry->is_page_hit)
-            {
-                lpr_hit_candidate_cmd.insert(cam_index);
-            }
-            lpr_candidate_cmd.insert(cam_index);
-        }
         if(rd_cam_entry->qos.GetQosLevel() == PriorityClass::Invalid
            || rd_cam_entry->qos.GetQosLevel() == PriorityClass::GPW
            || rd_cam_entry->qos.GetQosLevel() == PriorityClass::TPW)
@@ -132,63 +85,75 @@ RdCamFilter::GetSelectedRdCamIndex(const WaitingList& rd_waiting_list,bool IsPag
             std::cerr << "Invalid Qos level get" <<std::endl;
             std::abort();
         }
-    }
+        expired_candidate_cmd.Assign(cam_index, rd_cam_entry->IsExpired());
+        return false;
+    });
 
-    if(!expired_candidate_cmd.empty())
+    const CamMask& page_hit_mask = _rd_cam.GetAttributeMask(CamAttribute::PageHit);
+    CamMask expired_hit_candidate_cmd;
+    if(!IsPageHitLimit)
+        expired_hit_candidate_cmd = expired_candidate_cmd & page_hit_mask;
+    CamMask collision_candidate_cmd = rd_waiting_mask & _rd_cam.GetAttributeMask(CamAttribute::Collision);
+    CamMask hpr_candidate_cmd = rd_waiting_mask & _rd_cam.GetAttributeMask(CamAttribute::Hpr);
+    CamMask hpr_hit_candidate_cmd = hpr_candidate_cmd & page_hit_mask;
+    CamMask lpr_candidate_cmd = rd_waiting_mask & _rd_cam.GetAttributeMask(CamAttribute::Lpr);
+    CamMask lpr_hit_candidate_cmd = lpr_candidate_cmd & page_hit_mask;
+
+    if(expired_candidate_cmd.Any())
     {
-        // assert(!expired_candidate_cmd.empty());
-        if(!expired_hit_candidate_cmd.empty())
+        // assert(expired_candidate_cmd.Any());
+        if(expired_hit_candidate_cmd.Any())
             return GetOldestCamIndex(expired_hit_candidate_cmd);
         return GetOldestCamIndex(expired_candidate_cmd);
     }
-    if(!collision_candidate_cmd.empty())
+    if(collision_candidate_cmd.Any())
     {
-        // assert(!collision_candidate_cmd.empty());
+        // assert(collision_candidate_cmd.Any());
         return GetOldestCamIndex(collision_candidate_cmd);
     }
 
     if(!is_prefer_hit_than_hpr && !this->IsLprCritical()) // branch 0: hpr-hit > hpr > lpr-hit > lpr
     {
-        if(!hpr_hit_candidate_cmd.empty()) // hpr-hit
+        if(hpr_hit_candidate_cmd.Any()) // hpr-hit
             return GetOldestCamIndex(hpr_hit_candidate_cmd);
-        if(!hpr_candidate_cmd.empty()) // hpr
+        if(hpr_candidate_cmd.Any()) // hpr
             return GetOldestCamIndex(hpr_candidate_cmd);
-        if(!lpr_hit_candidate_cmd.empty()) // lpr-hit
+        if(lpr_hit_candidate_cmd.Any()) // lpr-hit
             return GetOldestCamIndex(lpr_hit_candidate_cmd);
-        if(!lpr_candidate_cmd.empty()) // lpr
+        if(lpr_candidate_cmd.Any()) // lpr
             return GetOldestCamIndex(lpr_candidate_cmd);
     }
     else if(!is_prefer_hit_than_hpr && this->IsLprCritical()) // branch 1: lpr-hit > lpr > hpr-hit > hpr
     {
-        if(!lpr_hit_candidate_cmd.empty()) // lpr-hit
+        if(lpr_hit_candidate_cmd.Any()) // lpr-hit
             return GetOldestCamIndex(lpr_hit_candidate_cmd);
-        if(!lpr_candidate_cmd.empty()) // lpr
+        if(lpr_candidate_cmd.Any()) // lpr
             return GetOldestCamIndex(lpr_candidate_cmd);
-        if(!hpr_hit_candidate_cmd.empty()) // hpr-hit
+        if(hpr_hit_candidate_cmd.Any()) // hpr-hit
             return GetOldestCamIndex(hpr_hit_candidate_cmd);
-        if(!hpr_candidate_cmd.empty()) // hpr
+        if(hpr_candidate_cmd.Any()) // hpr
             return GetOldestCamIndex(hpr_candidate_cmd);
     }
     else if(is_prefer_hit_than_hpr && !this->IsLprCritical()) // branch 2: hpr-hit > lpr-hit > hpr > lpr
     {
-        if(!hpr_hit_candidate_cmd.empty()) // hpr-hit
+        if(hpr_hit_candidate_cmd.Any()) // hpr-hit
             return GetOldestCamIndex(hpr_hit_candidate_cmd);
-        if(!lpr_hit_candidate_cmd.empty()) // lpr-hit
+        if(lpr_hit_candidate_cmd.Any()) // lpr-hit
             return GetOldestCamIndex(lpr_hit_candidate_cmd);
-        if(!hpr_candidate_cmd.empty()) // hpr
+        if(hpr_candidate_cmd.Any()) // hpr
             return GetOldestCamIndex(hpr_candidate_cmd);
-        if(!lpr_candidate_cmd.empty()) // lpr
+        if(lpr_candidate_cmd.Any()) // lpr
             return GetOldestCamIndex(lpr_candidate_cmd);
     }
     else // branch 3: lpr-hit > hpr-hit > lpr > hpr
     {
-        if(!lpr_hit_candidate_cmd.empty()) // lpr-hit
+        if(lpr_hit_candidate_cmd.Any()) // lpr-hit
             return GetOldestCamIndex(lpr_hit_candidate_cmd);
-        if(!hpr_hit_candidate_cmd.empty()) // hpr-hit
+        if(hpr_hit_candidate_cmd.Any()) // hpr-hit
             return GetOldestCamIndex(hpr_hit_candidate_cmd);
-        if(!lpr_candidate_cmd.empty()) // lpr
+        if(lpr_candidate_cmd.Any()) // lpr
             return GetOldestCamIndex(lpr_candidate_cmd);
-        if(!hpr_candidate_cmd.empty()) // hpr
+        if(hpr_candidate_cmd.Any()) // hpr
             return GetOldestCamIndex(hpr_candidate_cmd);
     }
 
@@ -198,23 +163,21 @@ RdCamFilter::GetSelectedRdCamIndex(const WaitingList& rd_waiting_list,bool IsPag
 }
 
 CAM_INDEX
-RdCamFilter::GetSelectedRdCamIndex(const WaitingList& rd_waiting_list)
+RdCamFilter::GetSelectedRdCamIndex(const CamMask& rd_waiting_mask)
 {
-    return GetSelectedRdCamIndex(rd_waiting_list,true);
+    return GetSelectedRdCamIndex(rd_waiting_mask,true);
 }
 
 CAM_INDEX
-RdCamFilter::GetOldestCamIndex(const Candidate_Cmd& candidate_cmd)
+RdCamFilter::GetOldestCamIndex(const CamMask& candidate_cmd)
 {
-    for(auto& cam_index: _rd_cam.GetOrderList())
+    CAM_INDEX cam_index = _rd_cam.GetOldestCamIndex(candidate_cmd);
+    if(cam_index == kInvalidCamIndex)
     {
-        if(candidate_cmd.count(cam_index))
-        {
-            return cam_index;
-        }
+        std::cerr << "In Rd Cam Filter, the order list element dont in given candidate_cmd" << std::endl;
+        std::abort();
     }
-    std::cerr << "In Rd Cam Filter, the order list element dont in given candidate_cmd" << std::endl;
-    std::abort();
+    return cam_index;
 }
 
     }
@@ -15,44 +15,45 @@ using Rank_INDEX = unsigned;
 CommandTuple::Type
 CmdSelect::SelectCommand(const ReadyCommands& ready_commands, GlobalRdWrState global_rdwr_state)
 {
-    sc_core::sc_time min_avail_time = MaxTime;
-    sc_core::sc_time cmd_avail_time = sc_core::SC_ZERO_TIME;
+    Tick cmd_avail_time = 0;
     BSC_INDEX cmd_bsc_index;
 
-    std::set<BSC_INDEX> row_bsc_set;
-    std::set<BSC_INDEX> col_bsc_set;
-    std::set<Rank_INDEX> rank_index_set;
+    // 同一个 bsc / rank 只保留第一条 ready command
+    row_bsc_mask = BscMask();
+    col_bsc_mask = BscMask();
+    rank_index_mask = RankMask();
 
-    std::map<BSC_INDEX,CommandTuple::Type> row_bsc2row_cmd_map;
-    std::map<BSC_INDEX,CommandTuple::Type> col_bsc2col_cmd_map;
-    std::map<Rank_INDEX,CommandTuple::Type> rank_index2rank_cmd_map;
-
-    // auto result = ready_commands.cend();
-    for(auto it = ready_commands.cbegin(); it!=ready_commands.cend();it++)
+    for(const auto& ready_command: ready_commands)
     {
         // Implement with Codex
-        cmd_avail_time = std::get<CommandTuple::AvailTime>(*it);//TODO: Cmd lenth if command is 2-N mode
-        // std::cout << " Debug: "<<cmd_avail_time << ",\t";
-        assert(cmd_avail_time <= sc_core::sc_time_stamp() );
-        if(std::get<CommandTuple::Command>(*it).IsCASCommand())
+        cmd_avail_time = std::get<CommandTuple::AvailTime>(ready_command);//TODO: Cmd lenth if command is 2-N mode
+        assert(cmd_avail_time <= mc_clock.Now());
+        if(std::get<CommandTuple::Command>(ready_command).IsCASCommand())
         {
-            // readyCasCommands.emplace_back(*it);
-            cmd_bsc_index = _bank_slice_manager.GetBa2BscTable()->at(std::get<CommandTuple::BaAddress>(*it).real_ba);
-            col_bsc_set.emplace(cmd_bsc_index);
-            col_bsc2col_cmd_map.emplace(cmd_bsc_index,*it);
+            cmd_bsc_index = _bank_slice_manager.GetBscIndex(std::get<CommandTuple::BaAddress>(ready_command).real_ba);
+            if(!col_bsc_mask.Test(cmd_bsc_index))
+            {
+                col_bsc_mask.Set(cmd_bsc_index);
+                col_bsc2col_cmd[cmd_bsc_index] = &ready_command;
+            }
         }
-        else if(std::get<CommandTuple::Command>(*it).IsRASCommand())
+        else if(std::get<CommandTuple::Command>(ready_command).IsRASCommand())
         {
-            // readyRasCommands.emplace_back(*it);
-            cmd_bsc_index = _bank_slice_manager.GetBa2BscTable()->at(std::get<CommandTuple::BaAddress>(*it).real_ba);
-            row_bsc_set.emplace(cmd_bsc_index);
-            row_bsc2row_cmd_map.emplace(cmd_bsc_index,*it);
+            cmd_bsc_index = _bank_slice_manager.GetBscIndex(std::get<CommandTuple::BaAddress>(ready_command).real_ba);
+            if(!row_bsc_mask.Test(cmd_bsc_index))
+            {
+                row_bsc_mask.Set(cmd_bsc_index);
+                row_bsc2row_cmd[cmd_bsc_index] = &ready_command;
+            }
         }
-        else if(std::get<CommandTuple::Command>(*it).IsRefCommand())
+        else if(std::get<CommandTuple::Command>(ready_command).IsRefCommand())
         {
-            Rank_INDEX rank_index = std::get<CommandTuple::BaAddress>(*it).real_cid;
-            rank_index_set.emplace(rank_index);
-            rank_index2rank_cmd_map.emplace(rank_index,*it);
+            Rank_INDEX rank_index = std::get<CommandTuple::BaAddress>(ready_command).real_cid;
+            if(!rank_index_mask.Test(rank_index))
+            {
+                rank_index_mask.Set(rank_index);
+                rank_index2rank_cmd[rank_index] = &ready_command;
+            }
         }
         else
         {
@@ -61,38 +62,21 @@ CmdSelect::SelectCommand(const ReadyCommands& ready_commands, GlobalRdWrState gl
 
     }
     DPRINT_INFO(CMD_SELECT, "Cmd Select", "ready refresh commands size: %ld, ready row commands size: %ld, ready col commands size: %ld",
-        rank_index2rank_cmd_map.size(),
-        row_bsc2row_cmd_map.size(),
-        col_bsc2col_cmd_map.size()
+        static_cast<long>(rank_index_mask.Count()),
+        static_cast<long>(row_bsc_mask.Count()),
+        static_cast<long>(col_bsc_mask.Count())
     );
 
-    // BSC_INDEX oldest_page_hit_bsc = _bank_slice_manager.GetOldestPageHitCmdBsc();
-    if(!rank_index2rank_cmd_map.empty())
+    if(rank_index_mask.Any())
     {
-        // for(auto rank_index:rank_index_set)
-        // {
-        //     std::cout << " "<< rank_index <<",\t";
-        // }
-        // std::cout << std::endl;
-        // for(auto iter = rank_index2rank_cmd_map.begin(); iter != rank_index2rank_cmd_map.end();iter++)
-        // {
-        //     std::cout << " "<< iter->first << " ; "<<std::get<CommandTuple::BaAddress>(iter->second).real_cid<<",\t";
-        // }
-        // std::cout<< std::endl;
-        auto arb_iter = rank_index_set.upper_bound(last_selected_rank_index);
-        if(arb_iter != rank_index_set.cend())
-        {
-            last_selected_rank_index = *arb_iter;
-        }
-        else {
-            last_selected_rank_index = *rank_index_set.begin();
-        }
-        return rank_index2rank_cmd_map.at(last_selected_rank_index);
+        // 严格大于上一次选中的 rank
+        last_selected_rank_index = rank_index_mask.FindNextWrap(last_selected_rank_index + 1);
+        return *rank_index2rank_cmd[last_selected_rank_index];
     }
-    if(!col_bsc_set.empty())
+    if(col_bsc_mask.Any())
     {
         //round-robin select a bsc and oldest page-hit cmd bsc
-        BSC_INDEX oldest_page_hit_bsc;
+        BSC_INDEX oldest_page_hit_bsc = kInvalidBscIndex;
         if(global_rdwr_state == GlobalRdWrState::Rd || global_rdwr_state == GlobalRdWrState::Rd2Wr)
         {
             oldest_page_hit_bsc = _bank_slice_manager.GetRdOldestPageHitBsc();
@@ -104,27 +88,17 @@ CmdSelect::SelectCommand(const ReadyCommands& ready_commands, GlobalRdWrState gl
         else {
             ;
         }
-        if(col_bsc_set.count(oldest_page_hit_bsc)>0)
+        if(col_bsc_mask.Test(oldest_page_hit_bsc))
         {
-            return col_bsc2col_cmd_map.at(oldest_page_hit_bsc);
-        }
-        else {
-            auto arb_iter = col_bsc_set.lower_bound(last_selected_col_bsc);
-            if(arb_iter != col_bsc_set.cend())
-            {
-                last_selected_col_bsc = *arb_iter;
-            }
-            else {
-                last_selected_col_bsc = *col_bsc_set.begin();
-            }
-            return col_bsc2col_cmd_map.at(last_selected_col_bsc);
+            return *col_bsc2col_cmd[oldest_page_hit_bsc];
         }
+        last_selected_col_bsc = col_bsc_mask.FindNextWrap(last_selected_col_bsc);
+        return *col_bsc2col_cmd[last_selected_col_bsc];
     }
-    if(!row_bsc_set.empty())
+    if(row_bsc_mask.Any())
     {
         //round-robin select a bsc and oldest page-miss cmd bsc
-        
-        BSC_INDEX oldest_page_miss_bsc;
+        BSC_INDEX oldest_page_miss_bsc = kInvalidBscIndex;
         if(global_rdwr_state == GlobalRdWrState::Rd || global_rdwr_state == GlobalRdWrState::Rd2Wr)
         {
             oldest_page_miss_bsc = _bank_slice_manager.GetRdOldestPageMissBsc();
@@ -136,24 +110,15 @@ CmdSelect::SelectCommand(const ReadyCommands& ready_commands, GlobalRdWrState gl
         else {
             ;
         }
-        if(row_bsc_set.count(oldest_page_miss_bsc)>0)
+        if(row_bsc_mask.Test(oldest_page_miss_bsc))
         {
-            return row_bsc2row_cmd_map.at(oldest_page_miss_bsc);
-        }
-        else {
-            auto arb_iter = row_bsc_set.lower_bound(last_selected_row_bsc);
-            if(arb_iter != row_bsc_set.cend())
-            {
-                last_selected_row_bsc = *arb_iter;
-            }
-            else {
-                last_selected_row_bsc = *row_bsc_set.begin();
-            }
-            return row_bsc2row_cmd_map.at(last_selected_row_bsc);
+            return *row_bsc2row_cmd[oldest_page_miss_bsc];
         }
+        last_selected_row_bsc = row_bsc_mask.FindNextWrap(last_selected_row_bsc);
+        return *row_bsc2row_cmd[last_selected_row_bsc];
     }
 
-    DPRINT_FATAL(true, "No command to select");
+    DPRINT_FATAL("Cmd Select", "No command to select");
     std::abort();
     // if(result != ready_commands.cend())
     // {
@@ -27,7 +27,9 @@ InputProcessReq::InputProcessReq(tlm::tlm_generic_payload& trans)
     }
     else
     {
-        _qos = Qos(uif_ext->_uif_info.qos.GetQosValue(),true);
+        // RMW 的读在 port 侧占用的是 lpr credit (P2cFifo HasWrRequest), controller 侧不能按 HPR 计, 否则 CAS 后归还的是 hpr credit
+        Qos rd_qos(uif_ext->_uif_info.qos.GetQosValue(),true);
+        _qos = rd_qos.GetQosLevel() == PriorityClass::HPR ? Qos(rd_qos.GetQosValue(), PriorityClass::LPR) : rd_qos;
     }
     cmd_id = uif_ext->_uif_info.cmd_id;
     expired_time = uif_ext->_uif_info.expired_time;
@@ -113,11 +115,11 @@ InputProcess::InputProcess(const Configure& config, Scheduler& scheduler)
     std::cout<< "InputProcess Module created" << std::endl;
     for(unsigned i = 0; i < config.controller_config->RD_CAM_DEPTH; ++i)
     {
-        unallocated_rd_cam_index_set.insert(i);
+        unallocated_rd_cam_index_mask.Set(i);
     }
     for(unsigned i = 0; i < config.controller_config->WR_CAM_DEPTH; ++i)
     {
-        unallocated_wr_cam_index_set.insert(i);
+        unallocated_wr_cam_index_mask.Set(i);
     }
 }
 
@@ -216,7 +218,8 @@ InputProcess::PipProcess()
 void
 InputProcess::SplitTrans(tlm::tlm_generic_payload& trans)
 {
-    std::vector<tlm::tlm_generic_payload*> childTranses;
+    std::vector<tlm::tlm_generic_payload*>& childTranses = split_child_transes;
+    childTranses.clear();
 
     constexpr unsigned numChildTranser = 2;//rmw = read and write
 
@@ -226,24 +229,35 @@ InputProcess::SplitTrans(tlm::tlm_generic_payload& trans)
         childTrans.acquire();
         childTrans.set_address(trans.get_address());
         childTrans.set_data_length(trans.get_data_length());
-        childTrans.set_data_ptr(trans.get_data_ptr());
 
+        // 读 child 只提供 RMW 的时序, 读出的数据不使用, 不带 data 以免覆盖 parent 的写数据
+        // 写 child 带 parent 的数据和 byte enable, 由 MemoryDevice 按 byte enable 写入 backing store 完成 merge
         if(childId == 0)
         {
             childTrans.set_command(tlm::TLM_READ_COMMAND);
+            childTrans.set_data_ptr(nullptr);
+            childTrans.set_byte_enable_ptr(nullptr);
+            childTrans.set_byte_enable_length(0);
         }
         else
         {
             childTrans.set_command(tlm::TLM_WRITE_COMMAND);
+            childTrans.set_data_ptr(trans.get_data_ptr());
+            childTrans.set_byte_enable_ptr(trans.get_byte_enable_ptr());
+            childTrans.set_byte_enable_length(trans.get_byte_enable_length());
         }
         ChildExtension::SetExtension(childTrans,trans);
-        UifExtension* clone_uif_ext = dynamic_cast<UifExtension*>(trans.get_extension<UifExtension>()->clone());
-        assert(!(clone_uif_ext == NULL));
-        childTrans.set_extension<UifExtension>(clone_uif_ext);
+        UifExtension* uif_ext = trans.get_extension<UifExtension>();
+        assert(!(uif_ext == NULL));
+        _memory_manager.GetUifExtensionPool().Attach(childTrans)->_uif_info = uif_ext->_uif_info;
+        // child 沿用 parent 的 transaction id 与 decoded address, cam / cmd / data 时间记在 child 自己身上
+        _memory_manager.GetStatisticExtensionPool().Attach(childTrans)->copy_from(*trans.get_extension<StatisticExtension>());
         childTranses.push_back(&childTrans);
     }
+    // child 持有 parent 的指针, parent 不能先于 child 回到 pool; 最后一个完成的 child 在 MemoryController::CompleteChildTrans 中 release
+    trans.acquire();
 
-    ParentExtension::SetExtension(trans,std::move(childTranses));
+    ParentExtension::SetExtension(trans,childTranses);
 
 }
 
@@ -276,8 +290,8 @@ InputProcess::DetectAddrCollision()
     }
     else if(!wr_pip_buffer.empty())
     {
-        _cmd_type_temp = rd_pip_buffer.front().cmd_type;
-        pip_buffer_sdram_addr = rd_pip_buffer.front().sdram_addr;
+        _cmd_type_temp = wr_pip_buffer.front().cmd_type;
+        pip_buffer_sdram_addr = wr_pip_buffer.front().sdram_addr;
     }
     else {
         std::cerr<< " Impossible Scenery" << std::endl;
@@ -288,126 +302,112 @@ InputProcess::DetectAddrCollision()
     // bool rd_cam_collision = false;
     // unsigned collision_rd_cam_index = 0;
 
+    // 上一次检测的 collision 先全部清掉, 再只对地址相同的 entry (hash 桶内) 重新分类
     auto rd_cam = _scheduler.GetRdCam();
     rd_cam->ClearRdCollisionCamIndex();
+    rd_cam->ResetAddrCollision();
 
-    for(const unsigned& cam_index : _scheduler.GetRdCamIndex())
-    {
-        RdCamEntry* rd_cam_entry = _scheduler.GetRdCam()->GetCamEntry(cam_index);
-        if(rd_cam_entry->sdram_addr == pip_buffer_sdram_addr)
+    rd_cam->GetAddrMatchMask(pip_buffer_sdram_addr).FindIf([&](unsigned cam_index) {
+        RdCamEntry* rd_cam_entry = rd_cam->GetCamEntry(cam_index);
+        if(_cmd_type_temp == CmdType::RD && rd_cam_entry->cmd_type == CmdType::RD)
         {
-            if(_cmd_type_temp == CmdType::RD && rd_cam_entry->cmd_type == CmdType::RD)
-            {
-                rd_cam_entry->SetCollision(AddrCollisionType::No_Collision);
-                continue;
-            }
-            // RD-A-RMW (RD) --> RD->RMW(WR)->RMW(RD) --> rd flush, and maskr wr flush
-            else if(_cmd_type_temp == CmdType::RD && rd_cam_entry->cmd_type == CmdType::RMW)
-            {
-                rd_cam_entry->SetCollision(AddrCollisionType::RARMW); // stall rd pip buffer
-                rd_cam->AddRdCollisionCamIndex(cam_index);
-            }
-            // RMW-A-RD --> stall rd pip buffer and wr pip buffer
-            else if(_cmd_type_temp == CmdType::RMW && rd_cam_entry->cmd_type == CmdType::RD)
-            {
-                rd_cam_entry->SetCollision(AddrCollisionType::RMWAR);
-                rd_cam->AddRdCollisionCamIndex(cam_index);
-            }
-            // stall rd pip buffer and wr pip buffer, and set rd flush
-            else if(_cmd_type_temp == CmdType::RMW && rd_cam_entry->cmd_type == CmdType::RMW)
-            {
-                rd_cam_entry->SetCollision(AddrCollisionType::RMWARMW);
-                rd_cam->AddRdCollisionCamIndex(cam_index);
-            }
-            // W-A-R --> stall wr pip buffer, call the rd flush
-            else if(_cmd_type_temp == CmdType::WR && rd_cam_entry->cmd_type == CmdType::RD)
-            {
-                rd_cam_entry->SetCollision(AddrCollisionType::WAR);
-                rd_cam->AddRdCollisionCamIndex(cam_index);
-            }
-            // W-A-RMW(RD) --> W-A-RMW(WR)-RMW(RD) --> if Wr-combine fail, then call the rd flush, and stall wr pip buffer
-            else if(_cmd_type_temp == CmdType::WR && rd_cam_entry->cmd_type == CmdType::RMW)
-            {
-                rd_cam_entry->SetCollision(AddrCollisionType::WARMW);
-                rd_cam->AddRdCollisionCamIndex(cam_index);
-            }
+            rd_cam_entry->SetCollision(AddrCollisionType::No_Collision);
         }
-        else
+        // RD-A-RMW (RD) --> RD->RMW(WR)->RMW(RD) --> rd flush, and maskr wr flush
+        else if(_cmd_type_temp == CmdType::RD && rd_cam_entry->cmd_type == CmdType::RMW)
         {
-            rd_cam_entry->SetCollision(AddrCollisionType::No_Collision);
-            continue;
+            rd_cam_entry->SetCollision(AddrCollisionType::RARMW); // stall rd pip buffer
+            rd_cam->AddRdCollisionCamIndex(cam_index);
         }
-    }
+        // RMW-A-RD --> stall rd pip buffer and wr pip buffer
+        else if(_cmd_type_temp == CmdType::RMW && rd_cam_entry->cmd_type == CmdType::RD)
+        {
+            rd_cam_entry->SetCollision(AddrCollisionType::RMWAR);
+            rd_cam->AddRdCollisionCamIndex(cam_index);
+        }
+        // stall rd pip buffer and wr pip buffer, and set rd flush
+        else if(_cmd_type_temp == CmdType::RMW && rd_cam_entry->cmd_type == CmdType::RMW)
+        {
+            rd_cam_entry->SetCollision(AddrCollisionType::RMWARMW);
+            rd_cam->AddRdCollisionCamIndex(cam_index);
+        }
+        // W-A-R --> stall wr pip buffer, call the rd flush
+        else if(_cmd_type_temp == CmdType::WR && rd_cam_entry->cmd_type == CmdType::RD)
+        {
+            rd_cam_entry->SetCollision(AddrCollisionType::WAR);
+            rd_cam->AddRdCollisionCamIndex(cam_index);
+        }
+        // W-A-RMW(RD) --> W-A-RMW(WR)-RMW(RD) --> if Wr-combine fail, then call the rd flush, and stall wr pip buffer
+        else if(_cmd_type_temp == CmdType::WR && rd_cam_entry->cmd_type == CmdType::RMW)
+        {
+            rd_cam_entry->SetCollision(AddrCollisionType::WARMW);
+            rd_cam->AddRdCollisionCamIndex(cam_index);
+        }
+        return false;
+    });
 
     // bool wr_cam_collision = false;
     // unsigned collision_wr_cam_index = 0;
     auto wr_cam = _scheduler.GetWrCam();
     wr_cam->ClearWrCollisionCamIndex();
+    wr_cam->ResetAddrCollision();
 
-    for(const unsigned& cam_index : _scheduler.GetWrCamIndex())
-    {
-        WrCamEntry* wr_cam_entry = _scheduler.GetWrCam()->GetCamEntry(cam_index);
-        if(wr_cam_entry->sdram_addr == pip_buffer_sdram_addr)
+    wr_cam->GetAddrMatchMask(pip_buffer_sdram_addr).FindIf([&](unsigned cam_index) {
+        WrCamEntry* wr_cam_entry = wr_cam->GetCamEntry(cam_index);
+        // R-A-W --> stall rd pip buffer, and call the wr flush
+        if(_cmd_type_temp == CmdType::RD && wr_cam_entry->cmd_type == CmdType::WR)
+        {
+            wr_cam_entry->SetCollision(AddrCollisionType::RAW);
+            wr_cam->AddWrCollisionCamIndex(cam_index);
+        }
+        // R-A-RMW --> stall rd pip buffer, and call the wr flush, if rd flush exist, mask wr flush
+        else if(_cmd_type_temp == CmdType::RD && wr_cam_entry->cmd_type == CmdType::RMW)
+        {
+            wr_cam_entry->SetCollision(AddrCollisionType::RARMW);
+            wr_cam->AddWrCollisionCamIndex(cam_index);
+        }
+        // RMW-A-WR --> stall wr pip buffer and rd pip buffer, call the wr flush
+        else if(_cmd_type_temp == CmdType::RMW && wr_cam_entry->cmd_type == CmdType::WR)
         {
-            // R-A-W --> stall rd pip buffer, and call the wr flush
-            if(_cmd_type_temp == CmdType::RD && wr_cam_entry->cmd_type == CmdType::WR)
+            wr_cam_entry->SetCollision(AddrCollisionType::RMWAW);
+            wr_cam->AddWrCollisionCamIndex(cam_index);
+        }
+        // RMW-A-RMW --> stall wr pip buffer and rd pip buffer (RMW(WR)-RMW(RD)-RMW(WR)-RMW(RD)), call the wr flush( may be mask)
+        else if(_cmd_type_temp == CmdType::RMW && wr_cam_entry->cmd_type == CmdType::RMW)
+        {
+            wr_cam_entry->SetCollision(AddrCollisionType::RMWARMW);
+            wr_cam->AddWrCollisionCamIndex(cam_index);
+        }
+        // WR-A-WR --> can do the write combine, if wr-combine-condition is satisfied, else do the wr flush, stall wr pip buffer
+        else if(_cmd_type_temp == CmdType::WR && wr_cam_entry->cmd_type == CmdType::WR)
+        {
+            if(wr_cam->IsWrCamEntryWrCombSatisfied(cam_index))
             {
-                wr_cam_entry->SetCollision(AddrCollisionType::RAW);
-                wr_cam->AddWrCollisionCamIndex(cam_index);
+                wr_cam_entry->SetCollision(AddrCollisionType::No_Collision);
+                // write_combine_cam_index_vec.push_back(cam_index);
+                wr_cam->AddWrCombineCamIndex(cam_index);
             }
-            // R-A-RMW --> stall rd pip buffer, and call the wr flush, if rd flush exist, mask wr flush
-            else if(_cmd_type_temp == CmdType::RD && wr_cam_entry->cmd_type == CmdType::RMW)
-            {
-                wr_cam_entry->SetCollision(AddrCollisionType::RARMW);
+            else {
+                wr_cam_entry->SetCollision(AddrCollisionType::WAW);
                 wr_cam->AddWrCollisionCamIndex(cam_index);
             }
-            // RMW-A-WR --> stall wr pip buffer and rd pip buffer, call the wr flush
-            else if(_cmd_type_temp == CmdType::RMW && wr_cam_entry->cmd_type == CmdType::WR)
+        }
+        //W-A-RMW --> can do the write combine, if wr-combine-condition is satisfied, else do the wr flush and rd flush( if exist),
+        // and stall the wr pip buffer
+        else if(_cmd_type_temp == CmdType::WR && wr_cam_entry->cmd_type == CmdType::RMW)
+        {
+            if(wr_cam->IsWrCamEntryWrCombSatisfied(cam_index))
             {
-                wr_cam_entry->SetCollision(AddrCollisionType::RMWAW);
-                wr_cam->AddWrCollisionCamIndex(cam_index);
+                wr_cam_entry->SetCollision(AddrCollisionType::No_Collision);
+                wr_cam->AddWrCombineCamIndex(cam_index);
             }
-            // RMW-A-RMW --> stall wr pip buffer and rd pip buffer (RMW(WR)-RMW(RD)-RMW(WR)-RMW(RD)), call the wr flush( may be mask)
-            else if(_cmd_type_temp == CmdType::RMW && wr_cam_entry->cmd_type == CmdType::RMW)
-            {
-                wr_cam_entry->SetCollision(AddrCollisionType::RMWARMW);
+            else {
+                wr_cam_entry->SetCollision(AddrCollisionType::WARMW);
                 wr_cam->AddWrCollisionCamIndex(cam_index);
             }
-            // WR-A-WR --> can do the write combine, if wr-combine-condition is satisfied, else do the wr flush, stall wr pip buffer
-            else if(_cmd_type_temp == CmdType::WR && wr_cam_entry->cmd_type == CmdType::WR)
-            {
-                if(_scheduler.GetWrCam()->IsWrCamEntryWrCombSatisfied(cam_index))
-                {
-                    wr_cam_entry->SetCollision(AddrCollisionType::No_Collision);
-                    // write_combine_cam_index_vec.push_back(cam_index);
-                    wr_cam->AddWrCombineCamIndex(cam_index);
-                }
-                else {
-                    wr_cam_entry->SetCollision(AddrCollisionType::WAW);
-                    wr_cam->AddWrCollisionCamIndex(cam_index);
-                }
-            }
-            //W-A-RMW --> can do the write combine, if wr-combine-condition is satisfied, else do the wr flush and rd flush( if exist),
-            // and stall the wr pip buffer
-            else if(_cmd_type_temp == CmdType::WR && wr_cam_entry->cmd_type == CmdType::RMW)
-            {
-                if(_scheduler.GetWrCam()->IsWrCamEntryWrCombSatisfied(cam_index))
-                {
-                    wr_cam_entry->SetCollision(AddrCollisionType::No_Collision);
-                    wr_cam->AddWrCombineCamIndex(cam_index);
-                }
-                else {
-                    wr_cam_entry->SetCollision(AddrCollisionType::WARMW);
-                    wr_cam->AddWrCollisionCamIndex(cam_index);
-                }
-            }
-        }
-        else
-        {
-            wr_cam_entry->SetCollision(AddrCollisionType::No_Collision);
-            continue;
         }
-    }
+        return false;
+    });
 /*
     // if(!rd_cam_collision && !wr_cam_collision)
     // {
@@ -7,6 +7,7 @@
 #include "Controller/RefreshMachineManager.hh"
 #include "Controller/Scheduler.hh"
 #include "Controller/WrCam.hh"
+#include "Controller/common/ChildParentExtension.hh"
 #include "Controller/common/Command.hh"
 #include "Controller/common/ControllerCommon.hh"
 #include "Common/CommonDefine.hh"
@@ -113,6 +114,12 @@ MemoryController::pipline_method(tlm::tlm_generic_payload& trans, const tlm::tlm
     {
         // busy_time_collector.end();
         RemoveTransFromResonseQueue(trans.get_extension<StatisticExtension>()->GetTransactionId(),&trans);
+        // RMW 的读 child 只用于 merge, 读数据不回给 UIF
+        if(ChildExtension::IsChildTrans(trans))
+        {
+            CompleteChildTrans(trans);
+            return;
+        }
         tlm::tlm_phase rdat_phase = UIF_RDAT_BEGIN;
         sc_core::sc_time rdat_delay = dfi_cycle_time;
         tSocket->nb_transport_bw(trans, rdat_phase, rdat_delay);
@@ -145,12 +152,14 @@ MemoryController::pipline_method(tlm::tlm_generic_payload& trans, const tlm::tlm
         sc_core::sc_time wdat_delay = phy_wdat_delay;
         iSocket->nb_transport_fw(trans, wdat_phase, wdat_delay);
         RemoveTransFromResonseQueue(trans.get_extension<StatisticExtension>()->GetTransactionId(),&trans);
+        if(ChildExtension::IsChildTrans(trans))
+            CompleteChildTrans(trans);
         // Implement with Codex
         //TODO: Check the Wdat Buffer is full, if not full, then check all the wr cam cmd is sending data request
     }
     else if(phase == UIF_WDAT_REQ)
     {
-        DPRINT_INFO(true, "Uif Channel", "Wdat Request for Write Data");
+        DPRINT_INFO(MEMORY_CONTROLLER, "Uif Channel", "Wdat Request for Write Data");
         tlm::tlm_phase wdat_phase = phase;
         sc_core::sc_time wdat_delay = sc_core::SC_ZERO_TIME;
         tSocket->nb_transport_bw(trans, wdat_phase, wdat_delay);
@@ -171,16 +180,20 @@ MemoryController::pipline_method(tlm::tlm_generic_payload& trans, const tlm::tlm
         if(_scheduler->IsBscMatch(request_ba_index))
         {
             CAM_INDEX request_cam_index = wr_cam_index;
-            auto bank_slice = _bankslice_manager->GetBankSliceMap()->at(_bankslice_manager->GetBa2BscTable()->at(request_ba_index)).get();
+            BSC_INDEX request_bsc_index = _bankslice_manager->GetBscIndex(request_ba_index);
+            auto bank_slice = _bankslice_manager->GetBsc(request_bsc_index);
             bool is_page_hit = bank_slice->IsPageOpen() && (bank_slice->GetOpenPage() == wr_cam_entry->sdram_addr.row);
-            wr_cam_entry->SetBaMatch(_bankslice_manager->GetBa2BscTable()->at(request_ba_index), is_page_hit);
+            wr_cam_entry->SetBaMatch(request_bsc_index, is_page_hit);
             if(is_page_hit || (!is_page_hit && (!bank_slice->IsActiving() || bank_slice->IsWrNttValid())))
             {
-                _scheduler->UpdateWrNttPip(_bankslice_manager->GetBa2BscTable()->at(request_ba_index),request_ba_index,UpdateType::NewCmdStore);
+                _scheduler->UpdateWrNttPip(request_bsc_index,request_ba_index,UpdateType::NewCmdStore);
             }
         }
-        next_trigger_delay = std::min(next_trigger_delay, _scheduler->GetNextUpdateTime() - sc_core::sc_time_stamp());
-        ctrl_event.notify(next_trigger_delay);
+        // only wake up the controller at the ntt update time, next_trigger_delay belongs to the last ControllerMethod run
+        if(_scheduler->GetNextUpdateTime() != MaxTick)
+        {
+            ctrl_event.notify(mc_clock.ToTime(_scheduler->GetNextUpdateTime()) - sc_core::sc_time_stamp());
+        }
         DPRINT_INFO(false, "UIF_WDAT_END", "function end");
     }
     else if(phase == UIF_REQ)
@@ -189,6 +202,15 @@ MemoryController::pipline_method(tlm::tlm_generic_payload& trans, const tlm::tlm
     }
 }
 
+void
+MemoryController::CompleteChildTrans(tlm::tlm_generic_payload& child_trans)
+{
+    // 最后一个 child 完成时 NotifyChildTransCompletion 会 release 两个 child, 之后不能再访问 child_trans
+    tlm::tlm_generic_payload& parent_trans = ChildExtension::GetParentTrans(child_trans);
+    if(ParentExtension::NotifyChildTransCompletion(parent_trans))
+        parent_trans.release();
+}
+
 MemoryController::~MemoryController()
 {
     ControllerFinishCheck();
@@ -197,7 +219,14 @@ MemoryController::~MemoryController()
 void
 MemoryController::ControllerMethod()
 {
-    DPRINT_INFO(true, "Controller", "ControllerMethod function start");
+    StepPrepare();
+    StepCommit();
+}
+
+void
+MemoryController::StepPrepare()
+{
+    DPRINT_INFO(MEMORY_CONTROLLER, "Controller", "ControllerMethod function start");
     //initial event next trigger time
     next_trigger_delay = sc_core::sc_max_time();
     // DPRINT_INFO(TOP_DEBUG,name(),"[ControllerMethod EXE]");
@@ -208,7 +237,13 @@ MemoryController::ControllerMethod()
         _bankslice_manager->BankSliceRelease();
         next_trigger_delay = dfi_cycle_time;
     }
+    // 所有 bank / refresh 命令的可发送时间, CmdSend 使用
+    AcTimingUpdate();
+}
 
+void
+MemoryController::StepCommit()
+{
     // cmd send stage
     CmdSend();
     // cmd updated to ntt stage
@@ -241,7 +276,7 @@ MemoryController::ControllerFinishCheck()
     std::vector<RdCamEntry*> rd_cam_entry_list;
     if(!_scheduler->GetRdCam()->IsCamEmpty())
     {
-        for(auto& rd_cam_index: _scheduler->GetRdCam()->GetUsedCamIndex())
+        for(auto rd_cam_index: _scheduler->GetRdCam()->GetUsedCamIndex())
         {
             auto rd_cam_entry = _scheduler->GetRdCam()->GetCamEntry(rd_cam_index);
             rd_cam_entry->print();
@@ -252,7 +287,7 @@ MemoryController::ControllerFinishCheck()
     std::vector<WrCamEntry*> wr_cam_entry_list;
     if(!_scheduler->GetWrCam()->IsCamEmpty())
     {
-        for(auto& wr_cam_index: _scheduler->GetWrCam()->GetUsedCamIndex())
+        for(auto wr_cam_index: _scheduler->GetWrCam()->GetUsedCamIndex())
         {
             auto wr_cam_entry = _scheduler->GetWrCam()->GetCamEntry(wr_cam_index);
             wr_cam_entry->print();
@@ -263,15 +298,15 @@ MemoryController::ControllerFinishCheck()
     std::vector<BankSlice*> allocated_bsc_list;
     if(!_bankslice_manager->IsAllocatedBscEmpty())
     {
-        for(auto& allocated_bsc: _bankslice_manager->GetAllocatedBscSet())
+        for(auto allocated_bsc: _bankslice_manager->GetAllocatedBscMask())
         {
-            auto allocated_bank_slice = _bankslice_manager->GetBankSliceMap()->at(allocated_bsc).get();
+            auto allocated_bank_slice = _bankslice_manager->GetBsc(allocated_bsc);
             allocated_bsc_list.push_back(allocated_bank_slice);
             allocated_bank_slice->print();
         }
     }
     std::cout << "-----------------------------------Ntt-----------------------------------"<<std::endl;
-    std::cout << "Next Ntt trigger time: " << _scheduler->GetNextUpdateTime().to_string().c_str() << std::endl;
+    std::cout << "Next Ntt trigger time: " << mc_clock.ToTime(_scheduler->GetNextUpdateTime()).to_string().c_str() << std::endl;
     assert(rd_cam_entry_list.empty() && "rd cam is not empty");
     assert(wr_cam_entry_list.empty() && "wr cam is not empty");
     assert(allocated_bsc_list.empty() && "allocated bsc is not empty");
@@ -281,22 +316,30 @@ MemoryController::ControllerFinishCheck()
 void
 MemoryController::AcTimingUpdate()
 {
-    for(auto rank_index: _refresh_machine_manager->GetRefreshRankIds())
+    // 只有 tREFI deadline 到期或还有 pending refresh 的 rank 需要 Evaluate, 其余 rank 的 refresh command 保持 NOP
+    // 打开 refresh 打印时仍按 rank 顺序打印所有 rank
+    const bool print_refresh = _config.controller_config->REFRESH_ENABLE && DPRINT_ENABLED(MEMORY_CONTROLLER);
+    const RefreshMachineManager::RankMask evaluate_rank_mask = _refresh_machine_manager->AdvanceRefreshTimer();
+    for(auto rank_index: print_refresh ? _refresh_machine_manager->GetRefreshRankMask() : evaluate_rank_mask)
     {
         auto refresh_machine = _refresh_machine_manager->GetRefreshMachine(rank_index);
-        refresh_machine->Evaluate();
         const BankAddress rank_addr = refresh_machine->GetRankAddress();
-        const Command refresh_cmd = refresh_machine->GetRefreshCommand();
-        sc_core::sc_time& refresh_command_avail_time = refresh_machine->GetRefreshCommandAvailTime();
-        if(refresh_cmd == Command::NOP)
-        {
-            refresh_command_avail_time = sc_core::sc_max_time();
-        }
-        else
+        Tick& refresh_command_avail_time = refresh_machine->GetRefreshCommandAvailTime();
+        if(evaluate_rank_mask.Test(rank_index))
         {
-            refresh_command_avail_time = _sdram_constraint->TimeToSatisfyConstraints(refresh_cmd,rank_addr);
+            refresh_machine->Evaluate();
+            const Command refresh_cmd = refresh_machine->GetRefreshCommand();
+            if(refresh_cmd == Command::NOP)
+            {
+                refresh_command_avail_time = MaxTick;
+            }
+            else
+            {
+                refresh_command_avail_time = _sdram_constraint->TimeToSatisfyConstraints(refresh_cmd,rank_addr);
+            }
+            _refresh_machine_manager->RefreshTimerUpdate(rank_index);
         }
-        DPRINT_INFO(MEMORY_CONTROLLER && _config.controller_config->REFRESH_ENABLE, "Memory Controller", "Refresh Rank: %d, Refresh Command: %s, the Refresh Avail Time is %s, and all bank is closed: %s, refresh_pending count:%d", rank_index,refresh_cmd.to_string().c_str(),refresh_command_avail_time.to_string().c_str(),refresh_machine->IsAllBanksClosed()?"true" :"false",refresh_machine->GetPendingCount());
+        DPRINT_INFO(MEMORY_CONTROLLER, "Memory Controller", "Refresh Rank: %d, Refresh Command: %s, the Refresh Avail Time is %s, and all bank is closed: %s, refresh_pending count:%d", rank_index,refresh_machine->GetRefreshCommand().to_string().c_str(),mc_clock.ToTime(refresh_command_avail_time).to_string().c_str(),refresh_machine->IsAllBanksClosed()?"true" :"false",refresh_machine->GetPendingCount());
         // refresh_machine->Print();
     }
 
@@ -304,26 +347,26 @@ MemoryController::AcTimingUpdate()
 
 
     // Get all the command and then do the Ac Timing update, and decide the avail cmd sending time
-    for(auto& allocated_bsc: _bankslice_manager->GetAllocatedBscSet())
+    for(auto allocated_bsc: _bankslice_manager->GetAllocatedBscMask())
     {
         auto bank_slice = _bankslice_manager->GetBsc(allocated_bsc);
         bank_slice->Evaluate();
         const BankAddress ba_addr = bank_slice->GetBaAddr();
         const Command::Type& rd_cmd = bank_slice->GetRdCmd();
-        sc_core::sc_time& rd_cmd_avail_time = bank_slice->GetRdCmdAvailTime();
+        Tick& rd_cmd_avail_time = bank_slice->GetRdCmdAvailTime();
         if(rd_cmd == Command::NOP)
         {
-            rd_cmd_avail_time = sc_core::sc_max_time();
+            rd_cmd_avail_time = MaxTick;
         }
         else
         {
             rd_cmd_avail_time = _sdram_constraint->TimeToSatisfyConstraints(rd_cmd,ba_addr);
         }
         const Command::Type& wr_cmd = bank_slice->GetWrCmd();
-        sc_core::sc_time& wr_cmd_avail_time = bank_slice->GetWrCmdAvailTime();
+        Tick& wr_cmd_avail_time = bank_slice->GetWrCmdAvailTime();
         if(wr_cmd == Command::NOP)
         {
-            wr_cmd_avail_time = sc_core::sc_max_time();
+            wr_cmd_avail_time = MaxTick;
         }
         else
         {
@@ -356,9 +399,7 @@ MemoryController::CmdSend()
     // every time the cam num changed, the fill level and cam full state may be affected( fill level pos edge and full state negedeg)
     // so when do cam entry store or cam entry delete
 
-    // refresh
-    AcTimingUpdate();
-
+    // AcTimingUpdate 已在 StepPrepare 中完成
     ready_commands.clear();
     if(!_refresh_machine_manager->IsRefreshReadyCommandsEmpty())
     {
@@ -386,8 +427,8 @@ MemoryController::CmdSend()
     {
         CommandTuple::Type selected_cmd = _cmd_select->SelectCommand(ready_commands,global_rdwr_mode);
         BankAddress selected_cmd_addr = std::get<CommandTuple::BaAddress>(selected_cmd);
-        sc_core::sc_time selected_cmd_sending_time = std::get<CommandTuple::AvailTime>(selected_cmd);
-        assert(selected_cmd_sending_time <= sc_core::sc_time_stamp());
+        Tick selected_cmd_sending_time = std::get<CommandTuple::AvailTime>(selected_cmd);
+        assert(selected_cmd_sending_time <= mc_clock.Now());
         Command selected_cmd_type = std::get<CommandTuple::Command>(selected_cmd);
         if(selected_cmd_type.IsBankCommand())
         {
@@ -395,6 +436,10 @@ MemoryController::CmdSend()
             BankAddress selected_cmd_ba_addr = std::get<CommandTuple::BaAddress>(selected_cmd);
             RealBaIndex selected_cmd_real_ba = selected_cmd_ba_addr.real_ba;
             bool is_rd = std::get<CommandTuple::IsRd>(selected_cmd);
+            // 按 IsRd 到 rd / wr cam 取 request, cam index 必须属于这个 cam, 且 entry 与 command 在同一个 bank
+            assert((is_rd ? _scheduler->GetRdCam()->IsCamEntryInBank(selected_cmd_cam_index, selected_cmd_real_ba)
+                          : _scheduler->GetWrCam()->IsCamEntryInBank(selected_cmd_cam_index, selected_cmd_real_ba))
+                   && "bank command cam index does not belong to the cam selected by IsRd");
 
             _sdram_constraint->InsertCommand(selected_cmd_type,selected_cmd_ba_addr);
             // bank slice manager update command,
@@ -433,6 +478,7 @@ MemoryController::CmdSend()
                     {
                         _scheduler->GetRdCam()->HprCmdExe();
                         _scheduler->GetRdCam()->IncreaseHprCredit();
+                        credit_event.notify(sc_core::SC_ZERO_TIME);
                         _scheduler->GetRdCam()->LprStarveCounter();
                         _scheduler->GetWrCam()->TpwStarveCounter();
                     }
@@ -440,6 +486,7 @@ MemoryController::CmdSend()
                     {
                         _scheduler->GetRdCam()->LprCmdExe();
                         _scheduler->GetRdCam()->IncreaseLprCredit();
+                        credit_event.notify(sc_core::SC_ZERO_TIME);
                         _scheduler->GetRdCam()->HprStarveCounter();
                         _scheduler->GetWrCam()->TpwStarveCounter();
                     }
@@ -458,6 +505,7 @@ MemoryController::CmdSend()
                     _mode_switch->WrCmdSend();
                     _scheduler->GetWrCam()->TpwCmdExe();
                     _scheduler->GetWrCam()->IncreaseTpwCredit();
+                    credit_event.notify(sc_core::SC_ZERO_TIME);
                     _scheduler->GetRdCam()->LprStarveCounter();
                     _scheduler->GetRdCam()->HprStarveCounter();
 
@@ -519,9 +567,12 @@ MemoryController::CmdSend()
         DPRINT_INFO(TOP_DEBUG, "Memory Controller", "Refresh command sent to rank %d", rank_index);
         _sdram_constraint->InsertCommand(selected_cmd_type,selected_cmd_rank_addr);
         _refresh_machine_manager->CommandUpdate(selected_cmd);
-        for(auto rank_id: _refresh_machine_manager->GetRefreshRankIds())
+        if(DPRINT_ENABLED(MEMORY_CONTROLLER))
         {
-            _refresh_machine_manager->GetRefreshMachine(rank_id)->Print();
+            for(auto rank_id: _refresh_machine_manager->GetRefreshRankIds())
+            {
+                _refresh_machine_manager->GetRefreshMachine(rank_id)->Print();
+            }
         }
 
         _bankslice_manager->CommandUpdate(selected_cmd);
@@ -547,41 +598,36 @@ MemoryController::CmdSend()
     }
     else
     {
-        sc_core::sc_time next_refresh_trigger_time = _refresh_machine_manager->GetNextRefreshTriggerTime();
-
-        if(next_refresh_trigger_time == sc_core::sc_time_stamp())
-        {
-            next_trigger_delay = std::min(next_trigger_delay , dfi_cycle_time);
-        }
-        else if(next_refresh_trigger_time >= dfi_cycle_time + sc_core::sc_time_stamp() && next_refresh_trigger_time < sc_core::sc_max_time())
-        {
-            next_trigger_delay = std::min(next_trigger_delay , _refresh_machine_manager->GetNextRefreshTriggerTime() - sc_core::sc_time_stamp());
-        }
-        else if (next_refresh_trigger_time == sc_core::sc_max_time()) {
+        // no command can be sent, sleep until the earliest refresh / bank command avail time (tRFC, tRCD, tCL ...)
+        Tick next_refresh_trigger_time = _refresh_machine_manager->GetNextRefreshTriggerTime();
+        if (next_refresh_trigger_time == MaxTick) {
             DPRINT_INFO(TOP_DEBUG,name(),"There is no Refresh needed to be sent");
         }
-        else{
-            DPRINT_INFO(TOP_DEBUG,name(),"Invalid condition");
-        }
+        next_trigger_delay = std::min(next_trigger_delay , WakeupDelay(next_refresh_trigger_time));
 
-        sc_core::sc_time next_trigger_time = _bankslice_manager->GetNextCommandTriggerTime();
-        if(next_trigger_time == sc_core::sc_time_stamp())
-        {
-            next_trigger_delay = std::min(next_trigger_delay , dfi_cycle_time);
-        }
-        else if(next_trigger_time >= dfi_cycle_time + sc_core::sc_time_stamp() && next_trigger_time < sc_core::sc_max_time())
-        {
-            next_trigger_delay = std::min(next_trigger_delay , _bankslice_manager->GetNextCommandTriggerTime() - sc_core::sc_time_stamp());
-        }
-        else if (next_trigger_time == sc_core::sc_max_time()) {
+        Tick next_trigger_time = _bankslice_manager->GetNextCommandTriggerTime();
+        if (next_trigger_time == MaxTick) {
             DPRINT_INFO(TOP_DEBUG,name(),"There is no Bank cmd needed to be sent");
         }
-        else{
-            DPRINT_INFO(TOP_DEBUG,name(),"Invalid condition");
-        }
+        next_trigger_delay = std::min(next_trigger_delay , WakeupDelay(next_trigger_time));
 }
 
 }
+sc_core::sc_time
+MemoryController::WakeupDelay(Tick wakeup_time) const
+{
+    if(wakeup_time == MaxTick)
+    {
+        return sc_core::sc_max_time();
+    }
+    // already reached: evaluate again at the next dfi cycle
+    if(wakeup_time <= mc_clock.Now())
+    {
+        return dfi_cycle_time;
+    }
+    return mc_clock.ToTime(wakeup_time) - sc_core::sc_time_stamp();
+}
+
 void
 MemoryController::ReqUpdate()
 {
@@ -598,10 +644,10 @@ MemoryController::ReqUpdate()
     }
     else
     {
-        if(_scheduler->GetNextUpdateTime() != sc_core::sc_max_time())
+        if(_scheduler->GetNextUpdateTime() != MaxTick)
         {
-            DPRINT_ASSERT(_scheduler->GetNextUpdateTime() >= sc_core::sc_time_stamp(), "MemoryControlle", "ReqUpdate Func,NTT Update time is invalid: %s", _scheduler->GetNextUpdateTime().to_string().c_str());
-            next_trigger_delay = std::min(next_trigger_delay, _scheduler->GetNextUpdateTime() - sc_core::sc_time_stamp());
+            DPRINT_ASSERT(_scheduler->GetNextUpdateTime() >= mc_clock.Now(), "MemoryControlle", "ReqUpdate Func,NTT Update time is invalid: %s", mc_clock.ToTime(_scheduler->GetNextUpdateTime()).to_string().c_str());
+            next_trigger_delay = std::min(next_trigger_delay, mc_clock.ToTime(_scheduler->GetNextUpdateTime()) - sc_core::sc_time_stamp());
             DPRINT_INFO(TOP_DEBUG,name(), " Ntt next update time: %s", (sc_core::sc_time_stamp()+next_trigger_delay).to_string().c_str());
         }
     }
@@ -661,14 +707,15 @@ MemoryController::CqStore()
                 //stall
                 DPRINT_INFO(TOP_DEBUG,name(),"Addr Collision Detect, causing flush");
                 addr_collision_busy = true;
-                if(rd_cam->IsRdCamBusy())
+                // cam entry dump 走 std::cout, 与 DPRINT 一样受 trace mask 控制
+                if(DPRINT_ENABLED(TOP_DEBUG) && rd_cam->IsRdCamBusy())
                 {
                     for(auto busy_cam_index: rd_cam->GetRdCollisionCamIndex())
                     {
                         rd_cam->GetCamEntry(busy_cam_index)->print();
                     }
                 }
-                if(wr_cam->IsWrCamBusy())
+                if(DPRINT_ENABLED(TOP_DEBUG) && wr_cam->IsWrCamBusy())
                 {
                     for(auto busy_cam_index: wr_cam->GetWrCollisionCamIndex())
                     {
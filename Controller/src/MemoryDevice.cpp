@@ -4,12 +4,15 @@
 #include "Common/CommonDefine.hh"
 #include "Controller/common/DfiExtension.hh"
 #include "Common/StatisticExtension.hh"
+#include "Common/UifExtension.hh"
 #include "sysc/kernel/sc_simcontext.h"
 #include "sysc/kernel/sc_time.h"
 #include "tlm_core/tlm_2/tlm_2_interfaces/tlm_fw_bw_ifs.h"
 #include "tlm_core/tlm_2/tlm_generic_payload/tlm_phase.h"
+#include <algorithm>
 #include <cassert>
 #include <iomanip>
+#include <iostream>
 #include <sys/types.h>
 
 namespace dmu{
@@ -38,9 +41,41 @@ MemoryDevice::MemoryDevice(const sc_core::sc_module_name& name, const Configure&
 
 }
 
+namespace {
+
+template<typename Record>
+void
+FillDecodedAddress(Record& record, const DecodedAddress& address)
+{
+    record.channel = static_cast<uint8_t>(address.channel);
+    record.cs = static_cast<uint8_t>(address.cs);
+    record.cid = static_cast<uint8_t>(address.cid);
+    record.bankgroup = static_cast<uint8_t>(address.bankgroup);
+    record.bank = static_cast<uint8_t>(address.bank);
+    record.row = address.row;
+    record.column = static_cast<uint16_t>(address.column);
+    record.byte = static_cast<uint16_t>(address.byte);
+}
+
+} // namespace
+
 void
 MemoryDevice::PrintDfiCmd(tlm::tlm_generic_payload& trans)
 {
+    if(dfi_trace)
+    {
+        const StatisticExtension* statistic = trans.get_extension<StatisticExtension>();
+        const DecodedAddress& address = statistic->GetDecodedAddress();
+        trace::DfiCmdRecord record{};
+        record.type = static_cast<uint8_t>(trace::RecordType::DfiCmd);
+        record.command = trans.get_extension<DfiExtension>()->GetCommand().to_type();
+        record.trans_id = statistic->GetTransactionId();
+        record.time = sc_core::sc_time_stamp().value();
+        FillDecodedAddress(record, address);
+        record.real_ba = static_cast<uint16_t>(address.real_ba);
+        dfi_trace->Append(record);
+        return;
+    }
     outFile_dfi_cmd << std::left<<"Trans Id: " <<std::setw(8)<< trans.get_extension<StatisticExtension>()->GetTransactionId()
     << " Cmd: " << std::setw(6)<< trans.get_extension<DfiExtension>()->GetCommand().to_string()
     << " Time: " << std::setw(10)<< sc_core::sc_time_stamp().value() << " ps"
@@ -56,6 +91,10 @@ tlm::tlm_sync_enum
 MemoryDevice::nb_transport_fw(tlm::tlm_generic_payload& trans, tlm::tlm_phase& phase, sc_core::sc_time& delay)
 {
     // DPRINT_INFO(DEVICE, "MemoryDevice nb_transport_fw", "Trans Id: %d, Receive Cmd: %s, ",trans.get_extension<StatisticExtension>()->GetTransactionId(),trans.get_extension<DfiExtension>()->GetCommand().to_string().c_str());
+    // payload 在 event queue 中时 device 持有一个引用, pipline_method 处理完后 release
+    // 写数据的 DFI_WDAT_END 到达时 controller 已经 release, 没有这个引用 payload 可能已经回到 pool
+    if(trans.has_mm())
+        trans.acquire();
     payload_event_queue.notify(trans,phase,delay);
     return tlm::TLM_ACCEPTED;
 }
@@ -75,6 +114,8 @@ MemoryDevice::pipline_method(tlm::tlm_generic_payload& trans, const tlm::tlm_pha
             PrintDfiCmd(trans);
             sc_core::sc_time delay1 = _config.mem_spec->tCL;
             tlm::tlm_phase phase1 = DFI_RDAT_BEGIN;
+            if(trans.has_mm())
+                trans.acquire();
             payload_event_queue.notify(trans,phase1,delay1);
         }
         else if(dfi_cmd_type == Command::WR || dfi_cmd_type == Command::WRA)
@@ -83,14 +124,9 @@ MemoryDevice::pipline_method(tlm::tlm_generic_payload& trans, const tlm::tlm_pha
         }
         else if(dfi_cmd_type == Command::REFab || dfi_cmd_type == Command::REFsb || dfi_cmd_type == Command::RFMab || dfi_cmd_type == Command::RFMsb)
         {
-            outFile_dfi_cmd << std::left<<"Trans Id: " <<std::setw(8)<< -1
-            << " Cmd: " << std::setw(6)<< trans.get_extension<DfiExtension>()->GetCommand().to_string()
-            << " Time: " << std::setw(10)<< sc_core::sc_time_stamp().value() << " ps"
-            << " Last Cmd Delay: " << std::setw(10)<<( (last_cmd_time == sc_core::SC_ZERO_TIME) ? 0 : (sc_core::sc_time_stamp() - last_cmd_time).value() ) << " ps"
-            << " Real Rank Index: "<< std::setw(3)<< trans.get_extension<DfiExtension>()->GetAddress().real_cid
-            << " "<<trans.get_extension<DfiExtension>()->GetAddress()
-            << " "<<std::endl;
-            last_cmd_time = sc_core::sc_time_stamp();
+            PrintRefreshCmd(trans);
+            if(perf_counters)
+                perf_counters->RecordRefresh(dfi_ext->GetAddress().real_cid, dfi_cmd_type);
         }
         dfi_ext->PopCommand();
         //if cmd is RD or RDA, will call a function nb_transport_bw
@@ -102,8 +138,18 @@ MemoryDevice::pipline_method(tlm::tlm_generic_payload& trans, const tlm::tlm_pha
 
         // DPRINT_INFO(DEVICE, "MemoryDevice", "Trans Id: %d, Rdata Begin",trans.get_extension<StatisticExtension>()->GetTransactionId());
         trans.get_extension<StatisticExtension>()->RecordDfiDataBeginTime(sc_core::sc_time_stamp());
+        if(perf_counters)
+            perf_counters->RecordDataBurst(true, sc_core::sc_time_stamp());
+        if(backing_store && trans.get_data_ptr() != nullptr)
+        {
+            unsigned length;
+            uint64_t address = GetDataAddress(trans, length);
+            backing_store->Read(address, trans.get_data_ptr(), length);
+        }
         sc_core::sc_time delay2 = _config.mem_spec->tBurst - _config.mem_spec->tCK;
         tlm::tlm_phase phase2 = DFI_RDAT_END;
+        if(trans.has_mm())
+            trans.acquire();
         payload_event_queue.notify(trans,phase2,delay2);
         tlm::tlm_phase rdat_phase = phase;
         sc_core::sc_time rdat_delay = phy_rdat_delay;
@@ -117,28 +163,176 @@ MemoryDevice::pipline_method(tlm::tlm_generic_payload& trans, const tlm::tlm_pha
         sc_core::sc_time rdat_delay = phy_rdat_delay;
         tSocket->nb_transport_bw(trans, rdat_phase, rdat_delay);
         // DPRINT_INFO(DEVICE, "MemoryDevice", "Trans Id: %d, Rdata End",trans.get_extension<StatisticExtension>()->GetTransactionId());
-        trans.get_extension<StatisticExtension>()->PrintStatistics(outFile);
+        FinishTransaction(trans);
     }
     else if(phase == DFI_WDAT_BEGIN)
     {
         trans.get_extension<StatisticExtension>()->RecordDfiDataBeginTime(sc_core::sc_time_stamp());
+        if(perf_counters)
+            perf_counters->RecordDataBurst(false, sc_core::sc_time_stamp());
         // DPRINT_INFO(false,"MemoryDevice", "Wdata Begin");
     }
     else if(phase == DFI_WDAT_END)
     {
         trans.get_extension<StatisticExtension>()->RecordDfiDataEndTime(sc_core::sc_time_stamp() + _config.mem_spec->tCK);
         // DPRINT_INFO(false,"MemoryDevice", "Wdata End");
-        trans.get_extension<StatisticExtension>()->PrintStatistics(outFile);
+        if(backing_store && trans.get_data_ptr() != nullptr)
+        {
+            unsigned length;
+            uint64_t address = GetDataAddress(trans, length);
+            backing_store->Write(address, trans.get_data_ptr(), length, trans.get_byte_enable_ptr(), trans.get_byte_enable_length());
+        }
+        FinishTransaction(trans);
     }
     else
     {
         DPRINT_FATAL("MemoryDevice", "Invalid phase");
     }
+    if(trans.has_mm())
+        trans.release();
+}
+
+
+void
+MemoryDevice::PrintRefreshCmd(tlm::tlm_generic_payload& trans)
+{
+    const BankAddress& address = trans.get_extension<DfiExtension>()->GetAddress();
+    if(dfi_trace)
+    {
+        trace::DfiCmdRecord record{};
+        record.type = static_cast<uint8_t>(trace::RecordType::DfiCmd);
+        record.command = trans.get_extension<DfiExtension>()->GetCommand().to_type();
+        record.is_rank = 1;
+        record.time = sc_core::sc_time_stamp().value();
+        record.channel = static_cast<uint8_t>(address.ch);
+        record.cs = static_cast<uint8_t>(address.cs);
+        record.cid = static_cast<uint8_t>(address.cid);
+        record.bankgroup = static_cast<uint8_t>(address.bankgroup);
+        record.bank = static_cast<uint8_t>(address.bank);
+        record.real_ba = static_cast<uint16_t>(address.real_ba);
+        record.real_bg = static_cast<uint8_t>(address.real_bg);
+        record.real_cid = static_cast<uint8_t>(address.real_cid);
+        dfi_trace->Append(record);
+        return;
+    }
+    outFile_dfi_cmd << std::left<<"Trans Id: " <<std::setw(8)<< -1
+    << " Cmd: " << std::setw(6)<< trans.get_extension<DfiExtension>()->GetCommand().to_string()
+    << " Time: " << std::setw(10)<< sc_core::sc_time_stamp().value() << " ps"
+    << " Last Cmd Delay: " << std::setw(10)<<( (last_cmd_time == sc_core::SC_ZERO_TIME) ? 0 : (sc_core::sc_time_stamp() - last_cmd_time).value() ) << " ps"
+    << " Real Rank Index: "<< std::setw(3)<< address.real_cid
+    << " "<<address
+    << " "<<std::endl;
+    last_cmd_time = sc_core::sc_time_stamp();
+}
+
+void
+MemoryDevice::FinishTransaction(tlm::tlm_generic_payload& trans)
+{
+    const StatisticExtension* statistic = trans.get_extension<StatisticExtension>();
+    const UifInfo& uif_info = trans.get_extension<UifExtension>()->_uif_info;
+    latency_statistics.Record(*statistic, uif_info.qos.GetQosLevel(), uif_info.cmd_type, uif_info.src_id);
+    if(!trans_info_enable)
+        return;
+    if(dfi_trace)
+        TraceStatistics(*statistic);
+    else
+        statistic->PrintStatistics(outFile);
+}
+
+// 一个 TransRecord 带前 kTransInlineCmds 个命令, 其余的命令每 kTransCmdRecordCmds 个一个 TransCmdRecord
+void
+MemoryDevice::TraceStatistics(const StatisticExtension& statistic)
+{
+    const auto& cmd_time_vec = statistic.GetCmdTimeVec();
+    trace::TransRecord record{};
+    record.type = static_cast<uint8_t>(trace::RecordType::Trans);
+    record.num_of_cmds = static_cast<uint8_t>(std::min<std::size_t>(cmd_time_vec.size(), UINT8_MAX));
+    record.trans_id = statistic.GetTransactionId();
+    FillDecodedAddress(record, statistic.GetDecodedAddress());
+    record.times[trace::kInPortTime] = statistic.GetInPortTime().value();
+    record.times[trace::kOutPortTime] = statistic.GetOutPortTime().value();
+    record.times[trace::kInCamTime] = statistic.GetInCamTime().value();
+    record.times[trace::kOutCamTime] = statistic.GetOutCamTime().value();
+    record.times[trace::kUifDataBeginTime] = statistic.GetUiFDataBeginTime().value();
+    record.times[trace::kUifDataEndTime] = statistic.GetUiFDataEndTime().value();
+    record.times[trace::kDfiDataBeginTime] = statistic.GetDfiDataBeginTime().value();
+    record.times[trace::kDfiDataEndTime] = statistic.GetDfiDataEndTime().value();
+    record.times[trace::kDqDataBeginTime] = statistic.GetDqDataBeginTime().value();
+    record.times[trace::kDqDataEndTime] = statistic.GetDqDataEndTime().value();
+    std::size_t index = 0;
+    for(; index < record.num_of_cmds && index < trace::kTransInlineCmds; index++)
+    {
+        record.commands[index] = static_cast<uint8_t>(cmd_time_vec[index].second);
+        record.command_times[index] = cmd_time_vec[index].first.value();
+    }
+    dfi_trace->Append(record);
+    while(index < record.num_of_cmds)
+    {
+        trace::TransCmdRecord cmd_record{};
+        cmd_record.type = static_cast<uint8_t>(trace::RecordType::TransCmd);
+        cmd_record.trans_id = record.trans_id;
+        for(unsigned i = 0; i < trace::kTransCmdRecordCmds && index < record.num_of_cmds; i++, index++)
+        {
+            cmd_record.commands[i] = static_cast<uint8_t>(cmd_time_vec[index].second);
+            cmd_record.command_times[i] = cmd_time_vec[index].first.value();
+        }
+        dfi_trace->Append(cmd_record);
+    }
 }
 
+bool
+MemoryDevice::EnableBinaryTrace(bool compress)
+{
+    auto writer = std::make_unique<trace::DfiTraceWriter>();
+    const uint64_t resolution_fs = static_cast<uint64_t>(sc_core::sc_get_time_resolution().to_seconds() * 1e15 + 0.5);
+    if(!writer->Open(output_dir + "/" + "DfiTrace.bin", resolution_fs, _config.config_hash, compress))
+        return false;
+    dfi_trace = std::move(writer);
+    // 文本文件不再写入, 保留为空文件
+    outFile.close();
+    outFile_dfi_cmd.close();
+    return true;
+}
+
+void
+MemoryDevice::SetTransInfoEnabled(bool enable)
+{
+    trans_info_enable = enable;
+}
+
+void
+MemoryDevice::RegisterPerformanceCounters(PerformanceCounters* counters)
+{
+    perf_counters = counters;
+}
+
+void
+MemoryDevice::EnableBackingStore()
+{
+    if(!backing_store)
+        backing_store = std::make_unique<BackingStore>();
+}
+
+// payload 的 data 从按请求大小对齐的地址开始; data_length 中是 CHI size 编码, 字节数取自 UifExtension
+uint64_t
+MemoryDevice::GetDataAddress(tlm::tlm_generic_payload& trans, unsigned& length)
+{
+    length = trans.get_extension<UifExtension>()->_uif_info.data_bytes;
+    assert(length != 0 && (length & (length - 1)) == 0);
+    return trans.get_address() & ~uint64_t(length - 1);
+}
 
 MemoryDevice::~MemoryDevice()
 {
+    if(!latency_statistics.WriteJson(output_dir + "/" + "LatencyStats.json"))
+        std::cerr << "[" << name() << "] unable to write " << output_dir << "/LatencyStats.json" << std::endl;
+    if(perf_counters && !perf_counters->WriteJson(output_dir + "/" + "PerfCounters.json"))
+        std::cerr << "[" << name() << "] unable to write " << output_dir << "/PerfCounters.json" << std::endl;
+    if(dfi_trace)
+    {
+        dfi_trace->Close();
+        std::cout << "[" << name() << "] dfi trace records: " << dfi_trace->GetNumOfRecords() << std::endl;
+    }
     if(outFile.is_open())
     {
         outFile.close();
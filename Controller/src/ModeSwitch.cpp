@@ -308,6 +308,7 @@ ModeSwitch::UpdateGlobalState()
             DPRINT_FATAL("ModeSwitch State Update", "Invalid Current State");
 
     }
+    _perf_counters.RecordModeState(current_state);
 
 }
     }
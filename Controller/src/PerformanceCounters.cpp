@@ -0,0 +1,362 @@
+#include "Controller/PerformanceCounters.hh"
+
+#include <algorithm>
+
+#include "rapidjson/ostreamwrapper.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/writer.h"
+#include "sysc/kernel/sc_simcontext.h"
+
+namespace dmu{
+    namespace Controller{
+
+namespace {
+
+template <typename Writer>
+void
+WriteBankFields(Writer& writer, const PerformanceCounters::BankCounters& bank)
+{
+    writer.Key("reads");
+    writer.Uint64(bank.reads);
+    writer.Key("writes");
+    writer.Uint64(bank.writes);
+    writer.Key("hits");
+    writer.Uint64(bank.hits);
+    writer.Key("misses");
+    writer.Uint64(bank.misses);
+    writer.Key("conflicts");
+    writer.Uint64(bank.conflicts);
+    writer.Key("hit_rate");
+    const uint64_t accesses = bank.hits + bank.misses + bank.conflicts;
+    writer.Double(accesses ? static_cast<double>(bank.hits) / accesses : 0.0);
+    writer.Key("acts");
+    writer.Uint64(bank.acts);
+    writer.Key("pres");
+    writer.Uint64(bank.pres);
+}
+
+} // namespace
+
+PerformanceCounters::PerformanceCounters(const Configure& config)
+: mc_clock(config.mem_spec->tCK_mc)
+, t_burst(config.mem_spec->tBurst)
+, t_rfc(config.mem_spec->tRFC_slr_mc)
+, t_rfc_sb(config.mem_spec->tRFCsb_slr_mc)
+, banks(config.mem_spec->NumOfTotalBanks)
+, ranks(config.mem_spec->TotalNumOfLogicalRanks)
+{
+}
+
+PerformanceCounters::BankCounters&
+PerformanceCounters::GetBank(const unsigned real_ba)
+{
+    if(real_ba >= banks.size())
+        banks.resize(real_ba + 1);
+    return banks[real_ba];
+}
+
+PerformanceCounters::RankCounters&
+PerformanceCounters::GetRank(const unsigned real_cid)
+{
+    if(real_cid >= ranks.size())
+        ranks.resize(real_cid + 1);
+    return ranks[real_cid];
+}
+
+void
+PerformanceCounters::RecordBankCommand(const unsigned real_ba, const Command::Type cmd)
+{
+    CheckSnapshot();
+    BankCounters& bank = GetBank(real_ba);
+    switch(cmd)
+    {
+        case Command::ACT:
+            bank.acts++;
+            bank.pending_act = true;
+            break;
+        case Command::PRE:
+            bank.pres++;
+            bank.pending_pre = true;
+            break;
+        case Command::RD:
+        case Command::RDA:
+        case Command::WR:
+        case Command::WRA:
+            if(cmd == Command::RD || cmd == Command::RDA)
+                bank.reads++;
+            else
+                bank.writes++;
+            // 读写两个方向的 candidate 共用一个 bank, PRE / ACT 记给之后第一个 CAS, 总数与 row 切换次数一致
+            if(bank.pending_pre)
+                bank.conflicts++;
+            else if(bank.pending_act)
+                bank.misses++;
+            else
+                bank.hits++;
+            bank.pending_pre = false;
+            bank.pending_act = false;
+            break;
+        default:
+            break;
+    }
+}
+
+void
+PerformanceCounters::RecordModeState(const GlobalRdWrState state)
+{
+    CheckSnapshot();
+    const Tick now = mc_clock.Now();
+    mode_cycles[static_cast<std::size_t>(mode_state)] += now - mode_state_tick;
+    mode_state_tick = now;
+    if(state == mode_state)
+        return;
+    // Rd2Wr / Wr2Rd 只是等待另一个方向的 row 命令, 到达 Wr / Rd 才算一次切换
+    if(state == GlobalRdWrState::Wr && (mode_state == GlobalRdWrState::Rd || mode_state == GlobalRdWrState::Rd2Wr))
+        rd2wr_switches++;
+    else if(state == GlobalRdWrState::Rd && (mode_state == GlobalRdWrState::Wr || mode_state == GlobalRdWrState::Wr2Rd))
+        wr2rd_switches++;
+    mode_state = state;
+}
+
+void
+PerformanceCounters::RecordRefresh(const unsigned real_cid, const Command::Type cmd)
+{
+    CheckSnapshot();
+    RankCounters& rank = GetRank(real_cid);
+    switch(cmd)
+    {
+        case Command::REFab:
+            rank.ref_ab++;
+            rank.all_bank_blocked += t_rfc;
+            break;
+        case Command::RFMab:
+            rank.rfm_ab++;
+            rank.all_bank_blocked += t_rfc;
+            break;
+        case Command::REFsb:
+            rank.ref_sb++;
+            rank.same_bank_blocked += t_rfc_sb;
+            break;
+        case Command::RFMsb:
+            rank.rfm_sb++;
+            rank.same_bank_blocked += t_rfc_sb;
+            break;
+        default:
+            break;
+    }
+}
+
+void
+PerformanceCounters::RecordDataBurst(const bool is_read, const sc_core::sc_time& begin)
+{
+    CheckSnapshot();
+    const sc_core::sc_time end = begin + t_burst;
+    if(is_read)
+        data_bus.read_bursts++;
+    else
+        data_bus.write_bursts++;
+    if(has_last_burst && last_burst_is_read != is_read)
+    {
+        if(is_read)
+            data_bus.wr2rd_turnarounds++;
+        else
+            data_bus.rd2wr_turnarounds++;
+        if(begin > last_burst_end)
+            data_bus.turnaround_gap += begin - last_burst_end;
+    }
+    // burst 之间不应该重叠, 为了 busy 不重复计算, 只累加超出上一个 burst 的部分
+    if(!has_last_burst || end > last_burst_end)
+    {
+        data_bus.busy += (has_last_burst && begin < last_burst_end) ? end - last_burst_end : end - begin;
+        last_burst_end = end;
+    }
+    has_last_burst = true;
+    last_burst_is_read = is_read;
+}
+
+PerformanceCounters::BankCounters
+PerformanceCounters::GetTotalBankCounters() const
+{
+    BankCounters total;
+    for(const BankCounters& bank: banks)
+    {
+        total.reads += bank.reads;
+        total.writes += bank.writes;
+        total.hits += bank.hits;
+        total.misses += bank.misses;
+        total.conflicts += bank.conflicts;
+        total.acts += bank.acts;
+        total.pres += bank.pres;
+    }
+    return total;
+}
+
+std::array<Tick, PerformanceCounters::kNumOfModeStates>
+PerformanceCounters::GetModeCycles() const
+{
+    std::array<Tick, kNumOfModeStates> cycles = mode_cycles;
+    const Tick now = mc_clock.Now();
+    if(now > mode_state_tick)
+        cycles[static_cast<std::size_t>(mode_state)] += now - mode_state_tick;
+    return cycles;
+}
+
+bool
+PerformanceCounters::EnableSnapshot(const std::string& filename, const sc_core::sc_time& interval)
+{
+    if(interval == sc_core::SC_ZERO_TIME)
+        return false;
+    snapshot_file.open(filename, std::ios::out | std::ios::trunc);
+    if(!snapshot_file.is_open())
+        return false;
+    snapshot_interval = interval;
+    next_snapshot_time = sc_core::sc_time_stamp() + interval;
+    return true;
+}
+
+void
+PerformanceCounters::CheckSnapshot()
+{
+    // 两次事件之间可能跨过多个 interval, 每个 interval 一行, 值为跨过时的累计值
+    while(sc_core::sc_time_stamp() >= next_snapshot_time)
+    {
+        WriteSnapshot(next_snapshot_time);
+        next_snapshot_time += snapshot_interval;
+    }
+}
+
+void
+PerformanceCounters::WriteSnapshot(const sc_core::sc_time& time)
+{
+    rapidjson::OStreamWrapper stream(snapshot_file);
+    rapidjson::Writer<rapidjson::OStreamWrapper> writer(stream);
+    const BankCounters total = GetTotalBankCounters();
+    writer.StartObject();
+    writer.Key("cycle");
+    writer.Uint64(ToCycles(time));
+    WriteBankFields(writer, total);
+    writer.Key("rd2wr_switches");
+    writer.Uint64(rd2wr_switches);
+    writer.Key("wr2rd_switches");
+    writer.Uint64(wr2rd_switches);
+    writer.Key("data_busy_cycles");
+    writer.Uint64(ToCycles(data_bus.busy));
+    writer.Key("turnarounds");
+    writer.Uint64(data_bus.rd2wr_turnarounds + data_bus.wr2rd_turnarounds);
+    writer.EndObject();
+    snapshot_file << std::endl;
+}
+
+void
+PerformanceCounters::WriteJson(std::ostream& os) const
+{
+    using JsonWriter = rapidjson::PrettyWriter<rapidjson::OStreamWrapper>;
+    rapidjson::OStreamWrapper stream(os);
+    JsonWriter writer(stream);
+    const Tick elapsed = mc_clock.Now();
+
+    writer.StartObject();
+    writer.Key("clock_period_ps");
+    writer.Uint64(mc_clock.ToTime(1).value() / sc_core::sc_time(1, sc_core::SC_PS).value());
+    writer.Key("elapsed_cycles");
+    writer.Uint64(elapsed);
+
+    writer.Key("total");
+    writer.StartObject();
+    WriteBankFields(writer, GetTotalBankCounters());
+    writer.EndObject();
+
+    // 只输出访问过的 bank
+    writer.Key("banks");
+    writer.StartArray();
+    for(std::size_t real_ba = 0; real_ba < banks.size(); real_ba++)
+    {
+        const BankCounters& bank = banks[real_ba];
+        if(bank.reads == 0 && bank.writes == 0 && bank.acts == 0 && bank.pres == 0)
+            continue;
+        writer.StartObject();
+        writer.Key("real_ba");
+        writer.Uint64(real_ba);
+        WriteBankFields(writer, bank);
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.Key("ranks");
+    writer.StartArray();
+    for(std::size_t real_cid = 0; real_cid < ranks.size(); real_cid++)
+    {
+        const RankCounters& rank = ranks[real_cid];
+        writer.StartObject();
+        writer.Key("real_cid");
+        writer.Uint64(real_cid);
+        writer.Key("ref_ab");
+        writer.Uint64(rank.ref_ab);
+        writer.Key("ref_sb");
+        writer.Uint64(rank.ref_sb);
+        writer.Key("rfm_ab");
+        writer.Uint64(rank.rfm_ab);
+        writer.Key("rfm_sb");
+        writer.Uint64(rank.rfm_sb);
+        writer.Key("all_bank_refresh_blocked_cycles");
+        writer.Uint64(ToCycles(rank.all_bank_blocked));
+        writer.Key("same_bank_refresh_blocked_cycles");
+        writer.Uint64(ToCycles(rank.same_bank_blocked));
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.Key("mode_switch");
+    writer.StartObject();
+    writer.Key("rd2wr_switches");
+    writer.Uint64(rd2wr_switches);
+    writer.Key("wr2rd_switches");
+    writer.Uint64(wr2rd_switches);
+    writer.Key("state_cycles");
+    writer.StartObject();
+    const std::array<Tick, kNumOfModeStates> cycles = GetModeCycles();
+    for(std::size_t state = 0; state < kNumOfModeStates; state++)
+    {
+        writer.Key(PrintState(static_cast<GlobalRdWrState>(state)).c_str());
+        writer.Uint64(cycles[state]);
+    }
+    writer.EndObject();
+    writer.EndObject();
+
+    const Tick busy = ToCycles(data_bus.busy);
+    writer.Key("data_bus");
+    writer.StartObject();
+    writer.Key("read_bursts");
+    writer.Uint64(data_bus.read_bursts);
+    writer.Key("write_bursts");
+    writer.Uint64(data_bus.write_bursts);
+    writer.Key("busy_cycles");
+    writer.Uint64(busy);
+    writer.Key("idle_cycles");
+    writer.Uint64(elapsed > busy ? elapsed - busy : 0);
+    writer.Key("utilization");
+    writer.Double(elapsed ? static_cast<double>(busy) / elapsed : 0.0);
+    writer.Key("rd2wr_turnarounds");
+    writer.Uint64(data_bus.rd2wr_turnarounds);
+    writer.Key("wr2rd_turnarounds");
+    writer.Uint64(data_bus.wr2rd_turnarounds);
+    writer.Key("turnaround_gap_cycles");
+    writer.Uint64(ToCycles(data_bus.turnaround_gap));
+    writer.EndObject();
+
+    writer.EndObject();
+    os << std::endl;
+}
+
+bool
+PerformanceCounters::WriteJson(const std::string& filename) const
+{
+    std::ofstream file(filename, std::ios::out | std::ios::trunc);
+    if(!file.is_open())
+        return false;
+    WriteJson(file);
+    return true;
+}
+
+    }
+}
@@ -12,9 +12,12 @@ namespace dmu{
 // }
 
 RdCam::RdCam(const Configure& config)
-: CamIF(config.controller_config->RD_CAM_DEPTH)
+: CamIF(config.controller_config->RD_CAM_DEPTH, config.mem_spec->NumOfTotalBanks, config.mem_spec->BurstLenth)
 , _config(config)
+, mc_clock(config.mem_spec->tCK_mc)
+, rd_cam_slot(config.controller_config->RD_CAM_DEPTH)
 {
+    collision_rd_cam_index_vec.reserve(cam_depth);
     lpr_cam_credit = _config.controller_config->LPR_CREDIT;
     hpr_cam_credit = _config.controller_config->HPR_CREDIT;
 }
@@ -23,27 +26,20 @@ void
 RdCam::StoreRequest(InputProcessReq& rd_request)
 {
     DPRINT_INFO(RD_CAM, "Rd Cam", "call Rd Cam Store Request");
-    // record the used cam index
-    used_allocated_cam_index.insert(rd_request.cam_index);
-    // add the rd cmd into cam order list
-    cam_order_list.push_back(rd_request.cam_index);
-
-    // add the cmd into ba-addr based order list
-    if(ba_cmds_order_list.find(rd_request.sdram_addr.real_ba) == ba_cmds_order_list.end())
-    {
-        ba_cmds_order_list.emplace(rd_request.sdram_addr.real_ba,std::list<CAM_INDEX>());
-    }
-    ba_cmds_order_list[rd_request.sdram_addr.real_ba].push_back(rd_request.cam_index);
+    // construct the entry in its slot, then link it into the entering order and ba order list
+    assert(rd_request.cam_index < cam_depth && !rd_cam_slot[rd_request.cam_index]);
+    RdCamEntry& rd_cam_entry = rd_cam_slot[rd_request.cam_index].emplace(rd_request);
+    LinkCamEntry(rd_request.cam_index, &rd_cam_entry);
 
     if(rd_request._qos.GetQosLevel() == PriorityClass::HPR)
     {
-        hpr_cmd_set.insert(rd_request.cam_index);
+        num_of_hpr_cmd++;
         UpdateHprCamFull();
         UpdateHprFillLevel();
     }
     else if(rd_request._qos.GetQosLevel() == PriorityClass::LPR || rd_request._qos.GetQosLevel() == PriorityClass::GPR)
     {
-        lpr_cmd_set.insert(rd_request.cam_index);
+        num_of_lpr_cmd++;
         UpdateLprCamFull();
         UpdateLprFillLevel();
     }
@@ -51,26 +47,21 @@ RdCam::StoreRequest(InputProcessReq& rd_request)
     {
         ABORT_MESSAGE("Invalid qos level in rd cam entry store");
     }
-    // assert((cam_store.size()>=1) && (cam_store.find(rd_request.cam_index)!= cam_store.end()));
-    assert(cam_store.size()<cam_depth);
-    cam_store.emplace(rd_request.cam_index,std::make_unique<RdCamEntry>(rd_request));
 }
 
 void
 RdCam::DeleteCamEntry(CAM_INDEX removed_cam_index)
 {
-    used_allocated_cam_index.erase(removed_cam_index);
     RdCamEntry* removed_rd_cam_entry = GetCamEntry(removed_cam_index);
-    RealBaIndex removed_rd_cam_entry_ba_addr = removed_rd_cam_entry->GetCamEntryRealBa();
     if(removed_rd_cam_entry->GetQosLevel() == PriorityClass::HPR)
     {
-        hpr_cmd_set.erase(removed_cam_index);
+        num_of_hpr_cmd--;
         UpdateHprCamFull();
         UpdateHprFillLevel();
     }
     else if(removed_rd_cam_entry->GetQosLevel() == PriorityClass::LPR || removed_rd_cam_entry->GetQosLevel() == PriorityClass::GPR)
     {
-        lpr_cmd_set.erase(removed_cam_index);
+        num_of_lpr_cmd--;
         UpdateLprCamFull();
         UpdateLprFillLevel();
     }
@@ -84,9 +75,8 @@ RdCam::DeleteCamEntry(CAM_INDEX removed_cam_index)
                                          collision_rd_cam_index_vec.end(),removed_cam_index),collision_rd_cam_index_vec.end());
     }
 
-    ba_cmds_order_list[removed_rd_cam_entry_ba_addr].remove(removed_cam_index);
-    cam_order_list.remove(removed_cam_index);
-    cam_store.erase(removed_cam_index);
+    UnlinkCamEntry(removed_cam_index);
+    rd_cam_slot[removed_cam_index].reset();
 }
 
 
@@ -94,8 +84,7 @@ OrderList
 RdCam::GetAvailBaOrderList(RealBaIndex ba_addr)
 {
     OrderList aval_ba_order_list;
-    auto ba_list = this->ba_cmds_order_list.at(ba_addr);
-    for(auto cam_index : ba_list)
+    for(auto cam_index : this->GetBaOrderList(ba_addr))
     {
         if(GetCamEntry(cam_index)->is_allocated)//rd cam only bsc allocated
             aval_ba_order_list.push_back((cam_index));
@@ -110,8 +99,7 @@ RdCam::IsAvailBaOrderListEmpty(RealBaIndex ba_addr)
         return true;
     else
     {
-        auto ba_list = this->ba_cmds_order_list.at(ba_addr);
-        for(auto cam_index : ba_list)
+        for(auto cam_index : this->GetBaOrderList(ba_addr))
         {
             if(GetCamEntry(cam_index)->is_allocated)//rd cam only bsc allocated
                 return false;
@@ -167,9 +155,9 @@ RdCam::UpdateRdCriticalState()
 bool
 RdCam::IsRdCamExpired() const
 {
-    for(auto cam_index: used_allocated_cam_index)
+    for(auto& rd_cam_entry: rd_cam_slot)
     {
-        if(cam_store.at(cam_index)->IsExpired())
+        if(rd_cam_entry && rd_cam_entry->IsExpired())
             return true;
     }
     return false;
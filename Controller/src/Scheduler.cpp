@@ -17,8 +17,8 @@ namespace dmu{
     namespace Controller{
 
 Scheduler::Scheduler(const Configure& config)
-: mc_cycle_time(config.mem_spec->tCK_mc)
-, ntt_store(Ntt(config.controller_config->BSC_NUM))
+: mc_clock(config.mem_spec->tCK_mc)
+, ntt_store(Ntt(config.controller_config->BSC_NUM, config.mem_spec->tCK_mc))
 {
     rd_cam = std::make_unique<RdCam>(config);
     wr_cam = std::make_unique<WrCam>(config);
@@ -39,7 +39,10 @@ void
 Scheduler::StoreRdRequest(InputProcessReq& rd_input_request)
 {
     RealBaIndex request_ba = rd_input_request.sdram_addr.real_ba;
-    rd_input_request.print();
+    if(DPRINT_ENABLED(RD_CAM))
+    {
+        rd_input_request.print();
+    }
     rd_cam->StoreRequest(rd_input_request);
     rd_input_request.GetRequest()->get_extension<StatisticExtension>()->RecordInCamTime(sc_core::sc_time_stamp());
     if(IsBscMatch(request_ba))
@@ -55,10 +58,13 @@ Scheduler::StoreRdRequest(InputProcessReq& rd_input_request)
         else
         {
             DPRINT_WARNING(false, "Scheduler Rd Store", "the new command page hit: %d, the bank is in Activing: %d, activing end time: %s, the ntt is valid: %d",
-            is_page_hit,bank_slice->IsActiving(),bank_slice->GetActEndTime().to_string().c_str(),bank_slice->IsRdNttValid());
+            is_page_hit,bank_slice->IsActiving(),mc_clock.ToTime(bank_slice->GetActEndTime()).to_string().c_str(),bank_slice->IsRdNttValid());
         }
     }
-    rd_cam->GetCamEntry(rd_input_request.cam_index)->print();
+    if(DPRINT_ENABLED(RD_CAM))
+    {
+        rd_cam->GetCamEntry(rd_input_request.cam_index)->print();
+    }
 }
 
 void
@@ -102,28 +108,28 @@ Scheduler::UpdateRdNttPip(BSC_INDEX bsc_index, RealBaIndex ba_addr, UpdateType u
 
     if(update_type == UpdateType::NewCmdStore && !rd_cam->IsBaOrderListEmpty(ba_addr)&& rd_cam->IsBaListAvail(ba_addr))
     {
-        auto updated_cam_index = rd_cam_filter->GetSelectedRdCamIndex(rd_cam->GetBaOrderList(ba_addr));
+        auto updated_cam_index = rd_cam_filter->GetSelectedRdCamIndex(rd_cam->GetBaMask(ba_addr));
 
         DPRINT_ASSERT(rd_cam->GetCamEntry(updated_cam_index)->sdram_addr.real_ba == ba_addr,"Rd Ntt Update:",
         "ba_addr mismatch, the read updated cam index ba is %d, but the bsc ba_addr is %ld",(rd_cam->GetCamEntry(updated_cam_index)->sdram_addr.real_ba),ba_addr);
 
         // rd_updated_bsc_set.insert(bsc_index);
         // rd_update_ntt_temp.at(bsc_index).at(static_cast<size_t>(update_type)).push_back(
-        //     rd_cam_filter->GetSelectedRdCamIndex(rd_cam->GetBaOrderList(ba_addr))
+        //     rd_cam_filter->GetSelectedRdCamIndex(rd_cam->GetBaMask(ba_addr))
         // );
-        sc_core::sc_time updating_time = sc_core::sc_time_stamp() + mc_cycle_time;
+        Tick updating_time = mc_clock.Now() + Ntt::kUpdateLatency;
         ntt_store.RecordNttsBsc(true,bsc_index,updating_time);
         ntt_store.RdNttStore(bsc_index,update_type,updated_cam_index,
         updating_time);
     }
     else if(update_type == UpdateType::CmdExe && !rd_cam->IsBaOrderListEmpty(ba_addr) && rd_cam->IsBaListAvail(ba_addr))
     {
-        auto updated_cam_index = rd_cam_filter->GetSelectedRdCamIndex(rd_cam->GetBaOrderList(ba_addr));
+        auto updated_cam_index = rd_cam_filter->GetSelectedRdCamIndex(rd_cam->GetBaMask(ba_addr));
 
         DPRINT_ASSERT(rd_cam->GetCamEntry(updated_cam_index)->sdram_addr.real_ba == ba_addr,"Rd Ntt Update:",
         "ba_addr mismatch, the read updated cam index ba is %d, but the bsc ba_addr is %ld",(rd_cam->GetCamEntry(updated_cam_index)->sdram_addr.real_ba),ba_addr);
 
-        sc_core::sc_time updating_time = sc_core::sc_time_stamp() + mc_cycle_time;
+        Tick updating_time = mc_clock.Now() + Ntt::kUpdateLatency;
         ntt_store.RecordNttsBsc(true,bsc_index,updating_time);
         ntt_store.RdNttStore(bsc_index,update_type,updated_cam_index,
         updating_time);
@@ -131,28 +137,28 @@ Scheduler::UpdateRdNttPip(BSC_INDEX bsc_index, RealBaIndex ba_addr, UpdateType u
     }
     else if(update_type == UpdateType::Pre_Act && !rd_cam->IsBaOrderListEmpty(ba_addr)&& rd_cam->IsBaListAvail(ba_addr))
     {
-        auto updated_cam_index = rd_cam_filter->GetSelectedRdCamIndex(rd_cam->GetBaOrderList(ba_addr));
+        auto updated_cam_index = rd_cam_filter->GetSelectedRdCamIndex(rd_cam->GetBaMask(ba_addr));
 
         DPRINT_ASSERT(rd_cam->GetCamEntry(updated_cam_index)->sdram_addr.real_ba == ba_addr,"Rd Ntt Update:",
         "ba_addr mismatch, the read updated cam index ba is %d, but the bsc ba_addr is %ld",(rd_cam->GetCamEntry(updated_cam_index)->sdram_addr.real_ba),ba_addr);
         // rd_updated_bsc_set.insert(bsc_index);
         // rd_update_ntt_temp.at(bsc_index).at(static_cast<size_t>(update_type)).push_back(
-        //     rd_cam_filter->GetSelectedRdCamIndex(rd_cam->GetBaOrderList(ba_addr))
+        //     rd_cam_filter->GetSelectedRdCamIndex(rd_cam->GetBaMask(ba_addr))
         // );
-        sc_core::sc_time updating_time = sc_core::sc_time_stamp() + mc_cycle_time;
+        Tick updating_time = mc_clock.Now() + Ntt::kUpdateLatency;
         ntt_store.RecordNttsBsc(true,bsc_index,updating_time);
         ntt_store.RdNttStore(bsc_index,update_type,updated_cam_index,
         updating_time);
     }
     else if(update_type == UpdateType::BscAllocate && !rd_cam->IsBaOrderListEmpty(ba_addr) && rd_cam->IsBaListAvail(ba_addr))
     {
-        auto updated_cam_index = rd_cam_filter->GetSelectedRdCamIndex(rd_cam->GetBaOrderList(ba_addr));
+        auto updated_cam_index = rd_cam_filter->GetSelectedRdCamIndex(rd_cam->GetBaMask(ba_addr));
 
         DPRINT_ASSERT(rd_cam->GetCamEntry(updated_cam_index)->sdram_addr.real_ba == ba_addr,"Rd Ntt Update:",
         "ba_addr mismatch, the read updated cam index ba is %d, but the bsc ba_addr is %ld",(rd_cam->GetCamEntry(updated_cam_index)->sdram_addr.real_ba),ba_addr);
-        sc_core::sc_time updating_time = sc_core::sc_time_stamp() + mc_cycle_time;
+        Tick updating_time = mc_clock.Now() + Ntt::kUpdateLatency;
         ntt_store.RecordNttsBsc(true,bsc_index,updating_time);
-        ntt_store.RdNttStore(bsc_index,update_type,rd_cam_filter->GetSelectedRdCamIndex(rd_cam->GetBaOrderList(ba_addr)),
+        ntt_store.RdNttStore(bsc_index,update_type,rd_cam_filter->GetSelectedRdCamIndex(rd_cam->GetBaMask(ba_addr)),
         updating_time);
     }
     else if(update_type == UpdateType::BrokenTerminate && !rd_cam->IsBaOrderListEmpty(ba_addr)&& rd_cam->IsBaListAvail(ba_addr))
@@ -179,23 +185,23 @@ Scheduler::UpdateWrNttPip(BSC_INDEX bsc_index, RealBaIndex ba_addr, UpdateType u
 
     if(update_type == UpdateType::NewCmdStore && !wr_cam->IsBaOrderListEmpty(ba_addr) && wr_cam->IsBaListAvail(ba_addr))
     {
-        auto updated_cam_index = wr_cam_filter->GetSelectedWrCamIndex(wr_cam->GetBaOrderList(ba_addr));
+        auto updated_cam_index = wr_cam_filter->GetSelectedWrCamIndex(wr_cam->GetBaMask(ba_addr));
 
         DPRINT_ASSERT(wr_cam->GetCamEntry(updated_cam_index)->sdram_addr.real_ba == ba_addr,"Wr Ntt Update:",
         "ba_addr mismatch, the write updated cam index ba is %d, but the bsc ba_addr is %ld",(wr_cam->GetCamEntry(updated_cam_index)->sdram_addr.real_ba),ba_addr);
-        sc_core::sc_time updating_time = sc_core::sc_time_stamp() + mc_cycle_time;
+        Tick updating_time = mc_clock.Now() + Ntt::kUpdateLatency;
         ntt_store.RecordNttsBsc(false,bsc_index,updating_time);
         ntt_store.WrNttStore(bsc_index,update_type,updated_cam_index,
         updating_time);
     }
     else if(update_type == UpdateType::CmdExe && !wr_cam->IsBaOrderListEmpty(ba_addr) && wr_cam->IsBaListAvail(ba_addr))
     {
-        auto updated_cam_index = wr_cam_filter->GetSelectedWrCamIndex(wr_cam->GetBaOrderList(ba_addr));
+        auto updated_cam_index = wr_cam_filter->GetSelectedWrCamIndex(wr_cam->GetBaMask(ba_addr));
 
         DPRINT_ASSERT(wr_cam->GetCamEntry(updated_cam_index)->sdram_addr.real_ba == ba_addr,"Wr Ntt Update:",
         "ba_addr mismatch, the write updated cam index ba is %d, but the bsc ba_addr is %ld",(wr_cam->GetCamEntry(updated_cam_index)->sdram_addr.real_ba),ba_addr);
 
-        sc_core::sc_time updating_time = sc_core::sc_time_stamp() + mc_cycle_time;
+        Tick updating_time = mc_clock.Now() + Ntt::kUpdateLatency;
         ntt_store.RecordNttsBsc(false,bsc_index,updating_time);
         ntt_store.WrNttStore(bsc_index,update_type,updated_cam_index,
         updating_time);
@@ -203,12 +209,12 @@ Scheduler::UpdateWrNttPip(BSC_INDEX bsc_index, RealBaIndex ba_addr, UpdateType u
     }
     else if(update_type == UpdateType::Pre_Act && !wr_cam->IsBaOrderListEmpty(ba_addr) && wr_cam->IsBaListAvail(ba_addr))
     {
-        auto updated_cam_index = wr_cam_filter->GetSelectedWrCamIndex(wr_cam->GetBaOrderList(ba_addr));
+        auto updated_cam_index = wr_cam_filter->GetSelectedWrCamIndex(wr_cam->GetBaMask(ba_addr));
 
         DPRINT_ASSERT(wr_cam->GetCamEntry(updated_cam_index)->sdram_addr.real_ba == ba_addr,"Wr Ntt Update:",
         "ba_addr mismatch, the write updated cam index ba is %d, but the bsc ba_addr is %ld",(wr_cam->GetCamEntry(updated_cam_index)->sdram_addr.real_ba),ba_addr);
 
-        sc_core::sc_time updating_time = sc_core::sc_time_stamp() + mc_cycle_time;
+        Tick updating_time = mc_clock.Now() + Ntt::kUpdateLatency;
         ntt_store.RecordNttsBsc(false,bsc_index,updating_time);
         ntt_store.WrNttStore(bsc_index,update_type,updated_cam_index,
         updating_time);
@@ -220,12 +226,12 @@ Scheduler::UpdateWrNttPip(BSC_INDEX bsc_index, RealBaIndex ba_addr, UpdateType u
     }
     else if(update_type == UpdateType::BscAllocate && !wr_cam->IsBaOrderListEmpty(ba_addr) && wr_cam->IsBaListAvail(ba_addr))
     {
-        auto updated_cam_index = wr_cam_filter->GetSelectedWrCamIndex(wr_cam->GetBaOrderList(ba_addr));
+        auto updated_cam_index = wr_cam_filter->GetSelectedWrCamIndex(wr_cam->GetBaMask(ba_addr));
 
         DPRINT_ASSERT(wr_cam->GetCamEntry(updated_cam_index)->sdram_addr.real_ba == ba_addr,"Wr Ntt Update:",
         "ba_addr mismatch, the write updated cam index ba is %d, but the bsc ba_addr is %ld",(wr_cam->GetCamEntry(updated_cam_index)->sdram_addr.real_ba),ba_addr);
 
-        sc_core::sc_time updating_time = sc_core::sc_time_stamp() + mc_cycle_time;
+        Tick updating_time = mc_clock.Now() + Ntt::kUpdateLatency;
         ntt_store.RecordNttsBsc(false,bsc_index,updating_time);
         ntt_store.WrNttStore(bsc_index,update_type,updated_cam_index,
         updating_time);
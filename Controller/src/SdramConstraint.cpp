@@ -18,45 +18,46 @@ using namespace sc_core;
 SdramConstraintDDR5_3ds::SdramConstraintDDR5_3ds(const DDR5MemSpec3ds& ddr5_memspec_3ds)
 : _ddr5_memspec_3ds(ddr5_memspec_3ds)
 , is_x4_device(_ddr5_memspec_3ds.width == 4)
+, mc_clock(ddr5_memspec_3ds.tCK_mc)
 {
 
-    previous_command_time4bank = std::vector<std::vector<sc_time>>(Command::NumOfCommands(),
-                                 std::vector<sc_time>(_ddr5_memspec_3ds.NumOfTotalBanks,MaxTime));
+    previous_command_time4bank = std::vector<std::vector<Tick>>(Command::NumOfCommands(),
+                                 std::vector<Tick>(_ddr5_memspec_3ds.NumOfTotalBanks,MaxTime));
 
-    previous_command_time4bg = std::vector<std::vector<sc_time>>(Command::NumOfCommands(),
-                               std::vector<sc_time>(_ddr5_memspec_3ds.NumOfTotalBankGroups,MaxTime));
+    previous_command_time4bg = std::vector<std::vector<Tick>>(Command::NumOfCommands(),
+                               std::vector<Tick>(_ddr5_memspec_3ds.NumOfTotalBankGroups,MaxTime));
 
-    previous_command_time4lrank = std::vector<std::vector<sc_time>>(Command::NumOfCommands(),
-                                  std::vector<sc_time>(_ddr5_memspec_3ds.TotalNumOfLogicalRanks,MaxTime));
+    previous_command_time4lrank = std::vector<std::vector<Tick>>(Command::NumOfCommands(),
+                                  std::vector<Tick>(_ddr5_memspec_3ds.TotalNumOfLogicalRanks,MaxTime));
 
-    previous_command_time4prank = std::vector<std::vector<sc_time>>(Command::NumOfCommands(),
-                                  std::vector<sc_time>(_ddr5_memspec_3ds.NumOfPhysicalRanksPerChannel,MaxTime));
+    previous_command_time4prank = std::vector<std::vector<Tick>>(Command::NumOfCommands(),
+                                  std::vector<Tick>(_ddr5_memspec_3ds.NumOfPhysicalRanksPerChannel,MaxTime));
 
-    previous_command_time4prank_lrank = std::vector<std::vector<std::vector<sc_time>>>(Command::NumOfCommands(),
-                                        std::vector<std::vector<sc_time>>(_ddr5_memspec_3ds.NumOfPhysicalRanksPerChannel,
-                                        std::vector<sc_time>(_ddr5_memspec_3ds.NumOfLogicalRanksPerPhysicalRank,MaxTime))
+    previous_command_time4prank_lrank = std::vector<std::vector<std::vector<Tick>>>(Command::NumOfCommands(),
+                                        std::vector<std::vector<Tick>>(_ddr5_memspec_3ds.NumOfPhysicalRanksPerChannel,
+                                        std::vector<Tick>(_ddr5_memspec_3ds.NumOfLogicalRanksPerPhysicalRank,MaxTime))
                                         );
 
-    previous_command_time4channel_prank = std::vector<std::vector<std::vector<sc_time>>>(Command::NumOfCommands(),
-                                          std::vector<std::vector<sc_time>>(_ddr5_memspec_3ds.NumOfChannels,
-                                          std::vector<sc_time>(_ddr5_memspec_3ds.NumOfPhysicalRanksPerChannel,MaxTime))
+    previous_command_time4channel_prank = std::vector<std::vector<std::vector<Tick>>>(Command::NumOfCommands(),
+                                          std::vector<std::vector<Tick>>(_ddr5_memspec_3ds.NumOfChannels,
+                                          std::vector<Tick>(_ddr5_memspec_3ds.NumOfPhysicalRanksPerChannel,MaxTime))
                                           );
 
 
-    previous_command_time4channel = std::vector<std::vector<sc_core::sc_time>>(Command::NumOfCommands(),
-                                    std::vector<sc_time>(_ddr5_memspec_3ds.NumOfSubChannels,MaxTime));
+    previous_command_time4channel = std::vector<std::vector<Tick>>(Command::NumOfCommands(),
+                                    std::vector<Tick>(_ddr5_memspec_3ds.NumOfSubChannels,MaxTime));
 
-    previous_command_time4channel_onbus = std::vector<sc_core::sc_time>(_ddr5_memspec_3ds.NumOfSubChannels,MaxTime);
+    previous_command_time4channel_onbus = std::vector<Tick>(_ddr5_memspec_3ds.NumOfSubChannels,MaxTime);
 
     // 修正初始化方式，确保容器正确初始化
-    last_4Activates4lrank = std::vector<std::deque<sc_time>>(_ddr5_memspec_3ds.TotalNumOfLogicalRanks,std::deque(4,MaxTime));
-    last_4Activates4prank = std::vector<std::deque<sc_time>>(_ddr5_memspec_3ds.NumOfPhysicalRanksPerChannel,std::deque(4,MaxTime));
+    last_4Activates4lrank = std::vector<std::deque<Tick>>(_ddr5_memspec_3ds.TotalNumOfLogicalRanks,std::deque(4,MaxTime));
+    last_4Activates4prank = std::vector<std::deque<Tick>>(_ddr5_memspec_3ds.NumOfPhysicalRanksPerChannel,std::deque(4,MaxTime));
 
 }
 
 
 
-sc_core::sc_time
+Tick
 SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress address) const
 {
     BankIndex command_bank = address.real_ba;
@@ -74,8 +75,8 @@ SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress ad
     assert(command_lrank < _ddr5_memspec_3ds.TotalNumOfLogicalRanks);
     assert(command_prank < _ddr5_memspec_3ds.NumOfPhysicalRanksPerChannel);
 
-    sc_time previous_cmd_record_time;
-    sc_time command_avail_time = sc_time_stamp();
+    Tick previous_cmd_record_time;
+    Tick command_avail_time = mc_clock.Now();
 
     if(command == Command::RFMab)
         command = Command::REFab;
@@ -87,45 +88,44 @@ SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress ad
         previous_cmd_record_time = previous_command_time4bank[Command::PRE][command_bank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRP_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRP_mc);
         }
 
         previous_cmd_record_time = previous_command_time4bank[Command::PREsb][command_bank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRP_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRP_mc);
         }
 
         previous_cmd_record_time = previous_command_time4lrank[Command::PREab][command_lrank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRP_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRP_mc);
         }
 
         previous_cmd_record_time = previous_command_time4bank[Command::ACT][command_bank];
         if(previous_cmd_record_time != MaxTime)
         {
             command_avail_time = std::max(command_avail_time, previous_cmd_record_time +
-                                        _ddr5_memspec_3ds.tRCD_mc + _ddr5_memspec_3ds.tRASmin_mc);
+                                        _ddr5_memspec_3ds.nRCD_mc + _ddr5_memspec_3ds.nRASmin_mc);
         }
 
         previous_cmd_record_time = previous_command_time4bg[Command::ACT][command_bg];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRRD_L_slr_mc);
-        // assert((command_avail_time % _ddr5_memspec_3ds.tCK_mc) == sc_core::SC_ZERO_TIME);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRRD_L_slr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4lrank[Command::ACT][command_lrank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRRD_S_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRRD_S_slr_mc);
         }
 
         // previous_cmd_record_time = previous_command_time4prank[Command::ACT][command_prank];
         // if(previous_cmd_record_time != MaxTime)
         // {
-        //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRRD_dlr_mc);
+        //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRRD_dlr_mc);
         // }
 
         for(int i=0; i< _ddr5_memspec_3ds.NumOfLogicalRanksPerPhysicalRank; i++)
@@ -137,7 +137,7 @@ SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress ad
             previous_cmd_record_time = previous_command_time4prank_lrank[Command::ACT][command_prank][i];
             if(previous_cmd_record_time != MaxTime)
             {
-                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRRD_dlr_mc);
+                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRRD_dlr_mc);
             }
         }
 
@@ -146,9 +146,8 @@ SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress ad
             previous_cmd_record_time = last_4Activates4lrank[command_lrank].front();
             if(previous_cmd_record_time != MaxTime)
             {
-                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tFAW_slr_mc);
+                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nFAW_slr_mc);
             }
-            assert((command_avail_time % _ddr5_memspec_3ds.tCK_mc) == sc_core::SC_ZERO_TIME);
         }
 
         if(last_4Activates4prank[command_prank].size()>=4)
@@ -157,21 +156,20 @@ SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress ad
             if(previous_cmd_record_time != MaxTime)
             {
                 command_avail_time = std::max(command_avail_time, last_4Activates4prank[command_prank].front()
-                                                                + _ddr5_memspec_3ds.tFAW_dlr_mc);
+                                                                + _ddr5_memspec_3ds.nFAW_dlr_mc);
             }
-            assert((command_avail_time % _ddr5_memspec_3ds.tCK_mc) == sc_core::SC_ZERO_TIME);
         }
 
         previous_cmd_record_time = previous_command_time4lrank[Command::REFab][command_lrank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFC_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFC_slr_mc);
         }
 
         // previous_cmd_record_time = previous_command_time4prank[Command::REFab][command_prank];
         // if(previous_cmd_record_time != MaxTime)
         // {
-        //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFC_dlr_mc);
+        //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFC_dlr_mc);
         // }
 
         for(int i=0; i< _ddr5_memspec_3ds.NumOfLogicalRanksPerPhysicalRank; i++)
@@ -183,14 +181,14 @@ SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress ad
             previous_cmd_record_time = previous_command_time4prank_lrank[Command::REFab][command_prank][i];
             if(previous_cmd_record_time != MaxTime)
             {
-                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFC_dlr_mc);
+                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFC_dlr_mc);
             }
         }
 
         // previous_cmd_record_time = previous_command_time4channel[Command::REFab][command_ch];
         // if(previous_cmd_record_time != MaxTime)
         // {
-        //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFC_dpr_mc);
+        //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFC_dpr_mc);
         // }
         for(int i=0; i< _ddr5_memspec_3ds.NumOfPhysicalRanksPerChannel; i++)
         {
@@ -201,26 +199,26 @@ SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress ad
             previous_cmd_record_time = previous_command_time4channel_prank[Command::REFab][command_ch][i];
             if(previous_cmd_record_time != MaxTime)
             {
-                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFC_dpr_mc);
+                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFC_dpr_mc);
             }
         }
 
         previous_cmd_record_time = previous_command_time4bank[Command::REFsb][command_bank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFCsb_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFCsb_slr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4bg[Command::REFsb][command_bg];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tREFSBRD_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nREFSBRD_slr_mc);
         }
 
         // previous_cmd_record_time = previous_command_time4prank[Command::REFsb][command_prank];
         // if(previous_cmd_record_time != MaxTime)
         // {
-        //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tREFSBRD_dlr_mc);
+        //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nREFSBRD_dlr_mc);
         // }
         for(int i=0; i< _ddr5_memspec_3ds.NumOfLogicalRanksPerPhysicalRank; i++)
         {
@@ -231,7 +229,7 @@ SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress ad
             previous_cmd_record_time = previous_command_time4prank_lrank[Command::REFsb][command_prank][i];
             if(previous_cmd_record_time != MaxTime)
             {
-                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tREFSBRD_dlr_mc);
+                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nREFSBRD_dlr_mc);
             }
         }
 
@@ -239,15 +237,14 @@ SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress ad
         if(previous_cmd_record_time != MaxTime)
         {
             command_avail_time = std::max(command_avail_time, previous_cmd_record_time +
-                                        _ddr5_memspec_3ds.tRTP_slr_mc + _ddr5_memspec_3ds.tRP_mc);
-            // assert((command_avail_time % _ddr5_memspec_3ds.tCK_mc) == sc_core::SC_ZERO_TIME);
+                                        _ddr5_memspec_3ds.nRTP_slr_mc + _ddr5_memspec_3ds.nRP_mc);
         }
 
         previous_cmd_record_time = previous_command_time4bank[Command::WRA][command_bank];
         if(previous_cmd_record_time != MaxTime)
         {
             command_avail_time = std::max(command_avail_time, previous_cmd_record_time +
-                                        _ddr5_memspec_3ds.tCWL_mc + _ddr5_memspec_3ds.tBurst_mc + _ddr5_memspec_3ds.tWR_slr_mc + _ddr5_memspec_3ds.tRP_mc);
+                                        _ddr5_memspec_3ds.nCWL_mc + _ddr5_memspec_3ds.nBurst_mc + _ddr5_memspec_3ds.nWR_slr_mc + _ddr5_memspec_3ds.nRP_mc);
         }
 
     }
@@ -256,55 +253,55 @@ SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress ad
         previous_cmd_record_time = previous_command_time4bg[Command::PRE][command_bg];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tPPD_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nPPD_slr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4lrank[Command::PRE][command_lrank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tPPD_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nPPD_slr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4prank[Command::PRE][command_prank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tPPD_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nPPD_dlr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4bg[Command::PREsb][command_bg];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tPPD_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nPPD_slr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4prank[Command::PREsb][command_prank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tPPD_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nPPD_dlr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4prank[Command::PREab][command_prank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tPPD_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nPPD_dlr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4bank[Command::ACT][command_bank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRASmin_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRASmin_mc);
         }
 
         previous_cmd_record_time = previous_command_time4bank[Command::RD][command_bank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRTP_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRTP_slr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4bank[Command::WR][command_bank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tWR_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nWR_slr_mc);
         }
     }
     else if(command == Command::PREsb)
@@ -312,31 +309,31 @@ SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress ad
         previous_cmd_record_time = previous_command_time4lrank[Command::PRE][command_lrank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tPPD_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nPPD_slr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4prank[Command::PRE][command_prank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tPPD_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nPPD_dlr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4lrank[Command::PREsb][command_lrank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tPPD_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nPPD_slr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4prank[Command::PREsb][command_prank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tPPD_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nPPD_dlr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4prank[Command::PREab][command_prank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tPPD_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nPPD_dlr_mc);
         }
 
         for(const auto& bank_sbg: this->GetSameBgBankVec(address))
@@ -344,19 +341,19 @@ SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress ad
             previous_cmd_record_time = previous_command_time4bank[Command::ACT][bank_sbg];
             if(previous_cmd_record_time != MaxTime)
             {
-                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRASmin_mc);
+                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRASmin_mc);
             }
 
             previous_cmd_record_time = previous_command_time4bank[Command::RD][bank_sbg];
             if(previous_cmd_record_time != MaxTime)
             {
-                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRTP_slr_mc);
+                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRTP_slr_mc);
             }
 
             previous_cmd_record_time = previous_command_time4bank[Command::WR][bank_sbg];
             if(previous_cmd_record_time != MaxTime)
             {
-                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tWR_slr_mc);
+                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nWR_slr_mc);
             }
         }
     }
@@ -365,49 +362,49 @@ SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress ad
         previous_cmd_record_time = previous_command_time4lrank[Command::PRE][command_lrank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tPPD_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nPPD_slr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4prank[Command::PRE][command_prank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tPPD_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nPPD_dlr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4lrank[Command::PREsb][command_lrank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tPPD_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nPPD_slr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4prank[Command::PREsb][command_prank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tPPD_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nPPD_dlr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4prank[Command::PREab][command_prank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tPPD_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nPPD_dlr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4lrank[Command::ACT][command_lrank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRASmin_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRASmin_mc);
         }
 
         previous_cmd_record_time = previous_command_time4lrank[Command::RD][command_lrank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRTP_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRTP_slr_mc);
         }
 
         previous_cmd_record_time = previous_command_time4lrank[Command::WR][command_lrank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tWR_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nWR_slr_mc);
         }
     }
     else if(command == Command::REFab)
@@ -415,25 +412,25 @@ SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress ad
         previous_cmd_record_time = previous_command_time4lrank[Command::PRE][command_lrank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRP_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRP_mc);
         }
 
         previous_cmd_record_time = previous_command_time4lrank[Command::PREab][command_lrank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRP_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRP_mc);
         }
 
         previous_cmd_record_time = previous_command_time4lrank[Command::PREsb][command_lrank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRP_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRP_mc);
         }
 
         previous_cmd_record_time = previous_command_time4lrank[Command::REFsb][command_lrank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFCsb_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFCsb_slr_mc);
         }
 
         for(int i=0; i< _ddr5_memspec_3ds.NumOfLogicalRanksPerPhysicalRank; i++)
@@ -445,42 +442,42 @@ SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress ad
             previous_cmd_record_time = previous_command_time4prank_lrank[Command::REFsb][command_prank][i];
             if(previous_cmd_record_time != MaxTime)
             {
-                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFCsb_dlr_mc);
+                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFCsb_dlr_mc);
             }
             previous_cmd_record_time = previous_command_time4prank_lrank[Command::REFab][command_prank][i];
             if(previous_cmd_record_time != MaxTime)
             {
-                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFC_dlr_mc);
+                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFC_dlr_mc);
             }
             previous_cmd_record_time = previous_command_time4prank_lrank[Command::ACT][command_prank][i];
             if(previous_cmd_record_time != MaxTime)
             {
-                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRRD_dlr_mc);
+                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRRD_dlr_mc);
             }
         }
 
         // previous_cmd_record_time = previous_command_time4prank[Command::REFsb][command_prank];
         // if(previous_cmd_record_time != MaxTime)
         // {
-        //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFCsb_dlr_mc);
+        //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFCsb_dlr_mc);
         // }
 
         previous_cmd_record_time = previous_command_time4lrank[Command::REFab][command_lrank];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFC_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFC_slr_mc);
         }
 
         // previous_cmd_record_time = previous_command_time4prank[Command::REFab][command_prank];
         // if(previous_cmd_record_time != MaxTime)
         // {
-        //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFC_dlr_mc);
+        //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFC_dlr_mc);
         // }
 
         // previous_cmd_record_time = previous_command_time4channel[Command::REFab][command_ch];
         // if(previous_cmd_record_time != MaxTime)
         // {
-        //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFC_dpr_mc);
+        //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFC_dpr_mc);
         // }
         for(int i=0; i< _ddr5_memspec_3ds.NumOfPhysicalRanksPerChannel; i++)
         {
@@ -491,27 +488,27 @@ SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress ad
             previous_cmd_record_time = previous_command_time4channel_prank[Command::REFab][command_ch][i];
             if(previous_cmd_record_time != MaxTime)
             {
-                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFC_dpr_mc);
+                command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFC_dpr_mc);
             }
     }
 
     // previous_cmd_record_time = previous_command_time4lrank[Command::ACT][command_lrank];
     // if(previous_cmd_record_time != MaxTime)
     // {
-    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRRD_dlr_mc);
+    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRRD_dlr_mc);
     // }
 
     previous_cmd_record_time = previous_command_time4lrank[Command::RDA][command_lrank];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRTP_slr_mc
-                                                                                   + _ddr5_memspec_3ds.tRP_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRTP_slr_mc
+                                                                                   + _ddr5_memspec_3ds.nRP_mc);
     }
     previous_cmd_record_time = previous_command_time4lrank[Command::WRA][command_lrank];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCWL_mc
-                                                        + _ddr5_memspec_3ds.tBurst_mc + _ddr5_memspec_3ds.tWR_slr_mc + _ddr5_memspec_3ds.tRP_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCWL_mc
+                                                        + _ddr5_memspec_3ds.nBurst_mc + _ddr5_memspec_3ds.nWR_slr_mc + _ddr5_memspec_3ds.nRP_mc);
     }
 
     if(last_4Activates4prank[command_prank].size()>=4)
@@ -520,7 +517,7 @@ SdramConstraintDDR5_3ds::TimeToSatisfyConstraints(Command command,BankAddress ad
         if(previous_cmd_record_time != MaxTime)
         {
             command_avail_time = std::max(command_avail_time, last_4Activates4prank[command_prank].front()
-                                                            + _ddr5_memspec_3ds.tFAW_dlr_mc);
+                                                            + _ddr5_memspec_3ds.nFAW_dlr_mc);
         }
     }
 }
@@ -529,7 +526,7 @@ else if(command == Command::REFsb)
     previous_cmd_record_time = previous_command_time4lrank[Command::REFab][command_lrank];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFC_slr_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFC_slr_mc);
     }
 
     for(int i=0; i< _ddr5_memspec_3ds.NumOfLogicalRanksPerPhysicalRank; i++)
@@ -541,30 +538,30 @@ else if(command == Command::REFsb)
         previous_cmd_record_time = previous_command_time4prank_lrank[Command::REFsb][command_prank][i];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFCsb_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFCsb_dlr_mc);
         }
         previous_cmd_record_time = previous_command_time4prank_lrank[Command::REFab][command_prank][i];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFC_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFC_dlr_mc);
         }
         previous_cmd_record_time = previous_command_time4prank_lrank[Command::ACT][command_prank][i];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRRD_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRRD_dlr_mc);
         }
     }
 
     // previous_cmd_record_time = previous_command_time4prank[Command::REFab][command_prank];
     // if(previous_cmd_record_time != MaxTime)
     // {
-    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFC_dlr_mc);
+    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFC_dlr_mc);
     // }
 
     // previous_cmd_record_time = previous_command_time4channel[Command::REFab][command_ch];
     // if(previous_cmd_record_time != MaxTime)
     // {
-    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFC_dpr_mc);
+    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFC_dpr_mc);
     // }
     for(int i=0; i< _ddr5_memspec_3ds.NumOfPhysicalRanksPerChannel; i++)
     {
@@ -575,32 +572,32 @@ else if(command == Command::REFsb)
         previous_cmd_record_time = previous_command_time4channel_prank[Command::REFab][command_ch][i];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFC_dpr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFC_dpr_mc);
         }
     }
 
     previous_cmd_record_time = previous_command_time4lrank[Command::REFsb][command_lrank];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFCsb_slr_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFCsb_slr_mc);
     }
 
     // previous_cmd_record_time = previous_command_time4prank[Command::REFsb][command_prank];
     // if(previous_cmd_record_time != MaxTime)
     // {
-    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRFCsb_dlr_mc);
+    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRFCsb_dlr_mc);
     // }
 
     previous_cmd_record_time = previous_command_time4lrank[Command::ACT][command_lrank];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRRD_L_slr_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRRD_L_slr_mc);
     }
 
     // previous_cmd_record_time = previous_command_time4prank[Command::ACT][command_prank];
     // if(previous_cmd_record_time != MaxTime)
     // {
-    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRRD_dlr_mc);
+    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRRD_dlr_mc);
     // }
 
     for(const auto& ba: this->GetSameBgBankVec(address))
@@ -608,15 +605,15 @@ else if(command == Command::REFsb)
         previous_cmd_record_time = previous_command_time4bank[Command::RDA][ba];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRTP_slr_mc
-                                                                                       + _ddr5_memspec_3ds.tRP_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRTP_slr_mc
+                                                                                       + _ddr5_memspec_3ds.nRP_mc);
         }
 
         previous_cmd_record_time = previous_command_time4bank[Command::WRA][ba];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCWL_mc
-                                                            + _ddr5_memspec_3ds.tBurst_mc + _ddr5_memspec_3ds.tWR_slr_mc + _ddr5_memspec_3ds.tRP_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCWL_mc
+                                                            + _ddr5_memspec_3ds.nBurst_mc + _ddr5_memspec_3ds.nWR_slr_mc + _ddr5_memspec_3ds.nRP_mc);
         }
     }
 
@@ -625,8 +622,8 @@ else if(command == Command::REFsb)
         previous_cmd_record_time = last_4Activates4lrank[command_lrank].front();
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, last_4Activates4lrank[command_prank].front()
-                                                            + _ddr5_memspec_3ds.tFAW_slr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time
+                                                            + _ddr5_memspec_3ds.nFAW_slr_mc);
         }
     }
 
@@ -636,7 +633,7 @@ else if(command == Command::REFsb)
         if(previous_cmd_record_time != MaxTime)
         {
             command_avail_time = std::max(command_avail_time, last_4Activates4prank[command_prank].front()
-                                                            + _ddr5_memspec_3ds.tFAW_dlr_mc);
+                                                            + _ddr5_memspec_3ds.nFAW_dlr_mc);
         }
     }
 }
@@ -645,65 +642,65 @@ else if(command == Command::RD || command == Command::RDA)
     previous_cmd_record_time = previous_command_time4bank[Command::ACT][command_bank];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRCD_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRCD_mc);
     }
 
     previous_cmd_record_time = previous_command_time4bg[Command::RD][command_bg];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_L_slr_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_L_slr_mc);
     }
 
     previous_cmd_record_time = previous_command_time4lrank[Command::RD][command_lrank];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_S_slr_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_S_slr_mc);
     }
 
     // previous_cmd_record_time = previous_command_time4prank[Command::RD][command_prank];
     // if(previous_cmd_record_time != MaxTime)
     // {
-    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_dlr_mc);
+    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_dlr_mc);
     // }
 
     // same sub-channel, though has no time constraint, should also limited to tburst length
     previous_cmd_record_time = previous_command_time4channel[Command::RD][command_ch];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tBurst_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nBurst_mc);
     }
     previous_cmd_record_time = previous_command_time4channel[Command::RDA][command_ch];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tBurst_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nBurst_mc);
     }
     previous_cmd_record_time = previous_command_time4channel[Command::WR][command_ch];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tBurst_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nBurst_mc);
     }
     previous_cmd_record_time = previous_command_time4channel[Command::WRA][command_ch];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tBurst_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nBurst_mc);
     }
 
     previous_cmd_record_time = previous_command_time4bg[Command::WR][command_bg];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_L_WTR_slr_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_L_WTR_slr_mc);
     }
 
     previous_cmd_record_time = previous_command_time4lrank[Command::WR][command_lrank];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_S_WTR_slr_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_S_WTR_slr_mc);
     }
 
     // previous_cmd_record_time = previous_command_time4prank[Command::WR][command_prank];
     // if(previous_cmd_record_time != MaxTime)
     // {
-    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_WTR_dlr_mc);
+    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_WTR_dlr_mc);
     // }
 
     for(int i=0; i< _ddr5_memspec_3ds.NumOfLogicalRanksPerPhysicalRank; i++)
@@ -715,59 +712,59 @@ else if(command == Command::RD || command == Command::RDA)
         previous_cmd_record_time = previous_command_time4prank_lrank[Command::RD][command_prank][i];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_dlr_mc);
         }
         previous_cmd_record_time = previous_command_time4prank_lrank[Command::WR][command_prank][i];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_WTR_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_WTR_dlr_mc);
         }
         previous_cmd_record_time = previous_command_time4prank_lrank[Command::RDA][command_prank][i];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_dlr_mc);
         }
         previous_cmd_record_time = previous_command_time4prank_lrank[Command::WRA][command_prank][i];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_WTR_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_WTR_dlr_mc);
         }
     }
 
     previous_cmd_record_time = previous_command_time4bg[Command::RDA][command_bg];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_L_slr_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_L_slr_mc);
     }
 
     previous_cmd_record_time = previous_command_time4lrank[Command::RDA][command_lrank];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_S_slr_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_S_slr_mc);
     }
 
     // previous_cmd_record_time = previous_command_time4prank[Command::RDA][command_prank];
     // if(previous_cmd_record_time != MaxTime)
     // {
-    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_dlr_mc);
+    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_dlr_mc);
     // }
 
     previous_cmd_record_time = previous_command_time4bg[Command::WRA][command_bg];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_L_WTR_slr_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_L_WTR_slr_mc);
     }
 
     previous_cmd_record_time = previous_command_time4lrank[Command::WRA][command_lrank];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_S_WTR_slr_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_S_WTR_slr_mc);
     }
 
     // previous_cmd_record_time = previous_command_time4prank[Command::WRA][command_prank];
     // if(previous_cmd_record_time != MaxTime)
     // {
-    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_WTR_dlr_mc);
+    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_WTR_dlr_mc);
     // }
 }
 else if(command == Command::WR || command == Command::WRA)
@@ -775,32 +772,32 @@ else if(command == Command::WR || command == Command::WRA)
     previous_cmd_record_time = previous_command_time4bank[Command::ACT][command_bank];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tRCD_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nRCD_mc);
     }
 
     previous_cmd_record_time = previous_command_time4bg[Command::WR][command_bg];
     if(previous_cmd_record_time != MaxTime)
     {
         command_avail_time = std::max(command_avail_time, previous_cmd_record_time +
-                                    (is_x4_device ? _ddr5_memspec_3ds.tCCD_L_WR_slr_mc : _ddr5_memspec_3ds.tCCD_L_WR2_slr_mc));
+                                    (is_x4_device ? _ddr5_memspec_3ds.nCCD_L_WR_slr_mc : _ddr5_memspec_3ds.nCCD_L_WR2_slr_mc));
     }
 
     previous_cmd_record_time = previous_command_time4lrank[Command::WR][command_lrank];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_S_WR_slr_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_S_WR_slr_mc);
     }
 
     // previous_cmd_record_time = previous_command_time4prank[Command::WR][command_prank];
     // if(previous_cmd_record_time != MaxTime)
     // {
-    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_WR_dlr_mc);
+    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_WR_dlr_mc);
     // }
 
     // previous_cmd_record_time = previous_command_time4channel[Command::WR][command_ch];
     // if(previous_cmd_record_time != MaxTime)
     // {
-    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_WR_dpr_mc);
+    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_WR_dpr_mc);
     // }
     for(int i=0; i< _ddr5_memspec_3ds.NumOfPhysicalRanksPerChannel; i++)
     {
@@ -811,53 +808,53 @@ else if(command == Command::WR || command == Command::WRA)
         previous_cmd_record_time = previous_command_time4channel_prank[Command::WR][command_ch][i];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_WR_dpr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_WR_dpr_mc);
         }
         previous_cmd_record_time = previous_command_time4channel_prank[Command::WRA][command_ch][i];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_WR_dpr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_WR_dpr_mc);
         }
     }
 
     previous_cmd_record_time = previous_command_time4bg[Command::RD][command_bg];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_L_RTW_slr_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_L_RTW_slr_mc);
     }
 
     previous_cmd_record_time = previous_command_time4lrank[Command::RD][command_lrank];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_S_RTW_slr_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_S_RTW_slr_mc);
     }
 
     // previous_cmd_record_time = previous_command_time4prank[Command::RD][command_prank];
     // if(previous_cmd_record_time != MaxTime)
     // {
-    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_RTW_dlr_mc);
+    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_RTW_dlr_mc);
     // }
 
     // same sub-channel, though has no time constraint, should also limited to tburst length
     previous_cmd_record_time = previous_command_time4channel[Command::RD][command_ch];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tBurst_mc + _ddr5_memspec_3ds.tCK_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nBurst_mc + 1);
     }
     previous_cmd_record_time = previous_command_time4channel[Command::RDA][command_ch];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tBurst_mc + _ddr5_memspec_3ds.tCK_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nBurst_mc + 1);
     }
     previous_cmd_record_time = previous_command_time4channel[Command::WR][command_ch];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tBurst_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nBurst_mc);
     }
     previous_cmd_record_time = previous_command_time4channel[Command::WRA][command_ch];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tBurst_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nBurst_mc);
     }
 
     for(int i=0; i< _ddr5_memspec_3ds.NumOfLogicalRanksPerPhysicalRank; i++)
@@ -869,22 +866,22 @@ else if(command == Command::WR || command == Command::WRA)
         previous_cmd_record_time = previous_command_time4prank_lrank[Command::RD][command_prank][i];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_RTW_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_RTW_dlr_mc);
         }
         previous_cmd_record_time = previous_command_time4prank_lrank[Command::WR][command_prank][i];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_WR_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_WR_dlr_mc);
         }
         previous_cmd_record_time = previous_command_time4prank_lrank[Command::RDA][command_prank][i];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_RTW_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_RTW_dlr_mc);
         }
         previous_cmd_record_time = previous_command_time4prank_lrank[Command::WRA][command_prank][i];
         if(previous_cmd_record_time != MaxTime)
         {
-            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_WR_dlr_mc);
+            command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_WR_dlr_mc);
         }
     }
 
@@ -892,43 +889,43 @@ else if(command == Command::WR || command == Command::WRA)
     if(previous_cmd_record_time != MaxTime)
     {
         command_avail_time = std::max(command_avail_time, previous_cmd_record_time +
-                                    (is_x4_device ? _ddr5_memspec_3ds.tCCD_L_WR_slr_mc : _ddr5_memspec_3ds.tCCD_L_WR2_slr_mc));
+                                    (is_x4_device ? _ddr5_memspec_3ds.nCCD_L_WR_slr_mc : _ddr5_memspec_3ds.nCCD_L_WR2_slr_mc));
     }
 
     previous_cmd_record_time = previous_command_time4lrank[Command::WRA][command_lrank];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_S_WR_slr_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_S_WR_slr_mc);
     }
 
     // previous_cmd_record_time = previous_command_time4prank[Command::WRA][command_prank];
     // if(previous_cmd_record_time != MaxTime)
     // {
-    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_WR_dlr_mc);
+    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_WR_dlr_mc);
     // }
 
     // previous_cmd_record_time = previous_command_time4channel[Command::WRA][command_ch];
     // if(previous_cmd_record_time != MaxTime)
     // {
-    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_WR_dpr_mc);
+    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_WR_dpr_mc);
     // }
 
     previous_cmd_record_time = previous_command_time4bg[Command::RDA][command_bg];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_L_RTW_slr_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_L_RTW_slr_mc);
     }
 
     previous_cmd_record_time = previous_command_time4lrank[Command::RDA][command_lrank];
     if(previous_cmd_record_time != MaxTime)
     {
-        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_S_RTW_slr_mc);
+        command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_S_RTW_slr_mc);
     }
 
     // previous_cmd_record_time = previous_command_time4prank[Command::RDA][command_prank];
     // if(previous_cmd_record_time != MaxTime)
     // {
-    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.tCCD_RTW_dlr_mc);
+    //     command_avail_time = std::max(command_avail_time, previous_cmd_record_time + _ddr5_memspec_3ds.nCCD_RTW_dlr_mc);
     // }
 }
 else
@@ -937,12 +934,7 @@ else
 }
 if(previous_command_time4channel_onbus[command_ch] != MaxTime)
 {
-    command_avail_time = std::max(command_avail_time, previous_command_time4channel_onbus[command_ch] + _ddr5_memspec_3ds.tCK_mc);
-}
-if(command_avail_time != MaxTime)
-{
-    // assert((command_avail_time % _ddr5_memspec_3ds.tCK_mc) == sc_core::SC_ZERO_TIME);
-    DPRINT_ASSERT((command_avail_time % _ddr5_memspec_3ds.tCK_mc) == sc_core::SC_ZERO_TIME,"SDRAM constraint","%s command_avail_time:%s",command.to_string().c_str(),command_avail_time.to_string().c_str());
+    command_avail_time = std::max(command_avail_time, previous_command_time4channel_onbus[command_ch] + 1);
 }
 return command_avail_time;
 }
@@ -964,8 +956,8 @@ SdramConstraintDDR5_3ds::InsertCommand(Command command,BankAddress address)
     if(command == Command::RFMsb)
         command = Command::REFsb;
 
-    sc_time record_time = sc_time_stamp();
-    assert((record_time % _ddr5_memspec_3ds.tCK_mc) == sc_core::SC_ZERO_TIME);
+    assert(mc_clock.IsAligned());
+    Tick record_time = mc_clock.Now();
     previous_command_time4lrank[command][command_lrank] = record_time;
     previous_command_time4prank[command][command_prank] = record_time;
     previous_command_time4channel[command][command_ch] = record_time;
@@ -0,0 +1,53 @@
+#include <algorithm>
+
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+#include <systemc>
+
+#include "Controller/SdramConstraint.hh"
+#include "Common/CommonDefine.hh"
+#include "Configure/DDR5MemSpec3ds.hh"
+#include "Controller/common/Command.hh"
+
+
+namespace dmu{
+    namespace Controller{
+
+template class SdramConstraintTable<DDR5MemSpec3ds, timing::kDDR5_3dsTimingRules>;
+
+SdramConstraintDiffCheck::SdramConstraintDiffCheck(const DDR5MemSpec3ds& ddr5_memspec_3ds)
+: pull_constraint(ddr5_memspec_3ds)
+, push_constraint(ddr5_memspec_3ds)
+{
+}
+
+SdramConstraintDiffCheck::~SdramConstraintDiffCheck()
+{
+    std::cout << "[SdramConstraintDiffCheck] " << num_of_checks << " timing queries matched" << std::endl;
+}
+
+Tick
+SdramConstraintDiffCheck::TimeToSatisfyConstraints(Command command,BankAddress address) const
+{
+    Tick pull_time = pull_constraint.TimeToSatisfyConstraints(command, address);
+    Tick push_time = push_constraint.TimeToSatisfyConstraints(command, address);
+    if(pull_time != push_time)
+    {
+        std::cerr << "SdramConstraintDiffCheck: @" << sc_core::sc_time_stamp() << " command: " << command.to_string()
+                  << " " << address << " pull model: " << pull_time << " push model: " << push_time << std::endl;
+        std::abort();
+    }
+    num_of_checks++;
+    return pull_time;
+}
+
+void
+SdramConstraintDiffCheck::InsertCommand(Command command,BankAddress address)
+{
+    pull_constraint.InsertCommand(command, address);
+    push_constraint.InsertCommand(command, address);
+}
+
+    }// Controller
+}// dmu
@@ -13,17 +13,10 @@ void
 WrCam::StoreRequest(InputProcessReq& wr_request)
 {
     DPRINT_INFO(WR_CAM, "Wr Cam", "call Wr Cam Store Request");
-    used_allocated_cam_index.insert(wr_request.cam_index);
-    cam_order_list.push_back(wr_request.cam_index);
-
-    // add the cmd into ba-addr based order list
-    if(ba_cmds_order_list.find(wr_request.sdram_addr.real_ba) == ba_cmds_order_list.end())
-    {
-        ba_cmds_order_list.emplace(wr_request.sdram_addr.real_ba,std::list<CAM_INDEX>());
-    }
-    ba_cmds_order_list[wr_request.sdram_addr.real_ba].push_back(wr_request.cam_index);
-    assert(cam_store.size() < cam_depth);
-    cam_store.emplace(wr_request.cam_index,std::make_unique<WrCamEntry>(wr_request));
+    // construct the entry in its slot, then link it into the entering order and ba order list
+    assert(wr_request.cam_index < cam_depth && !wr_cam_slot[wr_request.cam_index]);
+    WrCamEntry& wr_cam_entry = wr_cam_slot[wr_request.cam_index].emplace(wr_request);
+    LinkCamEntry(wr_request.cam_index, &wr_cam_entry);
     UpdateTpwCamFull();
     UpdateTpwFillLevel();
 }
@@ -31,9 +24,7 @@ WrCam::StoreRequest(InputProcessReq& wr_request)
 void
 WrCam::DeleteCamEntry(CAM_INDEX removed_cam_index)
 {
-    used_allocated_cam_index.erase(removed_cam_index);
     WrCamEntry* removed_wr_cam_entry = GetCamEntry(removed_cam_index);
-    RealBaIndex removed_wr_cam_entry_ba_addr = removed_wr_cam_entry->GetCamEntryRealBa();
 
     if(removed_wr_cam_entry->IsAddrCollision())
     {
@@ -41,9 +32,8 @@ WrCam::DeleteCamEntry(CAM_INDEX removed_cam_index)
                                          collision_wr_cam_index_vec.end(),removed_cam_index),collision_wr_cam_index_vec.end());
     }
 
-    ba_cmds_order_list[removed_wr_cam_entry_ba_addr].remove(removed_cam_index);
-    cam_order_list.remove(removed_cam_index);
-    cam_store.erase(removed_cam_index);
+    UnlinkCamEntry(removed_cam_index);
+    wr_cam_slot[removed_cam_index].reset();
     UpdateTpwCamFull();
     UpdateTpwFillLevel();
 }
@@ -52,8 +42,7 @@ OrderList
 WrCam::GetAvailBaOrderList(RealBaIndex ba_addr)
 {
     OrderList aval_ba_order_list;
-    auto ba_list = this->ba_cmds_order_list.at(ba_addr);
-    for(auto cam_index : ba_list)
+    for(auto cam_index : this->GetBaOrderList(ba_addr))
     {
         // FIX: Wr cmd should also be data ready
         if(GetCamEntry(cam_index)->is_allocated && GetCamEntry(cam_index)->data_ready)
@@ -69,8 +58,7 @@ WrCam::IsAvailBaOrderListEmpty(RealBaIndex ba_addr)
         return true;
     else
     {
-        auto ba_list = this->ba_cmds_order_list.at(ba_addr);
-        for(auto cam_index : ba_list)
+        for(auto cam_index : this->GetBaOrderList(ba_addr))
         {
             // FIX: Wr cmd should also be data ready
             if(GetCamEntry(cam_index)->is_allocated && GetCamEntry(cam_index)->data_ready)
@@ -84,9 +72,9 @@ bool
 WrCam::IsWrCamExpired() const
 {
     return this->is_cam_expired; // 原图中这行被后面覆盖了逻辑
-    for(auto cam_index: used_allocated_cam_index)
+    for(auto& wr_cam_entry: wr_cam_slot)
     {
-        if(cam_store.at(cam_index)->IsExpired())
+        if(wr_cam_entry && wr_cam_entry->IsExpired())
             return true;
     }
     return false;
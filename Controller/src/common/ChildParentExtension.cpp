@@ -71,18 +71,18 @@ ParentExtension::copy_from(const tlm_extension_base& ext)
 
 void
 ParentExtension::SetExtension(tlm::tlm_generic_payload& _parent_trans,
-                              std::vector<tlm::tlm_generic_payload*> _child_transes)
+                              const std::vector<tlm::tlm_generic_payload*>& _child_transes)
 {
     auto* extension = _parent_trans.get_extension<ParentExtension>();
 
     if (extension != nullptr)
     {
-        extension->_child_transes = std::move(_child_transes);
+        extension->_child_transes.assign(_child_transes.begin(), _child_transes.end());
         extension->completed_child_transes = 0;
     }
     else
     {
-        extension = new ParentExtension(std::move(_child_transes));
+        extension = new ParentExtension(_child_transes);
         _parent_trans.set_auto_extension(extension);
     }
 }
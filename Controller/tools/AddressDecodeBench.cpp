@@ -0,0 +1,195 @@
+// address decoder microbenchmark: 原来逐 bit 遍历 vXxxBits 的译码与 AddressDecoder 的 Lut / Pext / decodeBatch 对比
+// ConfigureFile/addressmapping 下的每个 mapping 都跑一遍, 所有实现的译码结果必须完全一致
+// usage: dmu_decode_bench [configure_dir] [rounds]
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <systemc>
+
+#include "Configure/AddressDecoder.hh"
+#include "Configure/DDR5MemSpec3ds.hh"
+#include "Configure/LoadAddressMapConfig.hh"
+#include "Configure/LoadMemSpec.hh"
+
+using namespace dmu;
+
+namespace {
+
+// 一组地址反复译码, 让地址和结果都留在 cache 里, 计时只反映译码本身
+constexpr unsigned kNumOfAddresses = 4096;
+
+struct MappingCase
+{
+    const char* address_mapping_filename;
+    const char* mem_spec_filename;
+};
+
+const MappingCase kMappingCases[] = {
+    {"am_ddr5_16Gbx8_3ds_2H_brc_map2.json", "16Gb_DDR5_6400_B_x8_3DS_2H.json"},
+    {"am_ddr5_16Gbx8_3ds_2H_brc_map7.json", "16Gb_DDR5_6400_B_x8_3DS_2H.json"},
+    {"am_ddr5_16Gbx8_brc_map1.json", "16Gb_DDR5_7200-6400_B_x8.json"},
+    {"am_ddr5_16Gbx8_brc_map5.json", "16Gb_DDR5_7200-6400_B_x8.json"},
+    {"am_ddr5_64Gbx8_3ds_4H_brc.json", "64Gb_DDR5_6400_B_x8_3DS_4H.json"},
+};
+
+// 原 AddressDecoder::decodeAddress 的做法: 每个 field 逐 bit 拼出来
+DecodedAddress
+BitLoopDecode(const AddressMapping& mapping, uint64_t encAddr)
+{
+    DecodedAddress decAddr;
+    for (unsigned it = 0; it < mapping.vChannelBits.size(); it++)
+        decAddr.channel |= ((encAddr >> mapping.vChannelBits[it]) & UINT64_C(1)) << it;
+    for (unsigned it = 0; it < mapping.vCsBits.size(); it++)
+        decAddr.cs |= ((encAddr >> mapping.vCsBits[it]) & UINT64_C(1)) << it;
+    for (unsigned it = 0; it < mapping.vCidBits.size(); it++)
+        decAddr.cid |= ((encAddr >> mapping.vCidBits[it]) & UINT64_C(1)) << it;
+    for (unsigned it = 0; it < mapping.vBankGroupBits.size(); it++)
+        decAddr.bankgroup |= ((encAddr >> mapping.vBankGroupBits[it]) & UINT64_C(1)) << it;
+    for (unsigned it = 0; it < mapping.vBankBits.size(); it++)
+        decAddr.bank |= ((encAddr >> mapping.vBankBits[it]) & UINT64_C(1)) << it;
+    for (unsigned it = 0; it < mapping.vRowBits.size(); it++)
+        decAddr.row |= ((encAddr >> mapping.vRowBits[it]) & UINT64_C(1)) << it;
+    for (unsigned it = 0; it < mapping.vColumnBits.size(); it++)
+        decAddr.column |= ((encAddr >> mapping.vColumnBits[it]) & UINT64_C(1)) << it;
+    for (unsigned it = 0; it < mapping.vByteBits.size(); it++)
+        decAddr.byte |= ((encAddr >> mapping.vByteBits[it]) & UINT64_C(1)) << it;
+
+    decAddr.real_ba  = decAddr.bank | (decAddr.bankgroup << (mapping.vBankBits.size())) |
+                       (decAddr.cid << (mapping.vBankGroupBits.size() + mapping.vBankBits.size())) |
+                       (decAddr.cs << (mapping.vCidBits.size() + mapping.vBankGroupBits.size() + (mapping.vBankBits.size())));
+    decAddr.real_bg  = decAddr.bankgroup | (decAddr.cid << (mapping.vBankGroupBits.size())) |
+                       (decAddr.cs << (mapping.vCidBits.size() + mapping.vBankGroupBits.size()));
+    decAddr.real_cid = decAddr.cid | (decAddr.cs << (mapping.vCidBits.size()));
+    return decAddr;
+}
+
+// operator== 不比较 channel/byte/real_xx (且 bank 与 bankgroup 比较), 这里逐个字段比
+bool
+SameDecode(const DecodedAddress& lhs, const DecodedAddress& rhs)
+{
+    return lhs.channel == rhs.channel && lhs.cs == rhs.cs && lhs.cid == rhs.cid &&
+           lhs.bankgroup == rhs.bankgroup && lhs.bank == rhs.bank && lhs.row == rhs.row &&
+           lhs.column == rhs.column && lhs.byte == rhs.byte && lhs.real_ba == rhs.real_ba &&
+           lhs.real_bg == rhs.real_bg && lhs.real_cid == rhs.real_cid;
+}
+
+uint64_t
+Checksum(uint64_t checksum, const DecodedAddress& decAddr)
+{
+    uint64_t fields[] = {decAddr.channel, decAddr.cs, decAddr.cid, decAddr.bankgroup, decAddr.bank,
+                         decAddr.row, decAddr.column, decAddr.byte, decAddr.real_ba};
+    for (auto field: fields)
+        checksum = checksum * 131 + field;
+    return checksum;
+}
+
+double
+ElapsedNs(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+{
+    return std::chrono::duration<double, std::nano>(end - begin).count();
+}
+
+} // namespace
+
+int
+sc_main(int argc, char** argv)
+{
+    std::string configure_dir = argc > 1 ? argv[1] : "../ConfigureFile";
+    unsigned num_of_rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 500;
+    const double num_of_decodes = static_cast<double>(num_of_rounds) * kNumOfAddresses;
+
+    bool mismatch = false;
+    for (const auto& mapping_case: kMappingCases)
+    {
+        std::filesystem::path base_dir(configure_dir);
+        AddressMapConfig address_map_config((base_dir / AddressMapping::SUB_DIR / mapping_case.address_mapping_filename).string());
+        LoadDDR5MemConfig load_mem_spec((base_dir / DDR5MemSpecBase::SUB_DIR / mapping_case.mem_spec_filename).string());
+        load_mem_spec.ParseJson();
+        const AddressMapping& mapping = address_map_config.address_mapping;
+        // am_ddr5_64Gbx8_3ds_4H_brc.json 只有 16 个 row bit, 与 64Gb memspec 的行数不一致, row 数以 mapping 为准
+        load_mem_spec.mem_spec.Device.NumOfRows = 1u << mapping.vRowBits.size();
+        Controller::DDR5MemSpec3ds mem_spec(load_mem_spec.mem_spec, "./");
+        AddressDecoder decoder(mapping, mem_spec, false);
+
+        std::mt19937_64 rng(2024);
+        std::vector<uint64_t> addresses(kNumOfAddresses);
+        for (auto& address: addresses)
+            address = rng() % (decoder.getMaximumAddress() + 1);
+        std::vector<DecodedAddress> decoded(kNumOfAddresses);
+
+        // 依次是 bit loop, Lut, Pext, decodeBatch (默认方式)
+        // 单个译码的计时区间只把结果折叠进 sink, 不拷贝整个 DecodedAddress; 校验和 checksum 在区间外算
+        const char* names[] = {"bit loop", "lut", "pext", "batch"};
+        double elapsed_ns[4] = {0, 0, 0, 0};
+        uint64_t checksums[4] = {0, 0, 0, 0};
+        bool has_result[4] = {true, true, decoder.isPextAvailable(), true};
+        uint64_t sink = 0;
+        std::vector<DecodedAddress> reference(kNumOfAddresses);
+
+        for (unsigned method = 0; method < 4; method++)
+        {
+            if (!has_result[method])
+                continue;
+            auto decode = [&](uint64_t address) {
+                return method == 0 ? BitLoopDecode(mapping, address) : decoder.decodeAddress(address);
+            };
+            if (method == 1)
+                decoder.setDecodeMethod(AddressDecoder::DecodeMethod::Lut);
+            else if (method == 2 || (method == 3 && decoder.isPextAvailable()))
+                decoder.setDecodeMethod(AddressDecoder::DecodeMethod::Pext);
+
+            auto begin = std::chrono::steady_clock::now();
+            for (unsigned round = 0; round < num_of_rounds; round++)
+            {
+                if (method == 3)
+                {
+                    decoder.decodeBatch(addresses.data(), addresses.size(), decoded.data());
+                    continue;
+                }
+                for (unsigned i = 0; i < kNumOfAddresses; i++)
+                {
+                    DecodedAddress decAddr = decode(addresses[i]);
+                    sink += decAddr.real_ba ^ decAddr.row ^ decAddr.column;
+                }
+            }
+            elapsed_ns[method] = ElapsedNs(begin, std::chrono::steady_clock::now());
+
+            for (unsigned i = 0; i < kNumOfAddresses; i++)
+            {
+                if (method != 3)
+                    decoded[i] = decode(addresses[i]);
+                if (method == 0)
+                    reference[i] = decoded[i];
+                checksums[method] = Checksum(checksums[method], decoded[i]);
+                if (!mismatch && !SameDecode(decoded[i], reference[i]))
+                {
+                    std::cerr << mapping_case.address_mapping_filename << ": " << names[method] << " decode mismatch at address 0x"
+                              << std::hex << addresses[i] << std::dec << std::endl;
+                    mismatch = true;
+                }
+            }
+        }
+
+        std::printf("%s (%u addresses x %u rounds)\n", mapping_case.address_mapping_filename, kNumOfAddresses, num_of_rounds);
+        for (unsigned i = 0; i < 4; i++)
+        {
+            if (!has_result[i])
+            {
+                std::printf("  %-10s unavailable\n", names[i]);
+                continue;
+            }
+            std::printf("  %-10s %8.2f ns/addr  checksum %016" PRIx64 "\n", names[i], elapsed_ns[i] / num_of_decodes, checksums[i]);
+        }
+        if (sink == 0)
+            std::printf("  (sink %" PRIu64 ")\n", sink);
+    }
+    return mismatch ? 1 : 0;
+}
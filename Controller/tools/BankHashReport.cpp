@@ -0,0 +1,280 @@
+// bank hash report: 一组请求地址在不同 bank hash 下的 per-bank 分布
+// 地址来自 UifMaster 的 traffic (Stream_Rd ... Random_Add, all 表示全部) 或者 trace 文件 (每行第一个 token 是地址, # 开头为注释)
+// 每种 hash 都检查 encodeAddress(decodeAddress(addr)) == addr
+// usage: dmu_hash_report [configure_dir] [configure_file] [traffic|trace_file] [detail]
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <systemc>
+
+#include "Common/UifMaster.hh"
+#include "Configure/AddressDecoder.hh"
+#include "Configure/Configure.hh"
+#include "Configure/LoadConfigure.hh"
+
+using namespace dmu;
+
+namespace {
+
+// 连续 kWindow 个请求 (约为一个 cam 的深度) 内访问到的不同 bank 数, 反映 bank 级并行度
+constexpr unsigned kWindow = 64;
+
+const char* kTrafficNames[] = {
+    "Stream_Rd", "Stream_Wr", "Random_Rd", "Random_Wr", "Stream_Copy", "Stream_Add", "Random_Copy", "Random_Add"
+};
+
+struct HashCandidate
+{
+    std::string name;
+    AddressMapping mapping;
+    bool bank_hash_enable;
+};
+
+// 与 UifMaster::RandomAddressGenerator 相同的取法, 种子固定以便结果可复现
+uint64_t
+RandomAddress(std::mt19937& gen, uint64_t low, uint64_t high)
+{
+    std::uniform_int_distribution<uint64_t> dis(low, high);
+    return dis(gen) & ~0x3FULL;
+}
+
+// 与 UifMaster::SendTrans 中各 traffic 的地址序列一致
+std::vector<uint64_t>
+TrafficAddresses(unsigned traffic_type)
+{
+    constexpr uint64_t base_addr0{0x0000'0000};
+    constexpr uint64_t stride{0x40};
+    std::mt19937 gen(2024);
+    std::vector<uint64_t> addresses;
+    switch(traffic_type)
+    {
+        case Stream_Rd:
+        case Stream_Wr:
+            for(unsigned i = 0; i < 10000; i++)
+                addresses.push_back(base_addr0 + stride * i);
+            break;
+        case Random_Rd:
+        case Random_Wr:
+            for(unsigned i = 0; i < 10000; i++)
+                addresses.push_back(RandomAddress(gen, base_addr0, base_addr0 + 0x2000'0000));
+            break;
+        case Stream_Copy:
+        {
+            unsigned trace_length{10240};
+            for(unsigned i = 0; i < trace_length; i++)
+            {
+                addresses.push_back(base_addr0 + i * stride);
+                addresses.push_back(base_addr0 + trace_length * stride * 2 + i * stride);
+            }
+            break;
+        }
+        case Stream_Add:
+        {
+            unsigned trace_length{10240};
+            for(unsigned i = 0; i < trace_length; i++)
+            {
+                addresses.push_back(base_addr0 + i * stride);
+                addresses.push_back(base_addr0 + trace_length * stride * 1 + i * stride);
+                addresses.push_back(base_addr0 + trace_length * stride * 2 + i * stride);
+            }
+            break;
+        }
+        case Random_Copy:
+            for(unsigned i = 0; i < 10240; i++)
+            {
+                addresses.push_back(RandomAddress(gen, base_addr0, base_addr0 + 0x2000'0000));
+                addresses.push_back(RandomAddress(gen, base_addr0 + 0x4000'0000, base_addr0 + 0x6000'0000));
+            }
+            break;
+        case Random_Add:
+            for(unsigned i = 0; i < 10240; i++)
+            {
+                addresses.push_back(RandomAddress(gen, base_addr0, base_addr0 + 0x2000'0000));
+                addresses.push_back(RandomAddress(gen, base_addr0 + 0x4000'0000, base_addr0 + 0x6000'0000));
+                addresses.push_back(RandomAddress(gen, base_addr0 + 0x8000'0000, base_addr0 + 0xA000'0000));
+            }
+            break;
+    }
+    return addresses;
+}
+
+std::vector<uint64_t>
+TraceAddresses(const std::string& trace_file)
+{
+    std::ifstream trace(trace_file);
+    std::vector<uint64_t> addresses;
+    std::string line;
+    while(std::getline(trace, line))
+    {
+        std::istringstream tokens(line);
+        std::string token;
+        if(!(tokens >> token) || token[0] == '#')
+            continue;
+        addresses.push_back(std::strtoull(token.c_str(), nullptr, 0));
+    }
+    return addresses;
+}
+
+std::vector<HashCandidate>
+HashCandidates(const AddressMapping& mapping)
+{
+    std::vector<HashCandidate> candidates;
+    candidates.push_back({"none", mapping, false});
+
+    // 配置文件里写了 BANK_HASH 时, 原样加入
+    if(!mapping.vRowHashBits.empty() || mapping.bankHashMode != BankHashMode::Xor)
+        candidates.push_back({"configured", mapping, true});
+
+    AddressMapping xor_low = mapping;
+    xor_low.bankHashMode = BankHashMode::Xor;
+    xor_low.vRowHashBits.clear();
+    xor_low.hashBankGroup = true;
+    xor_low.hashBank = true;
+    xor_low.hashCid = false;
+    candidates.push_back({"xor", xor_low, true});
+
+    AddressMapping xor_fold = xor_low;
+    xor_fold.vRowHashBits = mapping.vRowBits;
+    candidates.push_back({"xor-fold", xor_fold, true});
+
+    AddressMapping poly = xor_fold;
+    poly.bankHashMode = BankHashMode::Poly;
+    candidates.push_back({"poly", poly, true});
+
+    if(!mapping.vCidBits.empty())
+    {
+        AddressMapping poly_cid = poly;
+        poly_cid.hashCid = true;
+        candidates.push_back({"poly+cid", poly_cid, true});
+    }
+    return candidates;
+}
+
+void
+Report(const std::string& traffic_name, const std::vector<uint64_t>& addresses, const LoadConfigure& load_configure,
+       const Controller::DDR5MemSpec3ds& mem_spec, bool detail, bool& mismatch)
+{
+    const AddressMapping& mapping = load_configure.load_address_map->address_mapping;
+    const unsigned num_of_banks = 1u << (mapping.vCsBits.size() + mapping.vCidBits.size() +
+                                         mapping.vBankGroupBits.size() + mapping.vBankBits.size());
+    const unsigned banks_per_bg = 1u << mapping.vBankBits.size();
+
+    std::printf("%s (%zu requests, %u banks)\n", traffic_name.c_str(), addresses.size(), num_of_banks);
+    std::printf("  %-10s %6s %8s %8s %8s %9s %7s %9s %11s\n", "hash", "banks", "min", "max", "mean", "max/mean", "cv", "max bg",
+                "win banks");
+    for(const auto& candidate: HashCandidates(mapping))
+    {
+        AddressDecoder decoder(candidate.mapping, mem_spec, candidate.bank_hash_enable);
+        std::vector<uint64_t> bank_count(num_of_banks, 0);
+        std::vector<uint64_t> bg_count(num_of_banks / banks_per_bg, 0);
+        uint64_t num_of_requests = 0;
+        std::vector<unsigned> window_bank_count(num_of_banks, 0);
+        unsigned window_banks = 0;
+        uint64_t window_banks_sum = 0;
+        uint64_t num_of_windows = 0;
+        for(auto address: addresses)
+        {
+            if(address > decoder.getMaximumAddress())
+                continue;
+            DecodedAddress decoded = decoder.decodeAddress(address);
+            if(!mismatch && decoder.encodeAddress(decoded) != address)
+            {
+                std::cerr << candidate.name << ": encodeAddress does not invert decodeAddress at address 0x"
+                          << std::hex << address << std::dec << std::endl;
+                mismatch = true;
+            }
+            bank_count[decoded.real_ba]++;
+            bg_count[decoded.real_ba / banks_per_bg]++;
+            num_of_requests++;
+
+            window_banks += window_bank_count[decoded.real_ba]++ == 0;
+            if(num_of_requests % kWindow == 0)
+            {
+                window_banks_sum += window_banks;
+                num_of_windows++;
+                window_banks = 0;
+                std::fill(window_bank_count.begin(), window_bank_count.end(), 0);
+            }
+        }
+
+        unsigned used_banks = 0;
+        uint64_t min_count = UINT64_MAX;
+        uint64_t max_count = 0;
+        for(auto count: bank_count)
+        {
+            used_banks += count != 0;
+            min_count = std::min(min_count, count);
+            max_count = std::max(max_count, count);
+        }
+        double mean = static_cast<double>(num_of_requests) / num_of_banks;
+        double variance = 0;
+        for(auto count: bank_count)
+            variance += (count - mean) * (count - mean);
+        double cv = mean > 0 ? std::sqrt(variance / num_of_banks) / mean : 0;
+        uint64_t max_bg = 0;
+        for(auto count: bg_count)
+            max_bg = std::max(max_bg, count);
+
+        std::printf("  %-10s %6u %8" PRIu64 " %8" PRIu64 " %8.1f %9.2f %7.3f %8.1f%% %11.1f\n", candidate.name.c_str(), used_banks,
+                    min_count, max_count, mean, mean > 0 ? max_count / mean : 0, cv,
+                    num_of_requests ? 100.0 * max_bg / num_of_requests : 0,
+                    num_of_windows ? static_cast<double>(window_banks_sum) / num_of_windows : 0);
+        if(detail)
+        {
+            std::printf("    per bank:");
+            for(unsigned ba = 0; ba < num_of_banks; ba++)
+                std::printf("%s%" PRIu64, ba % 16 == 0 ? "\n     " : " ", bank_count[ba]);
+            std::printf("\n");
+        }
+        if(num_of_requests != addresses.size())
+            std::printf("    %zu addresses out of range skipped\n", addresses.size() - num_of_requests);
+    }
+}
+
+} // namespace
+
+int
+sc_main(int argc, char** argv)
+{
+    std::string configure_dir = argc > 1 ? argv[1] : "../ConfigureFile";
+    std::string configure_file = argc > 2 ? argv[2] : "3ds_map7.json";
+    std::string source = argc > 3 ? argv[3] : "all";
+    bool detail = argc > 4 && std::string(argv[4]) == "detail";
+
+    LoadConfigure load_configure(configure_dir, configure_file);
+    load_configure.ParseJson();
+    load_configure.ParseConfig();
+    Configure configure(load_configure);
+
+    bool mismatch = false;
+    bool is_traffic = false;
+    for(unsigned traffic_type = 0; traffic_type < std::size(kTrafficNames); traffic_type++)
+    {
+        if(source != "all" && source != kTrafficNames[traffic_type])
+            continue;
+        is_traffic = true;
+        Report(kTrafficNames[traffic_type], TrafficAddresses(traffic_type), load_configure, *configure.mem_spec, detail, mismatch);
+    }
+    if(!is_traffic)
+    {
+        std::vector<uint64_t> addresses = TraceAddresses(source);
+        if(addresses.empty())
+        {
+            std::cerr << source << " is neither a traffic name nor a trace file with addresses" << std::endl;
+            return 1;
+        }
+        Report(source, addresses, load_configure, *configure.mem_spec, detail, mismatch);
+    }
+    return mismatch ? 1 : 0;
+}
@@ -0,0 +1,166 @@
+// timing constraint microbenchmark: SdramConstraintDDR5_3ds (pull model) 与 rule 表展开的 push model 对比
+// 两个实现跑同一个随机命令序列, 查询结果必须完全一致
+// usage: dmu_timing_bench [configure_dir] [configure_file] [steps]
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <systemc>
+
+#include "Configure/Configure.hh"
+#include "Configure/LoadConfigure.hh"
+#include "Controller/SdramConstraint.hh"
+
+using namespace dmu;
+using namespace dmu::Controller;
+
+namespace {
+
+constexpr unsigned kQueriesPerStep = 128;
+constexpr unsigned kInsertsPerStep = 8;
+
+const Command::Type kQueryCommands[] = {
+    Command::ACT, Command::PRE, Command::PREsb, Command::PREab,
+    Command::REFab, Command::REFsb, Command::RD, Command::WR
+};
+const Command::Type kInsertCommands[] = {
+    Command::WR, Command::RD, Command::WRA, Command::RDA, Command::ACT, Command::PRE,
+    Command::PREsb, Command::REFsb, Command::RFMsb, Command::PREab, Command::REFab, Command::RFMab
+};
+
+struct Step
+{
+    unsigned cycles;
+    std::vector<std::pair<Command::Type, BankAddress>> inserts;
+    std::vector<std::pair<Command::Type, BankAddress>> queries;
+};
+
+struct Result
+{
+    double insert_ns{0};
+    double query_ns{0};
+    uint64_t checksum{0};
+};
+
+BankAddress
+RandomAddress(std::mt19937& rng, const DDR5MemSpec3ds& spec)
+{
+    unsigned lrank = rng() % spec.TotalNumOfLogicalRanks;
+    unsigned cs = lrank / spec.NumOfLogicalRanksPerPhysicalRank;
+    unsigned cid = lrank % spec.NumOfLogicalRanksPerPhysicalRank;
+    if(rng() % 4 == 0)
+    {
+        return BankAddress(0, cs, cid, lrank);
+    }
+    BankAddress address;
+    unsigned ba = lrank * spec.NumOfBankPerLogicalRank + rng() % spec.NumOfBankPerLogicalRank;
+    address.ch = 0;
+    address.cs = cs;
+    address.cid = cid;
+    address.real_cid = lrank;
+    address.real_ba = ba;
+    address.real_bg = ba / spec.NumOfBanksPerBg;
+    address.bank = ba % spec.NumOfBanksPerBg;
+    address.bankgroup = address.real_bg % spec.NumOfBgPerLogicalRank;
+    return address;
+}
+
+double
+ElapsedNs(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+{
+    return std::chrono::duration<double, std::nano>(end - begin).count();
+}
+
+} // namespace
+
+int
+sc_main(int argc, char** argv)
+{
+    std::string configure_dir = argc > 1 ? argv[1] : "../ConfigureFile";
+    std::string configure_file = argc > 2 ? argv[2] : "3ds_map2.json";
+    unsigned num_of_steps = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 100000;
+
+    LoadConfigure load_configure(configure_dir, configure_file);
+    load_configure.ParseJson();
+    load_configure.ParseConfig();
+    Configure configure(load_configure);
+    const DDR5MemSpec3ds& spec = *configure.mem_spec;
+
+    // 先生成命令序列, 计时区间内只有 constraint 本身的开销
+    std::mt19937 rng(2024);
+    std::vector<Step> steps(num_of_steps);
+    for(auto& step: steps)
+    {
+        step.cycles = 1 + rng() % 3;
+        for(unsigned i = 0; i < kInsertsPerStep; i++)
+        {
+            step.inserts.emplace_back(kInsertCommands[rng() % std::size(kInsertCommands)], RandomAddress(rng, spec));
+        }
+        for(unsigned i = 0; i < kQueriesPerStep; i++)
+        {
+            step.queries.emplace_back(kQueryCommands[i % std::size(kQueryCommands)], RandomAddress(rng, spec));
+        }
+    }
+
+    SdramConstraintDDR5_3ds pull_constraint(spec);
+    SdramConstraintDDR5_3dsPush table_constraint(spec);
+    SdramConstraintIF* constraints[] = {&pull_constraint, &table_constraint};
+    Result results[2];
+    double baseline_ns = 0;
+
+    for(const auto& step: steps)
+    {
+        sc_core::sc_start(spec.tCK_mc * step.cycles);
+
+        // 空区间, 用来扣除 steady_clock 本身的开销
+        auto begin = std::chrono::steady_clock::now();
+        auto end = std::chrono::steady_clock::now();
+        baseline_ns += ElapsedNs(begin, end);
+
+        for(unsigned i = 0; i < 2; i++)
+        {
+            SdramConstraintIF* constraint = constraints[i];
+            uint64_t checksum = 0;
+            begin = std::chrono::steady_clock::now();
+            for(const auto& query: step.queries)
+            {
+                checksum = checksum * 31 + constraint->TimeToSatisfyConstraints(Command(query.first), query.second);
+            }
+            end = std::chrono::steady_clock::now();
+            results[i].query_ns += ElapsedNs(begin, end);
+            results[i].checksum = results[i].checksum * 131 + checksum;
+
+            begin = std::chrono::steady_clock::now();
+            for(const auto& insert: step.inserts)
+            {
+                constraint->InsertCommand(Command(insert.first), insert.second);
+            }
+            end = std::chrono::steady_clock::now();
+            results[i].insert_ns += ElapsedNs(begin, end);
+        }
+    }
+
+    const char* names[] = {"pull", "rule table"};
+    const double num_of_queries = static_cast<double>(num_of_steps) * kQueriesPerStep;
+    const double num_of_inserts = static_cast<double>(num_of_steps) * kInsertsPerStep;
+    std::printf("%u steps, %.0f queries, %.0f inserts\n", num_of_steps, num_of_queries, num_of_inserts);
+    for(unsigned i = 0; i < 2; i++)
+    {
+        std::printf("%-12s query %8.2f ns/op  insert %8.2f ns/op  checksum %016" PRIx64 "\n", names[i],
+                    (results[i].query_ns - baseline_ns) / num_of_queries,
+                    (results[i].insert_ns - baseline_ns) / num_of_inserts,
+                    results[i].checksum);
+    }
+    if(results[0].checksum != results[1].checksum)
+    {
+        std::cerr << "timing query mismatch between pull model and rule table" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,33 @@
+#ifndef __CHANNEL_STEPPER_HH__
+#define __CHANNEL_STEPPER_HH__
+
+#include <vector>
+
+#include <systemc>
+
+#include "Controller/MemoryController.hh"
+
+namespace dmu{
+
+/*
+多个 sub-channel 时代替各个 controller 的 ControllerMethod, 一个 SC_METHOD 对所有 controller 的 ctrl_event 敏感
+    同一个 delta cycle 中 ctrl_event 触发的 controller 先全部 StepPrepare, 再按 sub-channel 顺序 StepCommit
+    StepPrepare 只访问各自 controller 的状态, StepCommit 才有跨 sub-channel 可见的副作用
+*/
+class ChannelStepper : public sc_core::sc_module
+{
+public:
+    SC_HAS_PROCESS(ChannelStepper);
+    // controllers 需要以 external_step 创建
+    ChannelStepper(const sc_core::sc_module_name& name, const std::vector<Controller::MemoryController*>& controllers);
+
+private:
+    std::vector<Controller::MemoryController*> controllers;
+    std::vector<Controller::MemoryController*> due_controllers;
+
+    void StepMethod();
+};
+
+}
+
+#endif
@@ -8,32 +8,51 @@
 #include "Controller/MemoryController.hh"
 #include "Controller/MemoryDevice.hh"
 #include "Controller/SdramConstraint.hh"
+#include "DMU/ChannelStepper.hh"
+#include "DMU/SubChannelRouter.hh"
 #include "sysc/communication/sc_clock.h"
 #include <memory>
+#include <vector>
 namespace dmu {
 
+/*
+address mapping 没有 CHANNEL_BIT 时只模拟一个 sub-channel: chi_port_0 直接连 controller / device, 输出写在 output_dir
+配置了 CHANNEL_BIT (NumOfSubChannels 个 channel) 时每个 sub-channel 一套 SdramConstraint / MemoryController / MemoryDevice,
+chi_port_0 经过 SubChannelRouter 按 channel 分发; sub-channel i 的输出写在 output_dir/subch<i>,
+output_dir 下的 LatencyStats.json 是所有 sub-channel 合并的延迟, SubChannelStats.json 是每个 sub-channel 及总的带宽和延迟
+DMU_DATA_CHECK 打开时 output_dir 下的 DataCheck.json 是 scoreboard 的检查结果以及 backing store / scoreboard 占用的内存
+多个 sub-channel 的 controller 由 ChannelStepper 统一推进
+*/
 class DramManagerUnit {
 public:
     explicit DramManagerUnit(const std::string& name,
         const sc_core::sc_clock& noc_clock,const unsigned chi_data_width_bits,
         const std::string& configure_base_dir, const std::string& configure_filename,const std::string& output_dir="./");
 
-    ~DramManagerUnit() = default;
+    ~DramManagerUnit();
     std::unique_ptr<Port::CHIPort> chi_port_0;
+
+    inline unsigned GetNumOfSubChannels() const { return static_cast<unsigned>(controllers.size()); }
 private:
+    const std::string name;
+    const std::string output_dir;
     std::unique_ptr<sc_core::sc_clock> dfi_clock;
     const sc_core::sc_clock& noc_clock;
     std::unique_ptr<LoadConfigure> load_configure;
     std::unique_ptr<Configure> configure;
 
-    std::unique_ptr<Controller::SdramConstraintIF> sdram_constraint;
+    // 按 sub-channel 索引; device 在 controller 之前析构 (device 析构时写 controller 的 PerfCounters.json)
+    std::vector<std::unique_ptr<Controller::SdramConstraintIF>> sdram_constraints;
+    std::vector<std::unique_ptr<Controller::MemoryController>> controllers;
+    std::vector<std::unique_ptr<Controller::MemoryDevice>> devices;
 
-    std::unique_ptr<Controller::MemoryController> controller_0;
-    std::unique_ptr<Controller::MemoryDevice> device_0;
+    std::unique_ptr<SubChannelRouter> sub_channel_router; // 只有一个 sub-channel 时为空
+    std::unique_ptr<ChannelStepper> channel_stepper;      // 只有一个 sub-channel 时为空
 
-    // std::unique_ptr<Port::CHIPort> chi_port_1;
-    // std::unique_ptr<Controller::MemoryController> controller_1;
-    // std::unique_ptr<Controller::MemoryDevice> device_1;
+    std::unique_ptr<Controller::SdramConstraintIF> CreateSdramConstraint() const;
+    // 按环境变量配置一个 sub-channel 的 controller / device
+    void ConfigureSubChannel(unsigned sub_channel, const std::string& sub_channel_dir);
+    bool WriteDataCheckJson(const std::string& filename) const;
 };
 
 }
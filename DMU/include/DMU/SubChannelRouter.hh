@@ -0,0 +1,97 @@
+#ifndef __SUB_CHANNEL_ROUTER_HH__
+#define __SUB_CHANNEL_ROUTER_HH__
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <systemc>
+#include <tlm>
+#include <tlm_utils/simple_initiator_socket.h>
+#include <tlm_utils/simple_target_socket.h>
+
+#include "Common/LatencyStatistics.hh"
+#include "Configure/Configure.hh"
+
+namespace dmu{
+
+/*
+DIMM 的两个 (NumOfSubChannels 个) sub-channel 共用一个 CHIPort, router 位于 CHIPort 的 UIF 接口和各个 controller 之间
+    fw: UIF_REQ / UIF_WDAT_BEGIN / UIF_WDAT_END 按 AddressDecoder 译出的 channel 发给对应的 controller
+    bw: 各个 controller 的 UIF_CREDIT / UIF_WDAT_REQ / UIF_RDAT_BEGIN / UIF_RDAT_END 原样合并给 CHIPort
+
+CHIPort 只有一组 hpr / lpr / tpw credit, 收到的是所有 sub-channel credit 的总和, 发请求时不知道请求去哪个 sub-channel.
+router 为每个 sub-channel 另外记录 controller 给出而还没有用掉的 credit, 目标 sub-channel 没有 credit 时请求在 router 中排队,
+按到达顺序等该 sub-channel 的 credit 归还后再发出; 排队的请求数不会超过 CHIPort 多拿到的 credit 数
+controller 每个 dfi cycle 只能接收一个请求, 发给同一个 sub-channel 的请求间隔至少一个 dfi cycle
+*/
+class SubChannelRouter : public sc_core::sc_module
+{
+public:
+    struct SubChannelCounters
+    {
+        uint64_t reads{0};
+        uint64_t writes{0};
+        uint64_t read_bytes{0};  // UIF_RDAT_END 时累计
+        uint64_t write_bytes{0}; // UIF_WDAT_END 时累计
+        uint64_t queued{0};      // 因为没有 credit 在 router 中排过队的请求数
+        std::size_t max_queue_depth{0};
+    };
+
+    SC_HAS_PROCESS(SubChannelRouter);
+    SubChannelRouter(const sc_core::sc_module_name& name, const Configure& config, unsigned num_of_sub_channels,
+                     const sc_core::sc_time& dfi_clock_period);
+
+    tlm_utils::simple_target_socket<SubChannelRouter> tSocket;
+    std::vector<std::unique_ptr<tlm_utils::simple_initiator_socket_tagged<SubChannelRouter>>> iSockets;
+
+    inline unsigned GetNumOfSubChannels() const { return static_cast<unsigned>(sub_channels.size()); }
+    inline const SubChannelCounters& GetCounters(unsigned sub_channel) const { return sub_channels[sub_channel].counters; }
+
+    // 每个 sub-channel 以及整个 DIMM 的请求数 / 带宽 / 端到端延迟, latency 按 sub-channel 顺序给出
+    void WriteJson(std::ostream& os, const std::vector<const LatencyStatistics*>& latency) const;
+    // 文件打不开时返回 false
+    bool WriteJson(const std::string& filename, const std::vector<const LatencyStatistics*>& latency) const;
+
+private:
+    struct Credits
+    {
+        unsigned hpr{0};
+        unsigned lpr{0};
+        unsigned tpw{0};
+    };
+
+    struct SubChannel
+    {
+        Credits credits;
+        std::deque<tlm::tlm_generic_payload*> pending;
+        sc_core::sc_time next_request_time{sc_core::SC_ZERO_TIME}; // 上一个请求之后一个 dfi cycle
+        SubChannelCounters counters;
+    };
+
+    const Configure& _config;
+    const sc_core::sc_time dfi_clock_period;
+    std::vector<SubChannel> sub_channels;
+    sc_core::sc_time first_request_time{sc_core::sc_max_time()};
+    sc_core::sc_time last_data_time{sc_core::SC_ZERO_TIME};
+
+    sc_core::sc_event drain_event;
+    // 有 credit 归还或者 controller 拒绝了请求之后, 按顺序发出排队的请求
+    void DrainMethod();
+
+    tlm::tlm_sync_enum nb_transport_fw(tlm::tlm_generic_payload& trans, tlm::tlm_phase& phase, sc_core::sc_time& delay);
+    tlm::tlm_sync_enum nb_transport_bw(int sub_channel, tlm::tlm_generic_payload& trans, tlm::tlm_phase& phase, sc_core::sc_time& delay);
+
+    unsigned GetSubChannel(const tlm::tlm_generic_payload& trans) const;
+    // 与 CHIPort 的 credit 消耗一致: 读按 qos 用 hpr / lpr, 写用 tpw, RMW 另外用一个 lpr
+    static bool HasCredit(const Credits& credits, const tlm::tlm_generic_payload& trans);
+    static void ConsumeCredit(Credits& credits, const tlm::tlm_generic_payload& trans);
+    // controller 拒绝时返回 false, credit 不消耗
+    bool SendRequest(unsigned sub_channel, tlm::tlm_generic_payload& trans);
+};
+
+}
+
+#endif
@@ -0,0 +1,33 @@
+#include "DMU/ChannelStepper.hh"
+
+namespace dmu{
+
+ChannelStepper::ChannelStepper(const sc_core::sc_module_name& name, const std::vector<Controller::MemoryController*>& controllers)
+: sc_core::sc_module(name)
+, controllers(controllers)
+{
+    due_controllers.reserve(controllers.size());
+
+    SC_METHOD(StepMethod);
+    for(auto controller: controllers)
+        sensitive << controller->GetCtrlEvent();
+    dont_initialize();
+}
+
+void
+ChannelStepper::StepMethod()
+{
+    due_controllers.clear();
+    for(auto controller: controllers)
+    {
+        if(controller->GetCtrlEvent().triggered())
+            due_controllers.push_back(controller);
+    }
+
+    for(auto controller: due_controllers)
+        controller->StepPrepare();
+    for(auto controller: due_controllers)
+        controller->StepCommit();
+}
+
+}
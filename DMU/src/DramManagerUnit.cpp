@@ -3,13 +3,22 @@
 #include "Configure/LoadConfigure.hh"
 #include "Controller/SdramConstraint.hh"
 #include "sysc/communication/sc_clock.h"
+#include "rapidjson/ostreamwrapper.h"
+#include "rapidjson/prettywriter.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
 #include <memory>
+#include <string>
 
 namespace dmu{
     DramManagerUnit::DramManagerUnit(const std::string& name,
         const sc_core::sc_clock& noc_clock, const unsigned chi_data_width_bits,
         const std::string& configure_base_dir, const std::string& configure_filename, const std::string& output_dir)
-    :noc_clock(noc_clock)
+    :name(name)
+    ,output_dir(output_dir)
+    ,noc_clock(noc_clock)
     {
         load_configure = std::make_unique<LoadConfigure>(configure_base_dir, configure_filename);
         load_configure->ParseJson();
@@ -17,38 +26,196 @@ namespace dmu{
 
         configure = std::make_unique<Configure>(*load_configure.get());
 
-        sdram_constraint = std::make_unique<Controller::SdramConstraintDDR5_3ds>(*configure->mem_spec.get());
+        // address mapping 的 CHANNEL_BIT 决定 sub-channel 数目, 每个 sub-channel 独立的 timing constraint
+        const unsigned num_of_sub_channels = configure->address_decoder->getNumOfChannels();
+        for(unsigned sub_channel = 0; sub_channel < num_of_sub_channels; sub_channel++)
+            sdram_constraints.push_back(CreateSdramConstraint());
 
         //创建dfi 时钟
         dfi_clock = std::make_unique<sc_core::sc_clock>((name+"_dfi_clock").c_str(),configure->mem_spec->tCK_mc);
-        // 使用name作为前缀创建两个端口
+        // 使用name作为前缀创建端口, 所有 sub-channel 共用
         chi_port_0 = std::make_unique<Port::CHIPort>((name + "_chi_port_0").c_str(), *configure, 256,
                                                     dfi_clock->period());
-        // chi_port_1 = std::make_unique<Port::CHIPort>((name + "_chi_port_1").c_str(), *configure, 256,
-        //                                            dfi_clock.period());
-
-        // 使用name作为前缀创建两个控制器
-        controller_0 = std::make_unique<Controller::MemoryController>((name + "_memory_controller_0").c_str(),
-                                                                     *configure,
-                                                                     sdram_constraint.get());
-        // controller_1 = std::make_unique<Controller::MemoryController>((name + "_memory_controller_1").c_str(),
-        //                                                              *configure,
-        //                                                              sdram_constraint.get());
-        // 使用name作为前缀创建两个设备
-        device_0 = std::make_unique<Controller::MemoryDevice>((name + "_memory_device_0").c_str(),
-                                                             *configure,
-                                                             output_dir);
-        // device_1 = std::make_unique<Controller::MemoryDevice>((name + "_memory_device_1").c_str(),
-        //                                                      *configure,
-        //                                                      output_dir);
+        if(num_of_sub_channels > 1)
+            sub_channel_router = std::make_unique<SubChannelRouter>((name + "_sub_channel_router").c_str(), *configure,
+                                                                    num_of_sub_channels, dfi_clock->period());
+
+        // 使用name作为前缀, 每个 sub-channel 创建一个控制器和一个设备
+        for(unsigned sub_channel = 0; sub_channel < num_of_sub_channels; sub_channel++)
+        {
+            controllers.push_back(std::make_unique<Controller::MemoryController>((name + "_memory_controller_" + std::to_string(sub_channel)).c_str(),
+                                                                                *configure,
+                                                                                sdram_constraints[sub_channel].get(),
+                                                                                num_of_sub_channels > 1));
+        }
+        // 多个 sub-channel 时 controller 由 stepper 推进
+        if(num_of_sub_channels > 1)
+        {
+            std::vector<Controller::MemoryController*> stepped_controllers;
+            for(auto& controller: controllers)
+                stepped_controllers.push_back(controller.get());
+            channel_stepper = std::make_unique<ChannelStepper>((name + "_channel_stepper").c_str(), stepped_controllers);
+        }
+        std::vector<std::string> sub_channel_dirs;
+        for(unsigned sub_channel = 0; sub_channel < num_of_sub_channels; sub_channel++)
+        {
+            std::string sub_channel_dir = output_dir;
+            if(num_of_sub_channels > 1)
+            {
+                sub_channel_dir = (std::filesystem::path(output_dir) / ("subch" + std::to_string(sub_channel))).string();
+                std::error_code error;
+                std::filesystem::create_directories(sub_channel_dir, error);
+                if(error)
+                    std::cerr << "[" << name << "] unable to create " << sub_channel_dir << ": " << error.message() << std::endl;
+            }
+            devices.push_back(std::make_unique<Controller::MemoryDevice>((name + "_memory_device_" + std::to_string(sub_channel)).c_str(),
+                                                                        *configure,
+                                                                        sub_channel_dir));
+            sub_channel_dirs.push_back(sub_channel_dir);
+        }
+
+        // 默认不保存数据, 环境变量 DMU_DATA_CHECK=store 时 port 传递数据、device 使用 backing store,
+        // DMU_DATA_CHECK=scoreboard 时 port 另外用参考模型检查每个 CompData
+        const char* data_check = std::getenv("DMU_DATA_CHECK");
+        if(data_check != nullptr && (std::string(data_check) == "store" || std::string(data_check) == "scoreboard"))
+            chi_port_0->EnableDataCheck(std::string(data_check) == "scoreboard");
+        for(unsigned sub_channel = 0; sub_channel < num_of_sub_channels; sub_channel++)
+            ConfigureSubChannel(sub_channel, sub_channel_dirs[sub_channel]);
 
         // bind clock
         chi_port_0->dfi_clock.bind(*dfi_clock);
         chi_port_0->noc_clock.bind(noc_clock);
-        controller_0->bind_dfi_clock(*dfi_clock);
+        for(auto& controller: controllers)
+            controller->bind_dfi_clock(*dfi_clock);
 
         // bind tlm interface
-        chi_port_0->iSocket.bind(controller_0->tSocket);
-        controller_0->iSocket.bind(device_0->tSocket);
+        if(sub_channel_router)
+        {
+            chi_port_0->iSocket.bind(sub_channel_router->tSocket);
+            for(unsigned sub_channel = 0; sub_channel < num_of_sub_channels; sub_channel++)
+                sub_channel_router->iSockets[sub_channel]->bind(controllers[sub_channel]->tSocket);
+        }
+        else
+        {
+            chi_port_0->iSocket.bind(controllers[0]->tSocket);
+        }
+        for(unsigned sub_channel = 0; sub_channel < num_of_sub_channels; sub_channel++)
+            controllers[sub_channel]->iSocket.bind(devices[sub_channel]->tSocket);
+    }
+
+    DramManagerUnit::~DramManagerUnit()
+    {
+        if(devices[0]->GetBackingStore() != nullptr && !WriteDataCheckJson(output_dir + "/" + "DataCheck.json"))
+            std::cerr << "[" << name << "] unable to write " << output_dir << "/DataCheck.json" << std::endl;
+        if(!sub_channel_router)
+            return;
+        // device 析构时各自写 sub-channel 的统计, 这里写整个 DIMM 的统计
+        LatencyStatistics total;
+        std::vector<const LatencyStatistics*> latency;
+        for(const auto& device: devices)
+        {
+            total.Merge(device->GetLatencyStatistics());
+            latency.push_back(&device->GetLatencyStatistics());
+        }
+        if(!total.WriteJson(output_dir + "/" + "LatencyStats.json"))
+            std::cerr << "[" << name << "] unable to write " << output_dir << "/LatencyStats.json" << std::endl;
+        if(!sub_channel_router->WriteJson(output_dir + "/" + "SubChannelStats.json", latency))
+            std::cerr << "[" << name << "] unable to write " << output_dir << "/SubChannelStats.json" << std::endl;
+    }
+
+    bool
+    DramManagerUnit::WriteDataCheckJson(const std::string& filename) const
+    {
+        std::ofstream file(filename, std::ios::out | std::ios::trunc);
+        if(!file.is_open())
+            return false;
+        rapidjson::OStreamWrapper stream(file);
+        rapidjson::PrettyWriter<rapidjson::OStreamWrapper> writer(stream);
+        writer.StartObject();
+        if(const Port::DataScoreboard* scoreboard = chi_port_0->GetDataScoreboard())
+        {
+            writer.Key("scoreboard");
+            writer.StartObject();
+            writer.Key("writes");
+            writer.Uint64(scoreboard->GetNumOfWrites());
+            writer.Key("compdata_checked");
+            writer.Uint64(scoreboard->GetNumOfChecks());
+            writer.Key("mismatches");
+            writer.Uint64(scoreboard->GetNumOfMismatches());
+            writer.Key("bytes");
+            writer.Uint64(scoreboard->GetNumOfBytes());
+            writer.EndObject();
+        }
+        writer.Key("backing_store");
+        writer.StartArray();
+        for(unsigned sub_channel = 0; sub_channel < devices.size(); sub_channel++)
+        {
+            const BackingStore* backing_store = devices[sub_channel]->GetBackingStore();
+            writer.StartObject();
+            writer.Key("sub_channel");
+            writer.Uint(sub_channel);
+            writer.Key("pages");
+            writer.Uint64(backing_store->GetNumOfPages());
+            writer.Key("bytes");
+            writer.Uint64(backing_store->GetNumOfBytes());
+            writer.EndObject();
+        }
+        writer.EndArray();
+        writer.EndObject();
+        file << std::endl;
+        return true;
+    }
+
+    std::unique_ptr<Controller::SdramConstraintIF>
+    DramManagerUnit::CreateSdramConstraint() const
+    {
+        // timing constraint 默认使用 push model, 环境变量 DMU_TIMING_CHECK=pull 使用原来的 pull model,
+        // DMU_TIMING_CHECK=diff 同时运行两者并逐次比较查询结果
+        const char* timing_check = std::getenv("DMU_TIMING_CHECK");
+        if(timing_check != nullptr && std::string(timing_check) == "pull")
+        {
+            return std::make_unique<Controller::SdramConstraintDDR5_3ds>(*configure->mem_spec.get());
+        }
+        else if(timing_check != nullptr && std::string(timing_check) == "diff")
+        {
+            return std::make_unique<Controller::SdramConstraintDiffCheck>(*configure->mem_spec.get());
+        }
+        return std::make_unique<Controller::SdramConstraintDDR5_3dsPush>(*configure->mem_spec.get());
+    }
+
+    void
+    DramManagerUnit::ConfigureSubChannel(const unsigned sub_channel, const std::string& sub_channel_dir)
+    {
+        Controller::MemoryController& controller = *controllers[sub_channel];
+        Controller::MemoryDevice& device = *devices[sub_channel];
+
+        const char* data_check = std::getenv("DMU_DATA_CHECK");
+        if(data_check != nullptr && (std::string(data_check) == "store" || std::string(data_check) == "scoreboard"))
+            device.EnableBackingStore();
+
+        // 每个请求的 StatisticExtension 默认写到 TransInfo.txt, 环境变量 DMU_TRANS_INFO=off 时只输出 LatencyStats.json
+        const char* trans_info = std::getenv("DMU_TRANS_INFO");
+        if(trans_info != nullptr && std::string(trans_info) == "off")
+            device.SetTransInfoEnabled(false);
+
+        // 环境变量 DMU_DFI_TRACE=binary / lz 时 DfiCmd.txt 和 TransInfo.txt 改为写 DfiTrace.bin (lz: block 压缩),
+        // 用 dmu_dfi_decode 还原文本
+        const char* dfi_trace = std::getenv("DMU_DFI_TRACE");
+        if(dfi_trace != nullptr && (std::string(dfi_trace) == "binary" || std::string(dfi_trace) == "lz"))
+        {
+            if(!device.EnableBinaryTrace(std::string(dfi_trace) == "lz"))
+                std::cerr << "[" << name << "] unable to write " << sub_channel_dir << "/DfiTrace.bin, keep text output" << std::endl;
+        }
+
+        // controller 的性能计数器, device 析构 (先于 controller) 时写 PerfCounters.json
+        // 环境变量 DMU_PERF_INTERVAL=<ns> 时另外每隔 ns 向 PerfCounters_interval.jsonl 追加一行累计值
+        device.RegisterPerformanceCounters(&controller.GetPerformanceCounters());
+        const char* perf_interval = std::getenv("DMU_PERF_INTERVAL");
+        if(perf_interval != nullptr && std::atof(perf_interval) > 0)
+        {
+            if(!controller.GetPerformanceCounters().EnableSnapshot(sub_channel_dir + "/" + "PerfCounters_interval.jsonl",
+                                                                  sc_core::sc_time(std::atof(perf_interval), sc_core::SC_NS)))
+                std::cerr << "[" << name << "] unable to write " << sub_channel_dir << "/PerfCounters_interval.jsonl" << std::endl;
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,259 @@
+#include "DMU/SubChannelRouter.hh"
+
+#include <algorithm>
+#include <fstream>
+
+#include "Common/Common.hh"
+#include "Common/UifExtension.hh"
+#include "rapidjson/ostreamwrapper.h"
+#include "rapidjson/prettywriter.h"
+
+namespace dmu{
+
+namespace {
+
+using JsonWriter = rapidjson::PrettyWriter<rapidjson::OStreamWrapper>;
+
+void
+WriteLatency(JsonWriter& writer, const LatencyHistogram& histogram)
+{
+    writer.StartObject();
+    writer.Key("count");
+    writer.Uint64(histogram.GetCount());
+    writer.Key("mean");
+    writer.Double(histogram.GetMean() / 1000.0);
+    writer.Key("p50");
+    writer.Double(histogram.GetValueAtPercentile(50.0) / 1000.0);
+    writer.Key("p99");
+    writer.Double(histogram.GetValueAtPercentile(99.0) / 1000.0);
+    writer.Key("max");
+    writer.Double(histogram.GetMax() / 1000.0);
+    writer.EndObject();
+}
+
+void
+WriteCounters(JsonWriter& writer, const SubChannelRouter::SubChannelCounters& counters, const LatencyHistogram& latency, double elapsed_ns)
+{
+    writer.Key("reads");
+    writer.Uint64(counters.reads);
+    writer.Key("writes");
+    writer.Uint64(counters.writes);
+    writer.Key("read_bytes");
+    writer.Uint64(counters.read_bytes);
+    writer.Key("write_bytes");
+    writer.Uint64(counters.write_bytes);
+    // byte / ns 即 GB/s
+    writer.Key("bandwidth_gbps");
+    writer.Double(elapsed_ns > 0 ? (counters.read_bytes + counters.write_bytes) / elapsed_ns : 0.0);
+    writer.Key("queued");
+    writer.Uint64(counters.queued);
+    writer.Key("max_queue_depth");
+    writer.Uint64(counters.max_queue_depth);
+    writer.Key("end_to_end_latency_ns");
+    WriteLatency(writer, latency);
+}
+
+} // namespace
+
+SubChannelRouter::SubChannelRouter(const sc_core::sc_module_name& name, const Configure& config, const unsigned num_of_sub_channels,
+                                   const sc_core::sc_time& dfi_clock_period)
+: sc_core::sc_module(name)
+, tSocket("tSocket")
+, _config(config)
+, dfi_clock_period(dfi_clock_period)
+, sub_channels(num_of_sub_channels)
+{
+    tSocket.register_nb_transport_fw(this, &SubChannelRouter::nb_transport_fw);
+    for(unsigned sub_channel = 0; sub_channel < num_of_sub_channels; sub_channel++)
+    {
+        iSockets.push_back(std::make_unique<tlm_utils::simple_initiator_socket_tagged<SubChannelRouter>>(
+            ("iSocket_" + std::to_string(sub_channel)).c_str()));
+        iSockets.back()->register_nb_transport_bw(this, &SubChannelRouter::nb_transport_bw, static_cast<int>(sub_channel));
+    }
+
+    SC_METHOD(DrainMethod);
+    sensitive << drain_event;
+    dont_initialize();
+}
+
+unsigned
+SubChannelRouter::GetSubChannel(const tlm::tlm_generic_payload& trans) const
+{
+    const unsigned sub_channel = _config.address_decoder->decodeChannel(trans.get_address());
+    assert(sub_channel < sub_channels.size());
+    return sub_channel;
+}
+
+bool
+SubChannelRouter::HasCredit(const Credits& credits, const tlm::tlm_generic_payload& trans)
+{
+    const UifInfo& uif_info = trans.get_extension<UifExtension>()->_uif_info;
+    if(trans.is_read())
+        return uif_info.qos.GetQosLevel() == PriorityClass::HPR ? credits.hpr > 0 : credits.lpr > 0;
+    return credits.tpw > 0 && (!uif_info.is_rmw || credits.lpr > 0);
+}
+
+void
+SubChannelRouter::ConsumeCredit(Credits& credits, const tlm::tlm_generic_payload& trans)
+{
+    const UifInfo& uif_info = trans.get_extension<UifExtension>()->_uif_info;
+    if(trans.is_read())
+    {
+        unsigned& credit = uif_info.qos.GetQosLevel() == PriorityClass::HPR ? credits.hpr : credits.lpr;
+        credit--;
+    }
+    else
+    {
+        credits.tpw--;
+        if(uif_info.is_rmw)
+            credits.lpr--;
+    }
+}
+
+bool
+SubChannelRouter::SendRequest(const unsigned sub_channel, tlm::tlm_generic_payload& trans)
+{
+    SubChannel& target = sub_channels[sub_channel];
+    tlm::tlm_phase phase = UIF_REQ;
+    sc_core::sc_time delay = sc_core::SC_ZERO_TIME;
+    if((*iSockets[sub_channel])->nb_transport_fw(trans, phase, delay) != tlm::TLM_ACCEPTED)
+        return false;
+    ConsumeCredit(target.credits, trans);
+    target.next_request_time = sc_core::sc_time_stamp() + dfi_clock_period;
+    if(trans.is_read())
+        target.counters.reads++;
+    else
+        target.counters.writes++;
+    return true;
+}
+
+tlm::tlm_sync_enum
+SubChannelRouter::nb_transport_fw(tlm::tlm_generic_payload& trans, tlm::tlm_phase& phase, sc_core::sc_time& delay)
+{
+    const unsigned sub_channel = GetSubChannel(trans);
+    SubChannel& target = sub_channels[sub_channel];
+    if(phase == UIF_REQ)
+    {
+        first_request_time = std::min(first_request_time, sc_core::sc_time_stamp());
+        if(target.pending.empty() && HasCredit(target.credits, trans) && target.next_request_time <= sc_core::sc_time_stamp())
+        {
+            // 直接发出时 controller 的拒绝原样返回给 CHIPort, 与只有一个 sub-channel 时相同
+            return SendRequest(sub_channel, trans) ? tlm::TLM_ACCEPTED : tlm::TLM_UPDATED;
+        }
+        // CHIPort 用完 payload 前 (UIF_RDAT_END / UIF_WDAT_END) 不会 release, 排队时不需要另外 acquire
+        target.pending.push_back(&trans);
+        if(target.next_request_time > sc_core::sc_time_stamp())
+            drain_event.notify(target.next_request_time - sc_core::sc_time_stamp());
+        target.counters.queued++;
+        target.counters.max_queue_depth = std::max(target.counters.max_queue_depth, target.pending.size());
+        return tlm::TLM_ACCEPTED;
+    }
+    if(phase == UIF_WDAT_END)
+    {
+        target.counters.write_bytes += trans.get_extension<UifExtension>()->_uif_info.data_bytes;
+        last_data_time = std::max(last_data_time, sc_core::sc_time_stamp());
+    }
+    return (*iSockets[sub_channel])->nb_transport_fw(trans, phase, delay);
+}
+
+tlm::tlm_sync_enum
+SubChannelRouter::nb_transport_bw(const int sub_channel, tlm::tlm_generic_payload& trans, tlm::tlm_phase& phase, sc_core::sc_time& delay)
+{
+    SubChannel& source = sub_channels[static_cast<unsigned>(sub_channel)];
+    if(phase == UIF_CREDIT)
+    {
+        const UifSideBandInfo& side_band_info = trans.get_extension<UifSideBandExtension>()->_uif_side_band_info;
+        source.credits.hpr += side_band_info.hpr_credit_valid;
+        source.credits.lpr += side_band_info.lpr_credit_valid;
+        source.credits.tpw += side_band_info.tpw_credit_valid;
+        // 不在 controller 的 CreditSend 中重入 controller, 排队的请求在 DrainMethod 中发出
+        if(!source.pending.empty())
+            drain_event.notify(sc_core::SC_ZERO_TIME);
+    }
+    else if(phase == UIF_RDAT_END)
+    {
+        source.counters.read_bytes += trans.get_extension<UifExtension>()->_uif_info.data_bytes;
+        last_data_time = std::max(last_data_time, sc_core::sc_time_stamp() + delay);
+    }
+    return tSocket->nb_transport_bw(trans, phase, delay);
+}
+
+void
+SubChannelRouter::DrainMethod()
+{
+    const sc_core::sc_time now = sc_core::sc_time_stamp();
+    for(unsigned sub_channel = 0; sub_channel < sub_channels.size(); sub_channel++)
+    {
+        SubChannel& target = sub_channels[sub_channel];
+        if(target.pending.empty() || !HasCredit(target.credits, *target.pending.front()))
+            continue;
+        if(target.next_request_time > now)
+        {
+            drain_event.notify(target.next_request_time - now);
+            continue;
+        }
+        // 地址冲突等原因被 controller 拒绝时保持顺序, 下一个 dfi cycle 重试
+        if(SendRequest(sub_channel, *target.pending.front()))
+            target.pending.pop_front();
+        if(!target.pending.empty())
+            drain_event.notify(dfi_clock_period);
+    }
+}
+
+void
+SubChannelRouter::WriteJson(std::ostream& os, const std::vector<const LatencyStatistics*>& latency) const
+{
+    const double elapsed_ns = last_data_time > first_request_time && first_request_time != sc_core::sc_max_time()
+                            ? (last_data_time - first_request_time).to_seconds() * 1e9 : 0.0;
+    rapidjson::OStreamWrapper stream(os);
+    JsonWriter writer(stream);
+    writer.StartObject();
+    writer.Key("elapsed_ns");
+    writer.Double(elapsed_ns);
+
+    SubChannelCounters total;
+    LatencyHistogram total_latency;
+    LatencyHistogram empty;
+    writer.Key("sub_channels");
+    writer.StartArray();
+    for(unsigned sub_channel = 0; sub_channel < sub_channels.size(); sub_channel++)
+    {
+        const SubChannelCounters& counters = sub_channels[sub_channel].counters;
+        const LatencyHistogram& end_to_end = sub_channel < latency.size() && latency[sub_channel]
+                                           ? latency[sub_channel]->GetHistograms()[static_cast<std::size_t>(LatencyStage::EndToEnd)] : empty;
+        writer.StartObject();
+        writer.Key("index");
+        writer.Uint(sub_channel);
+        WriteCounters(writer, counters, end_to_end, elapsed_ns);
+        writer.EndObject();
+
+        total.reads += counters.reads;
+        total.writes += counters.writes;
+        total.read_bytes += counters.read_bytes;
+        total.write_bytes += counters.write_bytes;
+        total.queued += counters.queued;
+        total.max_queue_depth = std::max(total.max_queue_depth, counters.max_queue_depth);
+        total_latency.Merge(end_to_end);
+    }
+    writer.EndArray();
+
+    writer.Key("total");
+    writer.StartObject();
+    WriteCounters(writer, total, total_latency, elapsed_ns);
+    writer.EndObject();
+
+    writer.EndObject();
+    os << std::endl;
+}
+
+bool
+SubChannelRouter::WriteJson(const std::string& filename, const std::vector<const LatencyStatistics*>& latency) const
+{
+    std::ofstream file(filename, std::ios::out | std::ios::trunc);
+    if(!file.is_open())
+        return false;
+    WriteJson(file, latency);
+    return true;
+}
+
+}
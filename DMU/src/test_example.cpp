@@ -44,7 +44,17 @@ int sc_main(int argc, char **argv)
     tg.initiator.bind(monitor.target);
     monitor.initiator.bind(dmu.chi_port_0->target);
 
-    add_payloads_to_tg(tg);
+    // usage: dmu_test [trace.bin [fast]], trace 由 dmu_trace_convert 生成, fast 表示不按记录的时间发送
+    if(argc > 1)
+    {
+        tg.replay_trace(argv[1], !(argc > 2 && std::string(argv[2]) == "fast"));
+        while(!tg.trace_finished())
+            sc_core::sc_start(1, sc_core::SC_US);
+    }
+    else
+    {
+        add_payloads_to_tg(tg);
+    }
 
     sc_core::sc_start(20, sc_core::SC_US);
 
@@ -0,0 +1,143 @@
+// 稳态 heap 分配检查: 全局 operator new 计数
+//   1. payload pool + extension pool 单独循环: warm-up 之后每个 transaction 0 次 heap 分配
+//   2. 整个 DMU 仿真: traffic 分批加入 (低于 port 的吞吐, 不触发 RetryAck, CHITrafficGenerator 不处理 retry), warm-up 之后
+//      PortMemoryManager 的 payload / extension 分配数不再增长; 全局 operator new 次数 (包括 container / CHITrafficGenerator) 分两个稳态窗口统计,
+//      第一个窗口只打印 (LatencyHistogram 的延迟第一次到达新的数量级时 bucket 数组扩容), 第二个窗口必须为 0, 即分配数不再增长
+//      traffic 中带 WriteNoSnpPtl (RMW), 用 3ds_map2_rmw.json (RMW 需要 lpr credit); drain 之后 RMW 的 parent 也要回到 pool
+//      仿真期间关掉 trace: DPRINT 文本输出 (SC_REPORT) 每条都要构造 std::string, 属于调试开销, 不计入
+// 失败时返回非 0
+#include "DMU/DramManagerUnit.hh"
+#include "CHIPort/CHITrafficGenerator.h"
+#include "CHIPort/PortMemoryManager.hh"
+#include "Controller/common/MemoryManager.hh"
+#include "Common/TraceLog.hh"
+#include "sysc/kernel/sc_externs.h"
+#include <systemc>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+uint64_t numOfHeapAllocations = 0;
+}
+
+void* operator new(std::size_t size)
+{
+    numOfHeapAllocations++;
+    if(void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+constexpr unsigned kWarmUpTrans = 64;
+constexpr unsigned kSteadyTrans = 4096;
+constexpr unsigned kBatch = 4;
+const sc_core::sc_time kBatchInterval(400, sc_core::SC_NS);
+
+// CHIPort / controller 在一个 transaction 中对 payload 和 extension 做的操作
+bool CheckPoolSteadyState()
+{
+    dmu::Port::PortMemoryManager port_mm(false);
+    dmu::Controller::MemoryManager controller_mm;
+    ARM::CHI::Payload& chi_payload = *ARM::CHI::Payload::new_payload();
+    chi_payload.size = ARM::CHI::SIZE_64;
+    dmu::Port::CHIFlit flit(chi_payload, ARM::CHI::Phase());
+    dmu::UifInfo uif_info;
+
+    uint64_t start = 0;
+    for(unsigned i = 0; i < kWarmUpTrans + kSteadyTrans; i++)
+    {
+        if(i == kWarmUpTrans)
+            start = numOfHeapAllocations;
+        chi_payload.address = 0x40ULL * i;
+        tlm::tlm_generic_payload& trans = port_mm.allocate(flit, i % 2);
+        trans.acquire();
+        uif_info.cmd_id = i % 16;
+        port_mm.SetUifExtension(trans, uif_info);
+        trans.acquire(); // controller cam
+        // RMW child
+        tlm::tlm_generic_payload& child = controller_mm.allocate();
+        controller_mm.GetUifExtensionPool().Attach(child)->_uif_info = uif_info;
+        child.acquire();
+        // credit
+        controller_mm.GetSideBandExtensionPool().Attach(*controller_mm.getDummyPayload());
+        child.release();
+        trans.release();
+        trans.release();
+    }
+    uint64_t allocations = numOfHeapAllocations - start;
+    chi_payload.unref();
+
+    std::printf("pool steady state: %llu heap allocations in %u transactions\n",
+                static_cast<unsigned long long>(allocations), kSteadyTrans);
+    return allocations == 0;
+}
+
+bool CheckSimulationSteadyState()
+{
+    sc_core::sc_clock noc_clk("noc_clk", 2, sc_core::SC_NS, 0.5);
+    unsigned chi_data_width_bits = 256;
+    dmu::DramManagerUnit dmu("dram_manager_unit",noc_clk,chi_data_width_bits,"../../ConfigureFile","3ds_map2_rmw.json");
+    dmu::Port::CHITrafficGenerator tg("tg", chi_data_width_bits);
+    tg.clock(noc_clk);
+    tg.initiator.bind(dmu.chi_port_0->target);
+    dmu::trace::TraceLog::SetMask(0);
+
+    constexpr unsigned kNumOfTrans = 4000;
+    const dmu::Port::PortMemoryManager& port_mm = dmu.chi_port_0->GetMemoryManager();
+    unsigned added = 0;
+    // [kNumOfTrans / 4, kNumOfTrans / 2) 为第一个稳态窗口, [kNumOfTrans / 2, kNumOfTrans) 为第二个
+    uint64_t start_trans = 0, start_payloads = 0, start_extensions = 0, start_heap = 0, second_window_heap = 0;
+    while(added < kNumOfTrans)
+    {
+        if(added == kNumOfTrans / 4)
+        {
+            start_trans = port_mm.GetNumOfTransactions();
+            start_payloads = port_mm.GetNumOfAllocations();
+            start_extensions = port_mm.GetNumOfExtensionAllocations();
+            start_heap = numOfHeapAllocations;
+        }
+        if(added == kNumOfTrans / 2)
+            second_window_heap = numOfHeapAllocations;
+        for(unsigned i = 0; i < kBatch / 2; i++, added += 2)
+        {
+            tg.add_payload(ARM::CHI::REQ_OPCODE_READ_NO_SNP, 0x00001000 + added*0x20, ARM::CHI::SIZE_64);
+            if(i == 0)
+                tg.add_payload(ARM::CHI::REQ_OPCODE_WRITE_NO_SNP_FULL, 0x10001000 + added*0x20, ARM::CHI::SIZE_64);
+            else
+                tg.add_payload(ARM::CHI::REQ_OPCODE_WRITE_NO_SNP_PTL, 0x20001000 + added*0x20, ARM::CHI::SIZE_32);
+        }
+        sc_core::sc_start(kBatchInterval);
+    }
+    const uint64_t trans = port_mm.GetNumOfTransactions() - start_trans;
+    const uint64_t payloads = port_mm.GetNumOfAllocations() - start_payloads;
+    const uint64_t extensions = port_mm.GetNumOfExtensionAllocations() - start_extensions;
+    const uint64_t first_window_heap = second_window_heap - start_heap;
+    second_window_heap = numOfHeapAllocations - second_window_heap;
+
+    // 所有 transaction 完成后 payload 都应回到 pool, controller 析构时也会检查 cam 为空
+    sc_core::sc_start(20, sc_core::SC_US);
+    const uint64_t in_use = port_mm.GetNumOfPayloadsInUse();
+
+    std::printf("simulation steady state: %llu transactions, %llu payload allocations, %llu extension allocations, "
+                "heap allocations %llu in the first window / %llu in the second window, %llu payloads in use after drain\n",
+                static_cast<unsigned long long>(trans), static_cast<unsigned long long>(payloads),
+                static_cast<unsigned long long>(extensions), static_cast<unsigned long long>(first_window_heap),
+                static_cast<unsigned long long>(second_window_heap), static_cast<unsigned long long>(in_use));
+    return payloads == 0 && extensions == 0 && second_window_heap == 0 && in_use == 0 && trans + kBatch >= kNumOfTrans * 3 / 4;
+}
+
+} // namespace
+
+int sc_main(int argc, char **argv)
+{
+    bool pass = CheckPoolSteadyState();
+    pass = CheckSimulationSteadyState() && pass;
+    std::printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+// DMU_DATA_CHECK=scoreboard 端到端检查: 少量 cache line 上的读 / 写 / PTL 写 (RMW) 混合
+//   同一行上读写交替, 覆盖 RAW / WAR / WAW 的顺序, 以及 RMW 读出的数据与写数据的合并
+//   CHILoadGenerator 处理 RetryAck / PcrdGrant, 所有请求都要完成
+//   检查 scoreboard 没有 mismatch, 每个完成的读都被检查过, 析构时写出 DataCheck.json
+// 失败时返回非 0
+#include "DMU/DramManagerUnit.hh"
+#include "CHIPort/CHILoadGenerator.hh"
+#include "CHIPort/DataScoreboard.hh"
+#include "Common/TraceLog.hh"
+#include "rapidjson/document.h"
+#include "rapidjson/istreamwrapper.h"
+#include <systemc>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+constexpr uint64_t kRequestsPerRequester = 2000;
+const sc_core::sc_time kDrainStep(1, sc_core::SC_US);
+constexpr unsigned kMaxDrainSteps = 1000;
+
+bool CheckDataScoreboard()
+{
+    sc_core::sc_clock noc_clk("noc_clk", 2, sc_core::SC_NS, 0.5);
+    unsigned chi_data_width_bits = 256;
+    uint64_t reads = 0, writes = 0, rmw_writes = 0, checks = 0, mismatches = 0;
+    bool drained = false;
+    {
+        dmu::DramManagerUnit dmu("dram_manager_unit",noc_clk,chi_data_width_bits,"../../ConfigureFile","3ds_map2_rmw.json");
+        dmu::Port::CHILoadGenerator generator("generator", chi_data_width_bits);
+        generator.clock(noc_clk);
+        generator.initiator.bind(dmu.chi_port_0->target);
+        dmu::trace::TraceLog::SetMask(0);
+
+        // 两个 requester 共用 8 个 cache line: 一个整行读写, 一个读和 32B 的 PTL 写
+        for(unsigned i = 0; i < 2; i++)
+        {
+            dmu::Port::RequesterConfig config;
+            config.bandwidth_gbps = 8.0;
+            config.read_ratio = 0.5;
+            config.locality = dmu::Port::LocalityModel::HotSet;
+            config.base_address = 0x40001000;
+            config.footprint_bytes = 8 * 64;
+            config.hot_set_bytes = 8 * 64;
+            config.size = i == 0 ? ARM::CHI::SIZE_64 : ARM::CHI::SIZE_32;
+            config.src_id = 1 + i;
+            config.seed = 1 + i;
+            config.max_requests = kRequestsPerRequester;
+            generator.AddRequester(config);
+        }
+
+        for(unsigned step = 0; step < kMaxDrainSteps && !drained; step++)
+        {
+            sc_core::sc_start(kDrainStep);
+            uint64_t completed = 0;
+            for(unsigned i = 0; i < generator.GetNumOfRequesters(); i++)
+                completed += generator.GetStats(i).completed_reads + generator.GetStats(i).completed_writes;
+            drained = completed == kRequestsPerRequester * generator.GetNumOfRequesters() && generator.GetNumOfOutstanding() == 0;
+        }
+        for(unsigned i = 0; i < generator.GetNumOfRequesters(); i++)
+        {
+            reads += generator.GetStats(i).completed_reads;
+            writes += generator.GetStats(i).completed_writes;
+        }
+        rmw_writes = generator.GetStats(1).completed_writes;
+        const dmu::Port::DataScoreboard* scoreboard = dmu.chi_port_0->GetDataScoreboard();
+        if(scoreboard == nullptr)
+        {
+            std::printf("data scoreboard not enabled\n");
+            return false;
+        }
+        checks = scoreboard->GetNumOfChecks();
+        mismatches = scoreboard->GetNumOfMismatches();
+        std::printf("data check: %llu reads, %llu writes (%llu RMW), %llu CompData checked, %llu mismatches, drained %d\n",
+                    static_cast<unsigned long long>(reads), static_cast<unsigned long long>(writes),
+                    static_cast<unsigned long long>(rmw_writes), static_cast<unsigned long long>(checks),
+                    static_cast<unsigned long long>(mismatches), drained);
+    }
+
+    // DataCheck.json 在 DMU 析构时写出
+    std::ifstream file("./DataCheck.json");
+    rapidjson::IStreamWrapper stream(file);
+    rapidjson::Document document;
+    document.ParseStream(stream);
+    bool json_ok = !document.HasParseError() && document.IsObject() && document.HasMember("scoreboard")
+                   && document["scoreboard"]["mismatches"].GetUint64() == mismatches
+                   && document["scoreboard"]["compdata_checked"].GetUint64() == checks
+                   && document.HasMember("backing_store") && document["backing_store"].Size() == 1
+                   && document["backing_store"][0]["pages"].GetUint64() == 1;
+    if(!json_ok)
+        std::printf("DataCheck.json missing or inconsistent\n");
+
+    return drained && mismatches == 0 && reads > 0 && checks == reads && rmw_writes > 0 && json_ok;
+}
+
+} // namespace
+
+int sc_main(int argc, char **argv)
+{
+    setenv("DMU_DATA_CHECK", "scoreboard", 1);
+    setenv("DMU_TRANS_INFO", "off", 1);
+    bool pass = CheckDataScoreboard();
+    std::printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,118 @@
+// 3ds_map2_2sc.json (channel bit 6) 的两个 sub-channel 端到端检查
+//   两个 Stride requester, 步长 128B: 一个地址的 bit 6 恒为 0, 另一个恒为 1
+//   router 按 bit 6 分发时, sub-channel i 收到的读写数正好是 requester i 完成的读写数
+//   检查 DMU 析构时写出的 SubChannelStats.json 有两个 sub-channel, 各自的计数以及 total 与 requester 一致
+// 失败时返回非 0
+#include "DMU/DramManagerUnit.hh"
+#include "CHIPort/CHILoadGenerator.hh"
+#include "Common/TraceLog.hh"
+#include "rapidjson/document.h"
+#include "rapidjson/istreamwrapper.h"
+#include <systemc>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+constexpr unsigned kNumOfSubChannels = 2;
+constexpr uint64_t kChannelBit = uint64_t(1) << 6;
+constexpr uint64_t kRequestsPerRequester = 1000;
+const sc_core::sc_time kDrainStep(1, sc_core::SC_US);
+constexpr unsigned kMaxDrainSteps = 1000;
+
+bool CheckSubChannelRouting()
+{
+    sc_core::sc_clock noc_clk("noc_clk", 2, sc_core::SC_NS, 0.5);
+    unsigned chi_data_width_bits = 256;
+    uint64_t reads[kNumOfSubChannels] = {};
+    uint64_t writes[kNumOfSubChannels] = {};
+    bool drained = false;
+    unsigned num_of_sub_channels = 0;
+    std::remove("./SubChannelStats.json");
+    {
+        dmu::DramManagerUnit dmu("dram_manager_unit",noc_clk,chi_data_width_bits,"../../ConfigureFile","3ds_map2_2sc.json");
+        dmu::Port::CHILoadGenerator generator("generator", chi_data_width_bits);
+        generator.clock(noc_clk);
+        generator.initiator.bind(dmu.chi_port_0->target);
+        dmu::trace::TraceLog::SetMask(0);
+        num_of_sub_channels = dmu.GetNumOfSubChannels();
+
+        // requester i 的地址: base + i * 64 + n * 128, bit 6 恒为 i
+        for(unsigned i = 0; i < kNumOfSubChannels; i++)
+        {
+            dmu::Port::RequesterConfig config;
+            config.bandwidth_gbps = 4.0;
+            config.read_ratio = 0.5;
+            config.locality = dmu::Port::LocalityModel::Stride;
+            config.base_address = 0x40000000 + i * kChannelBit;
+            config.footprint_bytes = uint64_t(1) << 20;
+            config.stride_bytes = 2 * kChannelBit;
+            config.src_id = 1 + i;
+            config.seed = 1 + i;
+            config.max_requests = kRequestsPerRequester;
+            generator.AddRequester(config);
+        }
+
+        for(unsigned step = 0; step < kMaxDrainSteps && !drained; step++)
+        {
+            sc_core::sc_start(kDrainStep);
+            uint64_t completed = 0;
+            for(unsigned i = 0; i < generator.GetNumOfRequesters(); i++)
+                completed += generator.GetStats(i).completed_reads + generator.GetStats(i).completed_writes;
+            drained = completed == kRequestsPerRequester * generator.GetNumOfRequesters() && generator.GetNumOfOutstanding() == 0;
+        }
+        for(unsigned i = 0; i < kNumOfSubChannels; i++)
+        {
+            reads[i] = generator.GetStats(i).completed_reads;
+            writes[i] = generator.GetStats(i).completed_writes;
+            std::printf("requester %u (bit 6 = %u): %llu reads, %llu writes\n", i, i,
+                        static_cast<unsigned long long>(reads[i]), static_cast<unsigned long long>(writes[i]));
+        }
+        std::printf("%u sub-channels, drained %d\n", num_of_sub_channels, drained);
+    }
+
+    // SubChannelStats.json 在 DMU 析构时写出
+    std::ifstream file("./SubChannelStats.json");
+    rapidjson::IStreamWrapper stream(file);
+    rapidjson::Document document;
+    document.ParseStream(stream);
+    if(document.HasParseError() || !document.IsObject() || !document.HasMember("sub_channels")
+       || !document["sub_channels"].IsArray() || document["sub_channels"].Size() != kNumOfSubChannels)
+    {
+        std::printf("SubChannelStats.json missing or does not list %u sub-channels\n", kNumOfSubChannels);
+        return false;
+    }
+    bool routed = true;
+    uint64_t total_reads = 0, total_writes = 0;
+    for(unsigned i = 0; i < kNumOfSubChannels; i++)
+    {
+        const auto& sub_channel = document["sub_channels"][i];
+        uint64_t sub_channel_reads = sub_channel["reads"].GetUint64();
+        uint64_t sub_channel_writes = sub_channel["writes"].GetUint64();
+        std::printf("sub-channel %u: %llu reads, %llu writes, %.2f GB/s\n", sub_channel["index"].GetUint(),
+                    static_cast<unsigned long long>(sub_channel_reads), static_cast<unsigned long long>(sub_channel_writes),
+                    sub_channel["bandwidth_gbps"].GetDouble());
+        routed = routed && sub_channel["index"].GetUint() == i && sub_channel_reads == reads[i] && sub_channel_writes == writes[i]
+                 && sub_channel["bandwidth_gbps"].GetDouble() > 0.0;
+        total_reads += reads[i];
+        total_writes += writes[i];
+    }
+    const auto& total = document["total"];
+    routed = routed && total["reads"].GetUint64() == total_reads && total["writes"].GetUint64() == total_writes;
+    if(!routed)
+        std::printf("SubChannelStats.json does not match routing by channel bit 6\n");
+
+    return drained && num_of_sub_channels == kNumOfSubChannels && routed && total_reads > 0 && total_writes > 0;
+}
+
+} // namespace
+
+int sc_main(int argc, char **argv)
+{
+    setenv("DMU_TRANS_INFO", "off", 1);
+    bool pass = CheckSubChannelRouting();
+    std::printf("%s\n", pass ? "PASS" : "FAIL");
+    return pass ? 0 : 1;
+}
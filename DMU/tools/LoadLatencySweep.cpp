@@ -0,0 +1,212 @@
+// 开环负载下的延迟-带宽曲线: 每个注入带宽在单独的子进程中仿真 (SystemC 每个进程只能 elaborate 一次)
+// usage: dmu_load_sweep [option value]...
+//   --bw 2,4,8,16        总注入带宽 (GB/s) 列表, 平均分给各个 requester
+//   --sources 4          requester 数目
+//   --read 1.0           读请求比例
+//   --injection poisson  constant / poisson / onoff
+//   --locality random    stride / hotset / random
+//   --qos 15             请求的 qos
+//   --warmup 2           warm-up 时间 (us), 之后开始统计
+//   --time 20            统计时间 (us)
+//   --detail             打印每个 requester 的统计
+//   --configure ../../ConfigureFile  --map 3ds_map2.json
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+#include <systemc>
+
+#include "CHIPort/CHILoadGenerator.hh"
+#include "DMU/DramManagerUnit.hh"
+
+namespace {
+
+struct SweepOptions
+{
+    std::vector<double> bandwidths{2, 4, 8, 16, 24, 32};
+    unsigned sources{4};
+    double read_ratio{1.0};
+    dmu::Port::InjectionProcess injection{dmu::Port::InjectionProcess::Poisson};
+    dmu::Port::LocalityModel locality{dmu::Port::LocalityModel::Random};
+    unsigned qos{15};
+    double warmup_us{2};
+    double time_us{20};
+    bool detail{false};
+    std::string configure_dir{"../../ConfigureFile"};
+    std::string configure_file{"3ds_map2.json"};
+};
+
+bool
+ParseOptions(int argc, char** argv, SweepOptions& options)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        std::string key = argv[i];
+        if(key == "--detail")
+        {
+            options.detail = true;
+            continue;
+        }
+        if(i + 1 >= argc)
+            return false;
+        std::string value = argv[++i];
+        if(key == "--bw")
+        {
+            options.bandwidths.clear();
+            std::istringstream list(value);
+            for(std::string item; std::getline(list, item, ',');)
+                options.bandwidths.push_back(std::stod(item));
+        }
+        else if(key == "--sources")
+            options.sources = std::stoul(value);
+        else if(key == "--read")
+            options.read_ratio = std::stod(value);
+        else if(key == "--injection")
+        {
+            if(value == "constant")
+                options.injection = dmu::Port::InjectionProcess::Constant;
+            else if(value == "poisson")
+                options.injection = dmu::Port::InjectionProcess::Poisson;
+            else if(value == "onoff")
+                options.injection = dmu::Port::InjectionProcess::OnOff;
+            else
+                return false;
+        }
+        else if(key == "--locality")
+        {
+            if(value == "stride")
+                options.locality = dmu::Port::LocalityModel::Stride;
+            else if(value == "hotset")
+                options.locality = dmu::Port::LocalityModel::HotSet;
+            else if(value == "random")
+                options.locality = dmu::Port::LocalityModel::Random;
+            else
+                return false;
+        }
+        else if(key == "--qos")
+            options.qos = std::stoul(value);
+        else if(key == "--warmup")
+            options.warmup_us = std::stod(value);
+        else if(key == "--time")
+            options.time_us = std::stod(value);
+        else if(key == "--configure")
+            options.configure_dir = value;
+        else if(key == "--map")
+            options.configure_file = value;
+        else
+            return false;
+    }
+    return options.sources > 0 && !options.bandwidths.empty();
+}
+
+// 在子进程中运行一个带宽点, 结果写到 result
+// 仿真结束时还有未完成的请求, 模块不析构 (MemoryController 析构时检查 cam 为空), 由调用者 _Exit
+void
+RunPoint(const SweepOptions& options, double bandwidth, std::FILE* result)
+{
+    sc_core::sc_clock* noc_clk = new sc_core::sc_clock("noc_clk", 2, sc_core::SC_NS, 0.5);
+    unsigned chi_data_width_bits = 256;
+    dmu::DramManagerUnit* dmu = new dmu::DramManagerUnit("dram_manager_unit", *noc_clk, chi_data_width_bits, options.configure_dir, options.configure_file);
+    dmu::Port::CHILoadGenerator& generator = *new dmu::Port::CHILoadGenerator("generator", chi_data_width_bits);
+    generator.clock(*noc_clk);
+    generator.initiator.bind(dmu->chi_port_0->target);
+
+    for(unsigned i = 0; i < options.sources; i++)
+    {
+        dmu::Port::RequesterConfig config;
+        config.bandwidth_gbps = bandwidth / options.sources;
+        config.injection = options.injection;
+        config.read_ratio = options.read_ratio;
+        config.locality = options.locality;
+        config.base_address = uint64_t(i) << 30;
+        config.qos = options.qos;
+        config.src_id = 1 + i;
+        config.seed = 1 + i;
+        generator.AddRequester(config);
+    }
+
+    sc_core::sc_start(options.warmup_us, sc_core::SC_US);
+    generator.ResetStats();
+    sc_core::sc_start(options.time_us, sc_core::SC_US);
+
+    dmu::Port::RequesterStats total;
+    double achieved_bytes = 0;
+    for(unsigned i = 0; i < generator.GetNumOfRequesters(); i++)
+    {
+        const dmu::Port::RequesterStats& stats = generator.GetStats(i);
+        total.generated += stats.generated;
+        total.retried += stats.retried;
+        total.completed_reads += stats.completed_reads;
+        total.completed_writes += stats.completed_writes;
+        total.read_latency_sum_ps += stats.read_latency_sum_ps;
+        total.write_latency_sum_ps += stats.write_latency_sum_ps;
+        total.max_read_latency_ps = std::max(total.max_read_latency_ps, stats.max_read_latency_ps);
+        total.max_write_latency_ps = std::max(total.max_write_latency_ps, stats.max_write_latency_ps);
+        achieved_bytes += stats.completed_bytes;
+    }
+    const double window_ns = options.time_us * 1000.0;
+    std::fprintf(result, "%10.2f %10.2f %10.2f %10.1f %10.1f %10.1f %10.1f %8llu\n",
+                bandwidth, total.generated * 64.0 / window_ns, achieved_bytes / window_ns,
+                total.completed_reads ? total.read_latency_sum_ps / 1000.0 / total.completed_reads : 0.0,
+                total.max_read_latency_ps / 1000.0,
+                total.completed_writes ? total.write_latency_sum_ps / 1000.0 / total.completed_writes : 0.0,
+                total.max_write_latency_ps / 1000.0,
+                static_cast<unsigned long long>(total.retried));
+    if(options.detail)
+    {
+        std::ostringstream report;
+        generator.PrintReport(report);
+        std::fputs(report.str().c_str(), result);
+    }
+    std::fflush(result);
+}
+
+} // namespace
+
+int
+sc_main(int argc, char** argv)
+{
+    SweepOptions options;
+    if(!ParseOptions(argc, argv, options))
+    {
+        std::cerr << "usage: " << argv[0] << " [--bw list] [--sources n] [--read ratio] [--injection constant|poisson|onoff]"
+                  << " [--locality stride|hotset|random] [--qos q] [--warmup us] [--time us] [--detail]"
+                  << " [--configure dir] [--map file]" << std::endl;
+        return 1;
+    }
+    // 模型的调试输出 (包括 SC_REPORT) 写到 stdout, 子进程把 stdout 重定向到 stderr, 结果表格写到原来的 stdout
+    std::printf("%10s %10s %10s %10s %10s %10s %10s %8s\n",
+                "target", "offered", "achieved", "rd avg ns", "rd max ns", "wr avg ns", "wr max ns", "retried");
+    std::fflush(stdout);
+    for(double bandwidth: options.bandwidths)
+    {
+        pid_t pid = fork();
+        if(pid == 0)
+        {
+            std::FILE* result = fdopen(dup(STDOUT_FILENO), "w");
+            if(result == nullptr || dup2(STDERR_FILENO, STDOUT_FILENO) < 0)
+                std::_Exit(1);
+            RunPoint(options, bandwidth, result);
+            std::_Exit(0);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if(!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            std::cerr << "simulation at " << bandwidth << " GB/s failed (";
+            if(WIFSIGNALED(status))
+                std::cerr << "signal " << WTERMSIG(status) << ")" << std::endl;
+            else
+                std::cerr << "exit " << WEXITSTATUS(status) << ")" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}